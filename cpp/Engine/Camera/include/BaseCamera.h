@@ -64,6 +64,8 @@ class BaseCamera : public SceneObject {
 
   virtual std::mutex& GetMatrixLock() { return updateMatrixMutex; }
   glm::mat4& GetViewMatrix() { return viewMatrix; }
+  // Viewed from the interpolated render transform instead of the last step
+  glm::mat4 GetRenderViewMatrix() const;
   glm::mat4& GetProjMatrix() { return projMatrix; }
 
 #pragma region Params
@@ -10,6 +10,14 @@ void BaseCamera::UpdateViewMatrix() {
              GetAbsolutePosition() + GetAbsoluteForward(), GetAbsoluteUp());
 }
 
+glm::mat4 BaseCamera::GetRenderViewMatrix() const {
+  const glm::mat4x4 transform = GetRenderTransform();
+  const glm::vec3 position(transform[3]);
+  return lookAt(position,
+                position + glm::normalize(glm::vec3(-transform[2])),
+                glm::normalize(glm::vec3(transform[1])));
+}
+
 void BaseCamera::UpdateProjMatrix() {
   if (aspect < 0) {
     if (auto graphicsPtr = graphics.lock()) {
@@ -27,7 +35,8 @@ void BaseCamera::OnCreate() {
 
   if (auto scenePtr = scene.lock()) {
     scenePtr->RegisterCamera(
-        name, std::static_pointer_cast<BaseCamera>(shared_from_this()));
+        StringIdUtils::Intern(name),
+        std::static_pointer_cast<BaseCamera>(shared_from_this()));
   }
 
   aspect = ParseAspect(JSON_CONFIG(String, "Aspect"));
@@ -66,44 +75,44 @@ void BaseCamera::OnDestroy() {
   SceneObject::OnDestroy();
 
   if (auto scenePtr = scene.lock()) {
-    scenePtr->UnregisterCamera(name);
+    scenePtr->UnregisterCamera(StringIdUtils::Intern(name));
   }
 }
 
 void BaseCamera::PerformTraslation() {
-  if (Input::Key::w) {
+  if (Input::Key::Held(GLFW_KEY_W)) {
     SetRelativePosition(GetRelativePosition() +
                         GetRelativeForward() * moveSpeed * GameDeltaTime);
   }
-  if (Input::Key::a) {
+  if (Input::Key::Held(GLFW_KEY_A)) {
     SetRelativePosition(GetRelativePosition() +
                         GetRelativeLeft() * moveSpeed * GameDeltaTime);
   }
-  if (Input::Key::s) {
+  if (Input::Key::Held(GLFW_KEY_S)) {
     SetRelativePosition(GetRelativePosition() -
                         GetRelativeForward() * moveSpeed * GameDeltaTime);
   }
-  if (Input::Key::d) {
+  if (Input::Key::Held(GLFW_KEY_D)) {
     SetRelativePosition(GetRelativePosition() -
                         GetRelativeLeft() * moveSpeed * GameDeltaTime);
   }
-  if (Input::Key::q) {
+  if (Input::Key::Held(GLFW_KEY_Q)) {
     SetRelativePosition(GetRelativePosition() -
                         GetRelativeUp() * moveSpeed * GameDeltaTime);
   }
-  if (Input::Key::e) {
+  if (Input::Key::Held(GLFW_KEY_E)) {
     SetRelativePosition(GetRelativePosition() +
                         GetRelativeUp() * moveSpeed * GameDeltaTime);
   }
-  if (Input::Mouse::scrollY > 0) {
-    if (Input::Key::leftShift) {
+  if (Input::Mouse::GetScrollY() > 0) {
+    if (Input::Key::Held(GLFW_KEY_LEFT_SHIFT)) {
       moveSpeed = std::min(maxMoveSpeed, moveSpeed * 2);
     } else {
       fovy = std::max(minFov, fovy - sensitivityZ);
     }
   }
-  if (Input::Mouse::scrollY < 0) {
-    if (Input::Key::leftShift) {
+  if (Input::Mouse::GetScrollY() < 0) {
+    if (Input::Key::Held(GLFW_KEY_LEFT_SHIFT)) {
       moveSpeed = std::max(minMoveSpeed, moveSpeed / 2);
     } else {
       fovy = std::min(maxFov, fovy + sensitivityZ);
@@ -115,13 +124,14 @@ void BaseCamera::PerformRotation() {
   static float mouseLastPosX = 0;
   static float mouseLastPosY = 0;
 
-  float mouseDeltaX = Input::Mouse::posX - mouseLastPosX;
-  float mouseDeltaY = Input::Mouse::posY - mouseLastPosY;
+  float mouseDeltaX = Input::Mouse::GetPosX() - mouseLastPosX;
+  float mouseDeltaY = Input::Mouse::GetPosY() - mouseLastPosY;
 
-  mouseLastPosX = Input::Mouse::posX;
-  mouseLastPosY = Input::Mouse::posY;
+  mouseLastPosX = Input::Mouse::GetPosX();
+  mouseLastPosY = Input::Mouse::GetPosY();
 
-  if (Input::Mouse::left || Input::Mouse::right) {
+  if (Input::Mouse::Held(GLFW_MOUSE_BUTTON_LEFT) ||
+      Input::Mouse::Held(GLFW_MOUSE_BUTTON_RIGHT)) {
     rotateY += sensitivityY * mouseDeltaY;
     rotateX -= sensitivityX * mouseDeltaX;
     SetRelativeRotation(glm::vec3(rotateY, rotateX, 0));
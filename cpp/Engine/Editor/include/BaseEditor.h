@@ -9,6 +9,7 @@
 #include <GLFW/glfw3.h>
 
 #include <filesystem>
+#include <functional>
 #include <fstream>
 #include <sstream>
 
@@ -17,6 +18,7 @@
 #include "imgui_impl_vulkan.h"
 #include "rapidjson/document.h"
 #include "rapidjson/istreamwrapper.h"
+#include "rapidjson/pointer.h"
 
 enum class LastSelectType { None, File, Object };
 class Application;
@@ -50,6 +52,10 @@ class BaseEditor : public BaseObject {
   bool enableZPrePass = false;
   bool enableShadowMap = false;
   bool enableDeferredRendering = false;
+  bool enableCompactGBuffer = false;
+  bool enableOcclusionCulling = false;
+  bool enableTileClassification = false;
+  bool enableAsyncCompute = false;
 
   bool showFileExplorer = true;
   bool showSceneHierarchy = false;
@@ -83,7 +89,14 @@ class BaseEditor : public BaseObject {
 
   std::weak_ptr<rapidjson::Document> LoadJsonFile(
       const std::filesystem::path& path);
-  void DisplayJson(rapidjson::Value& value, bool& modifiedValue);
+  // Shows the published document read only, an edit goes to a copy of it
+  // through EditSelectedFile
+  void DisplayJson(const rapidjson::Value& value,
+                   const rapidjson::Pointer& path, bool& modifiedValue);
+  void EditSelectedFile(
+      const rapidjson::Pointer& path,
+      const std::function<void(rapidjson::Value&, rapidjson::Document&)>&
+          edit);
   void DisplayDirectory(const std::filesystem::path& path);
   void DisplayHierarchy(std::weak_ptr<SceneObject> root, std::string path);
   void DisplayProperties(std::weak_ptr<SceneObject> object);
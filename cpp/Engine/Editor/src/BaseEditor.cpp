@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <format>
 
 #define DoubleClickTimeInterval 0.3f
 
@@ -448,6 +449,10 @@ void BaseEditor::InitConfig() {
   enableZPrePass = appPointer->GetEnableZPrePass();
   enableShadowMap = appPointer->GetEnableShadowMap();
   enableDeferredRendering = appPointer->GetEnableDeferred();
+  enableCompactGBuffer = appPointer->GetEnableCompactGBuffer();
+  enableOcclusionCulling = appPointer->GetEnableOcclusionCulling();
+  enableTileClassification = appPointer->GetEnableTileClassification();
+  enableAsyncCompute = appPointer->GetEnableAsyncCompute();
 }
 
 // Main code
@@ -664,6 +669,39 @@ void BaseEditor::EditorDrawMenuBar() {
                                     "EnableDeferred", enableDeferredRendering);
         appPointer->SetGraphicsSettingsModified(true);
       }
+      if (ImGui::Checkbox("Enable Compact GBuffer", &enableCompactGBuffer)) {
+        std::string graphicsConfigPath = JsonUtils::ReadStringFromFile(
+            appPointer->GetRoot() + appPointer->GetFile(), "GraphicsConfig");
+        JsonUtils::ModifyBoolOfFile(appPointer->GetRoot() + graphicsConfigPath,
+                                    "EnableCompactGBuffer",
+                                    enableCompactGBuffer);
+        appPointer->SetGraphicsSettingsModified(true);
+      }
+      if (ImGui::Checkbox("Enable Occlusion Culling",
+                          &enableOcclusionCulling)) {
+        std::string graphicsConfigPath = JsonUtils::ReadStringFromFile(
+            appPointer->GetRoot() + appPointer->GetFile(), "GraphicsConfig");
+        JsonUtils::ModifyBoolOfFile(appPointer->GetRoot() + graphicsConfigPath,
+                                    "EnableOcclusionCulling",
+                                    enableOcclusionCulling);
+        appPointer->SetGraphicsSettingsModified(true);
+      }
+      if (ImGui::Checkbox("Enable Tile Classification",
+                          &enableTileClassification)) {
+        std::string graphicsConfigPath = JsonUtils::ReadStringFromFile(
+            appPointer->GetRoot() + appPointer->GetFile(), "GraphicsConfig");
+        JsonUtils::ModifyBoolOfFile(appPointer->GetRoot() + graphicsConfigPath,
+                                    "EnableTileClassification",
+                                    enableTileClassification);
+        appPointer->SetGraphicsSettingsModified(true);
+      }
+      if (ImGui::Checkbox("Enable Async Compute", &enableAsyncCompute)) {
+        std::string graphicsConfigPath = JsonUtils::ReadStringFromFile(
+            appPointer->GetRoot() + appPointer->GetFile(), "GraphicsConfig");
+        JsonUtils::ModifyBoolOfFile(appPointer->GetRoot() + graphicsConfigPath,
+                                    "EnableAsyncCompute", enableAsyncCompute);
+        appPointer->SetGraphicsSettingsModified(true);
+      }
       ImGui::EndMenu();
     }
     ImGui::SameLine();
@@ -761,6 +799,46 @@ void BaseEditor::EditorDrawFrameCount() {
       if (appPointer->GetShowRenderFrame()) {
         fpsText +=
             "Render FPS: " + std::to_string(appPointer->GetRenderFrameCount());
+        if (appPointer->GetEnableOcclusionCulling() &&
+            appPointer->GetEnableZPrePass()) {
+          fpsText += " | Occluded: " +
+                     std::to_string(appPointer->GetOcclusionCulledCount()) +
+                     "/" +
+                     std::to_string(appPointer->GetOcclusionTestedCount());
+        }
+        if (appPointer->GetEnableAsyncCompute()) {
+          if (appPointer->GetTimelineSemaphoreSupport() == false) {
+            fpsText += " | Compute: Unsupported";
+          } else {
+            fpsText += appPointer->GetSeparateComputeQueue()
+                           ? " | Compute: Async"
+                           : " | Compute: Graphics Queue";
+          }
+        }
+        fpsText += " | Draws: " +
+                   std::to_string(appPointer->GetDrawCallCount()) +
+                   " | Binds: " + std::to_string(appPointer->GetBindCount()) +
+                   " (" + std::to_string(appPointer->GetSkippedBindCount()) +
+                   " skipped)";
+        if (appPointer->GetEnableDeferred()) {
+          fpsText += " | GBuffer: " +
+                     std::to_string(appPointer->GetGBufferMemorySize() >> 20) +
+                     " MB";
+          if (appPointer->GetEnableTileClassification()) {
+            fpsText +=
+                " | Lighting Tiles: " +
+                std::to_string(appPointer->GetLightingTileCount()) + "/" +
+                std::to_string(appPointer->GetLightingFullscreenTileCount());
+          }
+          fpsText += std::format(" | Lighting: {:.3f} ms",
+                                 appPointer->GetLightingGpuTime());
+        }
+        fpsText +=
+            " | Transient: " +
+            std::to_string(appPointer->GetTransientMemorySize() >> 20) +
+            " MB (" +
+            std::to_string(appPointer->GetAliasedMemorySize() >> 20) +
+            " MB aliased)";
       }
       if (appPointer->GetShowRenderFrame() && appPointer->GetShowGameFrame()) {
         fpsText += " | ";
@@ -821,7 +899,20 @@ std::weak_ptr<Document> BaseEditor::LoadJsonFile(const fs::path& path) {
                                        ParseFilePath(path.string()));
 }
 
-void BaseEditor::DisplayJson(Value& value, bool& modifiedValue) {
+void BaseEditor::EditSelectedFile(
+    const Pointer& path, const std::function<void(Value&, Document&)>& edit) {
+  JsonUtils::EditDocument(GetRoot() + ParseFilePath(selectedFile.first),
+                          [&path, &edit](Document& doc) {
+                            if (Value* value = path.Get(doc)) {
+                              edit(*value, doc);
+                            }
+                          });
+  // The published copy replaces the document shown
+  selectedFile.second = LoadJsonFile(selectedFile.first);
+}
+
+void BaseEditor::DisplayJson(const Value& value, const Pointer& path,
+                             bool& modifiedValue) {
   if (modifiedValue) {
     return;
   }
@@ -833,48 +924,52 @@ void BaseEditor::DisplayJson(Value& value, bool& modifiedValue) {
         ImGui::SetNextItemOpen(false, ImGuiCond_Always);
       }
       if (ImGui::TreeNode(it->name.GetString())) {
-        DisplayJson(it->value, modifiedValue);
+        DisplayJson(it->value,
+                    path.Append(it->name.GetString(),
+                                it->name.GetStringLength()),
+                    modifiedValue);
         ImGui::TreePop();
       }
     }
   } else if (value.IsArray()) {
-    int index = 0;
-    for (auto& item : value.GetArray()) {
+    SizeType index = 0;
+    for (const auto& item : value.GetArray()) {
       if (expandAllProperties) {
         ImGui::SetNextItemOpen(true, ImGuiCond_Always);
       } else if (collapseAllProperties) {
         ImGui::SetNextItemOpen(false, ImGuiCond_Always);
       }
-      if (ImGui::TreeNode(("Index " + std::to_string(index++)).c_str())) {
-        DisplayJson(item, modifiedValue);
+      if (ImGui::TreeNode(("Index " + std::to_string(index)).c_str())) {
+        DisplayJson(item, path.Append(index), modifiedValue);
         ImGui::TreePop();
       }
+      index++;
     }
   } else if (value.IsBool()) {
     bool val = value.GetBool();
     if (ImGui::Checkbox("##Value", &val)) {
-      value.SetBool(val);
       modifiedValue = true;
-      JsonUtils::WriteDocumentToFile(selectedFile.first, selectedFile.second,
-                                     false);
+      EditSelectedFile(path, [val](Value& edited, Document&) {
+        edited.SetBool(val);
+      });
     }
   } else if (value.IsInt()) {
     int val = value.GetInt();
     if (ImGui::InputInt("##Value", &val, 0, 0,
                         ImGuiInputTextFlags_EnterReturnsTrue)) {
-      value.SetInt(val);
       modifiedValue = true;
-      JsonUtils::WriteDocumentToFile(selectedFile.first, selectedFile.second,
-                                     false);
+      EditSelectedFile(path, [val](Value& edited, Document&) {
+        edited.SetInt(val);
+      });
     }
   } else if (value.IsDouble()) {
     double val = value.GetDouble();
     if (ImGui::InputDouble("##Value", &val, 0, 0, "%.4f",
                            ImGuiInputTextFlags_EnterReturnsTrue)) {
-      value.SetDouble(val);
       modifiedValue = true;
-      JsonUtils::WriteDocumentToFile(selectedFile.first, selectedFile.second,
-                                     false);
+      EditSelectedFile(path, [val](Value& edited, Document&) {
+        edited.SetDouble(val);
+      });
     }
   } else if (value.IsString()) {
     std::string val = value.GetString();
@@ -885,15 +980,13 @@ void BaseEditor::DisplayJson(Value& value, bool& modifiedValue) {
 
     if (ImGui::InputText("##Value", buf, sizeof(buf),
                          ImGuiInputTextFlags_EnterReturnsTrue)) {
-      auto selectedFilePtr = selectedFile.second.lock();
-      auto& allocator = selectedFilePtr->GetAllocator();
-
-      std::string bufStr(buf);
-      value.SetString(bufStr.data(), bufStr.size(), allocator);
-
       modifiedValue = true;
-      JsonUtils::WriteDocumentToFile(selectedFile.first, selectedFile.second,
-                                     false);
+      const std::string bufStr(buf);
+      EditSelectedFile(path, [&bufStr](Value& edited, Document& doc) {
+        edited.SetString(bufStr.data(),
+                         static_cast<SizeType>(bufStr.size()),
+                         doc.GetAllocator());
+      });
     }
   }
 }
@@ -1157,7 +1250,7 @@ void BaseEditor::EditorDrawFileExplorer() {
                 GetRoot(), ParseFilePath(selectedFile.first),
                 appPointer->GetScene());
             if (auto allLightsChannel =
-                    appPointer->GetLightChannelByName("All").lock()) {
+                    appPointer->GetLightChannelByName("All"_sid).lock()) {
               allLightsChannel->AddLightToChannel(
                   static_pointer_cast<BaseLight>(object));
             }
@@ -1167,7 +1260,7 @@ void BaseEditor::EditorDrawFileExplorer() {
                 selectedObject.second, objectName, GetRoot(),
                 ParseFilePath(selectedFile.first), appPointer->GetScene());
             if (auto allLightsChannel =
-                    appPointer->GetLightChannelByName("All").lock()) {
+                    appPointer->GetLightChannelByName("All"_sid).lock()) {
               allLightsChannel->AddLightToChannel(
                   static_pointer_cast<BaseLight>(object));
             }
@@ -1614,6 +1707,16 @@ void BaseEditor::DisplayProperties(std::weak_ptr<SceneObject> object) {
         }
         ImGui::TreePop();
       }
+    } else if (auto modelPtr = dynamic_pointer_cast<BaseModel>(objPtr)) {
+      ProcessExpandOrCollapse;
+      if (ImGui::TreeNode("Params")) {
+        ImGui::Text("Camera: %s",
+                    StringIdUtils::GetName(modelPtr->GetCameraId()).c_str());
+        ImGui::Text(
+            "Light Channel: %s",
+            StringIdUtils::GetName(modelPtr->GetLightChannelId()).c_str());
+        ImGui::TreePop();
+      }
     }
   }
 }
@@ -1693,7 +1796,7 @@ void BaseEditor::EditorDrawObjectInspector() {
       if (lastSelectType == LastSelectType::File && selectedFilePtr &&
           selectedFilePtr->IsObject()) {
         bool valueModified = false;
-        DisplayJson(*selectedFilePtr, valueModified);
+        DisplayJson(*selectedFilePtr, Pointer(), valueModified);
         expandAllProperties = false;
         collapseAllProperties = false;
       } else if (lastSelectType == LastSelectType::Object &&
@@ -1741,6 +1844,7 @@ void BaseEditor::EditorDrawObjectInspector() {
 
       ImGui::SetCursorPosX(ImGui::GetWindowSize().x * 0.5f + 82.0f);
       if (ImGui::Button("Save Properties", ImVec2(buttonWidth, buttonHeight))) {
+        JsonUtils::FlushPendingWrites();
       }
       ImGui::End();
     }
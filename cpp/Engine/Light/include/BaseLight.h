@@ -39,7 +39,7 @@ class BaseLight : public SceneObject {
   virtual float& GetIntensity() { return intensity; }
   virtual glm::vec4& GetColor() { return color; }
 
-  virtual const glm::vec3& GetPosition() const { return GetAbsolutePosition(); }
+  virtual glm::vec3 GetPosition() const { return GetAbsolutePosition(); }
   virtual const glm::vec3& GetNormal() { return GetAbsoluteForward(); }
 
   virtual void UpdateViewMatrix() = 0;
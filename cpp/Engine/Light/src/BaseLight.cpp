@@ -6,7 +6,8 @@ void BaseLight::OnCreate() {
 
   if (auto scenePtr = scene.lock()) {
     id = scenePtr->RegisterLight(
-        name, std::static_pointer_cast<BaseLight>(shared_from_this()));
+        StringIdUtils::Intern(name),
+        std::static_pointer_cast<BaseLight>(shared_from_this()));
   }
 
   intensity = JSON_CONFIG(Float, "Intensity");
@@ -17,6 +18,6 @@ void BaseLight::OnDestroy() {
   SceneObject::OnDestroy();
 
   if (auto scenePtr = scene.lock()) {
-    scenePtr->UnregisterLight(name);
+    scenePtr->UnregisterLight(StringIdUtils::Intern(name));
   }
 }
\ No newline at end of file
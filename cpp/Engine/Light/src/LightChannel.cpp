@@ -8,7 +8,8 @@ void LightChannel::OnCreate() {
     scene = std::static_pointer_cast<BaseScene>(ownerPtr);
     if (auto scenePtr = scene.lock()) {
       scenePtr->RegisterLightChannel(
-          name, std::static_pointer_cast<LightChannel>(shared_from_this()));
+          StringIdUtils::Intern(name),
+          std::static_pointer_cast<LightChannel>(shared_from_this()));
     } else {
       throw std::runtime_error(
           "please create light channel through scene method!");
@@ -19,6 +20,6 @@ void LightChannel::OnDestroy() {
   BaseObject::OnDestroy();
 
   if (auto scenePtr = scene.lock()) {
-    scenePtr->UnregisterLightChannel(name);
+    scenePtr->UnregisterLightChannel(StringIdUtils::Intern(name));
   }
 }
\ No newline at end of file
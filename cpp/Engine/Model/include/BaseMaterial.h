@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Engine/System/include/BaseObject.h>
+#include <Engine/Utility/include/StringIdUtils.h>
 #include <assimp/scene.h>
 #include <assimp/types.h>
 
@@ -15,6 +16,7 @@ class BaseMaterial final : public BaseObject {
 
   std::weak_ptr<BaseScene> scene;
   std::vector<std::string> shaders;
+  std::vector<StringId> shaderIds;
   aiMaterial* matData = nullptr;
 
  public:
@@ -26,10 +28,12 @@ class BaseMaterial final : public BaseObject {
 
   virtual void OnCreate() override;
   virtual void OnDestroy() override;
+  void ReloadParams();
 
   std::string& GetName() { return name; }
   glm::vec4& GetColor() { return color; }
   float& GetRoughness() { return roughness; }
   float& GetMetallic() { return metallic; }
   std::vector<std::string>& GetShaders() { return shaders; }
+  std::vector<StringId>& GetShaderIds() { return shaderIds; }
 };
\ No newline at end of file
@@ -21,16 +21,19 @@ class BaseModel final : public SceneObject {
   std::vector<std::shared_ptr<MeshData>> meshes;
   std::weak_ptr<GraphicsInterface> graphics;
 
-  std::string _cameraName = "Unset";
+  StringId _cameraId = "Unset"_sid;
   std::weak_ptr<BaseCamera> _camera;
 
-  std::string _lightChannelName = "Unset";
+  StringId _lightChannelId = "Unset"_sid;
   std::weak_ptr<LightChannel> _lightChannel;
 
   float importSize = 1.0f;
   float textureCompressionRatio = 1.0f;
+  uint32_t vertexFormat = FullVertexFormat;
+  uint32_t geometryPasses = NoGeometryPass;
   std::atomic<bool> loaing = false;
-  virtual void LoadFbxDatas(const unsigned int parserFlags);
+  virtual Coroutine::Task<void> LoadFbxDatas(BaseResource& resources,
+                                             const unsigned int parserFlags);
 
  public:
   template <typename... Args>
@@ -42,7 +45,6 @@ class BaseModel final : public SceneObject {
   void ClearTextureCache();
 
   virtual void OnCreate() override;
-  virtual void OnUpdate() override;
   virtual void OnDestroy() override;
   virtual void OnStart() override;
   virtual void OnStop() override;
@@ -52,9 +54,13 @@ class BaseModel final : public SceneObject {
 
   virtual void SetCamera(const std::string& cameraName);
   virtual void SetLightChannel(const std::string& lightChannelName);
+  StringId GetCameraId() const { return _cameraId; }
+  StringId GetLightChannelId() const { return _lightChannelId; }
 
   float GetImportSize() { return importSize; }
   float GetTextureCompressionRatio() { return textureCompressionRatio; }
+  uint32_t GetVertexFormat() { return vertexFormat; }
+  uint32_t GetGeometryPasses() { return geometryPasses; }
   virtual std::weak_ptr<BaseCamera> GetCamera();
   virtual std::weak_ptr<LightChannel> GetLightChannel();
   virtual std::vector<std::shared_ptr<MeshData>>& GetMeshes();
@@ -1,59 +1,38 @@
 #pragma once
 
+#include <Engine/Model/include/TransformSystem.h>
+
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <memory>
+#include <vector>
 
 class SceneObject;
+struct MeshData;
 
 class BaseTransform {
   std::weak_ptr<SceneObject> _owner;
+  uint32_t slot = TransformSystem::InvalidSlot;
+  // Meshes reading the render transform of the slot by address
+  std::vector<std::weak_ptr<MeshData>> renderTransformUsers;
 
  public:
-  void RegisterOwner(std::weak_ptr<SceneObject> other) { _owner = other; }
-
-  // glm::vec3 relativeLeft = glm::vec3(1, 0, 0);
-  // glm::vec3 absoluteLeft = glm::vec3(1, 0, 0);
-
-  // glm::vec3 relativeUp = glm::vec3(0, 1, 0);
-  // glm::vec3 absoluteUp = glm::vec3(0, 1, 0);
-
-  // glm::vec3 relativeForward = glm::vec3(0, 0, 1);
-  // glm::vec3 absoluteForward = glm::vec3(0, 0, 1);
-
-  // glm::vec3 relativePosition = glm::vec3(0);
-  // glm::vec3 absolutePosition = glm::vec3(0);
-
-  // glm::vec3 relativeRotation = glm::vec3(0);
-  // glm::vec3 absoluteRotation = glm::vec3(0);
-
-  // glm::vec3 relativeScale = glm::vec3(0);
-  // glm::vec3 absoluteScale = glm::vec3(0);
-
-  // glm::mat4x4x4 absoluteTransform = glm::mat4x4x4(1);
-  // glm::mat4x4x4 relativeTransform = glm::mat4x4x4(1);
-
-  // glm::quat absoluteRotationQuat;
-  // glm::quat relativeRotationQuat;
+  void RegisterOwner(std::weak_ptr<SceneObject> other);
 
   BaseTransform()
-      : relativePosition(0.0f),
-        relativeRotation(0.0f),
-        relativeScale(1.0f),
-        relativeTransform(1.0f),
-        absolutePosition(0.0f),
-        absoluteRotation(0.0f),
-        absoluteScale(1.0f),
-        absoluteTransform(1.0f),
-        relativeLeft(0.0f),
+      : relativeLeft(0.0f),
         relativeUp(0.0f),
         relativeForward(0.0f),
         absoluteLeft(0.0f),
         absoluteUp(0.0f),
         absoluteForward(0.0f),
-        _owner(std::shared_ptr<SceneObject>(nullptr)) {}
+        _owner(std::shared_ptr<SceneObject>(nullptr)),
+        slot(TransformSystem::AllocateSlot()) {}
+  ~BaseTransform();
+  BaseTransform(const BaseTransform&) = delete;
+  BaseTransform& operator=(const BaseTransform&) = delete;
 
   glm::vec3 ExtractTranslation(const glm::mat4x4& transform) {
     return glm::vec3(transform[3]);
@@ -75,77 +54,86 @@ class BaseTransform {
   void UpdateAbsoluteTransform();
   void UpdateRelativeTransform();
 
-  const glm::mat4x4& GetRelativeTransform() const { return relativeTransform; }
-  const glm::mat4x4& GetAbsoluteTransform() const { return absoluteTransform; }
-  const glm::vec3& GetRelativePosition() const { return relativePosition; }
-  const glm::vec3& GetAbsolutePosition() const { return absolutePosition; }
-  const glm::vec3& GetRelativeRotation() const { return relativeRotation; }
-  const glm::vec3& GetAbsoluteRotation() const { return absoluteRotation; }
-  const glm::vec3& GetRelativeScale() const { return relativeScale; }
-  const glm::vec3& GetAbsoluteScale() const { return absoluteScale; }
+  uint32_t GetSlot() const { return slot; }
+  // Points the mesh at the render transform, until this transform is gone
+  void BindRenderTransform(const std::shared_ptr<MeshData>& mesh);
+
+  glm::mat4x4 GetRelativeTransform() const {
+    return TransformSystem::GetRelativeTransform(slot);
+  }
+  glm::mat4x4 GetAbsoluteTransform() const {
+    return TransformSystem::GetAbsoluteTransform(slot);
+  }
+  glm::mat4x4 GetRenderTransform() const {
+    return TransformSystem::GetRenderTransform(slot);
+  }
+  glm::vec3 GetRelativePosition() const {
+    return TransformSystem::GetRelativePosition(slot);
+  }
+  glm::vec3 GetAbsolutePosition() const {
+    return TransformSystem::GetAbsolutePosition(slot);
+  }
+  glm::vec3 GetRelativeRotation() const {
+    return TransformSystem::GetRelativeRotation(slot);
+  }
+  glm::vec3 GetAbsoluteRotation() const {
+    return TransformSystem::GetAbsoluteRotation(slot);
+  }
+  glm::vec3 GetRelativeScale() const {
+    return TransformSystem::GetRelativeScale(slot);
+  }
+  glm::vec3 GetAbsoluteScale() const {
+    return TransformSystem::GetAbsoluteScale(slot);
+  }
 
   const glm::vec3& GetRelativeForward() {
-    relativeForward = glm::normalize(glm::vec3(-relativeTransform[2]));
+    relativeForward = glm::normalize(glm::vec3(-GetRelativeTransform()[2]));
     return relativeForward;
   }
   const glm::vec3& GetRelativeLeft() {
-    relativeLeft = glm::normalize(glm::vec3(-relativeTransform[0]));
+    relativeLeft = glm::normalize(glm::vec3(-GetRelativeTransform()[0]));
     return relativeLeft;
   }
   const glm::vec3& GetRelativeUp() {
-    relativeUp = glm::normalize(glm::vec3(relativeTransform[1]));
+    relativeUp = glm::normalize(glm::vec3(GetRelativeTransform()[1]));
     return relativeUp;
   }
   const glm::vec3& GetAbsoluteForward() {
-    absoluteForward = glm::normalize(glm::vec3(-absoluteTransform[2]));
+    absoluteForward = glm::normalize(glm::vec3(-GetAbsoluteTransform()[2]));
     return absoluteForward;
   }
   const glm::vec3& GetAbsoluteLeft() {
-    absoluteLeft = glm::normalize(glm::vec3(-absoluteTransform[0]));
+    absoluteLeft = glm::normalize(glm::vec3(-GetAbsoluteTransform()[0]));
     return absoluteLeft;
   }
   const glm::vec3& GetAbsoluteUp() {
-    absoluteUp = glm::normalize(glm::vec3(absoluteTransform[1]));
+    absoluteUp = glm::normalize(glm::vec3(GetAbsoluteTransform()[1]));
     return absoluteUp;
   }
 
   void SetRelativePosition(const glm::vec3& pos) {
-    relativePosition = pos;
-    UpdateAbsoluteTransform();
+    TransformSystem::SetRelativePosition(slot, pos);
   }
   void SetAbsolutePosition(const glm::vec3& pos) {
-    absolutePosition = pos;
-    UpdateRelativeTransform();
+    TransformSystem::SetAbsolute(slot, pos, GetAbsoluteRotation(),
+                                 GetAbsoluteScale());
   }
   void SetRelativeRotation(const glm::vec3& rot) {
-    relativeRotation = rot;
-    UpdateAbsoluteTransform();
+    TransformSystem::SetRelativeRotation(slot, rot);
   }
   void SetAbsoluteRotation(const glm::vec3& rot) {
-    absoluteRotation = rot;
-    UpdateRelativeTransform();
+    TransformSystem::SetAbsolute(slot, GetAbsolutePosition(), rot,
+                                 GetAbsoluteScale());
   }
   void SetRelativeScale(const glm::vec3& scale) {
-    relativeScale = scale;
-    UpdateAbsoluteTransform();
+    TransformSystem::SetRelativeScale(slot, scale);
   }
   void SetAbsoluteScale(const glm::vec3& scale) {
-    absoluteScale = scale;
-    UpdateRelativeTransform();
+    TransformSystem::SetAbsolute(slot, GetAbsolutePosition(),
+                                 GetAbsoluteRotation(), scale);
   }
 
  private:
-  glm::vec3 relativePosition;
-  glm::vec3 relativeRotation;
-  glm::vec3 relativeScale;
-
-  glm::vec3 absolutePosition;
-  glm::vec3 absoluteRotation;
-  glm::vec3 absoluteScale;
-
-  glm::mat4x4 relativeTransform;
-  glm::mat4x4 absoluteTransform;
-
   glm::vec3 relativeLeft;
   glm::vec3 relativeUp;
   glm::vec3 relativeForward;
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+
+// Transforms of all scene objects live in slot-indexed SoA arrays. Setters
+// only mark a slot dirty, world matrices are rebuilt lazily on access or once
+// per frame by UpdateWorldTransforms, which walks slots sorted by depth.
+namespace TransformSystem {
+inline constexpr uint32_t InvalidSlot = UINT32_MAX;
+
+uint32_t AllocateSlot();
+void ReleaseSlot(uint32_t slot);
+void SetParentSlot(uint32_t slot, uint32_t parentSlot);
+
+void SetRelativePosition(uint32_t slot, const glm::vec3& pos);
+void SetRelativeRotation(uint32_t slot, const glm::vec3& rot);
+void SetRelativeScale(uint32_t slot, const glm::vec3& scale);
+void SetAbsolute(uint32_t slot, const glm::vec3& pos, const glm::vec3& rot,
+                 const glm::vec3& scale);
+
+glm::vec3 GetRelativePosition(uint32_t slot);
+glm::vec3 GetRelativeRotation(uint32_t slot);
+glm::vec3 GetRelativeScale(uint32_t slot);
+glm::vec3 GetAbsolutePosition(uint32_t slot);
+glm::vec3 GetAbsoluteRotation(uint32_t slot);
+glm::vec3 GetAbsoluteScale(uint32_t slot);
+
+glm::mat4x4 GetRelativeTransform(uint32_t slot);
+glm::mat4x4 GetAbsoluteTransform(uint32_t slot);
+glm::mat4x4 GetRenderTransform(uint32_t slot);
+// Stays at the same address until the slot is released, for the renderer to
+// read the interpolated matrix from every frame
+const glm::mat4x4* GetRenderTransformAddress(uint32_t slot);
+
+void ResolveSlot(uint32_t slot);
+void UpdateWorldTransforms();
+void SaveTransformsForInterpolation();
+// Blends render transforms from the saved step to the current one, alpha 1
+// shows the world transforms as they are
+void InterpolateRenderTransforms(float alpha);
+void SetParallelUpdate(bool parallel);
+}  // namespace TransformSystem
@@ -7,6 +7,9 @@ void BaseMaterial::OnCreate() {
   BaseObject::OnCreate();
 
   JsonUtils::ParseMaterialShaders(GetRoot() + GetFile(), shaders);
+  for (const std::string& shader : shaders) {
+    shaderIds.push_back(StringIdUtils::Intern(shader));
+  }
   if (matData != nullptr) {
     aiColor4D color;
     matData->Get(AI_MATKEY_COLOR_DIFFUSE, color);
@@ -17,13 +20,17 @@ void BaseMaterial::OnCreate() {
   JsonUtils::ParseMaterialParams(GetRoot() + GetFile(), color, roughness,
                                  metallic);
 }
+void BaseMaterial::ReloadParams() {
+  JsonUtils::ParseMaterialParams(GetRoot() + GetFile(), color, roughness,
+                                 metallic);
+}
 void BaseMaterial::OnDestroy() {
   BaseObject::OnDestroy();
 
   if (auto ownerPtr = GetOwner().lock()) {
     scene = std::static_pointer_cast<BaseScene>(ownerPtr);
     if (auto scenePtr = scene.lock()) {
-      scenePtr->UnregisterMaterial(name);
+      scenePtr->UnregisterMaterial(StringIdUtils::Intern(name));
     }
   }
 }
\ No newline at end of file
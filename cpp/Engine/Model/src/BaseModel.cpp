@@ -7,18 +7,23 @@
 #include <Engine/Model/include/BaseMaterial.h>
 #include <Engine/Scene/include/BaseScene.h>
 #include <Engine/Scene/include/SceneObject.h>
+#include <Engine/System/include/BaseResource.h>
 #include <Engine/System/include/GraphicsInterface.h>
 #include <Engine/Utility/include/FileUtils.h>
 #include <Engine/Utility/include/JsonUtils.h>
 #include <Engine/Utility/include/MathUtils.h>
+#include <Engine/Utility/include/MeshUtils.h>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 #include <assimp/types.h>
 #include <stb_image.h>
 #include <stb_image_resize2.h>
 
+#include <algorithm>
 #include <assimp/Importer.hpp>
+#include <limits>
 #include <mutex>
+#include <optional>
 #include <ranges>
 #include <thread>
 
@@ -34,96 +39,259 @@ void BaseModel::ClearTextureCache() {
   }
 }
 
-#define LoadPNGTexture(type, _path, textures, comp)                            \
-  {                                                                            \
-    const auto texIter = model->TextureCache.find(_path);                      \
-    if (texIter != model->TextureCache.end()) {                                \
-      (textures).emplace_back(type, texIter->second.width,                     \
-                              texIter->second.height,                          \
-                              texIter->second.channels, texIter->second.data); \
-    } else {                                                                   \
-      int origWidth, origHeight, channels;                                     \
-      stbi_uc* origData = stbi_load((_path), &origWidth, &origHeight,          \
-                                    &channels, STBI_rgb_alpha);                \
-      if (origData == nullptr) {                                               \
-        PRINT_ERROR("failed to load texture image!");                          \
-      } else {                                                                 \
-        int width = origWidth / comp, height = origHeight / comp;              \
-        stbi_uc* data = (stbi_uc*)malloc(width * height * 4);                  \
-        data = stbir_resize_uint8_linear(origData, origWidth, origHeight, 0,   \
-                                         data, width, height, 0, STBIR_RGBA);  \
-        if (data == nullptr) {                                                 \
-          PRINT_AND_THROW_ERROR("failed to resize texture image!");            \
-        }                                                                      \
-        std::shared_ptr<TextureDataContent> dataPtr =                          \
-            std::make_shared<TextureDataContent>(data);                        \
-        (textures).emplace_back(type, width, height, channels, dataPtr);       \
-        model->TextureCache[_path] = {type, width, height, channels, dataPtr}; \
-        stbi_image_free(origData);                                             \
-      }                                                                        \
-    }                                                                          \
-  }
-
-#define ParseFbxTextureType(_aiTexturetype, textureType, textureComp)          \
-  {                                                                            \
-    for (int j = 0; j < material->GetTextureCount(_aiTexturetype); j++) {      \
-      aiString path;                                                           \
-      if (material->GetTexture(_aiTexturetype, j, &path) == AI_SUCCESS) {      \
-        std::string fullPath = model->GetRoot() + dataPath;                    \
-        fullPath = fullPath.substr(0, fullPath.rfind('/') + 1) + path.C_Str(); \
-        LoadPNGTexture(textureType, fullPath.c_str(), meshData->textures,      \
-                       textureComp);                                           \
-      }                                                                        \
-    }                                                                          \
-  }
-
-void ParseFbxTextures(
-    std::weak_ptr<BaseModel> modelPtr, aiMaterial* material,
-    std::shared_ptr<MeshData> meshData, const std::string& dataPath,
+using TextureRequests = std::vector<std::pair<TextureType, std::string>>;
+using TextureDecodes =
+    std::unordered_map<std::string,
+                       std::unique_ptr<Coroutine::Task<TextureCacheData>>>;
+
+struct PendingMesh {
+  std::shared_ptr<MeshData> meshData;
+  std::string matPath;
+  aiMaterial* matData;
+  TextureRequests textures;
+};
+
+Coroutine::Task<TextureCacheData> DecodeTexture(BaseResource& resources,
+                                                const TextureType type,
+                                                const std::string path,
+                                                const float comp) {
+  co_await Coroutine::Schedule(resources);
+  int origWidth, origHeight, channels;
+  stbi_uc* origData = stbi_load(path.c_str(), &origWidth, &origHeight,
+                                &channels, STBI_rgb_alpha);
+  if (origData == nullptr) {
+    // Failing here must not throw, sibling decodes may still be running
+    PRINT_ERROR("failed to load texture image!");
+    co_return TextureCacheData{type, 0, 0, 0, nullptr};
+  }
+  const int width = std::max(1, static_cast<int>(origWidth / comp));
+  const int height = std::max(1, static_cast<int>(origHeight / comp));
+  if (width == origWidth && height == origHeight) {
+    co_return TextureCacheData{type, width, height, channels,
+                               std::make_shared<TextureDataContent>(origData)};
+  }
+
+  // Rows stay tightly packed so stbir can run its SIMD paths on whole rows
+  stbi_uc* data = stbir_resize_uint8_linear(origData, origWidth, origHeight,
+                                            0, nullptr, width, height, 0,
+                                            STBIR_RGBA);
+  stbi_image_free(origData);
+  if (data == nullptr) {
+    PRINT_ERROR("failed to resize texture image!");
+    co_return TextureCacheData{type, 0, 0, 0, nullptr};
+  }
+  co_return TextureCacheData{type, width, height, channels,
+                             std::make_shared<TextureDataContent>(data)};
+}
+
+// Starts a decode for every path that is neither cached nor already being
+// decoded for another mesh of this model.
+void RequestTextures(BaseResource& resources, BaseModel& model,
+                     const TextureRequests& requests,
+                     TextureDecodes& decodes) {
+  for (const auto& [type, path] : requests) {
+    if (model.TextureCache.contains(path) || decodes.contains(path)) {
+      continue;
+    }
+    decodes.emplace(path, std::make_unique<Coroutine::Task<TextureCacheData>>(
+                              DecodeTexture(
+                                  resources, type, path,
+                                  model.GetTextureCompressionRatio())));
+  }
+}
+
+// Collected in request order so the texture bindings keep their order
+Coroutine::Task<void> CollectTextures(BaseModel& model, MeshData& meshData,
+                                      const TextureRequests& requests,
+                                      TextureDecodes& decodes) {
+  for (const auto& [type, path] : requests) {
+    if (!model.TextureCache.contains(path)) {
+      TextureCacheData decoded = co_await *decodes.at(path);
+      if (decoded.data == nullptr) {
+        continue;
+      }
+      model.TextureCache[path] = decoded;
+    }
+    const TextureCacheData& cached = model.TextureCache[path];
+    meshData.textures.emplace_back(type, cached.width, cached.height,
+                                   cached.channels, cached.data);
+  }
+}
+
+void ParseFbxTextureType(aiMaterial* material, const aiTextureType aiType,
+                         const TextureType textureType,
+                         const std::string& directory,
+                         TextureRequests& requests) {
+  for (int j = 0; j < material->GetTextureCount(aiType); j++) {
+    aiString path;
+    if (material->GetTexture(aiType, j, &path) == AI_SUCCESS) {
+      requests.emplace_back(textureType, directory + path.C_Str());
+    }
+  }
+}
+
+TextureRequests ParseFbxTextures(
+    const BaseModel& model, aiMaterial* material, const std::string& dataPath,
     const std::unordered_map<TextureType, std::string>& combineTextures) {
+  TextureRequests requests;
   if (material == nullptr) {
-    return;
-  }
-  auto model = modelPtr.lock();
-  if (!model) {
-    return;
+    return requests;
   }
+  const std::string fullPath = model.GetRoot() + dataPath;
+  const std::string directory = fullPath.substr(0, fullPath.rfind('/') + 1);
 
   if (combineTextures.empty()) {
-    ParseFbxTextureType(aiTextureType::aiTextureType_DIFFUSE,
-                        TextureType::BaseColor,
-                        model->GetTextureCompressionRatio());
-    ParseFbxTextureType(aiTextureType::aiTextureType_DIFFUSE_ROUGHNESS,
-                        TextureType::Roughness,
-                        model->GetTextureCompressionRatio());
-    ParseFbxTextureType(aiTextureType::aiTextureType_METALNESS,
-                        TextureType::Metallic,
-                        model->GetTextureCompressionRatio());
-    ParseFbxTextureType(aiTextureType::aiTextureType_NORMALS,
-                        TextureType::Normal,
-                        model->GetTextureCompressionRatio());
-    ParseFbxTextureType(aiTextureType::aiTextureType_AMBIENT_OCCLUSION,
-                        TextureType::AO, model->GetTextureCompressionRatio());
+    ParseFbxTextureType(material, aiTextureType::aiTextureType_DIFFUSE,
+                        TextureType::BaseColor, directory, requests);
+    ParseFbxTextureType(material,
+                        aiTextureType::aiTextureType_DIFFUSE_ROUGHNESS,
+                        TextureType::Roughness, directory, requests);
+    ParseFbxTextureType(material, aiTextureType::aiTextureType_METALNESS,
+                        TextureType::Metallic, directory, requests);
+    ParseFbxTextureType(material, aiTextureType::aiTextureType_NORMALS,
+                        TextureType::Normal, directory, requests);
+    ParseFbxTextureType(material,
+                        aiTextureType::aiTextureType_AMBIENT_OCCLUSION,
+                        TextureType::AO, directory, requests);
   } else {
     aiString path;
     if (material->GetTexture(aiTextureType::aiTextureType_DIFFUSE, 0, &path) ==
         AI_SUCCESS) {
       std::string picPath = path.C_Str();
-      std::string texPath = model->GetRoot() + dataPath;
-      std::string prefPath = texPath.substr(0, texPath.rfind('/') + 1) +
-                             picPath.substr(0, picPath.rfind('_') + 1);
+      std::string prefPath =
+          directory + picPath.substr(0, picPath.rfind('_') + 1);
 
       for (const auto& info : combineTextures) {
-        std::string fullPath = prefPath + info.second + ".png";
-        LoadPNGTexture(info.first, fullPath.c_str(), meshData->textures,
-                       model->GetTextureCompressionRatio());
+        requests.emplace_back(info.first, prefPath + info.second + ".png");
+      }
+    }
+  }
+  return requests;
+}
+
+// Bounds of the quantized attributes, the vertex shader maps them back
+VertexDequantData ComputeVertexDequant(
+    const std::vector<VertexData>& vertices) {
+  VertexDequantData dequant;
+  if (vertices.empty()) {
+    return dequant;
+  }
+  glm::vec3 posMin(std::numeric_limits<float>::max());
+  glm::vec3 posMax(std::numeric_limits<float>::lowest());
+  glm::vec2 texMin(std::numeric_limits<float>::max());
+  glm::vec2 texMax(std::numeric_limits<float>::lowest());
+  for (const VertexData& vertex : vertices) {
+    posMin = glm::min(posMin, vertex.pos);
+    posMax = glm::max(posMax, vertex.pos);
+    texMin = glm::min(texMin, vertex.texCoord);
+    texMax = glm::max(texMax, vertex.texCoord);
+  }
+  // Flat axes keep a tiny extent so the matrix stays invertible
+  const glm::vec3 posExtent = glm::max(posMax - posMin, glm::vec3(1e-6f));
+  const glm::vec2 texHalfExtent =
+      glm::max((texMax - texMin) * 0.5f, glm::vec2(1e-6f));
+  dequant.position =
+      glm::scale(glm::translate(glm::mat4(1), posMin), posExtent);
+  dequant.texCoord = glm::vec4(texHalfExtent, (texMin + texMax) * 0.5f);
+  return dequant;
+}
+
+void FillVertexData(MeshData& meshData,
+                    const std::vector<VertexData>& vertices,
+                    const uint32_t vertexFormat) {
+  meshData.bounds = MeshUtils::ComputeBounds(vertices);
+
+  meshData.vertexFormat = vertexFormat;
+  if (vertexFormat &
+      (QuantizedPositionVertexFormat | SnormTexCoordVertexFormat)) {
+    meshData.dequant = ComputeVertexDequant(vertices);
+  }
+}
+
+// Point and line faces left over by triangulation are not drawn
+size_t CountTriangleIndices(const aiMesh* mesh) {
+  size_t count = 0;
+  for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+    if (mesh->mFaces[i].mNumIndices == 3) {
+      count += 3;
+    }
+  }
+  return count;
+}
+
+template <typename Index>
+void CopyTriangleIndices(const aiMesh* mesh, Index* dst) {
+  for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
+    const auto& face = mesh->mFaces[i];
+    if (face.mNumIndices == 3) {
+      for (unsigned int j = 0; j < 3; ++j) {
+        *dst++ = static_cast<Index>(face.mIndices[j]);
       }
     }
   }
 }
 
-void ParseFbxData(const aiMatrix4x4& transform, const aiMesh* mesh,
-                  std::shared_ptr<MeshData> meshData, float importSize) {
+// Without geometry passes nothing rewrites the indices, so they are copied
+// from the faces straight into staging memory instead of through a list.
+// Returns false when the backend has no staging memory for the mesh.
+bool FillMeshDataFromFaces(MeshData& meshData, const aiMesh* mesh,
+                           const std::vector<VertexData>& vertices,
+                           const uint32_t vertexFormat,
+                           GraphicsInterface* graphics) {
+  if (graphics == nullptr) {
+    return false;
+  }
+  FillVertexData(meshData, vertices, vertexFormat);
+  meshData.staging = graphics->AllocateMeshStaging(
+      vertexFormat, vertices.size(), CountTriangleIndices(mesh));
+  if (!meshData.staging) {
+    return false;
+  }
+  meshData.staging->WriteVertices(vertices, meshData.dequant);
+  void* indexData = meshData.staging->GetIndexData();
+  if (meshData.staging->GetShortIndices()) {
+    CopyTriangleIndices(mesh, static_cast<uint16_t*>(indexData));
+  } else {
+    CopyTriangleIndices(mesh, static_cast<uint32_t*>(indexData));
+  }
+  return true;
+}
+
+// Vertices and indices go straight into staging memory of the graphics
+// backend when it has some, the lists are then freed on return.
+void FillMeshData(MeshData& meshData, MeshUtils::MeshChunk& chunk,
+                  const uint32_t vertexFormat, const uint32_t geometryPasses,
+                  GraphicsInterface* graphics) {
+  auto& [indices, vertices] = chunk;
+  if (geometryPasses & MeshletGeometryPass) {
+    meshData.meshlets = MeshUtils::BuildMeshlets(indices, vertices);
+  }
+  if (geometryPasses & LodGeometryPass) {
+    meshData.lods = MeshUtils::BuildLods(indices, vertices);
+  }
+  FillVertexData(meshData, vertices, vertexFormat);
+
+  if (graphics != nullptr) {
+    meshData.staging = graphics->AllocateMeshStaging(
+        vertexFormat, vertices.size(), indices.size());
+  }
+  if (meshData.staging) {
+    meshData.staging->WriteVertices(vertices, meshData.dequant);
+    meshData.staging->WriteIndices(indices);
+  } else {
+    meshData.vertices = std::move(vertices);
+    meshData.indices = std::move(indices);
+  }
+}
+
+// Returns meshData, followed by the chunks cut off it by SplitGeometryPass
+std::vector<std::shared_ptr<MeshData>> ParseFbxData(
+    const aiMatrix4x4& transform, const aiMesh* mesh,
+    std::shared_ptr<MeshData> meshData, float importSize,
+    uint32_t vertexFormat, uint32_t geometryPasses,
+    GraphicsInterface* graphics) {
+  std::vector<VertexData> vertices;
+  vertices.reserve(mesh->mNumVertices);
   for (unsigned int i = 0; i < mesh->mNumVertices; ++i) {
     aiVector3D pos = transform * mesh->mVertices[i];
     aiVector3D root = transform * aiVector3D(0);
@@ -145,29 +313,79 @@ void ParseFbxData(const aiMatrix4x4& transform, const aiMesh* mesh,
       texCoord = mesh->mTextureCoords[0][i];
     }
 
-    meshData->vertices.emplace_back(
+    vertices.emplace_back(
         MathUtils::AiVector3D2GlmVec3(pos * importSize),
         MathUtils::AiColor4D2GlmVec4(color),
         MathUtils::AiVector3D2GlmVec3(normal),
         MathUtils::AiVector3D2GlmVec3(tangent),
-        MathUtils::AiVector3D2GlmVec3(texCoord));
+        glm::vec2(texCoord.x, texCoord.y));
   }
 
-  for (unsigned int i = 0; i < mesh->mNumFaces; ++i) {
-    const auto& face = mesh->mFaces[i];
-    for (size_t j = 0; j < 3; ++j) {
-      meshData->indices.emplace_back(face.mIndices[j]);
+  // Vertex colors are only dropped from meshes that do not have any
+  if (mesh->HasVertexColors(0)) {
+    vertexFormat &= ~NoColorVertexFormat;
+  }
+  if (geometryPasses == NoGeometryPass &&
+      FillMeshDataFromFaces(*meshData, mesh, vertices, vertexFormat,
+                            graphics)) {
+    return {meshData};
+  }
+
+  std::vector<uint32_t> indices(CountTriangleIndices(mesh));
+  CopyTriangleIndices(mesh, indices.data());
+
+  MeshUtils::VertexCacheStats before, after;
+  if (geometryPasses != NoGeometryPass) {
+    before = MeshUtils::AnalyzeVertexCache(indices, vertices.size());
+    MeshUtils::OptimizeGeometry(geometryPasses, indices, vertices);
+    after = MeshUtils::AnalyzeVertexCache(indices, vertices.size());
+  }
+
+  std::vector<MeshUtils::MeshChunk> chunks;
+  if ((geometryPasses & SplitGeometryPass) &&
+      vertices.size() > MeshUtils::MaxShortIndexVertices) {
+    chunks = MeshUtils::SplitMesh(indices, vertices);
+    indices = {};
+    vertices = {};
+  } else {
+    chunks.push_back({std::move(indices), std::move(vertices)});
+  }
+
+  std::vector<std::shared_ptr<MeshData>> meshDatas;
+  size_t meshletCount = 0;
+  for (size_t i = 0; i < chunks.size(); i++) {
+    auto chunkData = meshData;
+    if (i != 0) {
+      chunkData = std::make_shared<MeshData>();
+      chunkData->state = meshData->state;
+      chunkData->name = meshData->name + "#" + std::to_string(i);
     }
+    FillMeshData(*chunkData, chunks[i], vertexFormat, geometryPasses,
+                 graphics);
+    meshletCount += chunkData->meshlets.meshlets.size();
+    meshDatas.push_back(std::move(chunkData));
+  }
+
+#ifndef NDEBUG
+  if (geometryPasses != NoGeometryPass) {
+    std::cout << "Optimize mesh name: " << meshData->name << ", ACMR "
+              << before.acmr << " -> " << after.acmr << ", ATVR "
+              << before.atvr << " -> " << after.atvr << ", meshlets "
+              << meshletCount << ", lods " << meshData->lods.size()
+              << ", chunks " << chunks.size() << std::endl;
   }
+#endif
+  return meshDatas;
 }
 
+// Textures are only requested for decoding when resources are given
 void ParseFbxDatas(
-    std::weak_ptr<BaseModel> modelPtr, std::weak_ptr<BaseScene> modelScenePtr,
-    std::weak_ptr<GraphicsInterface> graphicsPtr, const std::string& modelType,
-    const aiMatrix4x4& transform, const aiNode* node, const aiScene* scene,
-    const std::string& dataPath,
+    BaseResource* resources, BaseModel& model, const aiMatrix4x4 transform,
+    const aiNode* node, const aiScene* scene, const std::string& dataPath,
     const std::unordered_map<TextureType, std::string>& combineTextures,
-    const std::unordered_map<std::string, std::string>& materialMap) {
+    const std::unordered_map<std::string, std::string>& materialMap,
+    GraphicsInterface* graphics, TextureDecodes& decodes,
+    std::vector<PendingMesh>& pendingMeshes) {
   const aiMatrix4x4 nodeTransform = transform * node->mTransformation;
 
   for (unsigned int i = 0; i < node->mNumMeshes; ++i) {
@@ -185,92 +403,136 @@ void ParseFbxDatas(
     }
 
     // Parse Info
-    auto model = modelPtr.lock();
-    if (!model) {
-      return;
-    }
     const auto [matPath, texPaths] = JsonUtils::ParseMeshDataInfos(
-        model->GetRoot() + model->GetFile(), mesh->mName.C_Str());
+        model.GetRoot() + model.GetFile(), mesh->mName.C_Str());
 
     // Parse Name
-    std::shared_ptr<MeshData> meshData = std::make_shared<MeshData>(
-        MeshData({.state = {.alive = true}, .name = mesh->mName.C_Str()}));
-
-    // Parse Data
-    ParseFbxData(nodeTransform, mesh, meshData, model->GetImportSize());
+    std::shared_ptr<MeshData> meshData = std::make_shared<MeshData>();
+    meshData->state.alive = true;
+    meshData->name = mesh->mName.C_Str();
 
+    // Parse Textures, decoding overlaps with parsing the remaining meshes
+    TextureRequests requests;
     if (texPaths.empty()) {
-      // Parse Textures
-      ParseFbxTextures(modelPtr, matData, meshData, dataPath, combineTextures);
+      requests = ParseFbxTextures(model, matData, dataPath, combineTextures);
     } else {
-      // Parse Textures
       for (const auto& texPath : texPaths) {
-        LoadPNGTexture(TextureTypeMap[texPath.first],
-                       (model->GetRoot() + texPath.second).c_str(),
-                       meshData->textures, model->GetTextureCompressionRatio());
+        requests.emplace_back(TextureTypeMap[texPath.first],
+                              model.GetRoot() + texPath.second);
       }
     }
-
-    // Parse Material
-    auto modelScene = modelScenePtr.lock();
-    if (!modelScene) {
-      return;
+    if (resources != nullptr) {
+      RequestTextures(*resources, model, requests, decodes);
     }
-    meshData->uniform.material =
-        modelScene->GetMaterialByPath(matPath, matData);
 
-    // Parse MeshData
-    meshData->uniform.camera = model->GetCamera();
-    meshData->uniform.lightChannel = model->GetLightChannel();
-    meshData->uniform.modelMatrix = &model->GetAbsoluteTransform();
-
-    model->GetMeshes().emplace_back(meshData);
-    auto graphics = graphicsPtr.lock();
-    if (!graphics) {
-      return;
+    // Parse Data
+    for (auto& chunkData :
+         ParseFbxData(nodeTransform, mesh, meshData, model.GetImportSize(),
+                      model.GetVertexFormat(), model.GetGeometryPasses(),
+                      graphics)) {
+      pendingMeshes.push_back({std::move(chunkData), matPath, matData,
+                               requests});
     }
-    graphics->ParseMeshData(meshData);
-    std::cout << "Load mesh name: " << mesh->mName.C_Str() << std::endl;
   }
 
   for (unsigned int i = 0; i < node->mNumChildren; ++i) {
-    ParseFbxDatas(modelPtr, modelScenePtr, graphicsPtr, modelType,
-                  nodeTransform, node->mChildren[i], scene, dataPath,
-                  combineTextures, materialMap);
+    ParseFbxDatas(resources, model, nodeTransform, node->mChildren[i], scene,
+                  dataPath, combineTextures, materialMap, graphics, decodes,
+                  pendingMeshes);
   }
 }
 
-void BaseModel::LoadFbxDatas(const unsigned int parserFlags) {
-  if (auto scenePtr = scene.lock()) {
-    if (auto graphicsPtr = graphics.lock()) {
-      Assimp::Importer importer;
-      const std::string& dataPath = JSON_CONFIG(String, "ModelFile");
-      const aiScene* sceneData =
-          importer.ReadFile(GetRoot() + dataPath, parserFlags);
-
-      if (sceneData == nullptr ||
-          sceneData->mFlags & AI_SCENE_FLAGS_INCOMPLETE ||
-          sceneData->mRootNode == nullptr) {
-        throw std::runtime_error(
-            std::string("failed to load model resource: ") +
-            importer.GetErrorString());
-      }
+// The node walk of LoadFbxDatas without texture decodes, for the benchmarks
+std::vector<std::shared_ptr<MeshData>> ParseFbxMeshDatas(
+    BaseModel& model, const aiScene* scene, const std::string& dataPath) {
+  const std::string modelPath = model.GetRoot() + model.GetFile();
+  TextureDecodes decodes;
+  std::vector<PendingMesh> pendingMeshes;
+  ParseFbxDatas(nullptr, model, aiMatrix4x4(), scene->mRootNode, scene,
+                dataPath, JsonUtils::GetCombineTextures(modelPath),
+                JsonUtils::GetMaterialMap(modelPath), nullptr, decodes,
+                pendingMeshes);
+
+  std::vector<std::shared_ptr<MeshData>> meshDatas;
+  meshDatas.reserve(pendingMeshes.size());
+  for (PendingMesh& pendingMesh : pendingMeshes) {
+    meshDatas.emplace_back(std::move(pendingMesh.meshData));
+  }
+  return meshDatas;
+}
+
+Coroutine::Task<void> BaseModel::LoadFbxDatas(BaseResource& resources,
+                                              const unsigned int parserFlags) {
+  // Keep the model alive until its meshes are handed to the renderer
+  auto self = static_pointer_cast<BaseModel>(shared_from_this());
+  co_await Coroutine::Schedule(resources);
+
+  if (!scene.lock() || !graphics.lock()) {
+    loaing = false;
+    co_return;
+  }
+  Assimp::Importer importer;
+  const std::string& dataPath = JSON_CONFIG(String, "ModelFile");
+  const aiScene* sceneData =
+      importer.ReadFile(GetRoot() + dataPath, parserFlags);
+
+  if (sceneData == nullptr || sceneData->mFlags & AI_SCENE_FLAGS_INCOMPLETE ||
+      sceneData->mRootNode == nullptr) {
+    loaing = false;
+    throw std::runtime_error(std::string("failed to load model resource: ") +
+                             importer.GetErrorString());
+  }
+
+  const std::unordered_map<TextureType, std::string> combineTextures(
+      JsonUtils::GetCombineTextures(GetRoot() + GetFile()));
 
-      const std::unordered_map<TextureType, std::string> combineTextures(
-          JsonUtils::GetCombineTextures(GetRoot() + GetFile()));
+  const std::unordered_map<std::string, std::string> materialMap(
+      JsonUtils::GetMaterialMap(GetRoot() + GetFile()));
+
+  // Texture decodes fan out to the other workers while this one walks the
+  // node tree, meshes are then handed over in file order.
+  TextureDecodes decodes;
+  std::vector<PendingMesh> pendingMeshes;
+  if (const auto graphicsPtr = graphics.lock()) {
+    ParseFbxDatas(&resources, *this, aiMatrix4x4(), sceneData->mRootNode,
+                  sceneData, dataPath, combineTextures, materialMap,
+                  graphicsPtr.get(), decodes, pendingMeshes);
+  }
+
+  for (auto& [meshData, matPath, matData, textures] : pendingMeshes) {
+    co_await CollectTextures(*this, *meshData, textures, decodes);
+
+    // Parse Material
+    auto scenePtr = scene.lock();
+    auto graphicsPtr = graphics.lock();
+    if (!scenePtr || !graphicsPtr) {
+      break;
+    }
+    meshData->uniform.material = scenePtr->GetMaterialByPath(matPath, matData);
 
-      const std::unordered_map<std::string, std::string> materialMap(
-          JsonUtils::GetMaterialMap(GetRoot() + GetFile()));
+    // Parse MeshData
+    meshData->uniform.camera = GetCamera();
+    meshData->uniform.lightChannel = GetLightChannel();
+    GetTransform().BindRenderTransform(meshData);
 
-      const aiMatrix4x4 identity;
-      ParseFbxDatas(static_pointer_cast<BaseModel>(shared_from_this()),
-                    scenePtr, graphicsPtr, JSON_CONFIG(String, "ModelType"),
-                    identity, sceneData->mRootNode, sceneData, dataPath,
-                    combineTextures, materialMap);
+    meshes.emplace_back(meshData);
+    graphicsPtr->ParseMeshData(meshData);
+    std::cout << "Load mesh name: " << meshData->name << std::endl;
+  }
 
-      std::cout << "All meshes num: " << meshes.size() << std::endl;
+  // Decodes no mesh waited for must finish before their tasks are destroyed,
+  // and go to the cache so their pixels are freed with it.
+  for (auto& [path, decode] : decodes) {
+    TextureCacheData decoded = co_await *decode;
+    if (decoded.data != nullptr && !TextureCache.contains(path)) {
+      TextureCache[path] = decoded;
     }
   }
+  std::cout << "All meshes num: " << meshes.size() << std::endl;
+  if (meshes.empty() == false && GetCamera().expired()) {
+    std::cout << "Camera not found: " << StringIdUtils::GetName(_cameraId)
+              << std::endl;
+  }
   loaing = false;
 }
 
@@ -278,22 +540,36 @@ void BaseModel::OnCreate() {
   SceneObject::OnCreate();
   importSize = JSON_CONFIG(Float, "ImportSize");
   textureCompressionRatio = JSON_CONFIG(Float, "TextureCompressionRatio");
+  for (const std::string& format : JSON_CONFIG(Strings, "VertexFormat")) {
+    if (const auto iter = VertexFormatMap.find(format);
+        iter != VertexFormatMap.end()) {
+      vertexFormat |= iter->second;
+    } else {
+      PRINT_ERROR("unknown vertex format: " + format);
+    }
+  }
+  for (const std::string& pass : JSON_CONFIG(Strings, "GeometryPasses")) {
+    if (const auto iter = GeometryPassMap.find(pass);
+        iter != GeometryPassMap.end()) {
+      geometryPasses |= iter->second;
+    } else {
+      PRINT_ERROR("unknown geometry pass: " + pass);
+    }
+  }
 }
 void BaseModel::OnStart() {
   SceneObject::OnStart();
-  loaing = true;
-  auto scenePtr = scene.lock();
-  while (!scenePtr) {
-    scenePtr = scene.lock();
-  }
-  scenePtr->AddModelToResourceWaitQueue(
-      std::function<void()>(
-          std::bind(&BaseModel::LoadFbxDatas, this,
-                    aiProcess_Triangulate | aiProcess_GenSmoothNormals |
-                        aiProcess_FlipUVs | aiProcess_CalcTangentSpace)),
-      shared_from_this());
+  // The scene is set in SceneObject::OnCreate and outlives its objects
+  if (auto scenePtr = scene.lock()) {
+    loaing = true;
+    scenePtr->AddModelLoadTask([this](BaseResource& resources) {
+      return LoadFbxDatas(resources, aiProcess_Triangulate |
+                                         aiProcess_GenSmoothNormals |
+                                         aiProcess_FlipUVs |
+                                         aiProcess_CalcTangentSpace);
+    });
+  }
 }
-void BaseModel::OnUpdate() { SceneObject::OnUpdate(); }
 void BaseModel::OnStop() { SceneObject::OnStop(); }
 
 void BaseModel::OnDestroy() {
@@ -303,17 +579,17 @@ void BaseModel::OnDestroy() {
 }
 
 void BaseModel::SetCamera(const std::string& cameraName) {
-  _cameraName = cameraName;
+  _cameraId = StringIdUtils::Intern(cameraName);
 }
 void BaseModel::SetLightChannel(const std::string& lightChannelName) {
-  _lightChannelName = lightChannelName;
+  _lightChannelId = StringIdUtils::Intern(lightChannelName);
 }
 
 std::weak_ptr<BaseCamera> BaseModel::GetCamera() {
   if (_camera.lock()) {
     return _camera;
   } else if (auto scenePtr = scene.lock()) {
-    return scenePtr->GetCameraByName(_cameraName);
+    return scenePtr->GetCameraByName(_cameraId);
   } else {
     return std::shared_ptr<BaseCamera>(nullptr);
   }
@@ -322,7 +598,7 @@ std::weak_ptr<LightChannel> BaseModel::GetLightChannel() {
   if (_lightChannel.lock()) {
     return _lightChannel;
   } else if (auto scenePtr = scene.lock()) {
-    return scenePtr->GetLightChannelByName(_lightChannelName);
+    return scenePtr->GetLightChannelByName(_lightChannelId);
   } else {
     return std::shared_ptr<LightChannel>(nullptr);
   }
@@ -330,7 +606,4 @@ std::weak_ptr<LightChannel> BaseModel::GetLightChannel() {
 
 std::vector<std::shared_ptr<MeshData>>& BaseModel::GetMeshes() {
   return meshes;
-}
-
-#undef ParseFbxTextureType
-#undef LoadPNGTexture
\ No newline at end of file
+}
\ No newline at end of file
@@ -1,54 +1,38 @@
 #include <Engine/Model/include/BaseTransform.h>
 #include <Engine/Scene/include/SceneObject.h>
+#include <Engine/Utility/include/TypeUtils.h>
 
-void BaseTransform::UpdateAbsoluteTransform() {
-  relativeTransform = glm::translate(glm::mat4x4(1.0f), relativePosition) *
-                      glm::toMat4(glm::quat(relativeRotation)) *
-                      glm::scale(glm::mat4x4(1.0f), relativeScale);
-  auto object = static_pointer_cast<SceneObject>(_owner.lock());
-  if (auto parent = object->GetParent().lock()) {
-    absoluteTransform = parent->GetAbsoluteTransform() * relativeTransform;
-
-    absolutePosition = ExtractTranslation(absoluteTransform);
-    absoluteRotation = ExtractRotation(absoluteTransform);
-    absoluteScale = ExtractScale(absoluteTransform);
-  } else {
-    absolutePosition = relativePosition;
-    absoluteRotation = relativeRotation;
-    absoluteScale = relativeScale;
-
-    absoluteTransform = glm::translate(glm::mat4x4(1.0f), absolutePosition) *
-                        glm::toMat4(glm::quat(absoluteRotation)) *
-                        glm::scale(glm::mat4x4(1.0f), absoluteScale);
+BaseTransform::~BaseTransform() {
+  for (const std::weak_ptr<MeshData>& user : renderTransformUsers) {
+    if (const auto mesh = user.lock()) {
+      mesh->uniform.modelMatrix.store(nullptr);
+    }
   }
-  for (auto son : object->GetSons()) {
-    son->UpdateAbsoluteTransform();
+  TransformSystem::ReleaseSlot(slot);
+}
+
+void BaseTransform::RegisterOwner(std::weak_ptr<SceneObject> other) {
+  _owner = other;
+  if (auto object = _owner.lock()) {
+    if (auto parent = object->GetParent().lock()) {
+      TransformSystem::SetParentSlot(slot, parent->GetTransform().GetSlot());
+    } else {
+      TransformSystem::SetParentSlot(slot, TransformSystem::InvalidSlot);
+    }
   }
 }
 
-void BaseTransform::UpdateRelativeTransform() {
-  absoluteTransform = glm::translate(glm::mat4x4(1.0f), absolutePosition) *
-                      glm::toMat4(glm::quat(absoluteRotation)) *
-                      glm::scale(glm::mat4x4(1.0f), absoluteScale);
-  auto object = static_pointer_cast<SceneObject>(_owner.lock());
-  if (auto parent = object->GetParent().lock()) {
-    glm::mat4x4 invParentTransform =
-        glm::inverse(parent->GetAbsoluteTransform());
-    glm::mat4x4 relativeTransform = invParentTransform * absoluteTransform;
+void BaseTransform::BindRenderTransform(const std::shared_ptr<MeshData>& mesh) {
+  mesh->uniform.modelMatrix.store(
+      TransformSystem::GetRenderTransformAddress(slot));
+  renderTransformUsers.emplace_back(mesh);
+}
 
-    relativePosition = ExtractTranslation(relativeTransform);
-    relativeRotation = ExtractRotation(relativeTransform);
-    relativeScale = ExtractScale(relativeTransform);
-  } else {
-    relativePosition = absolutePosition;
-    relativeRotation = absoluteRotation;
-    relativeScale = absoluteScale;
+void BaseTransform::UpdateAbsoluteTransform() {
+  TransformSystem::ResolveSlot(slot);
+}
 
-    relativeTransform = glm::translate(glm::mat4x4(1.0f), relativePosition) *
-                        glm::toMat4(glm::quat(relativeRotation)) *
-                        glm::scale(glm::mat4x4(1.0f), relativeScale);
-  }
-  for (auto son : object->GetSons()) {
-    son->UpdateAbsoluteTransform();
-  }
+void BaseTransform::UpdateRelativeTransform() {
+  TransformSystem::SetAbsolute(slot, GetAbsolutePosition(),
+                               GetAbsoluteRotation(), GetAbsoluteScale());
 }
\ No newline at end of file
@@ -0,0 +1,430 @@
+#include "../include/TransformSystem.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <deque>
+#include <execution>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtx/quaternion.hpp>
+#include <mutex>
+#include <vector>
+
+namespace {
+constexpr size_t ParallelUpdateThreshold = 1024;
+
+std::mutex systemMutex;
+bool parallelUpdate = true;
+
+// Render transforms are exposed by address (MeshData::uniform.modelMatrix),
+// so they are kept in deques whose elements never move on growth.
+std::deque<glm::vec3> relativePositions;
+std::deque<glm::vec3> relativeRotations;
+std::deque<glm::vec3> relativeScales;
+std::deque<glm::vec3> absolutePositions;
+std::deque<glm::vec3> absoluteRotations;
+std::deque<glm::vec3> absoluteScales;
+std::deque<glm::mat4x4> relativeTransforms;
+std::deque<glm::mat4x4> absoluteTransforms;
+std::deque<glm::mat4x4> renderTransforms;
+
+std::vector<uint32_t> parents;
+std::vector<uint32_t> parentGenerations;
+std::vector<uint32_t> generations;
+std::vector<uint32_t> depths;
+std::vector<uint32_t> orderIndices;
+// Children whose parent link is still valid, so leaves skip the child search
+std::vector<uint32_t> childCounts;
+std::vector<uint64_t> worldVersions;
+std::vector<uint64_t> seenParentVersions;
+std::vector<uint8_t> relativeDirty;
+std::vector<uint8_t> decomposeDirty;
+std::vector<uint8_t> previousValid;
+
+// A world matrix split apart so the rotation can be slerped on its own
+struct TransformParts {
+  glm::vec3 pos;
+  glm::quat rot;
+  glm::vec3 scale;
+};
+std::vector<TransformParts> previousParts;
+
+std::vector<uint32_t> freeSlots;
+std::vector<std::vector<uint32_t>> slotsByDepth;
+
+glm::mat4x4 ComposeTransform(const glm::vec3& pos, const glm::quat& rot,
+                             const glm::vec3& scale) {
+  glm::mat4x4 ret = glm::toMat4(rot);
+  ret[0] *= scale.x;
+  ret[1] *= scale.y;
+  ret[2] *= scale.z;
+  ret[3] = glm::vec4(pos, 1.0f);
+  return ret;
+}
+
+glm::mat4x4 ComposeTransform(const glm::vec3& pos, const glm::vec3& rot,
+                             const glm::vec3& scale) {
+  return ComposeTransform(pos, glm::quat(rot), scale);
+}
+
+TransformParts SplitTransform(const glm::mat4x4& transform) {
+  const glm::vec3 scale(glm::length(glm::vec3(transform[0])),
+                        glm::length(glm::vec3(transform[1])),
+                        glm::length(glm::vec3(transform[2])));
+  const glm::vec3 divisor = glm::max(scale, glm::vec3(FLT_EPSILON));
+  const glm::mat3 rotation(glm::vec3(transform[0]) / divisor.x,
+                           glm::vec3(transform[1]) / divisor.y,
+                           glm::vec3(transform[2]) / divisor.z);
+  return {glm::vec3(transform[3]), glm::quat_cast(rotation), scale};
+}
+
+void DecomposeTransform(const glm::mat4x4& transform, glm::vec3& pos,
+                        glm::vec3& rot, glm::vec3& scale) {
+  pos = glm::vec3(transform[3]);
+  rot = glm::eulerAngles(glm::quat_cast(transform));
+  scale = glm::vec3(glm::length(glm::vec3(transform[0])),
+                    glm::length(glm::vec3(transform[1])),
+                    glm::length(glm::vec3(transform[2])));
+}
+
+uint32_t GetValidParent(uint32_t slot) {
+  const uint32_t parent = parents[slot];
+  if (parent != TransformSystem::InvalidSlot &&
+      generations[parent] == parentGenerations[slot]) {
+    return parent;
+  }
+  return TransformSystem::InvalidSlot;
+}
+
+void InsertToDepth(uint32_t slot, uint32_t depth) {
+  if (slotsByDepth.size() <= depth) {
+    slotsByDepth.resize(depth + 1);
+  }
+  depths[slot] = depth;
+  orderIndices[slot] = static_cast<uint32_t>(slotsByDepth[depth].size());
+  slotsByDepth[depth].emplace_back(slot);
+}
+
+void RemoveFromDepth(uint32_t slot) {
+  std::vector<uint32_t>& bucket = slotsByDepth[depths[slot]];
+  const uint32_t index = orderIndices[slot];
+  bucket[index] = bucket.back();
+  orderIndices[bucket[index]] = index;
+  bucket.pop_back();
+}
+
+// Children always sit one bucket below their parent, so they are found there
+// and follow the slot down or up together with their own subtrees.
+void MoveToDepth(uint32_t slot, uint32_t depth) {
+  const uint32_t oldDepth = depths[slot];
+  RemoveFromDepth(slot);
+  InsertToDepth(slot, depth);
+  if (oldDepth == depth || childCounts[slot] == 0) {
+    return;
+  }
+  std::vector<uint32_t> children;
+  for (const uint32_t child : slotsByDepth[oldDepth + 1]) {
+    if (GetValidParent(child) == slot) {
+      children.emplace_back(child);
+      if (children.size() == childCounts[slot]) {
+        break;
+      }
+    }
+  }
+  for (const uint32_t child : children) {
+    MoveToDepth(child, depth + 1);
+  }
+}
+
+void RecomputeIfStale(uint32_t slot, uint32_t parent) {
+  bool stale = false;
+  if (relativeDirty[slot]) {
+    relativeTransforms[slot] =
+        ComposeTransform(relativePositions[slot], relativeRotations[slot],
+                         relativeScales[slot]);
+    relativeDirty[slot] = false;
+    stale = true;
+  }
+  const uint64_t parentVersion =
+      parent == TransformSystem::InvalidSlot ? 0 : worldVersions[parent];
+  if (stale || parentVersion != seenParentVersions[slot]) {
+    absoluteTransforms[slot] =
+        parent == TransformSystem::InvalidSlot
+            ? relativeTransforms[slot]
+            : absoluteTransforms[parent] * relativeTransforms[slot];
+    seenParentVersions[slot] = parentVersion;
+    worldVersions[slot] += 1;
+    decomposeDirty[slot] = true;
+  }
+}
+
+void Resolve(uint32_t slot) {
+  const uint32_t parent = GetValidParent(slot);
+  if (parent != TransformSystem::InvalidSlot) {
+    Resolve(parent);
+  }
+  RecomputeIfStale(slot, parent);
+}
+
+void ResolveDecompose(uint32_t slot) {
+  Resolve(slot);
+  if (decomposeDirty[slot]) {
+    if (GetValidParent(slot) == TransformSystem::InvalidSlot) {
+      absolutePositions[slot] = relativePositions[slot];
+      absoluteRotations[slot] = relativeRotations[slot];
+      absoluteScales[slot] = relativeScales[slot];
+    } else {
+      DecomposeTransform(absoluteTransforms[slot], absolutePositions[slot],
+                         absoluteRotations[slot], absoluteScales[slot]);
+    }
+    decomposeDirty[slot] = false;
+  }
+}
+}  // namespace
+
+uint32_t TransformSystem::AllocateSlot() {
+  std::lock_guard lock(systemMutex);
+
+  uint32_t slot;
+  if (freeSlots.empty() == false) {
+    slot = freeSlots.back();
+    freeSlots.pop_back();
+  } else {
+    slot = static_cast<uint32_t>(generations.size());
+    relativePositions.emplace_back();
+    relativeRotations.emplace_back();
+    relativeScales.emplace_back();
+    absolutePositions.emplace_back();
+    absoluteRotations.emplace_back();
+    absoluteScales.emplace_back();
+    relativeTransforms.emplace_back();
+    absoluteTransforms.emplace_back();
+    renderTransforms.emplace_back();
+
+    parents.emplace_back();
+    parentGenerations.emplace_back();
+    generations.emplace_back(0);
+    depths.emplace_back();
+    orderIndices.emplace_back();
+    childCounts.emplace_back();
+    worldVersions.emplace_back(0);
+    seenParentVersions.emplace_back();
+    relativeDirty.emplace_back();
+    decomposeDirty.emplace_back();
+    previousValid.emplace_back();
+    previousParts.emplace_back();
+  }
+  relativePositions[slot] = glm::vec3(0.0f);
+  relativeRotations[slot] = glm::vec3(0.0f);
+  relativeScales[slot] = glm::vec3(1.0f);
+  absolutePositions[slot] = glm::vec3(0.0f);
+  absoluteRotations[slot] = glm::vec3(0.0f);
+  absoluteScales[slot] = glm::vec3(1.0f);
+  relativeTransforms[slot] = glm::mat4x4(1.0f);
+  absoluteTransforms[slot] = glm::mat4x4(1.0f);
+  renderTransforms[slot] = glm::mat4x4(1.0f);
+
+  parents[slot] = InvalidSlot;
+  parentGenerations[slot] = 0;
+  generations[slot] += 1;
+  childCounts[slot] = 0;
+  seenParentVersions[slot] = 0;
+  relativeDirty[slot] = true;
+  decomposeDirty[slot] = false;
+  previousValid[slot] = false;
+
+  InsertToDepth(slot, 0);
+  return slot;
+}
+
+void TransformSystem::ReleaseSlot(uint32_t slot) {
+  std::lock_guard lock(systemMutex);
+
+  RemoveFromDepth(slot);
+  if (const uint32_t parent = GetValidParent(slot); parent != InvalidSlot) {
+    childCounts[parent] -= 1;
+  }
+  // Children of the slot lose their parent with the generation bump
+  generations[slot] += 1;
+  childCounts[slot] = 0;
+  parents[slot] = InvalidSlot;
+  freeSlots.emplace_back(slot);
+}
+
+void TransformSystem::SetParentSlot(uint32_t slot, uint32_t parentSlot) {
+  std::lock_guard lock(systemMutex);
+
+  if (const uint32_t parent = GetValidParent(slot); parent != InvalidSlot) {
+    childCounts[parent] -= 1;
+  }
+  if (parentSlot == InvalidSlot) {
+    parents[slot] = InvalidSlot;
+    MoveToDepth(slot, 0);
+  } else {
+    parents[slot] = parentSlot;
+    parentGenerations[slot] = generations[parentSlot];
+    childCounts[parentSlot] += 1;
+    MoveToDepth(slot, depths[parentSlot] + 1);
+  }
+  relativeDirty[slot] = true;
+}
+
+void TransformSystem::SetRelativePosition(uint32_t slot,
+                                          const glm::vec3& pos) {
+  std::lock_guard lock(systemMutex);
+  relativePositions[slot] = pos;
+  relativeDirty[slot] = true;
+}
+void TransformSystem::SetRelativeRotation(uint32_t slot,
+                                          const glm::vec3& rot) {
+  std::lock_guard lock(systemMutex);
+  relativeRotations[slot] = rot;
+  relativeDirty[slot] = true;
+}
+void TransformSystem::SetRelativeScale(uint32_t slot,
+                                       const glm::vec3& scale) {
+  std::lock_guard lock(systemMutex);
+  relativeScales[slot] = scale;
+  relativeDirty[slot] = true;
+}
+
+void TransformSystem::SetAbsolute(uint32_t slot, const glm::vec3& pos,
+                                  const glm::vec3& rot,
+                                  const glm::vec3& scale) {
+  std::lock_guard lock(systemMutex);
+
+  if (const uint32_t parent = GetValidParent(slot); parent != InvalidSlot) {
+    Resolve(parent);
+    DecomposeTransform(
+        glm::inverse(absoluteTransforms[parent]) *
+            ComposeTransform(pos, rot, scale),
+        relativePositions[slot], relativeRotations[slot],
+        relativeScales[slot]);
+  } else {
+    relativePositions[slot] = pos;
+    relativeRotations[slot] = rot;
+    relativeScales[slot] = scale;
+  }
+  relativeDirty[slot] = true;
+}
+
+glm::vec3 TransformSystem::GetRelativePosition(uint32_t slot) {
+  std::lock_guard lock(systemMutex);
+  return relativePositions[slot];
+}
+glm::vec3 TransformSystem::GetRelativeRotation(uint32_t slot) {
+  std::lock_guard lock(systemMutex);
+  return relativeRotations[slot];
+}
+glm::vec3 TransformSystem::GetRelativeScale(uint32_t slot) {
+  std::lock_guard lock(systemMutex);
+  return relativeScales[slot];
+}
+
+glm::vec3 TransformSystem::GetAbsolutePosition(uint32_t slot) {
+  std::lock_guard lock(systemMutex);
+  ResolveDecompose(slot);
+  return absolutePositions[slot];
+}
+glm::vec3 TransformSystem::GetAbsoluteRotation(uint32_t slot) {
+  std::lock_guard lock(systemMutex);
+  ResolveDecompose(slot);
+  return absoluteRotations[slot];
+}
+glm::vec3 TransformSystem::GetAbsoluteScale(uint32_t slot) {
+  std::lock_guard lock(systemMutex);
+  ResolveDecompose(slot);
+  return absoluteScales[slot];
+}
+
+glm::mat4x4 TransformSystem::GetRelativeTransform(uint32_t slot) {
+  std::lock_guard lock(systemMutex);
+  Resolve(slot);
+  return relativeTransforms[slot];
+}
+glm::mat4x4 TransformSystem::GetAbsoluteTransform(uint32_t slot) {
+  std::lock_guard lock(systemMutex);
+  Resolve(slot);
+  return absoluteTransforms[slot];
+}
+
+glm::mat4x4 TransformSystem::GetRenderTransform(uint32_t slot) {
+  std::lock_guard lock(systemMutex);
+  return renderTransforms[slot];
+}
+
+const glm::mat4x4* TransformSystem::GetRenderTransformAddress(uint32_t slot) {
+  std::lock_guard lock(systemMutex);
+  return &renderTransforms[slot];
+}
+
+void TransformSystem::ResolveSlot(uint32_t slot) {
+  std::lock_guard lock(systemMutex);
+  Resolve(slot);
+}
+
+void TransformSystem::UpdateWorldTransforms() {
+  std::lock_guard lock(systemMutex);
+
+  // Parents always sit in a shallower bucket, so every slot of one bucket
+  // can be rebuilt independently once the previous buckets are done.
+  for (const std::vector<uint32_t>& bucket : slotsByDepth) {
+    auto update = [](uint32_t slot) {
+      RecomputeIfStale(slot, GetValidParent(slot));
+    };
+    if (parallelUpdate && bucket.size() >= ParallelUpdateThreshold) {
+      std::for_each(std::execution::par_unseq, bucket.begin(), bucket.end(),
+                    update);
+    } else {
+      std::for_each(bucket.begin(), bucket.end(), update);
+    }
+  }
+}
+
+void TransformSystem::SaveTransformsForInterpolation() {
+  std::lock_guard lock(systemMutex);
+
+  for (const std::vector<uint32_t>& bucket : slotsByDepth) {
+    for (const uint32_t slot : bucket) {
+      previousParts[slot] = SplitTransform(absoluteTransforms[slot]);
+      previousValid[slot] = true;
+    }
+  }
+}
+
+void TransformSystem::InterpolateRenderTransforms(float alpha) {
+  std::lock_guard lock(systemMutex);
+
+  // Without a step to blend from the world matrices are shown as they are
+  if (alpha >= 1.0f) {
+    std::copy(absoluteTransforms.begin(), absoluteTransforms.end(),
+              renderTransforms.begin());
+    return;
+  }
+  for (const std::vector<uint32_t>& bucket : slotsByDepth) {
+    auto interpolate = [alpha](uint32_t slot) {
+      if (previousValid[slot]) {
+        // Blending the matrices linearly would shear and shrink rotating
+        // objects, so rotation is slerped apart from position and scale
+        const TransformParts& prev = previousParts[slot];
+        const TransformParts curr = SplitTransform(absoluteTransforms[slot]);
+        renderTransforms[slot] =
+            ComposeTransform(glm::mix(prev.pos, curr.pos, alpha),
+                             glm::slerp(prev.rot, curr.rot, alpha),
+                             glm::mix(prev.scale, curr.scale, alpha));
+      } else {
+        renderTransforms[slot] = absoluteTransforms[slot];
+      }
+    };
+    if (parallelUpdate && bucket.size() >= ParallelUpdateThreshold) {
+      std::for_each(std::execution::par_unseq, bucket.begin(), bucket.end(),
+                    interpolate);
+    } else {
+      std::for_each(bucket.begin(), bucket.end(), interpolate);
+    }
+  }
+}
+
+void TransformSystem::SetParallelUpdate(bool parallel) {
+  std::lock_guard lock(systemMutex);
+  parallelUpdate = parallel;
+}
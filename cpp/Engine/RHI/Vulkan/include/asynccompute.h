@@ -0,0 +1,84 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <vector>
+
+class Device;
+
+enum class QueueType { Graphics, Compute };
+
+// A value of a timeline semaphore, signaled by one submission and waited on
+// by another at the given stages
+struct TimelinePoint {
+  VkSemaphore semaphore = VK_NULL_HANDLE;
+  uint64_t value = 0;
+  VkPipelineStageFlags stages = 0;
+};
+
+// An image handed between the graphics and compute queue families in the
+// layout it already is in, with the stages and accesses each queue uses it at
+struct QueueImageTransfer {
+  VkImage image = VK_NULL_HANDLE;
+  VkImageAspectFlags aspects = 0;
+  VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+  VkPipelineStageFlags graphicsStages = 0;
+  VkAccessFlags graphicsAccesses = 0;
+  VkPipelineStageFlags computeStages = 0;
+  VkAccessFlags computeAccesses = 0;
+};
+
+// Compute work submitted on a queue of its own so it overlaps rasterization.
+// Each queue counts its submissions on a timeline semaphore the other one
+// waits on, and images move between the queue families with ownership
+// transfers. Without a compute-only queue family the work falls back to the
+// graphics queue, where the same submissions and waits hold and the
+// transfers are left out.
+class AsyncCompute {
+  VkQueue queue = VK_NULL_HANDLE;
+  uint32_t family = 0;
+  uint32_t graphicsFamily = 0;
+
+  VkCommandPool commandPool = VK_NULL_HANDLE;
+  std::vector<VkCommandBuffer> commandBuffers;
+  // Compute timeline value the command buffer of each frame last signaled
+  std::vector<uint64_t> frameValues;
+
+  VkSemaphore graphicsTimeline = VK_NULL_HANDLE;
+  VkSemaphore computeTimeline = VK_NULL_HANDLE;
+  uint64_t graphicsValue = 0;
+  uint64_t computeValue = 0;
+
+  void RecordTransfer(VkCommandBuffer commandBuffer,
+                      const QueueImageTransfer& transfer, QueueType from,
+                      bool acquire) const;
+
+ public:
+  void CreateAsyncCompute(const Device& device, uint32_t framesInFlight);
+  void DestroyAsyncCompute(const VkDevice& device);
+
+  [[nodiscard]] bool GetSeparateQueue() const {
+    return family != graphicsFamily;
+  }
+
+  // The next value of the graphics timeline, for a graphics submission to
+  // signal and the compute queue to wait on
+  [[nodiscard]] TimelinePoint SignalGraphics();
+  // Waits until the previous submission of the frame's command buffer is
+  // done, then begins recording it again
+  [[nodiscard]] VkCommandBuffer BeginCommandBuffer(const VkDevice& device,
+                                                   uint32_t frame);
+  // Submits the frame's command buffer once wait is reached, returns the
+  // point it signals when done
+  [[nodiscard]] TimelinePoint Submit(uint32_t frame, const TimelinePoint& wait);
+  // Blocks the host until the point is reached
+  void Wait(const VkDevice& device, const TimelinePoint& point) const;
+
+  // Recorded on the queue giving the image up, then on the one taking it
+  // after waiting on a timeline point signaled past the release
+  void RecordRelease(VkCommandBuffer commandBuffer,
+                     const QueueImageTransfer& transfer, QueueType from) const;
+  void RecordAcquire(VkCommandBuffer commandBuffer,
+                     const QueueImageTransfer& transfer, QueueType to) const;
+};
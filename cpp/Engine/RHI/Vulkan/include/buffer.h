@@ -11,6 +11,8 @@
 class Device;
 class Render;
 class Pipeline;
+class MeshStagingTicket;
+struct UploadBatch;
 
 using UniformMapped = std::vector<void*>;
 using UniformBuffers = std::vector<VkBuffer>;
@@ -22,15 +24,31 @@ class DataBuffer : public Base {
 
   VkBuffer indexBuffer{};
   VkDeviceMemory indexBufferMemory{};
+  VkIndexType indexType = VK_INDEX_TYPE_UINT32;
 
   void CreateVertexBuffer(const Device& device,
-                          const std::vector<Vertex>& vertices,
-                          const Render& render);
+                          const std::vector<uint8_t>& vertices,
+                          UploadBatch& batch);
   void CreateIndexBuffer(const Device& device,
                          const std::vector<uint32_t>& indices,
-                         const Render& render);
+                         UploadBatch& batch);
+  // Device local destination of a copy recorded into the batch
+  static void CreateDeviceBuffer(const Device& device, const VkBuffer& source,
+                                 const VkDeviceSize& offset,
+                                 const VkDeviceSize& size,
+                                 const VkBufferUsageFlags& usage,
+                                 VkBuffer& buffer, VkDeviceMemory& bufferMemory,
+                                 UploadBatch& batch);
 
  public:
+  // 16 bit indices address every vertex of meshes with up to 65536 of them,
+  // primitive restart is never enabled
+  static VkIndexType IndexType(size_t vertexCount);
+  static uint32_t IndexSize(VkIndexType type);
+  // Writes the indices to dst in the width of type
+  static void WriteIndices(const std::vector<uint32_t>& indices,
+                           VkIndexType type, void* dst);
+
   static uint32_t MemoryType(const VkPhysicalDevice& physicalDevice,
                              const glm::uint32_t& typeFilter,
                              const VkMemoryPropertyFlags& properties);
@@ -40,9 +58,14 @@ class DataBuffer : public Base {
                            const VkMemoryPropertyFlags& properties,
                            VkBuffer& buffer, VkDeviceMemory& bufferMemory);
 
-  void CreateBuffers(const Device& device, const std::vector<Vertex>& vertices,
-                     const std::vector<uint32_t>& indices,
-                     const Render& render);
+  // Records the copies into the batch, the buffers may only be bound once the
+  // batch has completed
+  void CreateBuffers(const Device& device, const std::vector<uint8_t>& vertices,
+                     const std::vector<uint32_t>& indices, UploadBatch& batch);
+  // Copies straight from the range the loader wrote, the ticket must be kept
+  // until the batch has completed
+  void CreateBuffers(const Device& device, const MeshStagingTicket& staging,
+                     UploadBatch& batch);
   void DestroyBuffers(const VkDevice& device) const;
 
   [[nodiscard]] const VkBuffer& GetVertexBuffer() const { return vertexBuffer; }
@@ -52,6 +75,7 @@ class DataBuffer : public Base {
   }
 
   [[nodiscard]] const VkBuffer& GetIndexBuffer() const { return indexBuffer; }
+  [[nodiscard]] VkIndexType GetIndexType() const { return indexType; }
 
   [[nodiscard]] const VkDeviceMemory& GetIndexBufferMemory() const {
     return indexBufferMemory;
@@ -12,5 +12,23 @@ constexpr bool ENABLE_VALIDATION_LAYER = false;
 constexpr int DEFAULT_WINDOW_WIDTH = 800;
 constexpr int DEFAULT_WINDOW_HEIGHT = 600;
 
+constexpr int MAX_PENDING_MESHES = 1024;
+constexpr VkDeviceSize STAGING_POOL_SIZE = 64ull << 20;
+
+// Screen space error in pixels a mesh's level of detail may show, a mesh
+// coarsens only when the next level stays under (1 - LOD_HYSTERESIS) of it
+constexpr float LOD_PIXEL_ERROR = 1.0f;
+constexpr float LOD_HYSTERESIS = 0.25f;
+constexpr uint32_t SHADOW_LOD_BIAS = 1;
+
+// Local size of the depth pyramid compute shader, and the widest pyramid
+// level copied back to the host for the occlusion tests
+constexpr uint32_t HIZ_GROUP_SIZE = 8;
+constexpr uint32_t HIZ_READBACK_SIZE = 256;
+
+// Side in pixels of the screen tiles the deferred lighting pass is classified
+// by, a work group of the classification shader covers one
+constexpr uint32_t LIGHTING_TILE_SIZE = 16;
+
 const std::vector DEVICE_EXTENSIONS{VK_KHR_SWAPCHAIN_EXTENSION_NAME};
 }  // namespace VulkanConfig
@@ -8,30 +8,30 @@
 #include "vertex.h"
 
 class Data : public Base {
+  // Empty when the mesh was uploaded from a MeshStaging ticket
   std::vector<uint32_t> indices;
-  std::vector<Vertex> vertices;
+  // Packed in the mesh's VertexFormat, see VertexLayout
+  std::vector<uint8_t> vertices;
+  uint32_t indexCount = 0;
 
  public:
   [[nodiscard]] const std::vector<uint32_t>& GetIndices() const {
     return indices;
   }
 
-  [[nodiscard]] const std::vector<Vertex>& GetVertices() const {
+  [[nodiscard]] const std::vector<uint8_t>& GetVertices() const {
     return vertices;
   }
 
+  [[nodiscard]] uint32_t GetIndexCount() const { return indexCount; }
+  void SetIndexCount(const uint32_t count) { indexCount = count; }
+
   [[nodiscard]] const uint32_t& GetIndexByIndex(const uint32_t index) const {
     return indices[index];
   }
 
-  [[nodiscard]] const Vertex& GetVertexByIndex(const uint32_t index) const {
-    return vertices[index];
-  }
-
   void AddIndex(const uint32_t index) { indices.emplace_back(index); }
 
-  void AddVertex(const Vertex& vertex) { vertices.emplace_back(vertex); }
-
   template <typename... Args>
   explicit Data(Base* owner, Args&&... args) : Base(owner) {
     CreateData(std::forward(args)...);
@@ -40,5 +40,5 @@ class Data : public Base {
   ~Data() override = default;
 
   void CreateData(const std::vector<uint32_t>& indices,
-                  const std::vector<Vertex>& vertices);
+                  std::vector<uint8_t>&& vertices);
 };
@@ -33,15 +33,22 @@ class Device : public Base {
 
   uint32_t graphicsFamily;
   uint32_t presentFamily;
+  uint32_t computeFamily;
   VkQueue graphicsQueue;
   VkQueue presentQueue;
+  VkQueue computeQueue;
 
   uint32_t msaaSamplesNum = 1;
   VkSampleCountFlagBits msaaSamples = VK_SAMPLE_COUNT_1_BIT;
   uint32_t minUBOOffsetAlignment = 0;
+  float timestampPeriod = 0;
+  uint32_t timestampValidBits = 0;
+  bool timelineSemaphoreSupport = false;
 
   VkSampleCountFlagBits GetMaxUsableSampleCount(int msaaMaxSamples);
   uint32_t GetMinUniformBufferOffsetAlignment();
+  void QueryTimestampSupport();
+  bool QueryTimelineSemaphoreSupport() const;
 
  public:
   uint32_t GetMultiSampleNum() const;
@@ -49,6 +56,27 @@ class Device : public Base {
 
   uint32_t GetGraphicsFamily() const { return graphicsFamily; }
   uint32_t GetPresentFamily() const { return presentFamily; }
+  uint32_t GetComputeFamily() const { return computeFamily; }
+  /**
+   * 计算队列是否有自己的队列族，否则与图形队列相同
+   */
+  bool GetSeparateComputeQueue() const {
+    return computeFamily != graphicsFamily;
+  }
+  /**
+   * 时间戳每一跳的纳秒数
+   */
+  float GetTimestampPeriod() const { return timestampPeriod; }
+  /**
+   * 图形队列时间戳的有效位数，为 0 时不支持时间戳
+   */
+  uint32_t GetTimestampValidBits() const { return timestampValidBits; }
+  /**
+   * 是否支持时间线信号量，不支持时不使用异步计算
+   */
+  bool GetTimelineSemaphoreSupport() const {
+    return timelineSemaphoreSupport;
+  }
 
   /** Behaviors And Logic **/
   /**
@@ -106,4 +134,9 @@ class Device : public Base {
   [[nodiscard]] const VkQueue& GetGraphicsQueue() const {
     return graphicsQueue;
   }
+
+  /**
+   * 获取计算设备的队列，没有单独的队列族时即为图形队列
+   */
+  [[nodiscard]] const VkQueue& GetComputeQueue() const { return computeQueue; }
 };
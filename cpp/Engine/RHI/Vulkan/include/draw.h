@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Engine/Utility/include/StringIdUtils.h>
 #include <vulkan/vulkan_core.h>
 
 #include "base.h"
@@ -23,13 +24,20 @@ class Render;
 
 class Draw : public Base {
   Shader shader;
+  StringId drawKey = 0;
+  uint32_t vertexFormat = FullVertexFormat;
   Pipeline pipeline;
   std::list<Mesh*> meshes;
+  // Meshes whose upload is still in flight, not drawn yet
+  std::list<Mesh*> pendingMeshes;
 
   VkDescriptorPool deferredDescriptorPool;
   DescriptorSets deferredDescriptorSets;
 
   PipelineBuffer pipelineBuffer;
+  std::string rootPath;
+  std::string zPrePassShaderPath;
+  std::string shadowMapShaderPath;
   LightChannel* allLightsChannelPointer = nullptr;
   LightChannelBuffer* allLightsChannelBufferPointer = nullptr;
 
@@ -47,6 +55,7 @@ class Draw : public Base {
     return deferredDescriptorSets[index];
   }
 
+  [[nodiscard]] int GetPipelineId() { return pipeline.GetPipelineId(); }
   [[nodiscard]] int GetShaderFallbackIndex() {
     return pipeline.GetShaderFallbackIndex();
   }
@@ -56,7 +65,17 @@ class Draw : public Base {
   DEFINE_GET_PIPELINE_MEMBER(ZPrePass)
   DEFINE_GET_PIPELINE_MEMBER(ShadowMap)
 
+  // Meshes of one shader in different vertex formats need their own
+  // pipelines, so draws are keyed by both
+  static StringId GetDrawKey(const StringId shaderId,
+                             const uint32_t vertexFormat) {
+    return shaderId ^ vertexFormat * StringIdUtils::FNVPrime;
+  }
+
   std::list<Mesh*>& GetMeshes() { return meshes; }
+  [[nodiscard]] bool HasPendingMeshes() const {
+    return pendingMeshes.empty() == false;
+  }
 
   explicit Draw(Base* owner) : Base(owner) {}
   ~Draw() override = default;
@@ -71,15 +90,26 @@ class Draw : public Base {
 
   void CreateDrawResource(const Device& device, Render& render,
                           const std::string& rootPath, const int texCount,
+                          const uint32_t vertexFormat,
                           const std::vector<std::string>& shaderPaths,
                           const std::string& zPrePassShaderPath,
                           const std::string& shadowMapShaderPath);
   void LoadDrawResource(const Device& device, Render& render,
                         std::weak_ptr<MeshData> data);
+  void PromoteCreatedMeshes(const VkDevice& device, const Render& render);
   void DestroyDrawResource(const VkDevice& device, const Render& render);
 
+  // Hot reload, see Vulkan::ProcessHotReload
+  [[nodiscard]] GraphicsPipelines RebuildPipelines(const Device& device,
+                                                   Render& render,
+                                                   uint32_t variants);
+  void SwapPipelines(const VkDevice& device,
+                     const GraphicsPipelines& pipelines);
+  void ClearCompiledShaders() { shader.ClearCompiledCode(); }
+
   PipelineBuffer* GetPipelineBuffer() { return &pipelineBuffer; }
   void SetShaderPath(const std::string& shaderPath);
+  const std::string& GetShaderPath() { return shader.GetShaderPath(); }
   void SetPipelineId(const Render& render, const int pipelineId);
   virtual void Destroy() override;
 };
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "Engine/Utility/include/StringIdUtils.h"
+
+class Draw;
+class Mesh;
+
+enum class DrawPass : uint64_t {
+  ZPrePass = 0,
+  ShadowMap = 1,
+  Color = 2,
+};
+
+// Sort key, most significant bits first:
+//   pass     2 bits
+//   the Z-prepass:        depth 30 bits, pipeline 12 bits, unused 20 bits
+//   the other passes:     pipeline 12 bits, material 20 bits, depth 30 bits
+// Depth is the view space distance's float bits, which order like the
+// distance, so opaque draws run front to back. The Z-prepass, whose depth
+// the color pass tests against, puts it above the pipeline.
+struct DrawItem {
+  uint64_t key = 0;
+  Draw* draw = nullptr;
+  Mesh* mesh = nullptr;
+};
+
+struct DrawStats {
+  uint32_t drawCalls = 0;
+  uint32_t binds = 0;
+  uint32_t skippedBinds = 0;
+};
+
+class DrawList {
+  std::vector<DrawItem> items;
+  std::vector<DrawItem> scratch;
+  std::array<size_t, 4> passOffsets{};
+
+ public:
+  // Rebuilt each frame after the transforms of currentFrame are written
+  void Build(std::unordered_map<StringId, Draw*>& draws, uint32_t currentFrame,
+             bool zPrePass, bool shadowMap);
+  [[nodiscard]] std::span<const DrawItem> GetPass(DrawPass pass) const;
+};
+
+// Binds the state of a draw unless the previous draw of the command buffer
+// left the same bound, counting what it could skip
+class DrawStateCache {
+  VkCommandBuffer commandBuffer;
+  DrawStats& stats;
+  VkPipeline pipeline = VK_NULL_HANDLE;
+  VkBuffer vertexBuffer = VK_NULL_HANDLE;
+  VkBuffer indexBuffer = VK_NULL_HANDLE;
+  VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+
+ public:
+  DrawStateCache(VkCommandBuffer commandBuffer, DrawStats& stats)
+      : commandBuffer(commandBuffer), stats(stats) {}
+
+  void BindPipeline(VkPipeline inPipeline);
+  void BindBuffers(VkBuffer inVertexBuffer, VkBuffer inIndexBuffer,
+                   VkIndexType indexType);
+  void BindDescriptorSet(VkPipelineLayout layout,
+                         VkDescriptorSet inDescriptorSet);
+  void DrawIndexed(uint32_t indexCount, uint32_t firstIndex);
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <vector>
+
+class Device;
+
+// Times a span of a command buffer on the GPU with a pair of timestamp
+// queries per frame in flight. The time of a frame is read back once the
+// fence of its command buffer has signaled, so it lags the recording by the
+// frames in flight. Queues without timestamp support leave it at 0.
+class GpuTimer {
+  VkQueryPool queryPool = VK_NULL_HANDLE;
+  // Nanoseconds per tick and the bits of a timestamp that are valid
+  float timestampPeriod = 0;
+  uint64_t timestampMask = 0;
+  // Whether the queries of each frame were written since they were created
+  std::vector<uint8_t> written;
+  float milliseconds = 0;
+
+ public:
+  void CreateGpuTimer(const Device& device, uint32_t framesInFlight);
+  void DestroyGpuTimer(const VkDevice& device);
+
+  // Recorded outside of a render pass, before RecordBegin
+  void RecordReset(VkCommandBuffer commandBuffer, uint32_t frame) const;
+  void RecordBegin(VkCommandBuffer commandBuffer, uint32_t frame) const;
+  void RecordEnd(VkCommandBuffer commandBuffer, uint32_t frame);
+  // Only valid after the fence of the frame's command buffer
+  void ReadTime(const VkDevice& device, uint32_t frame);
+
+  [[nodiscard]] float GetMilliseconds() const { return milliseconds; }
+};
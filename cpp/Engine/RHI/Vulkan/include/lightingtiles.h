@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <string>
+
+#include "Engine/Utility/include/TypeUtils.h"
+#include "shader.h"
+
+class Device;
+class Render;
+
+// Tiles the lighting draws of a frame shaded, and those one fullscreen pass
+// per draw would have
+struct LightingTileStats {
+  uint32_t shaded = 0;
+  uint32_t fullscreen = 0;
+};
+
+// Classifies the screen tiles of the deferred lighting pass by the pipeline
+// ids in the G-buffer. A compute shader lists, for each pipeline, the tiles
+// holding at least one of its pixels and counts them into an indirect draw,
+// so the lighting pipeline of a draw only covers those tiles with quads
+// instead of the whole screen. Pixels of other pipelines within a tile are
+// still discarded by the lighting shaders.
+class LightingTiles {
+  Shader shader;
+  VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+  VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+  VkPipeline pipeline = VK_NULL_HANDLE;
+  VkSampler sampler = VK_NULL_HANDLE;
+
+  VkExtent2D extent{};
+  uint32_t tilesX = 0;
+  uint32_t tileCount = 0;
+  VkBuffer tileBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory tileMemory = VK_NULL_HANDLE;
+  VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+  VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+
+  // The indirect draws of each frame in flight, copied back for the stats
+  VkBuffer readbackBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory readbackMemory = VK_NULL_HANDLE;
+  const VkDrawIndirectCommand* readbackDraws = nullptr;
+
+  void CreatePipeline(const Device& device, const Render& render,
+                      const std::string& rootPath,
+                      const std::string& shaderPath);
+  void CreateDescriptorSet(const VkDevice& device,
+                           const VkImageView& pipelineIdView);
+  void CreateReadbackBuffer(const Device& device, const Render& render);
+
+ public:
+  void CreateLightingTiles(const Device& device, const Render& render,
+                           const VkImageView& pipelineIdView,
+                           const VkExtent2D& screenExtent,
+                           const std::string& rootPath,
+                           const std::string& shaderPath);
+  // The tiles follow the G-buffer, call after it has been recreated
+  void CreateTiles(const Device& device, const Render& render,
+                   const VkImageView& pipelineIdView,
+                   const VkExtent2D& screenExtent);
+  void DestroyTiles(const VkDevice& device);
+  void DestroyLightingTiles(const VkDevice& device);
+
+  // Recorded between the G-buffer and lighting render passes
+  void RecordClassify(VkCommandBuffer commandBuffer, uint32_t frame) const;
+  // Draws the quads of the tiles classified as holding the pipeline
+  void RecordDraw(VkCommandBuffer commandBuffer, int pipelineId) const;
+
+  // Bound to the vertex stage of the lighting pipelines
+  [[nodiscard]] VkDescriptorBufferInfo GetTileBufferInfo() const {
+    return {tileBuffer, 0, VK_WHOLE_SIZE};
+  }
+  [[nodiscard]] uint32_t GetTileCount() const { return tileCount; }
+  // Only valid after the fence of the frame's command buffer
+  [[nodiscard]] uint32_t GetTileCount(uint32_t frame, int pipelineId) const;
+};
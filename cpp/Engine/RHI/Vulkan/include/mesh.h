@@ -1,8 +1,10 @@
 #pragma once
 
+#include "Engine/Utility/include/Coroutine.h"
 #include "Engine/Utility/include/TypeUtils.h"
 #include "base.h"
 #include "buffer.h"
+#include "config.h"
 #include "data.h"
 #include "texture.h"
 #include "uniform.h"
@@ -17,32 +19,55 @@
   }
 
 class Draw;
+class OcclusionCulling;
+namespace BenchmarkUtils {
+struct MeshAccess;
+}
 
 class Mesh : public Base {
+  friend struct BenchmarkUtils::MeshAccess;
+
   bool createInterrupted = false;
   std::weak_ptr<MeshData> bridge;
+  std::optional<Coroutine::Task<void>> createTask;
 
   Data data;
   DataBuffer buffer;
   Descriptor descriptor;
   std::vector<Texture> textures;
 
-  void ParseTextures(const Device& device, const Render& render);
+  std::vector<MeshLod> lods;
+  glm::vec4 bounds{};
+  uint32_t lod = 0;
+  bool occluded = false;
+
+  void ParseTextures(const Device& device, const Render& render,
+                     UploadBatch& batch);
   void ParseVertexAndIndex();
-  void ParseBufferAndDescriptor(
-      const Device& device, Render& render,
-      const VkDescriptorSetLayout& colorDescriptorSetLayout,
-      const VkDescriptorSetLayout& zPrePassDescriptorSetLayout,
-      const VkDescriptorSetLayout& shadowMapDescriptorSetLayout);
+  void ParseLods();
 
  public:
   BufferManager& GetBufferManager() const;
   bool GetCreateInterrupted() const { return createInterrupted; }
+  bool GetCreateFinished() {
+    return createTask.has_value() == false || createTask->done();
+  }
+  // Rethrows on the render thread whatever failed while creating the mesh
+  void FinishCreate() {
+    if (createTask.has_value()) {
+      createTask->get_result();
+      createTask.reset();
+    }
+  }
 
   [[nodiscard]] const VkBuffer& GetIndexBuffer() const {
     return buffer.GetIndexBuffer();
   }
 
+  [[nodiscard]] VkIndexType GetIndexType() const {
+    return buffer.GetIndexType();
+  }
+
   [[nodiscard]] const VkBuffer& GetVertexBuffer() const {
     return buffer.GetVertexBuffer();
   }
@@ -51,7 +76,31 @@ class Mesh : public Base {
     return data.GetIndices();
   }
 
-  [[nodiscard]] const std::vector<Vertex>& GetVertices() const {
+  [[nodiscard]] uint32_t GetIndexCount() const { return data.GetIndexCount(); }
+
+  // Picks the coarsest level whose error projects to under
+  // VulkanConfig::LOD_PIXEL_ERROR pixels from the mesh's camera
+  void SelectLod(float viewportHeight);
+  [[nodiscard]] const MeshLod& GetLod() const { return lods[lod]; }
+  [[nodiscard]] const MeshLod& GetShadowLod() const {
+    return lods[std::min<size_t>(lod + VulkanConfig::SHADOW_LOD_BIAS,
+                                 lods.size() - 1)];
+  }
+
+  [[nodiscard]] const TransformData& GetTransformData(
+      const uint32_t currentFrame) const {
+    return descriptor.GetUniformBuffer().GetTransformData(currentFrame);
+  }
+  // Distance along the view direction of the bounds' center in currentFrame
+  [[nodiscard]] float GetViewDepth(uint32_t currentFrame) const;
+  [[nodiscard]] const BaseMaterial* GetMaterial() const {
+    return descriptor.GetMaterial();
+  }
+  // Tests the bounds with the matrices the Z-prepass of currentFrame used
+  bool TestOcclusion(const OcclusionCulling& culling, uint32_t currentFrame);
+  [[nodiscard]] bool GetOccluded() const { return occluded; }
+
+  [[nodiscard]] const std::vector<uint8_t>& GetVertices() const {
     return data.GetVertices();
   }
 
@@ -89,14 +138,16 @@ class Mesh : public Base {
   }
   template <typename... Args>
   void TriggerInitComponent(Args&&... args) {
-    CreateMesh(std::forward<Args>(args)...);
+    createTask.emplace(CreateMesh(std::forward<Args>(args)...));
   }
 
-  void CreateMesh(const Device& device, Render& render,
-                  std::weak_ptr<MeshData> inData,
-                  const VkDescriptorSetLayout& colorDescriptorSetLayout,
-                  const VkDescriptorSetLayout& zPrePassDescriptorSetLayout,
-                  const VkDescriptorSetLayout& shadowMapDescriptorSetLayout);
+  // Runs on the render thread and suspends while its upload is in flight, see
+  // Render::ResumeCompletedUploads
+  Coroutine::Task<void> CreateMesh(
+      const Device& device, Render& render, std::weak_ptr<MeshData> inData,
+      VkDescriptorSetLayout colorDescriptorSetLayout,
+      VkDescriptorSetLayout zPrePassDescriptorSetLayout,
+      VkDescriptorSetLayout shadowMapDescriptorSetLayout);
 
   void DestroyMesh(const VkDevice& device, const Render& render);
 
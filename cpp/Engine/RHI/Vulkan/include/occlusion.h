@@ -0,0 +1,77 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <string>
+#include <vector>
+
+#include "Engine/Utility/include/TypeUtils.h"
+#include "shader.h"
+
+class Depth;
+class Device;
+class Render;
+
+struct OcclusionStats {
+  uint32_t tested = 0;
+  uint32_t culled = 0;
+};
+
+// Farthest depth pyramid built by a compute shader from the Z-prepass depth,
+// a texel of level l holds the largest depth of the 2^(l+1) pixels wide
+// square it covers. The levels no wider than HIZ_READBACK_SIZE are copied to
+// the host once the pyramid is done, so the color pass of the same frame can
+// skip what the Z-prepass already hid. The CPU waits for that copy before it
+// records the color pass, which is why the feature is off by default.
+class OcclusionCulling {
+  struct ReadbackLevel {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    const float* depths = nullptr;
+  };
+
+  Shader shader;
+  VkDescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+  VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+  VkPipeline pipeline = VK_NULL_HANDLE;
+  VkSampler sampler = VK_NULL_HANDLE;
+  int32_t depthSamples = 1;
+
+  VkExtent2D extent{};
+  VkImage pyramid = VK_NULL_HANDLE;
+  VkDeviceMemory pyramidMemory = VK_NULL_HANDLE;
+  std::vector<VkExtent2D> levelExtents;
+  std::vector<VkImageView> levelViews;
+  VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
+  std::vector<VkDescriptorSet> descriptorSets;
+
+  uint32_t firstReadbackLevel = 0;
+  std::vector<ReadbackLevel> readbackLevels;
+  VkBuffer readbackBuffer = VK_NULL_HANDLE;
+  VkDeviceMemory readbackMemory = VK_NULL_HANDLE;
+
+  void CreatePipeline(const Device& device, const std::string& rootPath,
+                      const std::string& shaderPath);
+  void CreateDescriptorSets(const VkDevice& device,
+                            const VkImageView& depthImageView);
+  void CreateReadbackBuffer(const Device& device);
+
+ public:
+  void CreateOcclusionCulling(const Device& device, const Render& render,
+                              Depth& depth, const VkExtent2D& depthExtent,
+                              const std::string& rootPath,
+                              const std::string& shaderPath);
+  // The pyramid follows the depth image, call after it has been recreated
+  void CreatePyramid(const Device& device, const Render& render, Depth& depth,
+                     const VkExtent2D& depthExtent);
+  void DestroyPyramid(const VkDevice& device);
+  void DestroyOcclusionCulling(const VkDevice& device);
+
+  // Recorded after the Z-prepass render pass, which leaves the depth image
+  // ready to be sampled
+  void RecordBuildPyramid(VkCommandBuffer commandBuffer) const;
+  // Tests the box around a sphere, given in the space mvp maps to clip space.
+  // Only valid after the fence of the command buffer that built the pyramid.
+  [[nodiscard]] bool IsOccluded(const glm::mat4& mvp,
+                                const glm::vec4& bounds) const;
+};
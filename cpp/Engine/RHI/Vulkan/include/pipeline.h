@@ -9,7 +9,7 @@
 
 #define DEFINE_GET_PIPELINE_AND_DSL(lower, upper)                              \
   [[nodiscard]] const VkPipeline& Get##upper##GraphicsPipeline() const {       \
-    return lower##GraphicsPipeline;                                            \
+    return graphicsPipelines.lower;                                            \
   }                                                                            \
   [[nodiscard]] const VkPipelineLayout& Get##upper##PipelineLayout() const {   \
     return lower##PipelineLayout;                                              \
@@ -23,41 +23,59 @@ class Shader;
 class Device;
 class Render;
 
+enum PipelineVariant : uint32_t {
+  ColorPipelineVariant = 1 << 0,
+  ZPrePassPipelineVariant = 1 << 1,
+  ShadowMapPipelineVariant = 1 << 2,
+  AllPipelineVariants = ColorPipelineVariant | ZPrePassPipelineVariant |
+                        ShadowMapPipelineVariant,
+};
+
+struct GraphicsPipelines {
+  VkPipeline color = VK_NULL_HANDLE;
+  VkPipeline deferred = VK_NULL_HANDLE;
+  VkPipeline zPrePass = VK_NULL_HANDLE;
+  VkPipeline shadowMap = VK_NULL_HANDLE;
+};
+
 class Pipeline : public Base {
   int pipelineId = -1;
   int shaderFallbackIndex = -1;
+  uint32_t vertexFormat = 0;
+  GraphicsPipelines graphicsPipelines;
 
   VkDescriptorSetLayout colorDescriptorSetLayout;
   VkPipelineLayout colorPipelineLayout;
-  VkPipeline colorGraphicsPipeline;
 
   VkDescriptorSetLayout deferredDescriptorSetLayout;
   VkPipelineLayout deferredPipelineLayout;
-  VkPipeline deferredGraphicsPipeline;
 
   VkDescriptorSetLayout zPrePassDescriptorSetLayout;
   VkPipelineLayout zPrePassPipelineLayout;
-  VkPipeline zPrePassGraphicsPipeline;
 
   VkDescriptorSetLayout shadowMapDescriptorSetLayout;
   VkPipelineLayout shadowMapPipelineLayout;
-  VkPipeline shadowMapGraphicsPipeline;
-
-  void CreatePipelineLayout(const VkDevice& device,
-                            const VkDescriptorSetLayout& dstLayout,
-                            VkPipelineLayout& pipelineLayout);
-  void CreateColorGraphicsPipeline(const Device& device, Render& render,
-                                   Shader& shader, const std::string& rootPath,
-                                   const std::vector<std::string>& shaderPaths,
-                                   const VkRenderPass& renderPass);
+
+  void CreatePipelineLayout(
+      const VkDevice& device, const VkDescriptorSetLayout& dstLayout,
+      VkPipelineLayout& pipelineLayout,
+      const std::vector<VkPushConstantRange>& pushConstantRanges = {});
+  int CreateColorGraphicsPipeline(const Device& device, Render& render,
+                                  Shader& shader, const std::string& rootPath,
+                                  const std::vector<std::string>& shaderPaths,
+                                  const VkRenderPass& renderPass,
+                                  GraphicsPipelines& pipelines);
   void CreateZPrePassGraphicsPipeline(const Device& device, Shader& shader,
                                       const std::string& rootPath,
                                       const std::string& depthShaderPath,
-                                      const VkRenderPass& renderPass);
+                                      const VkRenderPass& renderPass,
+                                      uint32_t subpass,
+                                      GraphicsPipelines& pipelines);
   void CreateShadowMapGraphicsPipeline(const VkDevice& device, Render& render,
                                        Shader& shader,
                                        const std::string& rootPath,
-                                       const std::string& depthShaderPath);
+                                       const std::string& depthShaderPath,
+                                       GraphicsPipelines& pipelines);
 
   void CreateColorDescriptorSetLayout(const VkDevice& device, Render& render,
                                       int texCount);
@@ -73,12 +91,28 @@ class Pipeline : public Base {
   DEFINE_GET_PIPELINE_AND_DSL(shadowMap, ShadowMap)
 
   void CreatePipeline(const Device& device, Render& render, Shader& shader,
-                      int texCount, const std::string& rootPath,
+                      int texCount, uint32_t vertexFormat,
+                      const std::string& rootPath,
                       const std::vector<std::string>& shaderPaths,
                       const std::string& zPrePassShaderPath,
                       const std::string& shadowMapShaderPath);
   void DestroyPipeline(const VkDevice& device, const Render& render) const;
 
+  // Builds new graphics pipelines for the given variants against the
+  // existing layouts, so descriptor sets stay valid. Touches no state the
+  // render thread reads and may run on a worker thread.
+  [[nodiscard]] GraphicsPipelines RebuildGraphicsPipelines(
+      const Device& device, Render& render, Shader& shader,
+      uint32_t variants, const std::string& rootPath,
+      const std::string& shaderPath, const std::string& zPrePassShaderPath,
+      const std::string& shadowMapShaderPath);
+  // Installs the non-null pipelines and destroys the ones they replace, the
+  // caller makes sure the device is no longer using them.
+  void SwapGraphicsPipelines(const VkDevice& device,
+                             const GraphicsPipelines& pipelines);
+  static void DestroyGraphicsPipelines(const VkDevice& device,
+                                       const GraphicsPipelines& pipelines);
+
   int GetPipelineId() { return pipelineId; }
   void SetPipelineId(const int pipelineId) { this->pipelineId = pipelineId; }
 };
@@ -3,19 +3,23 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <coroutine>
 #include <unordered_map>
 
+#include "asynccompute.h"
 #include "base.h"
 #include "config.h"
 #include "device.h"
+#include "drawlist.h"
+#include "gputimer.h"
+#include "lightingtiles.h"
+#include "occlusion.h"
+#include "rendergraph.h"
+#include "staging.h"
 #include "swapchain.h"
 #include "uniform.h"
 #include "window.h"
 
-#define DEFINE_GET_RENDER_PASS(lower, upper)                         \
-  [[nodiscard]] const VkRenderPass& Get##upper##RenderPass() const { \
-    return lower##RenderPass;                                        \
-  }
 #define DEFINE_GET_COMMAND_BUFFERS(lower, upper)    \
   [[nodiscard]] const std::vector<VkCommandBuffer>& \
       Get##upper##CommandBuffers() const {          \
@@ -29,6 +33,14 @@ class Draw;
 class Depth;
 class Vulkan;
 
+// Copies recorded while creating a mesh, submitted together and released once
+// their fence has signaled.
+struct UploadBatch {
+  VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+  VkFence fence = VK_NULL_HANDLE;
+  std::vector<std::pair<VkBuffer, VkDeviceMemory>> stagingBuffers;
+};
+
 class Render : public Base {
   SwapChain swapChain;
   uint32_t currentFrame = 0;
@@ -43,13 +55,27 @@ class Render : public Base {
   std::vector<VkSemaphore> renderFinishedSemaphores;
   std::vector<std::vector<VkSemaphore>> shadowMapFinishedSemaphores;
 
-  VkRenderPass colorRenderPass;
-  VkRenderPass zPrePassRenderPass;
-  VkRenderPass shadowMapRenderPass;
-
-  void CreateColorRenderPass(const Device& device);
-  void CreateZPrePassRenderPass(const Device& device);
-  void CreateShadowMapRenderPass(const Device& device);
+  // Passes of a frame in submission order, the Z-prepass shares the render
+  // pass of the color pass unless the depth pyramid is built in between, and
+  // the lighting pass shares it unless its tiles are classified in between
+  RenderGraph renderGraph;
+  RenderGraph::ImageId swapChainImage = RenderGraphNone;
+  RenderGraph::ImageId depthImage = RenderGraphNone;
+  std::vector<RenderGraph::ImageId> gBufferImages;
+  std::vector<RenderGraph::ImageId> shadowMapImages;
+  RenderGraph::PassId zPrePassPass = RenderGraphNone;
+  RenderGraph::PassId depthPyramidPass = RenderGraphNone;
+  RenderGraph::PassId colorPass = RenderGraphNone;
+  RenderGraph::PassId lightingTilesPass = RenderGraphNone;
+  RenderGraph::PassId lightingPass = RenderGraphNone;
+  std::vector<RenderGraph::PassId> shadowMapPasses;
+
+  void CreateRenderGraph(const Device& device);
+  void CreateRenderGraphResources(const Device& device);
+  // Recorded and submitted on its own, otherwise it begins the color pass
+  [[nodiscard]] bool GetSeparateZPrePass() const;
+  // Submitted to asyncCompute, as the pass asks for the compute queue
+  [[nodiscard]] bool GetAsyncPass(RenderGraph::PassId pass) const;
   void CreateCommandBuffers(const VkDevice& device,
                             std::vector<VkCommandBuffer>& commandBuffers);
 
@@ -58,34 +84,74 @@ class Render : public Base {
   std::vector<VkCommandBuffer> zPrePassCommandBuffers;
   std::vector<std::vector<VkCommandBuffer>> shadowMapCommandBuffers;
 
-  void CreateRenderPasses(const Device& device);
+  std::vector<std::pair<VkFence, std::coroutine_handle<>>> pendingUploads;
+  // Shared with the tickets, which may outlive DestroyRenderResources
+  std::shared_ptr<StagingPool> stagingPool = std::make_shared<StagingPool>();
+
+  AsyncCompute asyncCompute;
+
+  OcclusionCulling occlusionCulling;
+  OcclusionStats occlusionStats;
+  // Reached once the depth pyramid of currentFrame is built on the compute
+  // queue, the color pass waits on it to take the depth image back
+  TimelinePoint depthPyramidDone;
+
+  LightingTiles lightingTiles;
+  LightingTileStats lightingTileStats;
+  // Spans the tile classification and the lighting pass, so the tiled and
+  // fullscreen lighting can be compared
+  GpuTimer lightingTimer;
+
+  // Sorted by state and depth once a frame, shared by the passes' recording
+  DrawList drawList;
+  DrawStats drawStats;
+
   void CreateCommandPool(const Device& device, const VkSurfaceKHR& surface);
   void CreateSyncObjects(const VkDevice& device);
   void CreateCommandBuffersSet(const VkDevice& device);
 
-  void DestroyRenderPasses(const VkDevice& device) const;
   void DestroyCommandPool(const VkDevice& device) const;
   void DestroySyncObjects(const VkDevice& device);
 
-  void ConvertShaderSourceToShadowMapDepth(
-      const Device& device, VkCommandBuffer commandBuffer = VK_NULL_HANDLE);
-  void ConvertShadowMapDepthToShaderSource(
-      const Device& device, VkCommandBuffer commandBuffer = VK_NULL_HANDLE);
-
+  static void SetViewport(VkCommandBuffer commandBuffer,
+                          const VkExtent2D& extent);
+  void RecordZPrePass(VkCommandBuffer commandBuffer, uint32_t frameBufferIndex);
   void RecordZPrePassCommandBuffer(
-      const Device& device, std::unordered_map<std::string, Draw*>& draws);
+      const Device& device, std::unordered_map<StringId, Draw*>& draws);
   void RecordShadowMapCommandBuffer(
-      const Device& device, std::unordered_map<std::string, Draw*>& draws,
+      const Device& device, std::unordered_map<StringId, Draw*>& draws,
       BaseLight* light);
   void RecordColorCommandBuffer(const Device& device,
-                                std::unordered_map<std::string, Draw*>& draws,
+                                std::unordered_map<StringId, Draw*>& draws,
                                 uint32_t imageIndex);
-
+  // The Z-prepass depth, left ready to be sampled by the pyramid
+  [[nodiscard]] QueueImageTransfer GetDepthQueueTransfer();
+  // Builds the depth pyramid on the compute queue once the Z-prepass has
+  // reached zPrePassDone, while the graphics queue goes on with the shadow maps
+  void SubmitDepthPyramid(const Device& device, TimelinePoint zPrePassDone);
+  // Waits for the Z-prepass or the compute queue to build the depth pyramid,
+  // then marks the meshes it hides so the color pass skips them
+  void CullOccludedMeshes(const Device& device,
+                          std::unordered_map<StringId, Draw*>& draws);
+  // Counts the tiles the lighting draws of currentFrame shaded, read back once
+  // its fence has signaled
+  void CountLightingTiles(std::unordered_map<StringId, Draw*>& draws);
+  // Recreates what follows the extent and points the descriptors of the draws
+  // at it
+  void RecreateSwapChain(const Device& device, const VkWindow& window,
+                         std::unordered_map<StringId, Draw*>& draws);
+  // The camera the G-buffer of currentFrame was drawn from
+  [[nodiscard]] DeferredViewData GetDeferredViewData() const;
+
+  // Also waits on and signals the timeline points given, which the compute
+  // queue shares
   void SubmitCommandBuffer(const Device& device,
                            const VkSemaphore& waitSemaphore,
                            const VkCommandBuffer& commandBuffer,
                            const VkSemaphore& signalSemaphore,
-                           const VkFence waitFence);
+                           const VkFence waitFence,
+                           const TimelinePoint& timelineWait = {},
+                           const TimelinePoint& timelineSignal = {});
 
  public:
   virtual void TriggerRegisterMember() override { RegisterMember(swapChain); }
@@ -93,23 +159,49 @@ class Render : public Base {
                              const std::string& imageFormat,
                              const std::string& colorSpace) {
     swapChain.CreateRenderTarget(imageFormat, colorSpace, device, window);
-    swapChain.CreateColorResource(device);
     swapChain.CreateDepthResources(device);
 
-    CreateRenderPasses(device);
+    CreateRenderGraph(device);
     CreateCommandPool(device, window.GetSurface());
 
     swapChain.TransitionDepthImageLayout(device);
-    swapChain.CreateFrameBuffers(device);
+    CreateRenderGraphResources(device);
 
     CreateCommandBuffersSet(device.GetLogical());
     CreateSyncObjects(device.GetLogical());
+    if (GetEnableAsyncCompute()) {
+      asyncCompute.CreateAsyncCompute(device, maxFramesInFlight);
+    }
+    if (GetEnableDeferred()) {
+      lightingTimer.CreateGpuTimer(device, maxFramesInFlight);
+    }
+    stagingPool->CreateStagingPool(device, VulkanConfig::STAGING_POOL_SIZE);
+  }
+  void CreateOcclusionCulling(const Device& device, const std::string& rootPath,
+                              const std::string& shaderPath) {
+    occlusionCulling.CreateOcclusionCulling(
+        device, *this, swapChain.GetZPrePassDepth(), swapChain.GetExtent(),
+        rootPath, shaderPath);
+  }
+  void CreateLightingTiles(const Device& device, const std::string& rootPath,
+                           const std::string& shaderPath) {
+    lightingTiles.CreateLightingTiles(device, *this, GetGBufferPipelineIdView(),
+                                      swapChain.GetExtent(), rootPath,
+                                      shaderPath);
   }
 
   bool GetEnableMipmap() const;
   bool GetEnableZPrePass() const;
   bool GetEnableShadowMap() const;
   bool GetEnableDeferred() const;
+  bool GetEnableCompactGBuffer() const;
+  // Requires the Z-prepass, whose depth the pyramid is built from
+  bool GetEnableOcclusionCulling() const;
+  // Lights each draw's tiles instead of the whole screen, requires deferred
+  bool GetEnableTileClassification() const;
+  // Submits the compute passes asking for it on the compute queue, left off
+  // when the device has no timeline semaphores
+  bool GetEnableAsyncCompute() const;
   uint32_t GetShadowMapWidth() const;
   uint32_t GetShadowMapHeight() const;
   float GetDepthBiasConstantFactor() const;
@@ -125,6 +217,26 @@ class Render : public Base {
   void EndSingleTimeCommands(const Device& device,
                              VkCommandBuffer* commandBuffer) const;
 
+  // Suspends the awaiting coroutine until the render thread sees the fence
+  struct UploadAwaiter {
+    Render& render;
+    VkFence fence;
+    constexpr bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<> handle) {
+      render.pendingUploads.emplace_back(fence, handle);
+    }
+    constexpr void await_resume() const noexcept {}
+  };
+  [[nodiscard]] UploadBatch BeginUpload(const VkDevice& device) const;
+  [[nodiscard]] UploadAwaiter SubmitUpload(const Device& device,
+                                           UploadBatch& batch);
+  void EndUpload(const VkDevice& device, UploadBatch& batch) const;
+  void ResumeCompletedUploads(const VkDevice& device);
+  void FlushUploads(const VkDevice& device);
+  [[nodiscard]] const std::shared_ptr<StagingPool>& GetStagingPool() const {
+    return stagingPool;
+  }
+
   void WaitFences(
       const Device& device,
       std::unordered_map<int, std::weak_ptr<BaseLight>>& lightsById);
@@ -132,17 +244,21 @@ class Render : public Base {
       const Device& device,
       std::unordered_map<int, std::weak_ptr<BaseLight>>& lightsById);
   void DrawFrame(const Device& device,
-                 std::unordered_map<std::string, Draw*>& draws,
+                 std::unordered_map<StringId, Draw*>& draws,
                  std::unordered_map<int, std::weak_ptr<BaseLight>>& lightsById,
                  VkWindow& window);
 
   void DestroyRenderResources(const Device& device) {
-    swapChain.DestroyColorResource(device);
-    swapChain.DestroyDepthResource(device.GetLogical());
-    swapChain.CleanupRenderTarget(device);
-    DestroyRenderPasses(device.GetLogical());
+    stagingPool->DestroyStagingPool();
+    occlusionCulling.DestroyOcclusionCulling(device.GetLogical());
+    lightingTiles.DestroyLightingTiles(device.GetLogical());
+    lightingTimer.DestroyGpuTimer(device.GetLogical());
+    asyncCompute.DestroyAsyncCompute(device.GetLogical());
     DestroySyncObjects(device.GetLogical());
     DestroyCommandPool(device.GetLogical());
+    renderGraph.Destroy(device.GetLogical());
+    swapChain.DestroyDepthResource(device.GetLogical());
+    swapChain.CleanupRenderTarget(device);
   }
 
   [[nodiscard]] const VkFormat& GetSwapChainImageFormat() const {
@@ -163,8 +279,35 @@ class Render : public Base {
   [[nodiscard]] VkImageView GetShadowMapDepthImageViewByIndex(uint32_t index) {
     return swapChain.GetShadowMapDepthImageViewByIndex(index);
   }
-  [[nodiscard]] VkImageView GetGBufferImageViewByIndex(uint32_t index) {
-    return swapChain.GetGBufferImageViewByIndex(index);
+  // The full layout keeps world position and the camera in float targets,
+  // the compact one reconstructs position from depth and packs the rest into
+  // 32 bits per target
+  [[nodiscard]] std::vector<VkFormat> GetGBufferFormats() const;
+  [[nodiscard]] uint32_t GetGBufferSize() const {
+    return static_cast<uint32_t>(GetGBufferFormats().size());
+  }
+  // The lighting subpass of the compact layout reads depth after the targets
+  [[nodiscard]] uint32_t GetGBufferInputSize() const {
+    return GetGBufferSize() + (GetEnableCompactGBuffer() ? 1 : 0);
+  }
+  [[nodiscard]] VkDescriptorImageInfo GetGBufferInputInfoByIndex(
+      uint32_t index);
+  // The target holding the pipeline id, albedo or position
+  [[nodiscard]] uint32_t GetGBufferPipelineIdIndex() const {
+    return GetEnableCompactGBuffer() ? 0 : 2;
+  }
+  [[nodiscard]] VkImageView GetGBufferPipelineIdView() const {
+    return renderGraph.GetImageView(gBufferImages[GetGBufferPipelineIdIndex()]);
+  }
+  [[nodiscard]] VkDescriptorBufferInfo GetLightingTileBufferInfo() const {
+    return lightingTiles.GetTileBufferInfo();
+  }
+  [[nodiscard]] VkDeviceSize GetGBufferMemorySize() const;
+  [[nodiscard]] VkDeviceSize GetTransientMemorySize() const {
+    return renderGraph.GetMemorySize();
+  }
+  [[nodiscard]] VkDeviceSize GetAliasedMemorySize() const {
+    return renderGraph.GetAliasedMemorySize();
   }
 
   [[nodiscard]] uint32_t GetSwapChainExtentWidth() const {
@@ -174,13 +317,44 @@ class Render : public Base {
     return swapChain.GetExtentHeight();
   }
 
-  DEFINE_GET_RENDER_PASS(color, Color)
-  DEFINE_GET_RENDER_PASS(zPrePass, ZPrePass)
-  DEFINE_GET_RENDER_PASS(shadowMap, ShadowMap)
+  [[nodiscard]] VkRenderPass GetColorRenderPass() const {
+    return renderGraph.GetRenderPass(colorPass);
+  }
+  [[nodiscard]] VkRenderPass GetLightingRenderPass() const {
+    return renderGraph.GetRenderPass(lightingPass);
+  }
+  [[nodiscard]] VkRenderPass GetZPrePassRenderPass() const {
+    return renderGraph.GetRenderPass(zPrePassPass);
+  }
+  // The render passes of the shadow maps are all compatible
+  [[nodiscard]] VkRenderPass GetShadowMapRenderPass() const {
+    return renderGraph.GetRenderPass(shadowMapPasses.front());
+  }
+  [[nodiscard]] uint32_t GetColorSubpass() const {
+    return renderGraph.GetSubpass(colorPass);
+  }
+  [[nodiscard]] uint32_t GetLightingSubpass() const {
+    return renderGraph.GetSubpass(lightingPass);
+  }
+  [[nodiscard]] uint32_t GetZPrePassSubpass() const {
+    return renderGraph.GetSubpass(zPrePassPass);
+  }
 
   DEFINE_GET_COMMAND_BUFFERS(color, Color)
   DEFINE_GET_COMMAND_BUFFERS(zPrePass, ZPrePass)
 
+  [[nodiscard]] const OcclusionStats& GetOcclusionStats() const {
+    return occlusionStats;
+  }
+  [[nodiscard]] const DrawStats& GetDrawStats() const { return drawStats; }
+  [[nodiscard]] const LightingTileStats& GetLightingTileStats() const {
+    return lightingTileStats;
+  }
+  // GPU time of the lighting of the last frame read back
+  [[nodiscard]] float GetLightingTime() const {
+    return lightingTimer.GetMilliseconds();
+  }
+
   [[nodiscard]] int GetCurrentFrame() const { return currentFrame; }
   [[nodiscard]] int GetMaxFramesInFlight() const { return maxFramesInFlight; }
   [[nodiscard]] float GetViewportAspect() {
@@ -188,5 +362,4 @@ class Render : public Base {
   }
 };
 
-#undef DEFINE_GET_COMMAND_BUFFERS
-#undef DEFINE_GET_RENDER_PASS
\ No newline at end of file
+#undef DEFINE_GET_COMMAND_BUFFERS
\ No newline at end of file
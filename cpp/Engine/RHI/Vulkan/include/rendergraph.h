@@ -0,0 +1,175 @@
+#pragma once
+
+#include <vulkan/vulkan_core.h>
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "asynccompute.h"
+
+class Device;
+
+constexpr uint32_t RenderGraphNone = ~0u;
+
+struct RenderGraphOutput {
+  uint32_t image = RenderGraphNone;
+  // Otherwise the pass keeps what earlier passes wrote
+  bool clear = true;
+  // A multisampled color output resolves into it at the end of the pass
+  uint32_t resolve = RenderGraphNone;
+};
+
+struct RenderGraphPassDesc {
+  std::string name;
+  // Recorded outside of render passes, may only sample what it reads
+  bool compute = false;
+  // A compute pass may ask to overlap the graphics work around it, the
+  // renderer submits it to AsyncCompute and hands its images over
+  QueueType queue = QueueType::Graphics;
+  // Left empty, the pass covers the extent given to CreateResources
+  VkExtent2D extent{};
+  std::vector<RenderGraphOutput> colors;
+  std::optional<RenderGraphOutput> depth;
+  // Read in place, in input attachment index order
+  std::vector<uint32_t> inputs;
+  std::vector<uint32_t> sampled;
+};
+
+// Frame graph the passes of a frame declare their reads and writes on. Compile
+// orders them into render passes, merging a pass into the previous one as a
+// subpass when it consumes its attachments in place, and derives load and
+// store ops, layouts and dependencies from what comes before and after each
+// use, wrapping around to the previous frame. Layout transitions happen at
+// render pass boundaries so recording needs no barriers. Images the graph
+// owns are transient: their contents do not outlive the frame, so those whose
+// lifetimes do not overlap share memory.
+class RenderGraph {
+ public:
+  using ImageId = uint32_t;
+  using PassId = uint32_t;
+
+ private:
+  enum class UseType {
+    Color,
+    Resolve,
+    Depth,
+    Input,
+    Sampled,
+  };
+  struct Use {
+    PassId pass;
+    UseType type;
+    bool clear;
+  };
+
+  struct Image {
+    std::string name;
+    VkFormat format;
+    VkSampleCountFlagBits samples;
+    bool imported;
+    // Layout an imported image is handed back in, e.g. to be presented
+    VkImageLayout finalLayout;
+    std::vector<Use> uses;
+    // Transient images sharing a slot alias the same memory, the first use
+    // of each waits on the last use of the one before it
+    uint32_t slot = RenderGraphNone;
+    std::optional<Use> aliasPredecessor;
+
+    std::vector<VkImageView> views;
+    VkImage image = VK_NULL_HANDLE;
+    VkDeviceSize memorySize = 0;
+  };
+
+  struct Step {
+    bool compute;
+    VkExtent2D extent;
+    std::vector<PassId> passes;
+    std::vector<ImageId> attachments;
+    std::vector<VkClearValue> clearValues;
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    std::vector<VkFramebuffer> frameBuffers;
+  };
+
+  std::vector<Image> images;
+  std::vector<RenderGraphPassDesc> passes;
+  std::vector<uint32_t> passSteps;
+  std::vector<Step> steps;
+  std::vector<VkDeviceMemory> memories;
+  VkExtent2D extent{};
+  VkDeviceSize memorySize = 0;
+  VkDeviceSize aliasedMemorySize = 0;
+
+  static bool IsDepthFormat(VkFormat format);
+  static bool NeedsContents(const Use& use);
+  [[nodiscard]] VkImageLayout GetLayout(ImageId image, const Use& use) const;
+  [[nodiscard]] VkPipelineStageFlags GetStages(const Use& use) const;
+  [[nodiscard]] VkAccessFlags GetAccesses(const Use& use) const;
+  [[nodiscard]] VkAccessFlags GetWriteAccesses(const Use& use) const;
+  [[nodiscard]] bool IsAttachment(const Use& use) const {
+    return use.type != UseType::Sampled;
+  }
+  [[nodiscard]] size_t FindUse(ImageId image, PassId pass) const;
+  // The uses around a use, the previous of the first one is the last one of
+  // the previous frame
+  [[nodiscard]] const Use& GetPreviousUse(ImageId image, size_t index) const;
+  [[nodiscard]] const Use& GetNextUse(ImageId image, size_t index) const;
+  [[nodiscard]] VkImageLayout GetFinalLayout(ImageId image,
+                                             size_t lastIndex) const;
+  [[nodiscard]] VkImageLayout GetLayoutAfter(ImageId image, size_t index) const;
+  [[nodiscard]] VkExtent2D GetStepExtent(const Step& step) const;
+
+  void AddUse(ImageId image, PassId pass, UseType type, bool clear);
+  [[nodiscard]] bool CanMerge(const Step& step, PassId pass) const;
+  void AssignAliasSlots();
+  void CreateRenderPass(const VkDevice& device, Step& step);
+
+ public:
+  ImageId AddImage(const std::string& name, VkFormat format,
+                   VkSampleCountFlagBits samples);
+  ImageId ImportImage(const std::string& name, VkFormat format,
+                      VkSampleCountFlagBits samples,
+                      VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED);
+  PassId AddPass(const RenderGraphPassDesc& desc);
+
+  // Creates the render passes, which do not depend on the extent
+  void Compile(const VkDevice& device);
+  // Imported images may come with a view per frame buffer, like the images
+  // of the swap chain, set again after they have been recreated
+  void SetImportedViews(ImageId image, const std::vector<VkImageView>& views);
+  void CreateResources(const Device& device, const VkExtent2D& screenExtent);
+  void DestroyResources(const VkDevice& device);
+  void Destroy(const VkDevice& device);
+
+  // Begins the render pass or moves to the subpass of the pass
+  void BeginPass(VkCommandBuffer commandBuffer, PassId pass,
+                 uint32_t frameBufferIndex = 0) const;
+  // Ends the render pass after its last subpass
+  void EndPass(VkCommandBuffer commandBuffer, PassId pass) const;
+
+  [[nodiscard]] VkRenderPass GetRenderPass(PassId pass) const {
+    return steps[passSteps[pass]].renderPass;
+  }
+  [[nodiscard]] uint32_t GetSubpass(PassId pass) const;
+  [[nodiscard]] QueueType GetQueue(PassId pass) const {
+    return passes[pass].queue;
+  }
+  [[nodiscard]] bool SharesRenderPass(PassId pass, PassId other) const {
+    return passSteps[pass] == passSteps[other];
+  }
+  [[nodiscard]] VkExtent2D GetExtent(PassId pass) const {
+    return GetStepExtent(steps[passSteps[pass]]);
+  }
+  [[nodiscard]] VkImageView GetImageView(ImageId image) const {
+    return images[image].views[0];
+  }
+  [[nodiscard]] VkDeviceSize GetImageMemorySize(ImageId image) const {
+    return images[image].memorySize;
+  }
+  // Allocated for the transient images, and saved by aliasing them
+  [[nodiscard]] VkDeviceSize GetMemorySize() const { return memorySize; }
+  [[nodiscard]] VkDeviceSize GetAliasedMemorySize() const {
+    return aliasedMemorySize;
+  }
+};
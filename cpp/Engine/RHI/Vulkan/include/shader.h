@@ -4,6 +4,7 @@
 #include <libshaderc_util/file_finder.h>
 #include <vulkan/vulkan_core.h>
 
+#include <filesystem>
 #include <shaderc/shaderc.hpp>
 #include <unordered_map>
 
@@ -15,6 +16,11 @@ using ShaderStages =
                        std::vector<VkPipelineShaderStageCreateInfo>>;
 using Definitions = std::vector<std::pair<std::string, std::string>>;
 
+struct CompiledShaderCode {
+  std::filesystem::file_time_type writeTime;
+  UIntegers code;
+};
+
 struct ShaderTypeInfo {
   PipelineType type;
   shaderc_shader_kind kind;
@@ -49,10 +55,17 @@ class Shader : public Base {
       {"fragp",
        {PipelineType::DeferredProcessGBuffer, shaderc_glsl_fragment_shader,
         VK_SHADER_STAGE_FRAGMENT_BIT, "main"}},
+
+      // Compute
+      {"comp",
+       {PipelineType::Compute, shaderc_glsl_compute_shader,
+        VK_SHADER_STAGE_COMPUTE_BIT, "main"}},
   };
 
   std::string shaderPath = "Unset";
   mutable std::vector<VkShaderModule> shaderModules;
+  // Keyed by glsl file path, lets a hot reload recompile changed stages only
+  std::unordered_map<std::string, CompiledShaderCode> compiledCode;
   const ShaderTypeInfo& GetTypeByName(const std::string& glslPath);
 
   UIntegers ReadSPVFileAsBinary(const std::string& spvPath,
@@ -76,6 +89,7 @@ class Shader : public Base {
   void SetOptimizationLevel(shaderc_optimization_level level);
   void SetGenerateDebugInfo(const bool flag);
   void DestroyModules(const VkDevice& device) const;
+  void ClearCompiledCode() { compiledCode.clear(); }
 
   [[nodiscard]] ShaderStages AutoCreateStages(const VkDevice& device,
                                               const std::string& rootPath,
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <Engine/Utility/include/TypeUtils.h>
+#include <vulkan/vulkan_core.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+class Device;
+
+struct StagingRange {
+  VkBuffer buffer = VK_NULL_HANDLE;
+  VkDeviceSize offset = 0;
+  VkDeviceSize size = 0;
+  uint8_t* mapped = nullptr;
+};
+
+// One persistently mapped host visible buffer that loaders on the resource
+// workers write into directly. Ranges are handed out first fit and merged
+// again on release, a request the pool cannot serve gets a dedicated buffer
+// rather than waiting for uploads in flight.
+class StagingPool {
+  static constexpr VkDeviceSize Alignment = 16;
+
+  std::mutex mutex;
+  const Device* device = nullptr;
+  VkBuffer buffer = VK_NULL_HANDLE;
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  uint8_t* mapped = nullptr;
+  std::map<VkDeviceSize, VkDeviceSize> freeRanges;
+  std::unordered_map<VkBuffer, VkDeviceMemory> dedicatedBuffers;
+
+ public:
+  void CreateStagingPool(const Device& inDevice, VkDeviceSize size);
+  // Ranges released afterwards are ignored
+  void DestroyStagingPool();
+
+  [[nodiscard]] std::optional<StagingRange> Allocate(VkDeviceSize size);
+  void Release(const StagingRange& range);
+};
+
+// Vertices in the mesh's VertexFormat followed by its indices, in one range
+// of the pool that is released with the ticket.
+class MeshStagingTicket final : public MeshStaging {
+  std::shared_ptr<StagingPool> pool;
+  StagingRange range;
+  uint32_t vertexFormat;
+  VkDeviceSize vertexSize;
+  VkDeviceSize indexOffset;
+  VkIndexType indexType;
+
+ public:
+  MeshStagingTicket(std::shared_ptr<StagingPool> pool,
+                    const StagingRange& range, uint32_t vertexFormat,
+                    size_t vertexCount, size_t indexCount);
+  ~MeshStagingTicket() override { pool->Release(range); }
+
+  static std::unique_ptr<MeshStaging> Allocate(
+      std::shared_ptr<StagingPool> pool, uint32_t vertexFormat,
+      size_t vertexCount, size_t indexCount);
+
+  void WriteVertices(const std::vector<VertexData>& vertices,
+                     const VertexDequantData& dequant) override;
+  void WriteIndices(const std::vector<uint32_t>& indices) override;
+  void* GetIndexData() override {
+    return range.mapped + (indexOffset - range.offset);
+  }
+  [[nodiscard]] bool GetShortIndices() const override {
+    return indexType == VK_INDEX_TYPE_UINT16;
+  }
+
+  [[nodiscard]] const VkBuffer& GetBuffer() const { return range.buffer; }
+  [[nodiscard]] VkDeviceSize GetVertexOffset() const { return range.offset; }
+  [[nodiscard]] VkDeviceSize GetVertexSize() const { return vertexSize; }
+  [[nodiscard]] VkDeviceSize GetIndexOffset() const { return indexOffset; }
+  [[nodiscard]] VkDeviceSize GetIndexSize() const;
+  [[nodiscard]] VkIndexType GetIndexType() const { return indexType; }
+};
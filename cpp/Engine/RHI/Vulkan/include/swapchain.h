@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Engine/Utility/include/StringIdUtils.h>
 #include <Engine/Utility/include/TypeUtils.h>
 #include <vulkan/vulkan_core.h>
 
@@ -14,7 +15,6 @@
 using PresentModes = std::vector<VkPresentModeKHR>;
 using SurfaceFormats = std::vector<VkSurfaceFormatKHR>;
 
-class Draw;
 class VkWindow;
 class Device;
 class Render;
@@ -31,32 +31,16 @@ class SwapChain : public Base {
   VkFormat surfaceFormat = VK_FORMAT_R8G8B8A8_SRGB;
   VkColorSpaceKHR surfaceColorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
 
-  VkImage colorImage;
-  VkDeviceMemory colorImageMemory;
-  VkImageView colorImageView;
-
-  std::vector<VkImage> gBufferImages;
-  std::vector<VkDeviceMemory> gBufferImageMemories;
-  std::vector<VkImageView> gBufferImageViews;
-
   std::vector<VkImage> swapChainImages;
   std::vector<VkImageView> swapChainImageViews;
 
-  VkFramebuffer zPrePassFrameBuffer;
-  std::vector<VkFramebuffer> colorFrameBuffers;
-  std::vector<VkFramebuffer> shadowMapFrameBuffers;
-
-  bool GetEnableZPrePass() const;
   bool GetEnableShadowMap() const;
-  bool GetEnableDeferred() const;
+  bool GetEnableCompactGBuffer() const;
+  bool GetEnableOcclusionCulling() const;
 
   uint32_t GetShadowMapWidth() const;
   uint32_t GetShadowMapHeight() const;
 
-  const VkRenderPass& GetColorRenderPass() const;
-  const VkRenderPass& GetZPrePassRenderPass() const;
-  const VkRenderPass& GetShadowMapRenderPass() const;
-
  public:
   virtual void TriggerRegisterMember() override {
     RegisterMember(zPrePassDepth);
@@ -64,10 +48,8 @@ class SwapChain : public Base {
       RegisterMember(depth);
     }
   }
-  void CreateColorResource(const Device& device);
   void CreateDepthResources(const Device& device);
   void TransitionDepthImageLayout(const Device& device);
-  void CreateFrameBuffers(const Device& device);
 
   VkSurfaceFormatKHR ChooseSurfaceFormat(
       const SurfaceFormats& availableFormats) const;
@@ -83,6 +65,10 @@ class SwapChain : public Base {
 
   VkFormat GetImageFormat() const { return imageFormat; }
   VkColorSpaceKHR GetImageColorSpace() const { return imageColorSpace; }
+  const std::vector<VkImageView>& GetImageViews() const {
+    return swapChainImageViews;
+  }
+  Depth& GetZPrePassDepth() { return zPrePassDepth; }
   VkFormat GetZPrePassDepthFormat() const {
     return zPrePassDepth.GetDepthFormat();
   }
@@ -93,14 +79,6 @@ class SwapChain : public Base {
   uint32_t GetExtentWidth() const { return extent.width; }
   uint32_t GetExtentHeight() const { return extent.height; }
 
-  VkFramebuffer GetColorFrameBufferByIndex(uint32_t index) const {
-    return colorFrameBuffers[index];
-  }
-  VkFramebuffer GetZPrePassFrameBuffer() const { return zPrePassFrameBuffer; }
-  VkFramebuffer GetShadowMapFrameBufferByIndex(uint32_t index) const {
-    return shadowMapFrameBuffers[index];
-  }
-
   size_t GetShadowMapDepthNum() { return shadowMapDepths.size(); }
   Depth& GetShadowMapDepthByIndex(uint32_t index) {
     return shadowMapDepths[index];
@@ -114,24 +92,16 @@ class SwapChain : public Base {
   VkImageView GetShadowMapDepthImageViewByIndex(uint32_t index) {
     return shadowMapDepths[index].GetDepthImageView();
   }
-  VkImageView GetGBufferImageViewByIndex(uint32_t index) {
-    return gBufferImageViews[index];
-  }
 
   void CreateSwapChain(const Device& device, const VkWindow& window);
   void CreateImageViews(const VkDevice& device);
-  void CreateColorFrameBuffers(const Device& device);
-  void CreateZPrePassFrameBuffer(const VkDevice& device);
-  void CreateShadowMapFrameBuffers(const VkDevice& device);
 
-  void RecreateSwapChain(const Device& device, const VkWindow& window,
-                         std::unordered_map<std::string, Draw*>& draws);
+  void RecreateSwapChain(const Device& device, const VkWindow& window);
 
   void CreateRenderTarget(const Device& device, const VkWindow& window);
   void CreateRenderTarget(const std::string& format, const std::string& space,
                           const Device& device, const VkWindow& window);
   void CleanupRenderTarget(const Device& device) const;
-  void DestroyColorResource(const Device& device);
   void DestroyDepthResource(const VkDevice& device) {
     zPrePassDepth.DestroyDepthResource(device);
     if (GetEnableShadowMap()) {
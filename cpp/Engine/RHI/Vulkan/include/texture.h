@@ -6,6 +6,7 @@
 
 class Device;
 class Render;
+struct UploadBatch;
 
 class Texture {
   bool createInterrupted = false;
@@ -19,12 +20,13 @@ class Texture {
 
   void CreateTextureImage(const Device& device, const Render& render,
                           int texWidth, int texHeight, int texChannels,
-                          std::weak_ptr<TextureDataContent> pixelsPtr);
+                          std::weak_ptr<TextureDataContent> pixelsPtr,
+                          UploadBatch& batch);
   void CreateTextureImageView(const VkDevice& device);
   void CreateTextureSampler(const Device& device);
 
-  static void CopyBufferToImage(const Device& device, const Render& render,
-                                VkBuffer buffer, VkImage image, uint32_t width,
+  static void CopyBufferToImage(VkCommandBuffer commandBuffer, VkBuffer buffer,
+                                VkImage image, uint32_t width,
                                 uint32_t height);
 
  public:
@@ -32,15 +34,15 @@ class Texture {
 
   Texture(const Device& device, const Render& render, const int width,
           const int height, const int channels,
-          std::weak_ptr<TextureDataContent> data) {
-    CreateTexture(device, render, width, height, channels, data);
+          std::weak_ptr<TextureDataContent> data, UploadBatch& batch) {
+    CreateTexture(device, render, width, height, channels, data, batch);
   }
 
   Texture(VkFormat imageFormat, const Device& device, const Render& render,
           const int width, const int height, const int channels,
-          std::weak_ptr<TextureDataContent> data)
+          std::weak_ptr<TextureDataContent> data, UploadBatch& batch)
       : imageFormat(imageFormat) {
-    CreateTexture(device, render, width, height, channels, data);
+    CreateTexture(device, render, width, height, channels, data, batch);
   }
 
   bool GetCreateInterrupted() const { return createInterrupted; }
@@ -63,7 +65,8 @@ class Texture {
   static void GenerateMipmaps(const Device& device, const Render& render,
                               const VkImage image, const int32_t width,
                               const int32_t height, const uint32_t mipLevels,
-                              const VkFormat imageFormat);
+                              const VkFormat imageFormat,
+                              VkCommandBuffer commandBuffer = VK_NULL_HANDLE);
   static void TransitionImageLayout(
       const Device& device, const Render& render, const VkImage& image,
       const uint32_t mipLevels, const VkFormat format,
@@ -71,8 +74,11 @@ class Texture {
       const VkImageAspectFlags aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
       VkCommandBuffer commandBuffer = VK_NULL_HANDLE);
 
+  // Records the upload into the batch, the texture may only be sampled once
+  // the batch has completed
   void CreateTexture(const Device& device, const Render& render, int width,
                      int height, int channels,
-                     std::weak_ptr<TextureDataContent> data);
+                     std::weak_ptr<TextureDataContent> data,
+                     UploadBatch& batch);
   void DestroyTexture(const VkDevice& device) const;
 };
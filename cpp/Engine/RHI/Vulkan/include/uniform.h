@@ -31,6 +31,11 @@ class TransformBuffer : public UniformBuffer {
  public:
   std::weak_ptr<MeshData> GetBridgeData();
   void UpdateUniformBuffer(const uint32_t currentImage);
+  [[nodiscard]] const TransformData& GetTransformData(
+      const uint32_t currentImage) const {
+    return *static_cast<const TransformData*>(
+        uniformBuffersMapped[currentImage]);
+  }
 };
 class ShadowMapBuffer : public UniformBuffer {
  public:
@@ -116,6 +121,9 @@ class Descriptor : public Base {
     return shadowMapDescriptorSets[lightId][currentFrame];
   }
 
+  [[nodiscard]] const BaseMaterial* GetMaterial() const {
+    return materialPointer;
+  }
   [[nodiscard]] const TransformBuffer& GetUniformBuffer() const {
     return transformBuffer;
   }
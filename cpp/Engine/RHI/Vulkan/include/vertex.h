@@ -6,21 +6,24 @@
 #include <assimp/vector3.h>
 #include <vulkan/vulkan_core.h>
 
-#include <array>
+#include <cstdint>
 #include <glm/glm.hpp>
+#include <string>
+#include <utility>
+#include <vector>
 
-using AttributeDescriptions = std::array<VkVertexInputAttributeDescription, 5>;
+using AttributeDescriptions = std::vector<VkVertexInputAttributeDescription>;
 
 class Vertex {
   glm::vec3 pos{};
   glm::vec4 color{};
   glm::vec3 normal{};
   glm::vec3 tangent{};
-  glm::vec3 texCoord{};
+  glm::vec2 texCoord{};
 
  public:
   Vertex(const glm::vec3& pos, const glm::vec4& color, const glm::vec3& normal,
-         const glm::vec3& tangent, const glm::vec3& texCoord)
+         const glm::vec3& tangent, const glm::vec2& texCoord)
       : pos(pos),
         color(color),
         normal(normal),
@@ -59,7 +62,25 @@ class Vertex {
       return posHash ^ colorHash ^ normalHash ^ tangentHash ^ texHash;
     }
   };
+};
+
+// GPU layout of the vertices of a VertexFormat. Attributes keep their shader
+// locations in every format, the vertex shaders declare matching inputs from
+// the definitions and decode them in DecodeVertexInput. The full format is
+// the byte layout of Vertex.
+class VertexLayout {
+ public:
+  static uint32_t GetStride(uint32_t format);
+  static VkVertexInputBindingDescription GetBindingDescription(
+      uint32_t format);
+  static AttributeDescriptions GetAttributeDescriptions(uint32_t format);
+  static std::vector<std::pair<std::string, std::string>> GetDefinitions(
+      uint32_t format);
 
-  static VkVertexInputBindingDescription GetBindingDescription();
-  static AttributeDescriptions GetAttributeDescriptions();
+  static std::vector<uint8_t> Encode(uint32_t format,
+                                     const std::vector<VertexData>& vertices,
+                                     const VertexDequantData& dequant);
+  // Writes GetStride(format) * vertices.size() bytes to dst
+  static void Encode(uint32_t format, const std::vector<VertexData>& vertices,
+                     const VertexDequantData& dequant, uint8_t* dst);
 };
@@ -1,11 +1,15 @@
 #pragma once
 
 #include <Engine/System/include/GraphicsInterface.h>
+#include <Engine/Utility/include/FileWatcher.h>
+#include <Engine/Utility/include/MPSCQueue.h>
+#include <Engine/Utility/include/StringIdUtils.h>
 #include <GLFW/glfw3.h>
 
 #include <atomic>
+#include <chrono>
 #include <mutex>
-#include <queue>
+#include <thread>
 
 #include "depth.h"
 #include "device.h"
@@ -29,12 +33,16 @@ class Vulkan final : public GraphicsInterface, public Base {
 
   BufferManager bufferManager;
   Application* appPointer = nullptr;
-  std::unordered_map<std::string, Draw*> drawsByShader;
+  std::unordered_map<StringId, Draw*> drawsByShader;
   std::unordered_map<int, Draw*> drawsByPipeline;
 
-  std::mutex updateMeshDataMutex;
-  std::atomic<bool> needToUpdateMeshDatas = false;
-  std::queue<std::weak_ptr<MeshData>> meshDataQueue;
+  MPSCQueue<std::weak_ptr<MeshData>> meshDataQueue{
+      VulkanConfig::MAX_PENDING_MESHES};
+
+  std::thread gameThread;
+  std::atomic<std::chrono::steady_clock::time_point> lastGameTickTime;
+
+  FileWatcher hotReloadWatcher;
 
  public:
   template <typename... Args>
@@ -50,9 +58,19 @@ class Vulkan final : public GraphicsInterface, public Base {
   void GameLoop() override;
   void RenderLoop() override;
 
+  void TickGame();
+  void RunFixedGameLoop();
+  void RunVariableGameLoop();
+  void PaceGameLoop(std::chrono::steady_clock::time_point until);
+  void UpdateRenderTransforms();
+
   void GetAppPointer();
   void ReleaseBufferLocks();
 
+  void StartHotReload();
+  void ProcessHotReload();
+  void RebuildPipelines(const std::unordered_map<Draw*, uint32_t>& variants);
+
   void UpdateGameDeltaTime();
   void UpdateRenderDeltaTime();
 
@@ -65,19 +83,22 @@ class Vulkan final : public GraphicsInterface, public Base {
   BufferManager& GetBufferManager() { return bufferManager; }
   float GetViewportAspect() override;
 
+  void LoadMeshToDraw(std::shared_ptr<MeshData> mesh);
   void ParseMeshData() override;
   void ParseMeshData(std::weak_ptr<MeshData> meshData) override;
+  std::unique_ptr<MeshStaging> AllocateMeshStaging(uint32_t vertexFormat,
+                                                   size_t vertexCount,
+                                                   size_t indexCount) override;
 
   virtual void OnCreate() override {
     GraphicsInterface::OnCreate();
     RegisterMember(device, window, render, instance, validation);
   }
   virtual void OnStart() override { GraphicsInterface::OnStart(); }
-  virtual void OnUpdate() override { GraphicsInterface::OnUpdate(); }
   virtual void OnStop() override { GraphicsInterface::OnStop(); }
   virtual void OnDestroy() override { GraphicsInterface::OnDestroy(); }
 
-  void RemoveDrawByShader(const std::string& shader) {
+  void RemoveDrawByShader(const StringId shader) {
     drawsByShader.erase(shader);
   }
   void RemoveDrawByPipeline(const int id) { drawsByPipeline.erase(id); }
@@ -85,12 +106,14 @@ class Vulkan final : public GraphicsInterface, public Base {
 
  private:
   const float oneSecondTime = 1;
+  const milliseconds paceYieldMargin = milliseconds(1);
+  const milliseconds hotReloadPollInterval = milliseconds(250);
 
   // Config
   void InitConfig();
 
  public:
-  std::weak_ptr<LightChannel> GetLightChannelByName(const std::string& name);
+  std::weak_ptr<LightChannel> GetLightChannelByName(StringId name);
 
   virtual bool GetEnableEditor();
   virtual GLFWwindow* GetParentWindow();
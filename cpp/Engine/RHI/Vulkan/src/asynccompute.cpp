@@ -0,0 +1,182 @@
+#include "../include/asynccompute.h"
+
+#include <Engine/Utility/include/TypeUtils.h>
+
+#include "../include/device.h"
+
+void AsyncCompute::CreateAsyncCompute(const Device& device,
+                                      const uint32_t framesInFlight) {
+  queue = device.GetComputeQueue();
+  family = device.GetComputeFamily();
+  graphicsFamily = device.GetGraphicsFamily();
+
+  const VkCommandPoolCreateInfo poolInfo{
+      .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+      .flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
+      .queueFamilyIndex = family,
+  };
+  if (vkCreateCommandPool(device.GetLogical(), &poolInfo, nullptr,
+                          &commandPool) != VK_SUCCESS) {
+    PRINT_AND_THROW_ERROR("failed to create compute command pool!");
+  }
+
+  commandBuffers.resize(framesInFlight);
+  frameValues.assign(framesInFlight, 0);
+  const VkCommandBufferAllocateInfo allocInfo{
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+      .commandPool = commandPool,
+      .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
+      .commandBufferCount = framesInFlight,
+  };
+  if (vkAllocateCommandBuffers(device.GetLogical(), &allocInfo,
+                               commandBuffers.data()) != VK_SUCCESS) {
+    PRINT_AND_THROW_ERROR("failed to allocate compute command buffers!");
+  }
+
+  const VkSemaphoreTypeCreateInfo typeInfo{
+      .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+      .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+      .initialValue = 0,
+  };
+  const VkSemaphoreCreateInfo semaphoreInfo{
+      .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+      .pNext = &typeInfo,
+  };
+  if (vkCreateSemaphore(device.GetLogical(), &semaphoreInfo, nullptr,
+                        &graphicsTimeline) != VK_SUCCESS ||
+      vkCreateSemaphore(device.GetLogical(), &semaphoreInfo, nullptr,
+                        &computeTimeline) != VK_SUCCESS) {
+    PRINT_AND_THROW_ERROR("failed to create timeline semaphores!");
+  }
+  graphicsValue = 0;
+  computeValue = 0;
+}
+
+void AsyncCompute::DestroyAsyncCompute(const VkDevice& device) {
+  if (commandPool == VK_NULL_HANDLE) {
+    return;
+  }
+  vkDestroySemaphore(device, graphicsTimeline, nullptr);
+  vkDestroySemaphore(device, computeTimeline, nullptr);
+  vkDestroyCommandPool(device, commandPool, nullptr);
+  commandBuffers.clear();
+  frameValues.clear();
+  commandPool = VK_NULL_HANDLE;
+}
+
+TimelinePoint AsyncCompute::SignalGraphics() {
+  return {graphicsTimeline, ++graphicsValue};
+}
+
+VkCommandBuffer AsyncCompute::BeginCommandBuffer(const VkDevice& device,
+                                                 const uint32_t frame) {
+  Wait(device, {computeTimeline, frameValues[frame]});
+  const VkCommandBuffer commandBuffer = commandBuffers[frame];
+  vkResetCommandBuffer(commandBuffer, 0);
+
+  constexpr VkCommandBufferBeginInfo beginInfo{
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+  };
+  if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
+    PRINT_AND_THROW_ERROR("failed to begin recording command buffer!");
+  }
+  return commandBuffer;
+}
+
+TimelinePoint AsyncCompute::Submit(const uint32_t frame,
+                                   const TimelinePoint& wait) {
+  if (vkEndCommandBuffer(commandBuffers[frame]) != VK_SUCCESS) {
+    PRINT_AND_THROW_ERROR("failed to record command buffer!");
+  }
+  frameValues[frame] = ++computeValue;
+
+  const uint32_t waitCount = wait.semaphore != VK_NULL_HANDLE ? 1 : 0;
+  const VkTimelineSemaphoreSubmitInfo timelineInfo{
+      .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+      .waitSemaphoreValueCount = waitCount,
+      .pWaitSemaphoreValues = &wait.value,
+      .signalSemaphoreValueCount = 1,
+      .pSignalSemaphoreValues = &frameValues[frame],
+  };
+  const VkSubmitInfo submitInfo{
+      .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+      .pNext = &timelineInfo,
+      .waitSemaphoreCount = waitCount,
+      .pWaitSemaphores = &wait.semaphore,
+      .pWaitDstStageMask = &wait.stages,
+      .commandBufferCount = 1,
+      .pCommandBuffers = &commandBuffers[frame],
+      .signalSemaphoreCount = 1,
+      .pSignalSemaphores = &computeTimeline,
+  };
+  if (vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+    PRINT_AND_THROW_ERROR("failed to submit compute command buffer!");
+  }
+  return {computeTimeline, computeValue};
+}
+
+void AsyncCompute::Wait(const VkDevice& device,
+                        const TimelinePoint& point) const {
+  const VkSemaphoreWaitInfo waitInfo{
+      .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+      .semaphoreCount = 1,
+      .pSemaphores = &point.semaphore,
+      .pValues = &point.value,
+  };
+  vkWaitSemaphores(device, &waitInfo, UINT64_MAX);
+}
+
+void AsyncCompute::RecordTransfer(VkCommandBuffer commandBuffer,
+                                  const QueueImageTransfer& transfer,
+                                  const QueueType from,
+                                  const bool acquire) const {
+  // A queue family owning the image on both sides has nothing to hand over
+  if (GetSeparateQueue() == false) {
+    return;
+  }
+  const bool fromGraphics = from == QueueType::Graphics;
+  const VkPipelineStageFlags srcStages =
+      fromGraphics ? transfer.graphicsStages : transfer.computeStages;
+  const VkPipelineStageFlags dstStages =
+      fromGraphics ? transfer.computeStages : transfer.graphicsStages;
+  const VkAccessFlags srcAccesses =
+      fromGraphics ? transfer.graphicsAccesses : transfer.computeAccesses;
+  const VkAccessFlags dstAccesses =
+      fromGraphics ? transfer.computeAccesses : transfer.graphicsAccesses;
+
+  // The release makes the writes of the giving queue available, the acquire
+  // makes them visible to the taking one, which waited on the timeline at
+  // dstStages before it
+  const VkImageMemoryBarrier barrier{
+      .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+      .srcAccessMask = acquire ? 0 : srcAccesses,
+      .dstAccessMask = acquire ? dstAccesses : 0,
+      .oldLayout = transfer.layout,
+      .newLayout = transfer.layout,
+      .srcQueueFamilyIndex = fromGraphics ? graphicsFamily : family,
+      .dstQueueFamilyIndex = fromGraphics ? family : graphicsFamily,
+      .image = transfer.image,
+      .subresourceRange = {transfer.aspects, 0, VK_REMAINING_MIP_LEVELS, 0,
+                           VK_REMAINING_ARRAY_LAYERS},
+  };
+  vkCmdPipelineBarrier(
+      commandBuffer, acquire ? dstStages : srcStages,
+      acquire ? dstStages : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0,
+      nullptr, 0, nullptr, 1, &barrier);
+}
+
+void AsyncCompute::RecordRelease(VkCommandBuffer commandBuffer,
+                                 const QueueImageTransfer& transfer,
+                                 const QueueType from) const {
+  RecordTransfer(commandBuffer, transfer, from, false);
+}
+
+void AsyncCompute::RecordAcquire(VkCommandBuffer commandBuffer,
+                                 const QueueImageTransfer& transfer,
+                                 const QueueType to) const {
+  RecordTransfer(commandBuffer, transfer,
+                 to == QueueType::Graphics ? QueueType::Compute
+                                           : QueueType::Graphics,
+                 true);
+}
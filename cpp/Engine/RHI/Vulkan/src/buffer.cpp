@@ -4,13 +4,36 @@
 #include <Engine/Light/include/LightChannel.h>
 #include <Engine/Model/include/BaseMaterial.h>
 
+#include <algorithm>
 #include <stdexcept>
 
 #include "../include/device.h"
 #include "../include/pipeline.h"
 #include "../include/render.h"
+#include "../include/staging.h"
 #include "../include/uniform.h"
 
+VkIndexType DataBuffer::IndexType(const size_t vertexCount) {
+  return vertexCount <= (1 << 16) ? VK_INDEX_TYPE_UINT16
+                                  : VK_INDEX_TYPE_UINT32;
+}
+
+uint32_t DataBuffer::IndexSize(const VkIndexType type) {
+  return type == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+}
+
+void DataBuffer::WriteIndices(const std::vector<uint32_t>& indices,
+                              const VkIndexType type, void* dst) {
+  if (type == VK_INDEX_TYPE_UINT32) {
+    memcpy(dst, indices.data(), indices.size() * sizeof(uint32_t));
+    return;
+  }
+  uint16_t* shortIndices = static_cast<uint16_t*>(dst);
+  for (const uint32_t index : indices) {
+    *shortIndices++ = static_cast<uint16_t>(index);
+  }
+}
+
 uint32_t DataBuffer::MemoryType(const VkPhysicalDevice& physicalDevice,
                                 const glm::uint32_t& typeFilter,
                                 const VkMemoryPropertyFlags& properties) {
@@ -58,10 +81,9 @@ void DataBuffer::CreateBuffer(const Device& device, const VkDeviceSize& size,
 }
 
 void DataBuffer::CreateVertexBuffer(const Device& device,
-                                    const std::vector<Vertex>& vertices,
-                                    const Render& render) {
-  const auto bufferSize =
-      vertices.empty() ? 0 : sizeof(vertices[0]) * vertices.size();
+                                    const std::vector<uint8_t>& vertices,
+                                    UploadBatch& batch) {
+  const VkDeviceSize bufferSize = vertices.size();
 
   VkBuffer stagingBuffer;
   VkDeviceMemory stagingBufferMemory;
@@ -69,6 +91,7 @@ void DataBuffer::CreateVertexBuffer(const Device& device,
                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
                stagingBuffer, stagingBufferMemory);
+  batch.stagingBuffers.emplace_back(stagingBuffer, stagingBufferMemory);
 
   void* vertexData;
   vkMapMemory(device.GetLogical(), stagingBufferMemory, 0, bufferSize, 0,
@@ -76,21 +99,17 @@ void DataBuffer::CreateVertexBuffer(const Device& device,
   memcpy(vertexData, vertices.data(), bufferSize);
   vkUnmapMemory(device.GetLogical(), stagingBufferMemory);
 
-  CreateBuffer(
-      device, bufferSize,
-      VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
-      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vertexBuffer, vertexBufferMemory);
-  render.CopyCommandBuffer(device, stagingBuffer, vertexBuffer, bufferSize);
-
-  vkDestroyBuffer(device.GetLogical(), stagingBuffer, nullptr);
-  vkFreeMemory(device.GetLogical(), stagingBufferMemory, nullptr);
+  CreateDeviceBuffer(device, stagingBuffer, 0, bufferSize,
+                     VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, vertexBuffer,
+                     vertexBufferMemory, batch);
 }
 
 void DataBuffer::CreateIndexBuffer(const Device& device,
                                    const std::vector<uint32_t>& indices,
-                                   const Render& render) {
-  const auto bufferSize =
-      indices.empty() ? 0 : sizeof(indices[0]) * indices.size();
+                                   UploadBatch& batch) {
+  indexType = IndexType(
+      indices.empty() ? 0 : size_t{*std::ranges::max_element(indices)} + 1);
+  const VkDeviceSize bufferSize = IndexSize(indexType) * indices.size();
 
   VkBuffer stagingBuffer;
   VkDeviceMemory stagingBufferMemory;
@@ -98,30 +117,51 @@ void DataBuffer::CreateIndexBuffer(const Device& device,
                VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
                stagingBuffer, stagingBufferMemory);
+  batch.stagingBuffers.emplace_back(stagingBuffer, stagingBufferMemory);
 
   void* indexData;
   vkMapMemory(device.GetLogical(), stagingBufferMemory, 0, bufferSize, 0,
               &indexData);
-  memcpy(indexData, indices.data(), bufferSize);
+  WriteIndices(indices, indexType, indexData);
   vkUnmapMemory(device.GetLogical(), stagingBufferMemory);
 
-  CreateBuffer(
-      device, bufferSize,
-      VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
-      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, indexBuffer, indexBufferMemory);
+  CreateDeviceBuffer(device, stagingBuffer, 0, bufferSize,
+                     VK_BUFFER_USAGE_INDEX_BUFFER_BIT, indexBuffer,
+                     indexBufferMemory, batch);
+}
 
-  render.CopyCommandBuffer(device, stagingBuffer, indexBuffer, bufferSize);
+void DataBuffer::CreateDeviceBuffer(
+    const Device& device, const VkBuffer& source, const VkDeviceSize& offset,
+    const VkDeviceSize& size, const VkBufferUsageFlags& usage, VkBuffer& buffer,
+    VkDeviceMemory& bufferMemory, UploadBatch& batch) {
+  CreateBuffer(device, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage,
+               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, buffer, bufferMemory);
 
-  vkDestroyBuffer(device.GetLogical(), stagingBuffer, nullptr);
-  vkFreeMemory(device.GetLogical(), stagingBufferMemory, nullptr);
+  const VkBufferCopy copyRegion{
+      .srcOffset = offset,
+      .size = size,
+  };
+  vkCmdCopyBuffer(batch.commandBuffer, source, buffer, 1, &copyRegion);
 }
 
 void DataBuffer::CreateBuffers(const Device& device,
-                               const std::vector<Vertex>& vertices,
+                               const std::vector<uint8_t>& vertices,
                                const std::vector<uint32_t>& indices,
-                               const Render& render) {
-  CreateVertexBuffer(device, vertices, render);
-  CreateIndexBuffer(device, indices, render);
+                               UploadBatch& batch) {
+  CreateVertexBuffer(device, vertices, batch);
+  CreateIndexBuffer(device, indices, batch);
+}
+
+void DataBuffer::CreateBuffers(const Device& device,
+                               const MeshStagingTicket& staging,
+                               UploadBatch& batch) {
+  indexType = staging.GetIndexType();
+  CreateDeviceBuffer(device, staging.GetBuffer(), staging.GetVertexOffset(),
+                     staging.GetVertexSize(), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                     vertexBuffer, vertexBufferMemory, batch);
+  CreateDeviceBuffer(device, staging.GetBuffer(), staging.GetIndexOffset(),
+                     staging.GetIndexSize(), VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                     indexBuffer, indexBufferMemory, batch);
 }
 
 void DataBuffer::DestroyBuffers(const VkDevice& device) const {
@@ -6,7 +6,8 @@
 #include "Engine/RHI/Vulkan/include/utils.h"
 
 void Data::CreateData(const std::vector<uint32_t>& inIndices,
-                      const std::vector<Vertex>& inVertices) {
+                      std::vector<uint8_t>&& inVertices) {
   indices = inIndices;
-  vertices = inVertices;
+  vertices = std::move(inVertices);
+  indexCount = static_cast<uint32_t>(indices.size());
 }
@@ -45,6 +45,28 @@ QueueFamilyIndices FindQueueFamilies(const VkPhysicalDevice& device,
   return indices;
 }
 
+/**
+ * 查找某一设备的计算队列族，优先选择不支持图形的队列族，
+ * 使计算与光栅化并行，找不到时退回到图形队列族
+ */
+uint32_t FindComputeFamily(const VkPhysicalDevice& device,
+                           const uint32_t graphicsFamily) {
+  uint32_t queueFamilyCount = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, nullptr);
+  QueueFamilyProps queueFamilies(queueFamilyCount);
+  vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount,
+                                           queueFamilies.data());
+
+  for (uint32_t i = 0; i < queueFamilyCount; i++) {
+    const VkQueueFlags queueFlags = queueFamilies[i].queueFlags;
+    if ((queueFlags & VK_QUEUE_COMPUTE_BIT) &&
+        (queueFlags & VK_QUEUE_GRAPHICS_BIT) == 0) {
+      return i;
+    }
+  }
+  return graphicsFamily;
+}
+
 /**
  * 检查某一设备是否支持所需的插件
  */
@@ -159,6 +181,38 @@ uint32_t Device::GetMinUniformBufferOffsetAlignment() {
   return properties.limits.minUniformBufferOffsetAlignment;
 }
 
+bool Device::QueryTimelineSemaphoreSupport() const {
+  // Vulkan 1.2 features can only be queried from 1.2 devices
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+  if (properties.apiVersion < VK_API_VERSION_1_2) {
+    return false;
+  }
+  VkPhysicalDeviceVulkan12Features vulkan12Features{
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+  };
+  VkPhysicalDeviceFeatures2 features{
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2,
+      .pNext = &vulkan12Features,
+  };
+  vkGetPhysicalDeviceFeatures2(physicalDevice, &features);
+  return vulkan12Features.timelineSemaphore == VK_TRUE;
+}
+
+void Device::QueryTimestampSupport() {
+  VkPhysicalDeviceProperties properties;
+  vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+  timestampPeriod = properties.limits.timestampPeriod;
+
+  uint32_t queueFamilyCount = 0;
+  vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount,
+                                           nullptr);
+  DeviceCheck::QueueFamilyProps queueFamilies(queueFamilyCount);
+  vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount,
+                                           queueFamilies.data());
+  timestampValidBits = queueFamilies[graphicsFamily].timestampValidBits;
+}
+
 uint32_t Device::GetMultiSampleNum() const { return msaaSamplesNum; }
 uint32_t Device::GetMinUBOOffsetAlignment() const {
   return minUBOOffsetAlignment;
@@ -181,6 +235,7 @@ void Device::PickPhysicalDevice(const VkInstance& instance,
       msaaSamples = GetMaxUsableSampleCount(
           static_cast<Vulkan*>(owner)->GetMSAASamples());
       minUBOOffsetAlignment = GetMinUniformBufferOffsetAlignment();
+      timelineSemaphoreSupport = QueryTimelineSemaphoreSupport();
       break;
     }
   }
@@ -202,8 +257,11 @@ void Device::CreateLogicalDevice(const VkSurfaceKHR& surface,
       DeviceCheck::FindQueueFamilies(physicalDevice, surface);
   graphicsFamily = _graphicsFamily.has_value() ? _graphicsFamily.value() : 0;
   presentFamily = _presentFamily.has_value() ? _presentFamily.value() : 0;
+  computeFamily =
+      DeviceCheck::FindComputeFamily(physicalDevice, graphicsFamily);
 
-  for (const std::set uniqueQueueFamilies = {graphicsFamily, presentFamily};
+  for (const std::set uniqueQueueFamilies = {graphicsFamily, presentFamily,
+                                             computeFamily};
        const auto queueFamily : uniqueQueueFamilies) {
     queueCreateInfos.push_back({
         .sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO,
@@ -213,8 +271,15 @@ void Device::CreateLogicalDevice(const VkSurfaceKHR& surface,
     });
   }
   VkPhysicalDeviceFeatures deviceFeatures{.samplerAnisotropy = VK_TRUE};
+  // The graphics and compute queues wait on each other's timelines, without
+  // them async compute is left off
+  VkPhysicalDeviceVulkan12Features vulkan12Features{
+      .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES,
+      .timelineSemaphore = VK_TRUE,
+  };
   VkDeviceCreateInfo createInfo{
       .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+      .pNext = timelineSemaphoreSupport ? &vulkan12Features : nullptr,
       .queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size()),
       .pQueueCreateInfos = queueCreateInfos.data(),
       .enabledExtensionCount =
@@ -236,4 +301,6 @@ void Device::CreateLogicalDevice(const VkSurfaceKHR& surface,
   }
   vkGetDeviceQueue(logicalDevice, graphicsFamily, 0, &graphicsQueue);
   vkGetDeviceQueue(logicalDevice, presentFamily, 0, &presentQueue);
+  vkGetDeviceQueue(logicalDevice, computeFamily, 0, &computeQueue);
+  QueryTimestampSupport();
 }
@@ -17,7 +17,7 @@ void Draw::CreateDeferredDescriptorPool(const VkDevice& device,
                          .descriptorCount = static_cast<uint32_t>(
                              render.GetMaxFramesInFlight())});
   }
-  for (uint32_t i = 0; i < GBUFFER_SIZE; i++) {
+  for (uint32_t i = 0; i < render.GetGBufferInputSize(); i++) {
     poolSizes.push_back({.type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,
                          .descriptorCount = static_cast<uint32_t>(
                              render.GetMaxFramesInFlight())});
@@ -28,6 +28,11 @@ void Draw::CreateDeferredDescriptorPool(const VkDevice& device,
          .descriptorCount = static_cast<uint32_t>(
              render.GetMaxFramesInFlight() * render.GetShadowMapDepthNum())});
   }
+  if (render.GetEnableTileClassification()) {
+    poolSizes.push_back({.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+                         .descriptorCount = static_cast<uint32_t>(
+                             render.GetMaxFramesInFlight())});
+  }
   VkDescriptorPoolCreateInfo poolInfo{
       .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
       .maxSets = static_cast<uint32_t>(render.GetMaxFramesInFlight()),
@@ -94,14 +99,10 @@ void Draw::CreateDeferredDescriptorSets(const Device& device, Render& render) {
     //  Do not merge the loops because `push_back` would move the memory to
     //  another location
     std::vector<VkDescriptorImageInfo> gBufferImageInfos;
-    for (uint32_t j = 0; j < GBUFFER_SIZE; j++) {
-      gBufferImageInfos.push_back({
-          .sampler = VK_NULL_HANDLE,
-          .imageView = render.GetGBufferImageViewByIndex(j),
-          .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-      });
+    for (uint32_t j = 0; j < render.GetGBufferInputSize(); j++) {
+      gBufferImageInfos.push_back(render.GetGBufferInputInfoByIndex(j));
     }
-    for (uint32_t j = 0; j < GBUFFER_SIZE; j++) {
+    for (uint32_t j = 0; j < render.GetGBufferInputSize(); j++) {
       descriptorWrites.push_back({
           .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
           .dstSet = deferredDescriptorSets[i],
@@ -135,6 +136,20 @@ void Draw::CreateDeferredDescriptorSets(const Device& device, Render& render) {
           .pImageInfo = shadowMapImageInfos.data(),
       });
     }
+
+    const VkDescriptorBufferInfo tileBufferInfo =
+        render.GetLightingTileBufferInfo();
+    if (render.GetEnableTileClassification()) {
+      descriptorWrites.push_back({
+          .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+          .dstSet = deferredDescriptorSets[i],
+          .dstBinding = static_cast<uint32_t>(descriptorWrites.size()),
+          .dstArrayElement = 0,
+          .descriptorCount = 1,
+          .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+          .pBufferInfo = &tileBufferInfo,
+      });
+    }
     vkUpdateDescriptorSets(device.GetLogical(),
                            static_cast<uint32_t>(descriptorWrites.size()),
                            descriptorWrites.data(), 0, nullptr);
@@ -159,7 +174,7 @@ void Draw::UpdateDeferredShadowMapDescriptorSets(const VkDevice& device,
     descriptorWrite = {
         .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
         .dstSet = deferredDescriptorSets[i],
-        .dstBinding = 2 + GBUFFER_SIZE,
+        .dstBinding = 2 + render.GetGBufferInputSize(),
         .dstArrayElement = 0,
         .descriptorCount = shadowMapDepthNum,
         .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
@@ -174,14 +189,10 @@ void Draw::UpdateDeferredGBufferDescriptorSets(const VkDevice& device,
   for (auto i = 0; i < render.GetMaxFramesInFlight(); i++) {
     std::vector<VkWriteDescriptorSet> descriptorWrites;
     std::vector<VkDescriptorImageInfo> gBufferImageInfos;
-    for (uint32_t j = 0; j < GBUFFER_SIZE; j++) {
-      gBufferImageInfos.push_back({
-          .sampler = VK_NULL_HANDLE,
-          .imageView = render.GetGBufferImageViewByIndex(j),
-          .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-      });
+    for (uint32_t j = 0; j < render.GetGBufferInputSize(); j++) {
+      gBufferImageInfos.push_back(render.GetGBufferInputInfoByIndex(j));
     }
-    for (uint32_t j = 0; j < GBUFFER_SIZE; j++) {
+    for (uint32_t j = 0; j < render.GetGBufferInputSize(); j++) {
       descriptorWrites.push_back({
           .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
           .dstSet = deferredDescriptorSets[i],
@@ -192,6 +203,21 @@ void Draw::UpdateDeferredGBufferDescriptorSets(const VkDevice& device,
           .pImageInfo = &gBufferImageInfos[j],
       });
     }
+    // The tile buffer is recreated with the G-buffer
+    const VkDescriptorBufferInfo tileBufferInfo =
+        render.GetLightingTileBufferInfo();
+    if (render.GetEnableTileClassification()) {
+      descriptorWrites.push_back({
+          .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+          .dstSet = deferredDescriptorSets[i],
+          .dstBinding = 2 + render.GetGBufferInputSize() +
+                        (render.GetEnableShadowMap() ? 1 : 0),
+          .dstArrayElement = 0,
+          .descriptorCount = 1,
+          .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+          .pBufferInfo = &tileBufferInfo,
+      });
+    }
     vkUpdateDescriptorSets(device,
                            static_cast<uint32_t>(descriptorWrites.size()),
                            descriptorWrites.data(), 0, nullptr);
@@ -200,16 +226,29 @@ void Draw::UpdateDeferredGBufferDescriptorSets(const VkDevice& device,
 
 void Draw::CreateDrawResource(const Device& device, Render& render,
                               const std::string& rootPath, const int texCount,
+                              const uint32_t vertexFormat,
                               const std::vector<std::string>& shaderPaths,
                               const std::string& zPrePassShaderPath,
                               const std::string& shadowMapShaderPath) {
+  this->vertexFormat = vertexFormat;
   shader.AddDefinitions({{"MaxLightNum", std::to_string(MaxLightNum)}});
+  shader.AddDefinitions(VertexLayout::GetDefinitions(vertexFormat));
   if (static_cast<Vulkan*>(owner)->GetEnableShadowMap()) {
     shader.AddDefinitions({{"EnableShadowMap", std::to_string(1)}});
   }
   if (static_cast<Vulkan*>(owner)->GetEnableDeferred()) {
     shader.AddDefinitions({{"EnableDeferred", std::to_string(1)}});
   }
+  if (render.GetEnableCompactGBuffer()) {
+    shader.AddDefinitions({{"EnableCompactGBuffer", std::to_string(1)}});
+  }
+  if (render.GetEnableTileClassification()) {
+    shader.AddDefinitions(
+        {{"EnableTileClassification", std::to_string(1)},
+         {"MaxPipelineNum", std::to_string(MaxPipelineNum)},
+         {"LightingTileSize",
+          std::to_string(VulkanConfig::LIGHTING_TILE_SIZE)}});
+  }
   if (device.GetMSAASamples() != VK_SAMPLE_COUNT_1_BIT) {
     shader.AddDefinitions(
         {{"EnableMultiSample", std::to_string(device.GetMultiSampleNum())}});
@@ -223,13 +262,18 @@ void Draw::CreateDrawResource(const Device& device, Render& render,
   shader.SetOptimizationLevel(ShaderOptimizationLevel);
   shader.SetGenerateDebugInfo(
       static_cast<Vulkan*>(owner)->GetEnableShaderDebug());
-  pipeline.CreatePipeline(device, render, shader, texCount, rootPath,
-                          shaderPaths, zPrePassShaderPath, shadowMapShaderPath);
+  pipeline.CreatePipeline(device, render, shader, texCount, vertexFormat,
+                          rootPath, shaderPaths, zPrePassShaderPath,
+                          shadowMapShaderPath);
+  this->rootPath = rootPath;
+  this->zPrePassShaderPath = zPrePassShaderPath;
+  this->shadowMapShaderPath = shadowMapShaderPath;
 
   if (render.GetEnableDeferred()) {
     CreateDeferredDescriptorPool(device.GetLogical(), render);
-    if (auto allLightsChannelPtr =
-            static_cast<Vulkan*>(owner)->GetLightChannelByName("All").lock()) {
+    if (auto allLightsChannelPtr = static_cast<Vulkan*>(owner)
+                                       ->GetLightChannelByName("All"_sid)
+                                       .lock()) {
       allLightsChannelPointer = allLightsChannelPtr.get();
       allLightsChannelBufferPointer =
           &GetBufferManager().CreateLightChannelBuffer(allLightsChannelPointer,
@@ -242,16 +286,29 @@ void Draw::CreateDrawResource(const Device& device, Render& render,
 
 void Draw::LoadDrawResource(const Device& device, Render& render,
                             std::weak_ptr<MeshData> data) {
-  Mesh* mesh =
+  pendingMeshes.emplace_back(
       Create<Mesh>(device, render, data, pipeline.GetColorDescriptorSetLayout(),
                    pipeline.GetZPrePassDescriptorSetLayout(),
-                   pipeline.GetShadowMapDescriptorSetLayout());
-  if (mesh->GetCreateInterrupted()) {
-    mesh->DestroyMesh(device.GetLogical(), render);
-    mesh->Destroy();
-    return;
+                   pipeline.GetShadowMapDescriptorSetLayout()));
+}
+
+void Draw::PromoteCreatedMeshes(const VkDevice& device, const Render& render) {
+  auto meshIter = pendingMeshes.begin();
+  while (meshIter != pendingMeshes.end()) {
+    Mesh* mesh = *meshIter;
+    if (mesh->GetCreateFinished() == false) {
+      meshIter++;
+      continue;
+    }
+    meshIter = pendingMeshes.erase(meshIter);
+    mesh->FinishCreate();
+    if (mesh->GetCreateInterrupted()) {
+      mesh->DestroyMesh(device, render);
+      mesh->Destroy();
+    } else {
+      meshes.emplace_back(mesh);
+    }
   }
-  meshes.emplace_back(mesh);
 }
 
 void Draw::DestroyDrawResource(const VkDevice& device, const Render& render) {
@@ -263,19 +320,34 @@ void Draw::DestroyDrawResource(const VkDevice& device, const Render& render) {
   }
 
   pipeline.DestroyPipeline(device, render);
+  // Pending meshes have finished, uploads are flushed before cleanup
+  PromoteCreatedMeshes(device, render);
   for (Mesh* mesh : meshes) {
     mesh->DestroyMesh(device, render);
     mesh->Destroy();
   }
 }
 
+GraphicsPipelines Draw::RebuildPipelines(const Device& device, Render& render,
+                                         const uint32_t variants) {
+  return pipeline.RebuildGraphicsPipelines(
+      device, render, shader, variants, rootPath, shader.GetShaderPath(),
+      zPrePassShaderPath, shadowMapShaderPath);
+}
+
+void Draw::SwapPipelines(const VkDevice& device,
+                         const GraphicsPipelines& pipelines) {
+  pipeline.SwapGraphicsPipelines(device, pipelines);
+}
+
 void Draw::Destroy() {
-  static_cast<Vulkan*>(owner)->RemoveDrawByShader(shader.GetShaderPath());
+  static_cast<Vulkan*>(owner)->RemoveDrawByShader(drawKey);
   static_cast<Vulkan*>(owner)->RemoveDrawByPipeline(pipeline.GetPipelineId());
   Base::Destroy();
 }
 void Draw::SetShaderPath(const std::string& shaderPath) {
   shader.SetShaderPath(shaderPath);
+  drawKey = GetDrawKey(StringIdUtils::Intern(shaderPath), vertexFormat);
 }
 void Draw::SetPipelineId(const Render& render, const int pipelineId) {
   pipeline.SetPipelineId(pipelineId);
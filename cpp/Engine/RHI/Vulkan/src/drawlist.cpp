@@ -0,0 +1,124 @@
+#include "../include/drawlist.h"
+
+#include <Engine/Utility/include/SortUtils.h>
+
+#include <algorithm>
+#include <bit>
+#include <ranges>
+
+#include "../include/draw.h"
+#include "../include/mesh.h"
+
+namespace {
+constexpr uint64_t PipelineMask = (1ull << 12) - 1;
+constexpr uint64_t MaterialMask = (1ull << 20) - 1;
+
+uint64_t PassKey(const DrawPass pass) {
+  return static_cast<uint64_t>(pass) << 62;
+}
+
+// Non negative floats order like their bits, the two lowest mantissa bits
+// are dropped to fit
+uint64_t DepthKey(const float depth) {
+  return std::bit_cast<uint32_t>(std::max(depth, 0.0f)) >> 2;
+}
+}  // namespace
+
+void DrawList::Build(std::unordered_map<StringId, Draw*>& draws,
+                     const uint32_t currentFrame, const bool zPrePass,
+                     const bool shadowMap) {
+  items.clear();
+  std::unordered_map<const BaseMaterial*, uint64_t> materialIds;
+  uint64_t pipelineId = 0;
+  for (Draw* draw : draws | std::views::values) {
+    const uint64_t pipeline = std::min(pipelineId++, PipelineMask);
+    for (Mesh* mesh : draw->GetMeshes()) {
+      const uint64_t depth = DepthKey(mesh->GetViewDepth(currentFrame));
+      uint64_t material = 0;
+      if (const BaseMaterial* materialPointer = mesh->GetMaterial()) {
+        material = materialIds.try_emplace(materialPointer, materialIds.size())
+                       .first->second;
+      }
+      items.push_back({PassKey(DrawPass::Color) | pipeline << 50 |
+                           std::min(material, MaterialMask) << 30 | depth,
+                       draw, mesh});
+      if (zPrePass) {
+        items.push_back({PassKey(DrawPass::ZPrePass) | depth << 32 |
+                             pipeline << 20,
+                         draw, mesh});
+      }
+      if (shadowMap) {
+        items.push_back(
+            {PassKey(DrawPass::ShadowMap) | pipeline << 50, draw, mesh});
+      }
+    }
+  }
+  SortUtils::RadixSort(items, scratch,
+                       [](const DrawItem& item) { return item.key; });
+
+  size_t offset = 0;
+  for (uint64_t pass = 0; pass < passOffsets.size(); pass++) {
+    while (offset < items.size() && items[offset].key >> 62 < pass) {
+      offset++;
+    }
+    passOffsets[pass] = offset;
+  }
+}
+
+std::span<const DrawItem> DrawList::GetPass(const DrawPass pass) const {
+  const auto index = static_cast<size_t>(pass);
+  const size_t end =
+      index + 1 < passOffsets.size() ? passOffsets[index + 1] : items.size();
+  return std::span(items).subspan(passOffsets[index],
+                                  end - passOffsets[index]);
+}
+
+void DrawStateCache::BindPipeline(const VkPipeline inPipeline) {
+  stats.binds++;
+  if (pipeline == inPipeline) {
+    stats.skippedBinds++;
+    return;
+  }
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                    inPipeline);
+  pipeline = inPipeline;
+  // Sets bound for another pipeline layout may have been disturbed
+  descriptorSet = VK_NULL_HANDLE;
+}
+
+void DrawStateCache::BindBuffers(const VkBuffer inVertexBuffer,
+                                 const VkBuffer inIndexBuffer,
+                                 const VkIndexType indexType) {
+  stats.binds += 2;
+  if (vertexBuffer == inVertexBuffer) {
+    stats.skippedBinds++;
+  } else {
+    constexpr VkDeviceSize offsets[] = {0};
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &inVertexBuffer, offsets);
+    vertexBuffer = inVertexBuffer;
+  }
+  if (indexBuffer == inIndexBuffer) {
+    stats.skippedBinds++;
+  } else {
+    vkCmdBindIndexBuffer(commandBuffer, inIndexBuffer, 0, indexType);
+    indexBuffer = inIndexBuffer;
+  }
+}
+
+void DrawStateCache::BindDescriptorSet(const VkPipelineLayout layout,
+                                       const VkDescriptorSet inDescriptorSet) {
+  stats.binds++;
+  if (descriptorSet == inDescriptorSet) {
+    stats.skippedBinds++;
+    return;
+  }
+  vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                          layout, 0, 1, &inDescriptorSet, 0, nullptr);
+  descriptorSet = inDescriptorSet;
+}
+
+void DrawStateCache::DrawIndexed(const uint32_t indexCount,
+                                 const uint32_t firstIndex) {
+  stats.drawCalls++;
+  vkCmdDrawIndexed(commandBuffer, indexCount, 1, firstIndex, 0, 0);
+}
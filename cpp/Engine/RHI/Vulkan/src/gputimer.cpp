@@ -0,0 +1,73 @@
+#include "../include/gputimer.h"
+
+#include <Engine/Utility/include/TypeUtils.h>
+
+#include "../include/device.h"
+
+void GpuTimer::CreateGpuTimer(const Device& device,
+                              const uint32_t framesInFlight) {
+  written.assign(framesInFlight, false);
+  milliseconds = 0;
+  const uint32_t validBits = device.GetTimestampValidBits();
+  if (validBits == 0) {
+    return;
+  }
+  timestampPeriod = device.GetTimestampPeriod();
+  timestampMask = validBits >= 64 ? UINT64_MAX : (1ull << validBits) - 1;
+
+  const VkQueryPoolCreateInfo poolInfo{
+      .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+      .queryType = VK_QUERY_TYPE_TIMESTAMP,
+      .queryCount = framesInFlight * 2,
+  };
+  if (vkCreateQueryPool(device.GetLogical(), &poolInfo, nullptr,
+                        &queryPool) != VK_SUCCESS) {
+    PRINT_AND_THROW_ERROR("failed to create timestamp query pool!");
+  }
+}
+
+void GpuTimer::DestroyGpuTimer(const VkDevice& device) {
+  if (queryPool == VK_NULL_HANDLE) {
+    return;
+  }
+  vkDestroyQueryPool(device, queryPool, nullptr);
+  queryPool = VK_NULL_HANDLE;
+  written.clear();
+}
+
+void GpuTimer::RecordReset(VkCommandBuffer commandBuffer,
+                           const uint32_t frame) const {
+  if (queryPool != VK_NULL_HANDLE) {
+    vkCmdResetQueryPool(commandBuffer, queryPool, frame * 2, 2);
+  }
+}
+
+void GpuTimer::RecordBegin(VkCommandBuffer commandBuffer,
+                           const uint32_t frame) const {
+  if (queryPool != VK_NULL_HANDLE) {
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                        queryPool, frame * 2);
+  }
+}
+
+void GpuTimer::RecordEnd(VkCommandBuffer commandBuffer, const uint32_t frame) {
+  if (queryPool != VK_NULL_HANDLE) {
+    vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                        queryPool, frame * 2 + 1);
+    written[frame] = true;
+  }
+}
+
+void GpuTimer::ReadTime(const VkDevice& device, const uint32_t frame) {
+  if (queryPool == VK_NULL_HANDLE || written[frame] == false) {
+    return;
+  }
+  uint64_t timestamps[2];
+  if (vkGetQueryPoolResults(device, queryPool, frame * 2, 2,
+                            sizeof(timestamps), timestamps, sizeof(uint64_t),
+                            VK_QUERY_RESULT_64_BIT) != VK_SUCCESS) {
+    return;
+  }
+  const uint64_t ticks = (timestamps[1] - timestamps[0]) & timestampMask;
+  milliseconds = static_cast<float>(ticks) * timestampPeriod * 1e-6f;
+}
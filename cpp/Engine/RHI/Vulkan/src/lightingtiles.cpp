@@ -0,0 +1,314 @@
+#include "../include/lightingtiles.h"
+
+#include <array>
+#include <cstring>
+
+#include "../include/buffer.h"
+#include "../include/config.h"
+#include "../include/device.h"
+#include "../include/render.h"
+#include "../include/texture.h"
+
+namespace {
+// Head of the tile buffer, followed by the tile lists of the pipelines, each
+// with room for every tile. Matches LightingTileMembers in LightingTiles.glsl.
+struct LightingTileHeader {
+  std::array<VkDrawIndirectCommand, MaxPipelineNum> draws;
+  glm::uvec2 extent;
+  uint32_t tilesX;
+  uint32_t tileCount;
+};
+// The classification shader gathers a tile's pipelines into a 32 bit mask
+static_assert(MaxPipelineNum <= 32);
+}  // namespace
+
+void LightingTiles::CreatePipeline(const Device& device, const Render& render,
+                                   const std::string& rootPath,
+                                   const std::string& shaderPath) {
+  shader.AddDefinitions(
+      {{"MaxPipelineNum", std::to_string(MaxPipelineNum)},
+       {"LightingTileSize", std::to_string(VulkanConfig::LIGHTING_TILE_SIZE)}});
+  if (render.GetEnableCompactGBuffer()) {
+    shader.AddDefinitions({{"EnableCompactGBuffer", "1"}});
+  }
+  if (device.GetMSAASamples() != VK_SAMPLE_COUNT_1_BIT) {
+    shader.AddDefinitions(
+        {{"EnableMultiSample", std::to_string(device.GetMultiSampleNum())}});
+  }
+  std::vector<std::string> shaderSearchPaths;
+  for (const std::string& searchPath : ShaderSearchPaths) {
+    shaderSearchPaths.push_back(rootPath + searchPath);
+  }
+  shader.SetFileIncluder(shaderSearchPaths);
+  ShaderStages stages =
+      shader.AutoCreateStages(device.GetLogical(), rootPath, shaderPath);
+  if (stages[PipelineType::Compute].empty()) {
+    PRINT_AND_THROW_ERROR("lighting tile shader has no compute stage!");
+  }
+
+  const std::array bindings{
+      VkDescriptorSetLayoutBinding{
+          .binding = 0,
+          .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+          .descriptorCount = 1,
+          .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+      },
+      VkDescriptorSetLayoutBinding{
+          .binding = 1,
+          .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+          .descriptorCount = 1,
+          .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+      },
+  };
+  const VkDescriptorSetLayoutCreateInfo layoutInfo{
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+      .bindingCount = static_cast<uint32_t>(bindings.size()),
+      .pBindings = bindings.data(),
+  };
+  if (vkCreateDescriptorSetLayout(device.GetLogical(), &layoutInfo, nullptr,
+                                  &descriptorSetLayout) != VK_SUCCESS) {
+    PRINT_AND_THROW_ERROR("failed to create descriptor set layout!");
+  }
+
+  const VkPipelineLayoutCreateInfo pipelineLayoutInfo{
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+      .setLayoutCount = 1,
+      .pSetLayouts = &descriptorSetLayout,
+  };
+  if (vkCreatePipelineLayout(device.GetLogical(), &pipelineLayoutInfo,
+                             nullptr, &pipelineLayout) != VK_SUCCESS) {
+    PRINT_AND_THROW_ERROR("failed to create pipeline layout!");
+  }
+
+  const VkComputePipelineCreateInfo pipelineInfo{
+      .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+      .stage = stages[PipelineType::Compute][0],
+      .layout = pipelineLayout,
+  };
+  if (vkCreateComputePipelines(device.GetLogical(), VK_NULL_HANDLE, 1,
+                               &pipelineInfo, nullptr,
+                               &pipeline) != VK_SUCCESS) {
+    PRINT_AND_THROW_ERROR("failed to create compute pipeline!");
+  }
+  shader.DestroyModules(device.GetLogical());
+}
+
+void LightingTiles::CreateLightingTiles(const Device& device,
+                                        const Render& render,
+                                        const VkImageView& pipelineIdView,
+                                        const VkExtent2D& screenExtent,
+                                        const std::string& rootPath,
+                                        const std::string& shaderPath) {
+  sampler = Texture::CreateSampler(device, 1, VK_FALSE, VK_FALSE,
+                                   VK_COMPARE_OP_ALWAYS);
+  CreatePipeline(device, render, rootPath, shaderPath);
+  CreateTiles(device, render, pipelineIdView, screenExtent);
+}
+
+void LightingTiles::CreateTiles(const Device& device, const Render& render,
+                                const VkImageView& pipelineIdView,
+                                const VkExtent2D& screenExtent) {
+  constexpr uint32_t tileSize = VulkanConfig::LIGHTING_TILE_SIZE;
+  extent = screenExtent;
+  tilesX = (extent.width + tileSize - 1) / tileSize;
+  tileCount = tilesX * ((extent.height + tileSize - 1) / tileSize);
+
+  const VkDeviceSize listSize =
+      sizeof(uint32_t) * static_cast<VkDeviceSize>(tileCount);
+  DataBuffer::CreateBuffer(
+      device, sizeof(LightingTileHeader) + listSize * MaxPipelineNum,
+      VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+          VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, tileBuffer, tileMemory);
+
+  CreateDescriptorSet(device.GetLogical(), pipelineIdView);
+  CreateReadbackBuffer(device, render);
+}
+
+void LightingTiles::CreateDescriptorSet(const VkDevice& device,
+                                        const VkImageView& pipelineIdView) {
+  const std::array poolSizes{
+      VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1},
+      VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1},
+  };
+  const VkDescriptorPoolCreateInfo poolInfo{
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+      .maxSets = 1,
+      .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+      .pPoolSizes = poolSizes.data(),
+  };
+  if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool) !=
+      VK_SUCCESS) {
+    PRINT_AND_THROW_ERROR("failed to create descriptor pool!");
+  }
+
+  const VkDescriptorSetAllocateInfo allocInfo{
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+      .descriptorPool = descriptorPool,
+      .descriptorSetCount = 1,
+      .pSetLayouts = &descriptorSetLayout,
+  };
+  if (vkAllocateDescriptorSets(device, &allocInfo, &descriptorSet) !=
+      VK_SUCCESS) {
+    PRINT_AND_THROW_ERROR("failed to allocate descriptor sets!");
+  }
+
+  const VkDescriptorImageInfo imageInfo{
+      sampler, pipelineIdView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+  const VkDescriptorBufferInfo bufferInfo = GetTileBufferInfo();
+  const std::array writes{
+      VkWriteDescriptorSet{
+          .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+          .dstSet = descriptorSet,
+          .dstBinding = 0,
+          .dstArrayElement = 0,
+          .descriptorCount = 1,
+          .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+          .pImageInfo = &imageInfo,
+      },
+      VkWriteDescriptorSet{
+          .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+          .dstSet = descriptorSet,
+          .dstBinding = 1,
+          .dstArrayElement = 0,
+          .descriptorCount = 1,
+          .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+          .pBufferInfo = &bufferInfo,
+      },
+  };
+  vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()),
+                         writes.data(), 0, nullptr);
+}
+
+void LightingTiles::CreateReadbackBuffer(const Device& device,
+                                         const Render& render) {
+  const VkDeviceSize size = sizeof(VkDrawIndirectCommand) * MaxPipelineNum *
+                            render.GetMaxFramesInFlight();
+  DataBuffer::CreateBuffer(device, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                               VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                           readbackBuffer, readbackMemory);
+
+  void* mapped;
+  vkMapMemory(device.GetLogical(), readbackMemory, 0, size, 0, &mapped);
+  // Frames not classified yet count no tiles
+  std::memset(mapped, 0, size);
+  readbackDraws = static_cast<const VkDrawIndirectCommand*>(mapped);
+}
+
+void LightingTiles::DestroyTiles(const VkDevice& device) {
+  if (tileBuffer == VK_NULL_HANDLE) {
+    return;
+  }
+  vkDestroyBuffer(device, readbackBuffer, nullptr);
+  vkFreeMemory(device, readbackMemory, nullptr);
+  readbackDraws = nullptr;
+
+  vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+  vkDestroyBuffer(device, tileBuffer, nullptr);
+  vkFreeMemory(device, tileMemory, nullptr);
+  tileBuffer = VK_NULL_HANDLE;
+}
+
+void LightingTiles::DestroyLightingTiles(const VkDevice& device) {
+  if (pipeline == VK_NULL_HANDLE) {
+    return;
+  }
+  DestroyTiles(device);
+  vkDestroyPipeline(device, pipeline, nullptr);
+  vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+  vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+  vkDestroySampler(device, sampler, nullptr);
+  pipeline = VK_NULL_HANDLE;
+}
+
+void LightingTiles::RecordClassify(VkCommandBuffer commandBuffer,
+                                   const uint32_t frame) const {
+  // The draws and the copy of the previous frame must be done reading the
+  // lists before they are reset
+  VkBufferMemoryBarrier barrier{
+      .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+      .srcAccessMask = 0,
+      .dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .buffer = tileBuffer,
+      .offset = 0,
+      .size = VK_WHOLE_SIZE,
+  };
+  vkCmdPipelineBarrier(commandBuffer,
+                       VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+                           VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                           VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 1,
+                       &barrier, 0, nullptr);
+
+  // Four vertices make the triangle strip of a tile's quad, one instance
+  // per tile
+  LightingTileHeader header{
+      .extent = glm::uvec2(extent.width, extent.height),
+      .tilesX = tilesX,
+      .tileCount = tileCount,
+  };
+  header.draws.fill({4, 0, 0, 0});
+  vkCmdUpdateBuffer(commandBuffer, tileBuffer, 0, sizeof(header), &header);
+
+  barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+  barrier.dstAccessMask =
+      VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 1,
+                       &barrier, 0, nullptr);
+
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+  vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                          pipelineLayout, 0, 1, &descriptorSet, 0, nullptr);
+  vkCmdDispatch(commandBuffer, tilesX, tileCount / tilesX, 1);
+
+  // Read by the lighting draws and by the copy
+  barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+  barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT |
+                          VK_ACCESS_SHADER_READ_BIT |
+                          VK_ACCESS_TRANSFER_READ_BIT;
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                       VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+                           VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                           VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       0, 0, nullptr, 1, &barrier, 0, nullptr);
+
+  const VkBufferCopy region{
+      .srcOffset = 0,
+      .dstOffset = sizeof(header.draws) * frame,
+      .size = sizeof(header.draws),
+  };
+  vkCmdCopyBuffer(commandBuffer, tileBuffer, readbackBuffer, 1, &region);
+
+  const VkBufferMemoryBarrier readbackBarrier{
+      .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+      .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+      .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
+      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .buffer = readbackBuffer,
+      .offset = 0,
+      .size = VK_WHOLE_SIZE,
+  };
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1,
+                       &readbackBarrier, 0, nullptr);
+}
+
+void LightingTiles::RecordDraw(VkCommandBuffer commandBuffer,
+                               const int pipelineId) const {
+  vkCmdDrawIndirect(commandBuffer, tileBuffer,
+                    sizeof(VkDrawIndirectCommand) * pipelineId, 1,
+                    sizeof(VkDrawIndirectCommand));
+}
+
+uint32_t LightingTiles::GetTileCount(const uint32_t frame,
+                                     const int pipelineId) const {
+  if (readbackDraws == nullptr) {
+    return 0;
+  }
+  return readbackDraws[frame * MaxPipelineNum + pipelineId].instanceCount;
+}
@@ -1,26 +1,52 @@
+#include <Engine/Camera/include/BaseCamera.h>
 #include <Engine/RHI/Vulkan/include/draw.h>
 #include <Engine/RHI/Vulkan/include/mesh.h>
+#include <Engine/RHI/Vulkan/include/render.h>
 #include <Engine/RHI/Vulkan/include/utils.h>
 
+#include <algorithm>
+
 BufferManager& Mesh::GetBufferManager() const {
   return static_cast<Draw*>(owner)->GetBufferManager();
 }
 
-void Mesh::CreateMesh(
+Coroutine::Task<void> Mesh::CreateMesh(
     const Device& device, Render& render, std::weak_ptr<MeshData> inData,
-    const VkDescriptorSetLayout& colorDescriptorSetLayout,
-    const VkDescriptorSetLayout& zPrePassDescriptorSetLayout,
-    const VkDescriptorSetLayout& shadowMapDescriptorSetLayout) {
+    const VkDescriptorSetLayout colorDescriptorSetLayout,
+    const VkDescriptorSetLayout zPrePassDescriptorSetLayout,
+    const VkDescriptorSetLayout shadowMapDescriptorSetLayout) {
   bridge = inData;
 
-  ParseTextures(device, render);
+  UploadBatch batch = render.BeginUpload(device.GetLogical());
+  ParseTextures(device, render, batch);
+  std::unique_ptr<MeshStaging> staging;
+  if (createInterrupted == false) {
+    if (auto bridgePtr = bridge.lock()) {
+      staging = std::move(bridgePtr->staging);
+    }
+    if (staging) {
+      // Already in the GPU layout, only the copy out of the pool is left
+      const auto& ticket = static_cast<const MeshStagingTicket&>(*staging);
+      data.SetIndexCount(static_cast<uint32_t>(ticket.indexCount));
+      buffer.CreateBuffers(device, ticket, batch);
+    } else {
+      ParseVertexAndIndex();
+      buffer.CreateBuffers(device, data.GetVertices(), data.GetIndices(),
+                           batch);
+    }
+    ParseLods();
+  }
+  // Textures recorded before an interruption still own staging buffers
+  co_await render.SubmitUpload(device, batch);
+  render.EndUpload(device.GetLogical(), batch);
+  staging.reset();
+
   if (createInterrupted) {
-    return;
+    co_return;
   }
-  ParseVertexAndIndex();
-  ParseBufferAndDescriptor(device, render, colorDescriptorSetLayout,
-                           zPrePassDescriptorSetLayout,
-                           shadowMapDescriptorSetLayout);
+  descriptor.CreateDescriptor(
+      device, render, textures, colorDescriptorSetLayout,
+      zPrePassDescriptorSetLayout, shadowMapDescriptorSetLayout);
 }
 
 void Mesh::DestroyMesh(const VkDevice& device, const Render& render) {
@@ -34,12 +60,13 @@ void Mesh::DestroyMesh(const VkDevice& device, const Render& render) {
   }
 }
 
-void Mesh::ParseTextures(const Device& device, const Render& render) {
+void Mesh::ParseTextures(const Device& device, const Render& render,
+                         UploadBatch& batch) {
   if (auto bridgePtr = bridge.lock()) {
     for (const auto& [type, width, height, channels, _data] :
          bridgePtr->textures) {
       Texture texture(VulkanUtils::TextureFormat[type], device, render, width,
-                      height, channels, _data);
+                      height, channels, _data, batch);
       if (texture.GetCreateInterrupted()) {
         createInterrupted = true;
         return;
@@ -49,27 +76,84 @@ void Mesh::ParseTextures(const Device& device, const Render& render) {
   }
 }
 
-void Mesh::ParseVertexAndIndex() {
-  std::vector<Vertex> vertices;
-
+void Mesh::ParseLods() {
   if (auto bridgePtr = bridge.lock()) {
-    vertices.reserve(bridgePtr->vertices.size());
-    for (const auto& vert : bridgePtr->vertices) {
-      vertices.emplace_back(vert);
-    }
-    data.CreateData(bridgePtr->indices, vertices);
+    lods = bridgePtr->lods;
+    bounds = bridgePtr->bounds;
+  }
+  if (lods.empty()) {
+    lods.push_back({.indexCount = data.GetIndexCount()});
   }
 }
 
-void Mesh::ParseBufferAndDescriptor(
-    const Device& device, Render& render,
-    const VkDescriptorSetLayout& colorDescriptorSetLayout,
-    const VkDescriptorSetLayout& zPrePassDescriptorSetLayout,
-    const VkDescriptorSetLayout& shadowMapDescriptorSetLayout) {
-  buffer.CreateBuffers(device, data.GetVertices(), data.GetIndices(), render);
-  descriptor.CreateDescriptor(
-      device, render, textures, colorDescriptorSetLayout,
-      zPrePassDescriptorSetLayout, shadowMapDescriptorSetLayout);
+void Mesh::SelectLod(const float viewportHeight) {
+  const auto bridgePtr = bridge.lock();
+  if (lods.size() < 2 || !bridgePtr) {
+    return;
+  }
+  const glm::mat4x4* modelMatrixPtr = bridgePtr->uniform.modelMatrix.load();
+  if (modelMatrixPtr == nullptr) {
+    return;
+  }
+  const auto camera = bridgePtr->uniform.camera.lock();
+  if (!camera) {
+    return;
+  }
+  const glm::mat4& modelMatrix = *modelMatrixPtr;
+  const float scale = std::max({glm::length(glm::vec3(modelMatrix[0])),
+                                glm::length(glm::vec3(modelMatrix[1])),
+                                glm::length(glm::vec3(modelMatrix[2]))});
+  const glm::vec3 center(modelMatrix * glm::vec4(glm::vec3(bounds), 1));
+
+  camera->GetMatrixLock().lock();
+  const float projScale = std::abs(camera->GetProjMatrix()[1][1]);
+  camera->GetMatrixLock().unlock();
+  const float distance =
+      std::max(glm::distance(center, camera->GetAbsolutePosition()) -
+                   bounds.w * scale,
+               camera->GetNear());
+  const float pixelsPerUnit =
+      projScale * viewportHeight * 0.5f * scale / distance;
+
+  const auto coarsest = [this, pixelsPerUnit](const float pixelError) {
+    uint32_t result = 0;
+    while (result + 1 < lods.size() &&
+           lods[result + 1].error * pixelsPerUnit <= pixelError) {
+      result++;
+    }
+    return result;
+  };
+  // Refines as soon as the current level errs too much, coarsens only past
+  // the hysteresis so meshes near a switching distance do not pop
+  const uint32_t allowed = coarsest(VulkanConfig::LOD_PIXEL_ERROR);
+  const uint32_t settled = coarsest(VulkanConfig::LOD_PIXEL_ERROR *
+                                    (1 - VulkanConfig::LOD_HYSTERESIS));
+  lod = std::clamp(lod, settled, allowed);
+}
+
+float Mesh::GetViewDepth(const uint32_t currentFrame) const {
+  const TransformData& transform = GetTransformData(currentFrame);
+  return -(transform.viewMatrix * transform.modelMatrix *
+           glm::vec4(glm::vec3(bounds), 1))
+              .z;
+}
+
+bool Mesh::TestOcclusion(const OcclusionCulling& culling,
+                         const uint32_t currentFrame) {
+  const TransformData& transform = GetTransformData(currentFrame);
+  occluded = culling.IsOccluded(
+      transform.projMatrix * transform.viewMatrix * transform.modelMatrix,
+      bounds);
+  return occluded;
+}
+
+void Mesh::ParseVertexAndIndex() {
+  if (auto bridgePtr = bridge.lock()) {
+    data.CreateData(bridgePtr->indices,
+                    VertexLayout::Encode(bridgePtr->vertexFormat,
+                                         bridgePtr->vertices,
+                                         bridgePtr->dequant));
+  }
 }
 
 PipelineBuffer* Mesh::GetPipelineBuffer() {
@@ -0,0 +1,410 @@
+#include "../include/occlusion.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "../include/buffer.h"
+#include "../include/config.h"
+#include "../include/depth.h"
+#include "../include/device.h"
+#include "../include/render.h"
+#include "../include/texture.h"
+
+namespace {
+struct HiZParams {
+  glm::ivec2 sourceSize;
+  int32_t fromDepth;
+  int32_t depthSamples;
+};
+}  // namespace
+
+void OcclusionCulling::CreatePipeline(const Device& device,
+                                      const std::string& rootPath,
+                                      const std::string& shaderPath) {
+  if (depthSamples > 1) {
+    shader.AddDefinitions({{"HiZMultisampled", "1"}});
+  }
+  ShaderStages stages =
+      shader.AutoCreateStages(device.GetLogical(), rootPath, shaderPath);
+  if (stages[PipelineType::Compute].empty()) {
+    PRINT_AND_THROW_ERROR("depth pyramid shader has no compute stage!");
+  }
+
+  std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+  for (uint32_t i = 0; i < bindings.size(); i++) {
+    bindings[i] = {
+        .binding = i,
+        .descriptorType = i < 2 ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER
+                                : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+        .descriptorCount = 1,
+        .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+        .pImmutableSamplers = nullptr,
+    };
+  }
+  const VkDescriptorSetLayoutCreateInfo layoutInfo{
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+      .bindingCount = static_cast<uint32_t>(bindings.size()),
+      .pBindings = bindings.data(),
+  };
+  if (vkCreateDescriptorSetLayout(device.GetLogical(), &layoutInfo, nullptr,
+                                  &descriptorSetLayout) != VK_SUCCESS) {
+    PRINT_AND_THROW_ERROR("failed to create descriptor set layout!");
+  }
+
+  constexpr VkPushConstantRange pushConstantRange{
+      .stageFlags = VK_SHADER_STAGE_COMPUTE_BIT,
+      .offset = 0,
+      .size = sizeof(HiZParams),
+  };
+  const VkPipelineLayoutCreateInfo pipelineLayoutInfo{
+      .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
+      .setLayoutCount = 1,
+      .pSetLayouts = &descriptorSetLayout,
+      .pushConstantRangeCount = 1,
+      .pPushConstantRanges = &pushConstantRange,
+  };
+  if (vkCreatePipelineLayout(device.GetLogical(), &pipelineLayoutInfo,
+                             nullptr, &pipelineLayout) != VK_SUCCESS) {
+    PRINT_AND_THROW_ERROR("failed to create pipeline layout!");
+  }
+
+  const VkComputePipelineCreateInfo pipelineInfo{
+      .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+      .stage = stages[PipelineType::Compute][0],
+      .layout = pipelineLayout,
+  };
+  if (vkCreateComputePipelines(device.GetLogical(), VK_NULL_HANDLE, 1,
+                               &pipelineInfo, nullptr,
+                               &pipeline) != VK_SUCCESS) {
+    PRINT_AND_THROW_ERROR("failed to create compute pipeline!");
+  }
+  shader.DestroyModules(device.GetLogical());
+}
+
+void OcclusionCulling::CreateOcclusionCulling(const Device& device,
+                                              const Render& render,
+                                              Depth& depth,
+                                              const VkExtent2D& depthExtent,
+                                              const std::string& rootPath,
+                                              const std::string& shaderPath) {
+  depthSamples = static_cast<int32_t>(device.GetMSAASamples());
+  sampler = Texture::CreateSampler(device, 1, VK_FALSE, VK_FALSE,
+                                   VK_COMPARE_OP_ALWAYS);
+  CreatePipeline(device, rootPath, shaderPath);
+  CreatePyramid(device, render, depth, depthExtent);
+}
+
+void OcclusionCulling::CreatePyramid(const Device& device, const Render& render,
+                                     Depth& depth,
+                                     const VkExtent2D& depthExtent) {
+  extent = depthExtent;
+  levelExtents.clear();
+  VkExtent2D level = extent;
+  do {
+    level = {std::max((level.width + 1) / 2, 1u),
+             std::max((level.height + 1) / 2, 1u)};
+    levelExtents.push_back(level);
+  } while (level.width > 1 || level.height > 1);
+  const auto levelCount = static_cast<uint32_t>(levelExtents.size());
+
+  auto [image, memory] = Texture::CreateImage(
+      device, levelExtents[0].width, levelExtents[0].height, levelCount,
+      VK_SAMPLE_COUNT_1_BIT, VK_FORMAT_R32_SFLOAT, VK_IMAGE_TILING_OPTIMAL,
+      VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
+          VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+  pyramid = image;
+  pyramidMemory = memory;
+
+  for (uint32_t i = 0; i < levelCount; i++) {
+    const VkImageViewCreateInfo viewInfo{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
+        .image = pyramid,
+        .viewType = VK_IMAGE_VIEW_TYPE_2D,
+        .format = VK_FORMAT_R32_SFLOAT,
+        .subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, i, 1, 0, 1},
+    };
+    if (VkImageView view; vkCreateImageView(device.GetLogical(), &viewInfo,
+                                            nullptr, &view) == VK_SUCCESS) {
+      levelViews.push_back(view);
+    } else {
+      PRINT_AND_THROW_ERROR("failed to create depth pyramid image view!");
+    }
+  }
+
+  // The pyramid stays in the general layout, written, sampled and copied
+  VkCommandBuffer commandBuffer{};
+  render.BeginSingleTimeCommands(device.GetLogical(), &commandBuffer);
+  const VkImageMemoryBarrier barrier{
+      .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+      .srcAccessMask = 0,
+      .dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+      .oldLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+      .newLayout = VK_IMAGE_LAYOUT_GENERAL,
+      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .image = pyramid,
+      .subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, levelCount, 0, 1},
+  };
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0,
+                       nullptr, 1, &barrier);
+  render.EndSingleTimeCommands(device, &commandBuffer);
+
+  CreateDescriptorSets(device.GetLogical(), depth.GetDepthImageView());
+  CreateReadbackBuffer(device);
+}
+
+void OcclusionCulling::CreateDescriptorSets(const VkDevice& device,
+                                            const VkImageView& depthImageView) {
+  const auto levelCount = static_cast<uint32_t>(levelExtents.size());
+  const std::array poolSizes{
+      VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+                           2 * levelCount},
+      VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, levelCount},
+  };
+  const VkDescriptorPoolCreateInfo poolInfo{
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+      .maxSets = levelCount,
+      .poolSizeCount = static_cast<uint32_t>(poolSizes.size()),
+      .pPoolSizes = poolSizes.data(),
+  };
+  if (vkCreateDescriptorPool(device, &poolInfo, nullptr, &descriptorPool) !=
+      VK_SUCCESS) {
+    PRINT_AND_THROW_ERROR("failed to create descriptor pool!");
+  }
+
+  const std::vector layouts(levelCount, descriptorSetLayout);
+  const VkDescriptorSetAllocateInfo allocInfo{
+      .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+      .descriptorPool = descriptorPool,
+      .descriptorSetCount = levelCount,
+      .pSetLayouts = layouts.data(),
+  };
+  descriptorSets.resize(levelCount);
+  if (vkAllocateDescriptorSets(device, &allocInfo, descriptorSets.data()) !=
+      VK_SUCCESS) {
+    PRINT_AND_THROW_ERROR("failed to allocate descriptor sets!");
+  }
+
+  // Level 0 reads the depth image, the source level binding is only there to
+  // keep the set complete
+  for (uint32_t i = 0; i < levelCount; i++) {
+    const std::array imageInfos{
+        VkDescriptorImageInfo{sampler, depthImageView,
+                              VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL},
+        VkDescriptorImageInfo{sampler, levelViews[i == 0 ? 0 : i - 1],
+                              VK_IMAGE_LAYOUT_GENERAL},
+        VkDescriptorImageInfo{VK_NULL_HANDLE, levelViews[i],
+                              VK_IMAGE_LAYOUT_GENERAL},
+    };
+    std::array<VkWriteDescriptorSet, 3> writes{};
+    for (uint32_t j = 0; j < writes.size(); j++) {
+      writes[j] = {
+          .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+          .dstSet = descriptorSets[i],
+          .dstBinding = j,
+          .dstArrayElement = 0,
+          .descriptorCount = 1,
+          .descriptorType = j < 2 ? VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER
+                                  : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+          .pImageInfo = &imageInfos[j],
+      };
+    }
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()),
+                           writes.data(), 0, nullptr);
+  }
+}
+
+void OcclusionCulling::CreateReadbackBuffer(const Device& device) {
+  firstReadbackLevel = 0;
+  while (firstReadbackLevel + 1 < levelExtents.size() &&
+         std::max(levelExtents[firstReadbackLevel].width,
+                  levelExtents[firstReadbackLevel].height) >
+             VulkanConfig::HIZ_READBACK_SIZE) {
+    firstReadbackLevel++;
+  }
+  VkDeviceSize size = 0;
+  for (uint32_t i = firstReadbackLevel; i < levelExtents.size(); i++) {
+    size += sizeof(float) * levelExtents[i].width * levelExtents[i].height;
+  }
+  DataBuffer::CreateBuffer(device, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                               VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                           readbackBuffer, readbackMemory);
+
+  void* mapped;
+  vkMapMemory(device.GetLogical(), readbackMemory, 0, size, 0, &mapped);
+  const auto* depths = static_cast<const float*>(mapped);
+  for (uint32_t i = firstReadbackLevel; i < levelExtents.size(); i++) {
+    readbackLevels.push_back(
+        {levelExtents[i].width, levelExtents[i].height, depths});
+    depths += levelExtents[i].width * levelExtents[i].height;
+  }
+}
+
+void OcclusionCulling::DestroyPyramid(const VkDevice& device) {
+  if (pyramid == VK_NULL_HANDLE) {
+    return;
+  }
+  vkDestroyBuffer(device, readbackBuffer, nullptr);
+  vkFreeMemory(device, readbackMemory, nullptr);
+  readbackLevels.clear();
+
+  vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+  descriptorSets.clear();
+  for (const VkImageView view : levelViews) {
+    vkDestroyImageView(device, view, nullptr);
+  }
+  levelViews.clear();
+  vkDestroyImage(device, pyramid, nullptr);
+  vkFreeMemory(device, pyramidMemory, nullptr);
+  pyramid = VK_NULL_HANDLE;
+}
+
+void OcclusionCulling::DestroyOcclusionCulling(const VkDevice& device) {
+  if (pipeline == VK_NULL_HANDLE) {
+    return;
+  }
+  DestroyPyramid(device);
+  vkDestroyPipeline(device, pipeline, nullptr);
+  vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+  vkDestroyDescriptorSetLayout(device, descriptorSetLayout, nullptr);
+  vkDestroySampler(device, sampler, nullptr);
+  pipeline = VK_NULL_HANDLE;
+}
+
+void OcclusionCulling::RecordBuildPyramid(
+    VkCommandBuffer commandBuffer) const {
+  const auto levelCount = static_cast<uint32_t>(levelExtents.size());
+  // The copy of the previous frame must be done reading before the writes
+  VkImageMemoryBarrier levelBarrier{
+      .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+      .srcAccessMask = 0,
+      .dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT,
+      .oldLayout = VK_IMAGE_LAYOUT_GENERAL,
+      .newLayout = VK_IMAGE_LAYOUT_GENERAL,
+      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .image = pyramid,
+      .subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, levelCount, 0, 1},
+  };
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0,
+                       nullptr, 1, &levelBarrier);
+
+  vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+  VkExtent2D source = extent;
+  for (uint32_t i = 0; i < levelCount; i++) {
+    const HiZParams params{
+        .sourceSize = glm::ivec2(source.width, source.height),
+        .fromDepth = i == 0,
+        .depthSamples = depthSamples,
+    };
+    vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+                            pipelineLayout, 0, 1, &descriptorSets[i], 0,
+                            nullptr);
+    vkCmdPushConstants(commandBuffer, pipelineLayout,
+                       VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(params), &params);
+
+    const VkExtent2D& target = levelExtents[i];
+    constexpr uint32_t groupSize = VulkanConfig::HIZ_GROUP_SIZE;
+    vkCmdDispatch(commandBuffer, (target.width + groupSize - 1) / groupSize,
+                  (target.height + groupSize - 1) / groupSize, 1);
+
+    // Read by the next level and by the copy
+    levelBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    levelBarrier.dstAccessMask =
+        VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+    levelBarrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, i, 1, 0, 1};
+    vkCmdPipelineBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &levelBarrier);
+    source = target;
+  }
+
+  std::vector<VkBufferImageCopy> regions;
+  VkDeviceSize offset = 0;
+  for (uint32_t i = firstReadbackLevel; i < levelCount; i++) {
+    regions.push_back({
+        .bufferOffset = offset,
+        .imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, i, 0, 1},
+        .imageExtent = {levelExtents[i].width, levelExtents[i].height, 1},
+    });
+    offset += sizeof(float) * levelExtents[i].width * levelExtents[i].height;
+  }
+  vkCmdCopyImageToBuffer(commandBuffer, pyramid, VK_IMAGE_LAYOUT_GENERAL,
+                         readbackBuffer, static_cast<uint32_t>(regions.size()),
+                         regions.data());
+
+  const VkBufferMemoryBarrier readbackBarrier{
+      .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
+      .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+      .dstAccessMask = VK_ACCESS_HOST_READ_BIT,
+      .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+      .buffer = readbackBuffer,
+      .offset = 0,
+      .size = VK_WHOLE_SIZE,
+  };
+  vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1,
+                       &readbackBarrier, 0, nullptr);
+}
+
+bool OcclusionCulling::IsOccluded(const glm::mat4& mvp,
+                                  const glm::vec4& bounds) const {
+  if (readbackLevels.empty()) {
+    return false;
+  }
+  glm::vec2 minCorner(std::numeric_limits<float>::max());
+  glm::vec2 maxCorner(std::numeric_limits<float>::lowest());
+  float nearest = 1;
+  for (uint32_t i = 0; i < 8; i++) {
+    const glm::vec3 offset(i & 1 ? 1 : -1, i & 2 ? 1 : -1, i & 4 ? 1 : -1);
+    const glm::vec4 clip =
+        mvp * glm::vec4(glm::vec3(bounds) + offset * bounds.w, 1);
+    // A box reaching past the near plane has no bounded screen rectangle
+    if (clip.w <= 0 || clip.z < 0) {
+      return false;
+    }
+    const glm::vec3 ndc = glm::vec3(clip) / clip.w;
+    minCorner = glm::min(minCorner, glm::vec2(ndc));
+    maxCorner = glm::max(maxCorner, glm::vec2(ndc));
+    nearest = std::min(nearest, ndc.z);
+  }
+  // Boxes off the screen are left to the clipper
+  if (minCorner.x > 1 || minCorner.y > 1 || maxCorner.x < -1 ||
+      maxCorner.y < -1) {
+    return false;
+  }
+
+  const glm::vec2 size(extent.width, extent.height);
+  const glm::vec2 lo =
+      (glm::clamp(minCorner, -1.0f, 1.0f) * 0.5f + 0.5f) * size;
+  const glm::vec2 hi =
+      (glm::clamp(maxCorner, -1.0f, 1.0f) * 0.5f + 0.5f) * size;
+  // The finest level whose texels, 2^(level+1) pixels wide, are at least a
+  // quarter of the rectangle's longer side, so at most 5x5 of them are read
+  const float span = std::max(hi.x - lo.x, hi.y - lo.y) / 8;
+  const uint32_t level = std::clamp(
+      static_cast<uint32_t>(std::ceil(std::log2(std::max(span, 1.0f)))),
+      firstReadbackLevel, static_cast<uint32_t>(levelExtents.size() - 1));
+
+  const auto& [width, height, depths] =
+      readbackLevels[level - firstReadbackLevel];
+  const float texelSize = static_cast<float>(2u << level);
+  const glm::uvec2 lastTexel(width - 1, height - 1);
+  const glm::uvec2 first = glm::min(glm::uvec2(lo / texelSize), lastTexel);
+  const glm::uvec2 last = glm::min(glm::uvec2(hi / texelSize), lastTexel);
+  float farthest = 0;
+  for (uint32_t y = first.y; y <= last.y; y++) {
+    for (uint32_t x = first.x; x <= last.x; x++) {
+      farthest = std::max(farthest, depths[y * width + x]);
+    }
+  }
+  return nearest > farthest;
+}
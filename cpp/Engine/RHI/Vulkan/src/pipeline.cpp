@@ -42,9 +42,7 @@
       .alphaBlendOp = VK_BLEND_OP_ADD,                                        \
       .colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | \
                         VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT,  \
-  };                                                                          \
-  std::vector<VkPipelineColorBlendAttachmentState> colorBlendAttachments(     \
-      GBUFFER_SIZE, colorBlendAttachment)
+  }
 #define COLOR_BLEND_STATE_CREATE_INFO(_attachmentCount, _pAttachments,  \
                                       _logicOp)                         \
   VkPipelineColorBlendStateCreateInfo colorBlending {                   \
@@ -63,13 +61,17 @@
     .front = {}, .back = {}, .minDepthBounds = 0.0f, .maxDepthBounds = 1.0f,  \
   }
 
-void Pipeline::CreatePipelineLayout(const VkDevice& device,
-                                    const VkDescriptorSetLayout& dstLayout,
-                                    VkPipelineLayout& pipelineLayout) {
+void Pipeline::CreatePipelineLayout(
+    const VkDevice& device, const VkDescriptorSetLayout& dstLayout,
+    VkPipelineLayout& pipelineLayout,
+    const std::vector<VkPushConstantRange>& pushConstantRanges) {
   const VkPipelineLayoutCreateInfo pipelineLayoutInfo{
       .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO,
       .setLayoutCount = 1,
       .pSetLayouts = &dstLayout,
+      .pushConstantRangeCount =
+          static_cast<uint32_t>(pushConstantRanges.size()),
+      .pPushConstantRanges = pushConstantRanges.data(),
   };
   if (vkCreatePipelineLayout(device, &pipelineLayoutInfo, nullptr,
                              &pipelineLayout) != VK_SUCCESS) {
@@ -77,13 +79,14 @@ void Pipeline::CreatePipelineLayout(const VkDevice& device,
   }
 }
 
-void Pipeline::CreateColorGraphicsPipeline(
+int Pipeline::CreateColorGraphicsPipeline(
     const Device& device, Render& render, Shader& shader,
     const std::string& rootPath, const std::vector<std::string>& shaderPaths,
-    const VkRenderPass& renderPass) {
+    const VkRenderPass& renderPass, GraphicsPipelines& pipelines) {
   // Forward shading or deferred output pipeline
-  auto bindingDescription = Vertex::GetBindingDescription();
-  auto attributeDescriptions = Vertex::GetAttributeDescriptions();
+  auto bindingDescription = VertexLayout::GetBindingDescription(vertexFormat);
+  auto attributeDescriptions =
+      VertexLayout::GetAttributeDescriptions(vertexFormat);
   const VkPipelineVertexInputStateCreateInfo vertexInputInfo{
       .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
       .vertexBindingDescriptionCount = 1,
@@ -113,6 +116,8 @@ void Pipeline::CreateColorGraphicsPipeline(
   COLOR_BLEND_ATTACHMENT_STATE();
   COLOR_BLEND_STATE_CREATE_INFO(1, &colorBlendAttachment, VK_LOGIC_OP_COPY);
 
+  const std::vector colorBlendAttachments(render.GetGBufferSize(),
+                                          colorBlendAttachment);
   if (render.GetEnableDeferred()) {
     colorBlending = {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO,
@@ -131,18 +136,14 @@ void Pipeline::CreateColorGraphicsPipeline(
       .pDynamicStates = dynamicStates.data(),
   };
 
-  CreatePipelineLayout(device.GetLogical(), colorDescriptorSetLayout,
-                       colorPipelineLayout);
-  if (render.GetEnableDeferred()) {
-    CreatePipelineLayout(device.GetLogical(), deferredDescriptorSetLayout,
-                         deferredPipelineLayout);
-  }
-
   auto shaderStagesSet(
       shader.AutoCreateStagesSet(device.GetLogical(), rootPath, shaderPaths));
 
   for (int i = 0; i < shaderStagesSet.size(); ++i) {
     ShaderStages& shaderStages = shaderStagesSet[i];
+    if (shaderStages.empty()) {
+      continue;
+    }
 
     auto& stages = shaderStages[PipelineType::Forward];
     if (render.GetEnableDeferred()) {
@@ -170,12 +171,12 @@ void Pipeline::CreateColorGraphicsPipeline(
         .pDynamicState = &dynamicState,
         .layout = colorPipelineLayout,
         .renderPass = renderPass,
-        .subpass = 0,
+        .subpass = render.GetColorSubpass(),
         .basePipelineHandle = VK_NULL_HANDLE,
     };
     if (vkCreateGraphicsPipelines(device.GetLogical(), VK_NULL_HANDLE, 1,
                                   &pipelineInfo, nullptr,
-                                  &colorGraphicsPipeline) == VK_SUCCESS) {
+                                  &pipelines.color) == VK_SUCCESS) {
       if (render.GetEnableDeferred()) {
         // Deferred process pipeline
         // Remember to initialize its sType
@@ -210,21 +211,19 @@ void Pipeline::CreateColorGraphicsPipeline(
             .pColorBlendState = &colorBlending,
             .pDynamicState = &dynamicState,
             .layout = deferredPipelineLayout,
-            .renderPass = renderPass,
-            .subpass = 1,
+            .renderPass = render.GetLightingRenderPass(),
+            .subpass = render.GetLightingSubpass(),
             .basePipelineHandle = VK_NULL_HANDLE,
         };
         if (vkCreateGraphicsPipelines(
                 device.GetLogical(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr,
-                &deferredGraphicsPipeline) == VK_SUCCESS) {
-          shaderFallbackIndex = i;
+                &pipelines.deferred) == VK_SUCCESS) {
           shader.DestroyModules(device.GetLogical());
-          return;
+          return i;
         }
       } else {
-        shaderFallbackIndex = i;
         shader.DestroyModules(device.GetLogical());
-        return;
+        return i;
       }
     }
   }
@@ -233,9 +232,11 @@ void Pipeline::CreateColorGraphicsPipeline(
 
 void Pipeline::CreateZPrePassGraphicsPipeline(
     const Device& device, Shader& shader, const std::string& rootPath,
-    const std::string& depthShaderPath, const VkRenderPass& renderPass) {
-  auto bindingDescription = Vertex::GetBindingDescription();
-  auto attributeDescriptions = Vertex::GetAttributeDescriptions();
+    const std::string& depthShaderPath, const VkRenderPass& renderPass,
+    const uint32_t subpass, GraphicsPipelines& pipelines) {
+  auto bindingDescription = VertexLayout::GetBindingDescription(vertexFormat);
+  auto attributeDescriptions =
+      VertexLayout::GetAttributeDescriptions(vertexFormat);
   const VkPipelineVertexInputStateCreateInfo vertexInputInfo{
       .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
       .vertexBindingDescriptionCount = 1,
@@ -267,8 +268,6 @@ void Pipeline::CreateZPrePassGraphicsPipeline(
       .dynamicStateCount = static_cast<uint32_t>(dynamicStates.size()),
       .pDynamicStates = dynamicStates.data(),
   };
-  CreatePipelineLayout(device.GetLogical(), zPrePassDescriptorSetLayout,
-                       zPrePassPipelineLayout);
 
   ShaderStages shaderStages(
       shader.AutoCreateStages(device.GetLogical(), rootPath, depthShaderPath));
@@ -287,12 +286,12 @@ void Pipeline::CreateZPrePassGraphicsPipeline(
       .pDynamicState = &dynamicState,
       .layout = zPrePassPipelineLayout,
       .renderPass = renderPass,
-      .subpass = 0,
+      .subpass = subpass,
       .basePipelineHandle = VK_NULL_HANDLE,
   };
   if (vkCreateGraphicsPipelines(device.GetLogical(), VK_NULL_HANDLE, 1,
                                 &pipelineInfo, nullptr,
-                                &zPrePassGraphicsPipeline) == VK_SUCCESS) {
+                                &pipelines.zPrePass) == VK_SUCCESS) {
     shader.DestroyModules(device.GetLogical());
     return;
   }
@@ -301,9 +300,11 @@ void Pipeline::CreateZPrePassGraphicsPipeline(
 
 void Pipeline::CreateShadowMapGraphicsPipeline(
     const VkDevice& device, Render& render, Shader& shader,
-    const std::string& rootPath, const std::string& depthShaderPath) {
-  auto bindingDescription = Vertex::GetBindingDescription();
-  auto attributeDescriptions = Vertex::GetAttributeDescriptions();
+    const std::string& rootPath, const std::string& depthShaderPath,
+    GraphicsPipelines& pipelines) {
+  auto bindingDescription = VertexLayout::GetBindingDescription(vertexFormat);
+  auto attributeDescriptions =
+      VertexLayout::GetAttributeDescriptions(vertexFormat);
   const VkPipelineVertexInputStateCreateInfo vertexInputInfo{
       .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO,
       .vertexBindingDescriptionCount = 1,
@@ -337,8 +338,6 @@ void Pipeline::CreateShadowMapGraphicsPipeline(
       .dynamicStateCount = static_cast<uint32_t>(dynamicStates.size()),
       .pDynamicStates = dynamicStates.data(),
   };
-  CreatePipelineLayout(device, shadowMapDescriptorSetLayout,
-                       shadowMapPipelineLayout);
 
   ShaderStages shaderStages(
       shader.AutoCreateStages(device, rootPath, depthShaderPath));
@@ -361,8 +360,7 @@ void Pipeline::CreateShadowMapGraphicsPipeline(
       .basePipelineHandle = VK_NULL_HANDLE,
   };
   if (vkCreateGraphicsPipelines(device, VK_NULL_HANDLE, 1, &pipelineInfo,
-                                nullptr,
-                                &shadowMapGraphicsPipeline) == VK_SUCCESS) {
+                                nullptr, &pipelines.shadowMap) == VK_SUCCESS) {
     shader.DestroyModules(device);
     return;
   }
@@ -416,7 +414,7 @@ void Pipeline::CreateColorDescriptorSetLayout(const VkDevice& device,
           .pImmutableSamplers = nullptr,
       });
     }
-    for (uint32_t i = 0; i < GBUFFER_SIZE; i++) {
+    for (uint32_t i = 0; i < render.GetGBufferInputSize(); i++) {
       bindings.push_back({
           .binding = static_cast<uint32_t>(bindings.size()),
           .descriptorType = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT,
@@ -435,6 +433,15 @@ void Pipeline::CreateColorDescriptorSetLayout(const VkDevice& device,
           .pImmutableSamplers = nullptr,
       });
     }
+    if (render.GetEnableTileClassification()) {
+      bindings.push_back({
+          .binding = static_cast<uint32_t>(bindings.size()),
+          .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+          .descriptorCount = 1,
+          .stageFlags = VK_SHADER_STAGE_VERTEX_BIT,
+          .pImmutableSamplers = nullptr,
+      });
+    }
     layoutInfo = {
         .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
         .bindingCount = static_cast<uint32_t>(bindings.size()),
@@ -530,44 +537,121 @@ void Pipeline::CreateShadowMapDescriptorSetLayout(const VkDevice& device) {
 
 void Pipeline::CreatePipeline(const Device& device, Render& render,
                               Shader& shader, int texCount,
+                              const uint32_t vertexFormat,
                               const std::string& rootPath,
                               const std::vector<std::string>& shaderPaths,
                               const std::string& zPrePassShaderPath,
                               const std::string& shadowMapShaderPath) {
+  this->vertexFormat = vertexFormat;
   CreateColorDescriptorSetLayout(device.GetLogical(), render, texCount);
-  CreateColorGraphicsPipeline(device, render, shader, rootPath, shaderPaths,
-                              render.GetColorRenderPass());
+  CreatePipelineLayout(device.GetLogical(), colorDescriptorSetLayout,
+                       colorPipelineLayout);
+  if (render.GetEnableDeferred()) {
+    std::vector<VkPushConstantRange> pushConstantRanges;
+    if (render.GetEnableCompactGBuffer()) {
+      pushConstantRanges.push_back({
+          .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+          .offset = 0,
+          .size = sizeof(DeferredViewData),
+      });
+    }
+    CreatePipelineLayout(device.GetLogical(), deferredDescriptorSetLayout,
+                         deferredPipelineLayout, pushConstantRanges);
+  }
+  shaderFallbackIndex = CreateColorGraphicsPipeline(
+      device, render, shader, rootPath, shaderPaths,
+      render.GetColorRenderPass(), graphicsPipelines);
 
   if (render.GetEnableZPrePass()) {
     CreateZPrePassDescriptorSetLayout(device.GetLogical());
+    CreatePipelineLayout(device.GetLogical(), zPrePassDescriptorSetLayout,
+                         zPrePassPipelineLayout);
     CreateZPrePassGraphicsPipeline(device, shader, rootPath, zPrePassShaderPath,
-                                   render.GetZPrePassRenderPass());
+                                   render.GetZPrePassRenderPass(),
+                                   render.GetZPrePassSubpass(),
+                                   graphicsPipelines);
   }
   if (render.GetEnableShadowMap()) {
     CreateShadowMapDescriptorSetLayout(device.GetLogical());
+    CreatePipelineLayout(device.GetLogical(), shadowMapDescriptorSetLayout,
+                         shadowMapPipelineLayout);
     CreateShadowMapGraphicsPipeline(device.GetLogical(), render, shader,
-                                    rootPath, shadowMapShaderPath);
+                                    rootPath, shadowMapShaderPath,
+                                    graphicsPipelines);
+  }
+}
+
+GraphicsPipelines Pipeline::RebuildGraphicsPipelines(
+    const Device& device, Render& render, Shader& shader,
+    const uint32_t variants, const std::string& rootPath,
+    const std::string& shaderPath, const std::string& zPrePassShaderPath,
+    const std::string& shadowMapShaderPath) {
+  GraphicsPipelines pipelines;
+  try {
+    if (variants & ColorPipelineVariant) {
+      CreateColorGraphicsPipeline(device, render, shader, rootPath,
+                                  {shaderPath}, render.GetColorRenderPass(),
+                                  pipelines);
+    }
+    if ((variants & ZPrePassPipelineVariant) && render.GetEnableZPrePass()) {
+      CreateZPrePassGraphicsPipeline(
+          device, shader, rootPath, zPrePassShaderPath,
+          render.GetZPrePassRenderPass(), render.GetZPrePassSubpass(),
+          pipelines);
+    }
+    if ((variants & ShadowMapPipelineVariant) && render.GetEnableShadowMap()) {
+      CreateShadowMapGraphicsPipeline(device.GetLogical(), render, shader,
+                                      rootPath, shadowMapShaderPath, pipelines);
+    }
+  } catch (...) {
+    shader.DestroyModules(device.GetLogical());
+    DestroyGraphicsPipelines(device.GetLogical(), pipelines);
+    throw;
   }
+  return pipelines;
+}
+
+void Pipeline::SwapGraphicsPipelines(const VkDevice& device,
+                                     const GraphicsPipelines& pipelines) {
+  GraphicsPipelines replaced;
+  const auto swap = [](VkPipeline& dst, const VkPipeline& src,
+                       VkPipeline& old) {
+    if (src != VK_NULL_HANDLE) {
+      old = dst;
+      dst = src;
+    }
+  };
+  swap(graphicsPipelines.color, pipelines.color, replaced.color);
+  swap(graphicsPipelines.deferred, pipelines.deferred, replaced.deferred);
+  swap(graphicsPipelines.zPrePass, pipelines.zPrePass, replaced.zPrePass);
+  swap(graphicsPipelines.shadowMap, pipelines.shadowMap, replaced.shadowMap);
+  DestroyGraphicsPipelines(device, replaced);
+}
+
+void Pipeline::DestroyGraphicsPipelines(const VkDevice& device,
+                                        const GraphicsPipelines& pipelines) {
+  // vkDestroyPipeline ignores null handles
+  vkDestroyPipeline(device, pipelines.color, nullptr);
+  vkDestroyPipeline(device, pipelines.deferred, nullptr);
+  vkDestroyPipeline(device, pipelines.zPrePass, nullptr);
+  vkDestroyPipeline(device, pipelines.shadowMap, nullptr);
 }
 
 void Pipeline::DestroyPipeline(const VkDevice& device,
                                const Render& render) const {
-  vkDestroyPipeline(device, colorGraphicsPipeline, nullptr);
+  DestroyGraphicsPipelines(device, graphicsPipelines);
   vkDestroyDescriptorSetLayout(device, colorDescriptorSetLayout, nullptr);
   vkDestroyPipelineLayout(device, colorPipelineLayout, nullptr);
 
   if (render.GetEnableZPrePass()) {
-    vkDestroyPipeline(device, zPrePassGraphicsPipeline, nullptr);
     vkDestroyDescriptorSetLayout(device, zPrePassDescriptorSetLayout, nullptr);
     vkDestroyPipelineLayout(device, zPrePassPipelineLayout, nullptr);
   }
   if (render.GetEnableShadowMap()) {
-    vkDestroyPipeline(device, shadowMapGraphicsPipeline, nullptr);
     vkDestroyDescriptorSetLayout(device, shadowMapDescriptorSetLayout, nullptr);
     vkDestroyPipelineLayout(device, shadowMapPipelineLayout, nullptr);
   }
   if (render.GetEnableDeferred()) {
-    vkDestroyPipeline(device, deferredGraphicsPipeline, nullptr);
     vkDestroyDescriptorSetLayout(device, deferredDescriptorSetLayout, nullptr);
     vkDestroyPipelineLayout(device, deferredPipelineLayout, nullptr);
   }
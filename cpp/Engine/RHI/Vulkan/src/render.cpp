@@ -8,30 +8,11 @@
 #include <Engine/RHI/Vulkan/include/vertex.h>
 #include <Engine/RHI/Vulkan/include/vulkan.h>
 
+#include <array>
 #include <cstdio>
 #include <ranges>
 #include <stdexcept>
 
-#define AddGBufferAttachment(lower, _format, index)            \
-  VkAttachmentDescription lower##Attachment{                   \
-      .format = _format,                                       \
-      .samples = device.GetMSAASamples(),                      \
-      .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,                   \
-      .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,             \
-      .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,        \
-      .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,      \
-      .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,              \
-      .finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, \
-  };                                                           \
-  VkAttachmentReference lower##AttachmentRef{                  \
-      .attachment = gBufferAttachmentIndex + 2 + index,        \
-      .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,      \
-  };                                                           \
-  VkAttachmentReference lower##InputRef {                      \
-    .attachment = gBufferAttachmentIndex + 2 + index,          \
-    .layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,        \
-  }
-
 bool Render::GetEnableMipmap() const {
   return static_cast<Vulkan*>(owner)->GetEnableMipmap();
 }
@@ -44,6 +25,23 @@ bool Render::GetEnableShadowMap() const {
 bool Render::GetEnableDeferred() const {
   return static_cast<Vulkan*>(owner)->GetEnableDeferred();
 }
+bool Render::GetEnableCompactGBuffer() const {
+  return GetEnableDeferred() &&
+         static_cast<Vulkan*>(owner)->GetEnableCompactGBuffer();
+}
+bool Render::GetEnableOcclusionCulling() const {
+  return GetEnableZPrePass() &&
+         static_cast<Vulkan*>(owner)->GetEnableOcclusionCulling();
+}
+bool Render::GetEnableTileClassification() const {
+  return GetEnableDeferred() &&
+         static_cast<Vulkan*>(owner)->GetEnableTileClassification();
+}
+bool Render::GetEnableAsyncCompute() const {
+  const Vulkan* vulkan = static_cast<Vulkan*>(owner);
+  return vulkan->GetEnableAsyncCompute() &&
+         vulkan->GetTimelineSemaphoreSupport();
+}
 uint32_t Render::GetShadowMapWidth() const {
   return static_cast<Vulkan*>(owner)->GetShadowMapWidth();
 }
@@ -60,335 +58,156 @@ float Render::GetDepthBiasSlopeFactor() const {
   return static_cast<Vulkan*>(owner)->GetDepthBiasSlopeFactor();
 }
 
-void Render::CreateColorRenderPass(const Device& device) {
-  // Forward rendering attachments
-  VkAttachmentDescription colorAttachment{
-      .format = swapChain.GetImageFormat(),
-      .samples = device.GetMSAASamples(),
-      .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
-      .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
-      .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
-      .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-      .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-      .finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
-  };
-  if (device.GetMSAASamples() != VK_SAMPLE_COUNT_1_BIT) {
-    colorAttachment.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+std::vector<VkFormat> Render::GetGBufferFormats() const {
+  if (GetEnableCompactGBuffer()) {
+    // Albedo with the pipeline id in alpha, octahedral normal, material
+    return {VK_FORMAT_R8G8B8A8_SRGB, VK_FORMAT_R16G16_SNORM,
+            VK_FORMAT_R8G8B8A8_UNORM};
   }
-  constexpr VkAttachmentReference colorAttachmentRef{
-      .attachment = 0,
-      .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-  };
+  // Color, normal, position with the pipeline id, material, camera normal
+  // and camera position
+  std::vector<VkFormat> formats(GBUFFER_SIZE, VK_FORMAT_R32G32B32A32_SFLOAT);
+  formats[0] = swapChain.GetImageFormat();
+  return formats;
+}
 
-  VkAttachmentDescription depthAttachment{
-      .format = swapChain.GetZPrePassDepthFormat(),
-      .samples = device.GetMSAASamples(),
-      .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
-      .storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-      .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
-      .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-      .initialLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-      .finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-  };
-  if (GetEnableZPrePass()) {
-    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+VkDescriptorImageInfo Render::GetGBufferInputInfoByIndex(
+    const uint32_t index) {
+  if (index < gBufferImages.size()) {
+    return {
+        .sampler = VK_NULL_HANDLE,
+        .imageView = renderGraph.GetImageView(gBufferImages[index]),
+        .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+    };
   }
-  constexpr VkAttachmentReference depthAttachmentRef{
-      .attachment = 1,
-      .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-  };
-  VkAttachmentDescription colorAttachmentResolve{
-      .format = swapChain.GetImageFormat(),
-      .samples = VK_SAMPLE_COUNT_1_BIT,
-      .loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
-      .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
-      .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
-      .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-      .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-      .finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+  return {
+      .sampler = VK_NULL_HANDLE,
+      .imageView = swapChain.GetZPrePassDepth().GetDepthImageView(),
+      .imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL,
   };
-  VkAttachmentReference colorAttachmentResolveRef{
-      .attachment = 2,
-      .layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL,
-  };
-  VkAttachmentReference* pColorAttachmentResolveRef = nullptr;
-  if (device.GetMSAASamples() != VK_SAMPLE_COUNT_1_BIT) {
-    pColorAttachmentResolveRef = &colorAttachmentResolveRef;
-  }
+}
 
-  // Deferred rendering attachments
-  uint32_t gBufferAttachmentIndex = 0;
-  if (device.GetMSAASamples() != VK_SAMPLE_COUNT_1_BIT) {
-    gBufferAttachmentIndex = 1;
+VkDeviceSize Render::GetGBufferMemorySize() const {
+  VkDeviceSize size = 0;
+  for (const RenderGraph::ImageId image : gBufferImages) {
+    size += renderGraph.GetImageMemorySize(image);
   }
+  return size;
+}
 
-  AddGBufferAttachment(fragColor, swapChain.GetImageFormat(), 0);
-  AddGBufferAttachment(fragNormal, VK_FORMAT_R32G32B32A32_SFLOAT, 1);
-  AddGBufferAttachment(fragPosition, VK_FORMAT_R32G32B32A32_SFLOAT, 2);
-  AddGBufferAttachment(fragMaterial, VK_FORMAT_R32G32B32A32_SFLOAT, 3);
-  AddGBufferAttachment(cameraNormal, VK_FORMAT_R32G32B32A32_SFLOAT, 4);
-  AddGBufferAttachment(cameraPosition, VK_FORMAT_R32G32B32A32_SFLOAT, 5);
+bool Render::GetSeparateZPrePass() const {
+  return GetEnableZPrePass() &&
+         renderGraph.SharesRenderPass(zPrePassPass, colorPass) == false;
+}
 
-  std::vector attachments{colorAttachment, depthAttachment};
-  if (device.GetMSAASamples() != VK_SAMPLE_COUNT_1_BIT) {
-    attachments.emplace_back(colorAttachmentResolve);
-  }
-  if (GetEnableDeferred()) {
-    attachments.emplace_back(fragColorAttachment);
-    attachments.emplace_back(fragNormalAttachment);
-    attachments.emplace_back(fragPositionAttachment);
-    attachments.emplace_back(fragMaterialAttachment);
-    attachments.emplace_back(cameraNormalAttachment);
-    attachments.emplace_back(cameraPositionAttachment);
-  }
+bool Render::GetAsyncPass(const RenderGraph::PassId pass) const {
+  return pass != RenderGraphNone && GetEnableAsyncCompute() &&
+         renderGraph.GetQueue(pass) == QueueType::Compute;
+}
 
-  std::array<VkAttachmentReference, GBUFFER_SIZE> gBufferAttachmentRefs{
-      fragColorAttachmentRef,    fragNormalAttachmentRef,
-      fragPositionAttachmentRef, fragMaterialAttachmentRef,
-      cameraNormalAttachmentRef, cameraPositionAttachmentRef};
-
-  std::array<VkAttachmentReference, GBUFFER_SIZE> gBufferInputRefs{
-      fragColorInputRef,    fragNormalInputRef,   fragPositionInputRef,
-      fragMaterialInputRef, cameraNormalInputRef, cameraPositionInputRef};
-
-  // Forward or deferred subpasses
-  std::vector<VkSubpassDescription> subPasses = {{
-      .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
-      .colorAttachmentCount = 1,
-      .pColorAttachments = &colorAttachmentRef,
-      .pResolveAttachments = pColorAttachmentResolveRef,
-      .pDepthStencilAttachment = &depthAttachmentRef,
-  }};
-  if (GetEnableDeferred()) {
-    subPasses = {{
-                     .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
-                     .colorAttachmentCount =
-                         static_cast<uint32_t>(gBufferAttachmentRefs.size()),
-                     .pColorAttachments = gBufferAttachmentRefs.data(),
-                     .pDepthStencilAttachment = &depthAttachmentRef,
-                 },
-                 {
-                     .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
-                     .inputAttachmentCount =
-                         static_cast<uint32_t>(gBufferInputRefs.size()),
-                     .pInputAttachments = gBufferInputRefs.data(),
-                     .colorAttachmentCount = 1,
-                     .pColorAttachments = &colorAttachmentRef,
-                     .pResolveAttachments = pColorAttachmentResolveRef,
-                 }};
+void Render::CreateRenderGraph(const Device& device) {
+  const VkSampleCountFlagBits samples = device.GetMSAASamples();
+  swapChainImage = renderGraph.ImportImage(
+      "SwapChain", swapChain.GetImageFormat(), VK_SAMPLE_COUNT_1_BIT,
+      VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+  depthImage = renderGraph.ImportImage(
+      "Depth", swapChain.GetZPrePassDepthFormat(), samples);
+  if (GetEnableShadowMap()) {
+    for (size_t i = 0; i < GetShadowMapDepthNum(); i++) {
+      shadowMapImages.push_back(renderGraph.ImportImage(
+          "ShadowMap", swapChain.GetShadowMapDepthFormat(),
+          VK_SAMPLE_COUNT_1_BIT));
+    }
   }
-
-  // Forward rendering dependencies
-  /*
-  constexpr VkSubpassDependency depBegToDepthBuffer{
-      .srcSubpass = VK_SUBPASS_EXTERNAL,
-      .dstSubpass = 0,
-      .srcStageMask = VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT,
-      .dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
-                      VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
-      .srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
-                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-      .dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
-                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-      .dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT,
-  };
-  constexpr VkSubpassDependency depEndFromDepthBuffer{
-      .srcSubpass = 0,
-      .dstSubpass = VK_SUBPASS_EXTERNAL,
-      .srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
-                      VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
-      .dstStageMask = VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT,
-      .srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
-                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-      .dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
-                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-      .dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT,
-  };
-  constexpr VkSubpassDependency depBegToColorBuffer{
-      .srcSubpass = VK_SUBPASS_EXTERNAL,
-      .dstSubpass = 0,
-      .srcStageMask = VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT,
-      .dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-      .srcAccessMask = VK_ACCESS_MEMORY_READ_BIT,
-      .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
-                       VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
-  };
-  constexpr VkSubpassDependency depEndFromColorBuffer{
-      .srcSubpass = 0,
-      .dstSubpass = VK_SUBPASS_EXTERNAL,
-      .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-      .dstStageMask = VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT,
-      .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT |
-                       VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
-      .dstAccessMask = VK_ACCESS_MEMORY_READ_BIT,
-  };
-  std::array dependencies = {depBegToDepthBuffer, depEndFromDepthBuffer,
-                             depBegToColorBuffer, depEndFromColorBuffer};
-  */
-  std::vector<VkSubpassDependency> dependencies;
-  if (GetEnableDeferred()) {
-    dependencies.push_back({
-        .srcSubpass = 0,
-        .dstSubpass = 1,
-        .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-        .dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
-        .srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
-        .dstAccessMask = VK_ACCESS_INPUT_ATTACHMENT_READ_BIT,
-        .dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT,
+  // Multisampled color only lives until it is resolved to the swap chain
+  RenderGraphOutput colorOutput{swapChainImage};
+  if (samples != VK_SAMPLE_COUNT_1_BIT) {
+    colorOutput = {
+        .image = renderGraph.AddImage("Color", swapChain.GetImageFormat(),
+                                      samples),
+        .resolve = swapChainImage,
+    };
+  }
+
+  // The depth pyramid is read back before the color pass is recorded, so the
+  // Z-prepass is submitted first and ends its render pass
+  const RenderGraphPassDesc zPrePass{
+      .name = "ZPrePass",
+      .depth = RenderGraphOutput{depthImage},
+  };
+  if (GetEnableOcclusionCulling()) {
+    zPrePassPass = renderGraph.AddPass(zPrePass);
+    depthPyramidPass = renderGraph.AddPass({
+        .name = "DepthPyramid",
+        .compute = true,
+        .queue = QueueType::Compute,
+        .sampled = {depthImage},
     });
   }
-
-  const VkRenderPassCreateInfo renderPassInfo{
-      .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
-      .attachmentCount = static_cast<uint32_t>(attachments.size()),
-      .pAttachments = attachments.data(),
-      .subpassCount = static_cast<uint32_t>(subPasses.size()),
-      .pSubpasses = subPasses.data(),
-      .dependencyCount = static_cast<uint32_t>(dependencies.size()),
-      .pDependencies = dependencies.data(),
-  };
-  if (vkCreateRenderPass(device.GetLogical(), &renderPassInfo, nullptr,
-                         &colorRenderPass) != VK_SUCCESS) {
-    PRINT_AND_THROW_ERROR("failed to create color render pass!");
+  for (const RenderGraph::ImageId image : shadowMapImages) {
+    shadowMapPasses.push_back(renderGraph.AddPass({
+        .name = "ShadowMap",
+        .extent = {GetShadowMapWidth(), GetShadowMapHeight()},
+        .depth = RenderGraphOutput{image},
+    }));
   }
-}
-
-void Render::CreateZPrePassRenderPass(const Device& device) {
-  const VkAttachmentDescription depthAttachment{
-      .format = swapChain.GetZPrePassDepthFormat(),
-      .samples = device.GetMSAASamples(),
-      .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
-      .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
-      .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
-      .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-      .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-      .finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-  };
-  constexpr VkAttachmentReference depthAttachmentRef{
-      .attachment = 0,
-      .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-  };
-
-  VkSubpassDescription subPass{
-      .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
-      .colorAttachmentCount = 0,
-      .pColorAttachments = nullptr,
-      .pDepthStencilAttachment = &depthAttachmentRef,
-  };
-  /*
-  constexpr VkSubpassDependency depBegToDepthBuffer{
-      .srcSubpass = VK_SUBPASS_EXTERNAL,
-      .dstSubpass = 0,
-      .srcStageMask = VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT,
-      .dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
-                      VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
-      .srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
-                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-      .dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
-                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-      .dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT,
-  };
-  constexpr VkSubpassDependency depEndFromDepthBuffer{
-      .srcSubpass = 0,
-      .dstSubpass = VK_SUBPASS_EXTERNAL,
-      .srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
-                      VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
-      .dstStageMask = VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT,
-      .srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
-                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-      .dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
-                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-      .dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT,
-  };
-  std::array dependencies{depBegToDepthBuffer, depEndFromDepthBuffer};
-  */
-  std::vector<VkSubpassDependency> dependencies;
-  const VkRenderPassCreateInfo renderPassInfo{
-      .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
-      .attachmentCount = 1,
-      .pAttachments = &depthAttachment,
-      .subpassCount = 1,
-      .pSubpasses = &subPass,
-      .dependencyCount = static_cast<uint32_t>(dependencies.size()),
-      .pDependencies = dependencies.data(),
-  };
-  if (vkCreateRenderPass(device.GetLogical(), &renderPassInfo, nullptr,
-                         &zPrePassRenderPass) != VK_SUCCESS) {
-    PRINT_AND_THROW_ERROR("failed to create z pre pass render pass!");
+  if (GetEnableZPrePass() && GetEnableOcclusionCulling() == false) {
+    zPrePassPass = renderGraph.AddPass(zPrePass);
   }
-}
-
-void Render::CreateShadowMapRenderPass(const Device& device) {
-  const VkAttachmentDescription depthAttachment{
-      .format = swapChain.GetShadowMapDepthFormat(),
-      .samples = VK_SAMPLE_COUNT_1_BIT,
-      .loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR,
-      .storeOp = VK_ATTACHMENT_STORE_OP_STORE,
-      .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
-      .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
-      .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-      .finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-  };
-  constexpr VkAttachmentReference depthAttachmentRef{
-      .attachment = 0,
-      .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-  };
 
-  VkSubpassDescription subPass{
-      .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
-      .colorAttachmentCount = 0,
-      .pColorAttachments = nullptr,
-      .pDepthStencilAttachment = &depthAttachmentRef,
-  };
-  /*
-  constexpr VkSubpassDependency depBegToDepthBuffer{
-      .srcSubpass = VK_SUBPASS_EXTERNAL,
-      .dstSubpass = 0,
-      .srcStageMask = VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT,
-      .dstStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
-                      VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
-      .srcAccessMask = VK_ACCESS_SHADER_READ_BIT,
-      .dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
-                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-      .dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT,
-  };
-  constexpr VkSubpassDependency depEndFromDepthBuffer{
-      .srcSubpass = 0,
-      .dstSubpass = VK_SUBPASS_EXTERNAL,
-      .srcStageMask = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
-                      VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
-      .dstStageMask = VK_PIPELINE_STAGE_ALL_GRAPHICS_BIT,
-      .srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
-                       VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-      .dstAccessMask = VK_ACCESS_SHADER_READ_BIT,
-      .dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT,
-  };
-  std::array dependencies{depBegToDepthBuffer, depEndFromDepthBuffer};
-  */
-  std::vector<VkSubpassDependency> dependencies;
-  const VkRenderPassCreateInfo renderPassInfo{
-      .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
-      .attachmentCount = 1,
-      .pAttachments = &depthAttachment,
-      .subpassCount = 1,
-      .pSubpasses = &subPass,
-      .dependencyCount = static_cast<uint32_t>(dependencies.size()),
-      .pDependencies = dependencies.data(),
+  const RenderGraphOutput depthOutput{
+      .image = depthImage,
+      .clear = GetEnableZPrePass() == false,
   };
-  if (vkCreateRenderPass(device.GetLogical(), &renderPassInfo, nullptr,
-                         &shadowMapRenderPass) != VK_SUCCESS) {
-    PRINT_AND_THROW_ERROR("failed to create shadow map render pass!");
+  if (GetEnableDeferred()) {
+    std::vector<RenderGraphOutput> gBufferOutputs;
+    for (const VkFormat format : GetGBufferFormats()) {
+      gBufferImages.push_back(renderGraph.AddImage("GBuffer", format, samples));
+      gBufferOutputs.push_back({gBufferImages.back()});
+    }
+    std::vector<RenderGraph::ImageId> inputs = gBufferImages;
+    if (GetEnableCompactGBuffer()) {
+      inputs.push_back(depthImage);
+    }
+    colorPass = renderGraph.AddPass({
+        .name = "GBuffer",
+        .colors = gBufferOutputs,
+        .depth = depthOutput,
+    });
+    // Reads the pipeline ids once the G-buffer is stored
+    if (GetEnableTileClassification()) {
+      lightingTilesPass = renderGraph.AddPass({
+          .name = "LightingTiles",
+          .compute = true,
+          .sampled = {gBufferImages[GetGBufferPipelineIdIndex()]},
+      });
+    }
+    lightingPass = renderGraph.AddPass({
+        .name = "Lighting",
+        .colors = {colorOutput},
+        .inputs = inputs,
+        .sampled = shadowMapImages,
+    });
+  } else {
+    colorPass = renderGraph.AddPass({
+        .name = "Color",
+        .colors = {colorOutput},
+        .depth = depthOutput,
+        .sampled = shadowMapImages,
+    });
   }
+  renderGraph.Compile(device.GetLogical());
 }
 
-void Render::CreateRenderPasses(const Device& device) {
-  CreateColorRenderPass(device);
-  if (GetEnableZPrePass()) {
-    CreateZPrePassRenderPass(device);
-  }
-  if (GetEnableShadowMap()) {
-    CreateShadowMapRenderPass(device);
+void Render::CreateRenderGraphResources(const Device& device) {
+  renderGraph.SetImportedViews(swapChainImage, swapChain.GetImageViews());
+  renderGraph.SetImportedViews(
+      depthImage, {swapChain.GetZPrePassDepth().GetDepthImageView()});
+  for (uint32_t i = 0; i < shadowMapImages.size(); i++) {
+    renderGraph.SetImportedViews(shadowMapImages[i],
+                                 {GetShadowMapDepthImageViewByIndex(i)});
   }
+  renderGraph.CreateResources(device, swapChain.GetExtent());
 }
 
 void Render::CreateCommandPool(const Device& device,
@@ -429,7 +248,7 @@ void Render::CreateCommandBuffers(
 
 void Render::CreateCommandBuffersSet(const VkDevice& device) {
   CreateCommandBuffers(device, colorCommandBuffers);
-  if (GetEnableZPrePass()) {
+  if (GetSeparateZPrePass()) {
     CreateCommandBuffers(device, zPrePassCommandBuffers);
   }
   if (GetEnableShadowMap()) {
@@ -484,77 +303,75 @@ void Render::EndSingleTimeCommands(const Device& device,
   vkFreeCommandBuffers(device.GetLogical(), commandPool, 1, commandBuffer);
 }
 
-void Render::ConvertShaderSourceToShadowMapDepth(
-    const Device& device, VkCommandBuffer commandBuffer) {
-  bool requireOneTimeCommandBuffer = false;
-  if (commandBuffer == VK_NULL_HANDLE) {
-    requireOneTimeCommandBuffer = true;
+UploadBatch Render::BeginUpload(const VkDevice& device) const {
+  UploadBatch batch;
+  BeginSingleTimeCommands(device, &batch.commandBuffer);
+  return batch;
+}
 
-    commandBuffer = {};
-    BeginSingleTimeCommands(device.GetLogical(), &commandBuffer);
-  }
-  for (uint32_t i = 0; i < GetShadowMapDepthNum(); i++) {
-    swapChain.GetShadowMapDepthByIndex(i).TransitionDepthImageLayout(
-        device, *this, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
-        VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL, commandBuffer);
+Render::UploadAwaiter Render::SubmitUpload(const Device& device,
+                                           UploadBatch& batch) {
+  vkEndCommandBuffer(batch.commandBuffer);
+  constexpr VkFenceCreateInfo fenceInfo{
+      .sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO,
+  };
+  if (vkCreateFence(device.GetLogical(), &fenceInfo, nullptr, &batch.fence) !=
+      VK_SUCCESS) {
+    PRINT_AND_THROW_ERROR("failed to create upload fence!");
   }
-  if (requireOneTimeCommandBuffer == true) {
-    EndSingleTimeCommands(device, &commandBuffer);
+  const VkSubmitInfo submitInfo{
+      .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+      .commandBufferCount = 1,
+      .pCommandBuffers = &batch.commandBuffer,
+  };
+  if (vkQueueSubmit(device.GetGraphicsQueue(), 1, &submitInfo, batch.fence) !=
+      VK_SUCCESS) {
+    PRINT_AND_THROW_ERROR("failed to submit upload command buffer!");
   }
+  return {*this, batch.fence};
 }
-void Render::ConvertShadowMapDepthToShaderSource(
-    const Device& device, VkCommandBuffer commandBuffer) {
-  bool requireOneTimeCommandBuffer = false;
-  if (commandBuffer == VK_NULL_HANDLE) {
-    requireOneTimeCommandBuffer = true;
-
-    commandBuffer = {};
-    BeginSingleTimeCommands(device.GetLogical(), &commandBuffer);
-  }
-  for (uint32_t i = 0; i < GetShadowMapDepthNum(); i++) {
-    swapChain.GetShadowMapDepthByIndex(i).TransitionDepthImageLayout(
-        device, *this, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-        VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, commandBuffer);
-  }
-  if (requireOneTimeCommandBuffer == true) {
-    EndSingleTimeCommands(device, &commandBuffer);
+
+void Render::EndUpload(const VkDevice& device, UploadBatch& batch) const {
+  for (const auto& [buffer, memory] : batch.stagingBuffers) {
+    vkDestroyBuffer(device, buffer, nullptr);
+    vkFreeMemory(device, memory, nullptr);
   }
+  batch.stagingBuffers.clear();
+  vkDestroyFence(device, batch.fence, nullptr);
+  vkFreeCommandBuffers(device, commandPool, 1, &batch.commandBuffer);
 }
 
-void Render::RecordZPrePassCommandBuffer(
-    const Device& device, std::unordered_map<std::string, Draw*>& draws) {
-  const VkCommandBuffer& commandBuffer = zPrePassCommandBuffers[currentFrame];
-
-  constexpr VkCommandBufferBeginInfo commandBufferBeginInfo{
-      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
-      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
-      .pInheritanceInfo = nullptr,
-  };
-  if (vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo) !=
-      VK_SUCCESS) {
-    PRINT_AND_THROW_ERROR("failed to begin recording command buffer!");
+void Render::ResumeCompletedUploads(const VkDevice& device) {
+  // Resumed coroutines may submit new uploads, resume them from a copy
+  std::vector<std::coroutine_handle<>> completed;
+  std::erase_if(pendingUploads, [&device, &completed](const auto& upload) {
+    if (vkGetFenceStatus(device, upload.first) != VK_SUCCESS) {
+      return false;
+    }
+    completed.push_back(upload.second);
+    return true;
+  });
+  for (const std::coroutine_handle<> handle : completed) {
+    handle.resume();
   }
-  constexpr std::array clearValues{
-      VkClearValue{.depthStencil = {1.0f, 0}},
-  };
-  VkRenderPassBeginInfo renderPassBeginInfo{
-      .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-      .renderPass = zPrePassRenderPass,
-      .framebuffer = swapChain.GetZPrePassFrameBuffer(),
-      .clearValueCount = static_cast<uint32_t>(clearValues.size()),
-      .pClearValues = clearValues.data(),
-  };
-  renderPassBeginInfo.renderArea.offset = {0, 0};
-  renderPassBeginInfo.renderArea.extent = swapChain.GetExtent();
+}
 
-  vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo,
-                       VK_SUBPASS_CONTENTS_INLINE);
+void Render::FlushUploads(const VkDevice& device) {
+  while (pendingUploads.empty() == false) {
+    for (const auto& [fence, handle] : pendingUploads) {
+      vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX);
+    }
+    ResumeCompletedUploads(device);
+  }
+}
 
+void Render::SetViewport(VkCommandBuffer commandBuffer,
+                         const VkExtent2D& extent) {
   const VkViewport viewport{
       .x = 0.0f,
       .y = 0.0f,
-      .width = static_cast<float>(swapChain.GetExtent().width),
-      .height = static_cast<float>(swapChain.GetExtent().height),
+      .width = static_cast<float>(extent.width),
+      .height = static_cast<float>(extent.height),
       .minDepth = 0.0f,
       .maxDepth = 1.0f,
   };
@@ -562,45 +379,95 @@ void Render::RecordZPrePassCommandBuffer(
 
   const VkRect2D scissor{
       .offset = {0, 0},
-      .extent = swapChain.GetExtent(),
+      .extent = extent,
   };
   vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+}
 
-  for (Draw* draw : draws | std::views::values) {
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                      draw->GetZPrePassGraphicsPipeline());
-
-    for (const auto& mesh : draw->GetMeshes()) {
-      const VkBuffer vertexBuffers[] = {mesh->GetVertexBuffer()};
-      constexpr VkDeviceSize offsets[] = {0};
-      vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+void Render::RecordZPrePass(VkCommandBuffer commandBuffer,
+                            const uint32_t frameBufferIndex) {
+  renderGraph.BeginPass(commandBuffer, zPrePassPass, frameBufferIndex);
+  SetViewport(commandBuffer, renderGraph.GetExtent(zPrePassPass));
 
-      vkCmdBindIndexBuffer(commandBuffer, mesh->GetIndexBuffer(), 0,
-                           VK_INDEX_TYPE_UINT32);
+  DrawStateCache state(commandBuffer, drawStats);
+  for (const auto& [key, draw, mesh] : drawList.GetPass(DrawPass::ZPrePass)) {
+    state.BindPipeline(draw->GetZPrePassGraphicsPipeline());
+    state.BindBuffers(mesh->GetVertexBuffer(), mesh->GetIndexBuffer(),
+                      mesh->GetIndexType());
+    state.BindDescriptorSet(
+        draw->GetZPrePassPipelineLayout(),
+        mesh->GetZPrePassDescriptorSetByIndex(currentFrame));
 
-      vkCmdBindDescriptorSets(
-          commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-          draw->GetZPrePassPipelineLayout(), 0, 1,
-          &mesh->GetZPrePassDescriptorSetByIndex(currentFrame), 0, nullptr);
+    const MeshLod& lod = mesh->GetLod();
+    state.DrawIndexed(lod.indexCount, lod.indexOffset);
+  }
+  renderGraph.EndPass(commandBuffer, zPrePassPass);
 
-      vkCmdDrawIndexed(commandBuffer,
-                       static_cast<uint32_t>(mesh->GetIndices().size()), 1, 0,
-                       0, 0);
-    }
+  if (GetAsyncPass(depthPyramidPass)) {
+    asyncCompute.RecordRelease(commandBuffer, GetDepthQueueTransfer(),
+                               QueueType::Graphics);
+  } else if (GetEnableOcclusionCulling()) {
+    occlusionCulling.RecordBuildPyramid(commandBuffer);
   }
-  vkCmdEndRenderPass(commandBuffer);
+}
 
-  if (GetEnableShadowMap()) {
-    ConvertShaderSourceToShadowMapDepth(device, commandBuffer);
+QueueImageTransfer Render::GetDepthQueueTransfer() {
+  Depth& depth = swapChain.GetZPrePassDepth();
+  VkImageAspectFlags aspects = VK_IMAGE_ASPECT_DEPTH_BIT;
+  if (Depth::HasStencilComponent(depth.GetDepthFormat())) {
+    aspects |= VK_IMAGE_ASPECT_STENCIL_BIT;
   }
+  // The render passes on either side of the pyramid depend on it at the
+  // compute stage, where the layout transitions of the graph end and begin
+  return {
+      .image = depth.GetDepthImage(),
+      .aspects = aspects,
+      .layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+      .graphicsStages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+                        VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT |
+                        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+      .graphicsAccesses = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+                          VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+      .computeStages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+      .computeAccesses = VK_ACCESS_SHADER_READ_BIT,
+  };
+}
+
+void Render::SubmitDepthPyramid(const Device& device,
+                                TimelinePoint zPrePassDone) {
+  const QueueImageTransfer depthTransfer = GetDepthQueueTransfer();
+  const VkCommandBuffer commandBuffer =
+      asyncCompute.BeginCommandBuffer(device.GetLogical(), currentFrame);
+  asyncCompute.RecordAcquire(commandBuffer, depthTransfer, QueueType::Compute);
+  occlusionCulling.RecordBuildPyramid(commandBuffer);
+  asyncCompute.RecordRelease(commandBuffer, depthTransfer, QueueType::Compute);
+
+  zPrePassDone.stages = depthTransfer.computeStages;
+  depthPyramidDone = asyncCompute.Submit(currentFrame, zPrePassDone);
+  depthPyramidDone.stages = depthTransfer.graphicsStages;
+}
+
+void Render::RecordZPrePassCommandBuffer(
+    const Device& device, std::unordered_map<StringId, Draw*>& draws) {
+  const VkCommandBuffer& commandBuffer = zPrePassCommandBuffers[currentFrame];
 
+  constexpr VkCommandBufferBeginInfo commandBufferBeginInfo{
+      .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+      .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+      .pInheritanceInfo = nullptr,
+  };
+  if (vkBeginCommandBuffer(commandBuffer, &commandBufferBeginInfo) !=
+      VK_SUCCESS) {
+    PRINT_AND_THROW_ERROR("failed to begin recording command buffer!");
+  }
+  RecordZPrePass(commandBuffer, 0);
   if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
     PRINT_AND_THROW_ERROR("failed to record command buffer!");
   }
 }
 
 void Render::RecordShadowMapCommandBuffer(
-    const Device& device, std::unordered_map<std::string, Draw*>& draws,
+    const Device& device, std::unordered_map<StringId, Draw*>& draws,
     BaseLight* light) {
   const VkCommandBuffer& commandBuffer =
       shadowMapCommandBuffers[light->GetId()][currentFrame];
@@ -614,65 +481,25 @@ void Render::RecordShadowMapCommandBuffer(
     PRINT_AND_THROW_ERROR("failed to begin recording command buffer!");
   }
 
-  constexpr std::array clearValues{
-      VkClearValue{.depthStencil = {1.0f, 0}},
-  };
-  VkRenderPassBeginInfo renderPassBeginInfo{
-      .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-      .renderPass = shadowMapRenderPass,
-      .framebuffer = swapChain.GetShadowMapFrameBufferByIndex(light->GetId()),
-      .clearValueCount = static_cast<uint32_t>(clearValues.size()),
-      .pClearValues = clearValues.data(),
-  };
-  renderPassBeginInfo.renderArea.offset = {0, 0};
-  renderPassBeginInfo.renderArea.extent = {GetShadowMapWidth(),
-                                           GetShadowMapHeight()};
-
-  vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo,
-                       VK_SUBPASS_CONTENTS_INLINE);
-
-  const VkViewport viewport{
-      .x = 0.0f,
-      .y = 0.0f,
-      .width = static_cast<float>(GetShadowMapWidth()),
-      .height = static_cast<float>(GetShadowMapHeight()),
-      .minDepth = 0.0f,
-      .maxDepth = 1.0f,
-  };
-  vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-
-  const VkRect2D scissor{
-      .offset = {0, 0},
-      .extent = {GetShadowMapWidth(), GetShadowMapHeight()},
-  };
-  vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+  const RenderGraph::PassId pass = shadowMapPasses[light->GetId()];
+  renderGraph.BeginPass(commandBuffer, pass);
+  SetViewport(commandBuffer, renderGraph.GetExtent(pass));
   vkCmdSetDepthBias(commandBuffer, GetDepthBiasConstantFactor(),
                     GetDepthBiasClamp(), GetDepthBiasSlopeFactor());
 
-  for (Draw* draw : draws | std::views::values) {
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                      draw->GetShadowMapGraphicsPipeline());
+  DrawStateCache state(commandBuffer, drawStats);
+  for (const auto& [key, draw, mesh] : drawList.GetPass(DrawPass::ShadowMap)) {
+    state.BindPipeline(draw->GetShadowMapGraphicsPipeline());
+    state.BindBuffers(mesh->GetVertexBuffer(), mesh->GetIndexBuffer(),
+                      mesh->GetIndexType());
+    state.BindDescriptorSet(
+        draw->GetShadowMapPipelineLayout(),
+        mesh->GetShadowMapDescriptorSetByIndices(light->GetId(), currentFrame));
 
-    for (const auto& mesh : draw->GetMeshes()) {
-      const VkBuffer vertexBuffers[] = {mesh->GetVertexBuffer()};
-      constexpr VkDeviceSize offsets[] = {0};
-      vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-
-      vkCmdBindIndexBuffer(commandBuffer, mesh->GetIndexBuffer(), 0,
-                           VK_INDEX_TYPE_UINT32);
-
-      vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                              draw->GetShadowMapPipelineLayout(), 0, 1,
-                              &mesh->GetShadowMapDescriptorSetByIndices(
-                                  light->GetId(), currentFrame),
-                              0, nullptr);
-
-      vkCmdDrawIndexed(commandBuffer,
-                       static_cast<uint32_t>(mesh->GetIndices().size()), 1, 0,
-                       0, 0);
-    }
+    const MeshLod& lod = mesh->GetShadowLod();
+    state.DrawIndexed(lod.indexCount, lod.indexOffset);
   }
-  vkCmdEndRenderPass(commandBuffer);
+  renderGraph.EndPass(commandBuffer, pass);
 
   if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
     PRINT_AND_THROW_ERROR("failed to record command buffer!");
@@ -680,7 +507,7 @@ void Render::RecordShadowMapCommandBuffer(
 }
 
 void Render::RecordColorCommandBuffer(
-    const Device& device, std::unordered_map<std::string, Draw*>& draws,
+    const Device& device, std::unordered_map<StringId, Draw*>& draws,
     const uint32_t imageIndex) {
   const VkCommandBuffer& commandBuffer = colorCommandBuffers[currentFrame];
 
@@ -693,78 +520,42 @@ void Render::RecordColorCommandBuffer(
     PRINT_AND_THROW_ERROR("failed to begin recording command buffer!");
   }
 
-  if (GetEnableShadowMap()) {
-    ConvertShadowMapDepthToShaderSource(device, commandBuffer);
+  if (GetEnableDeferred()) {
+    lightingTimer.RecordReset(commandBuffer, currentFrame);
   }
-
-  std::vector clearValues{
-      VkClearValue{.color = {{0.0f, 0.0f, 0.0f, 1.0f}}},
-      VkClearValue{
-          .depthStencil = {1.0f, 0},
-      },
-  };
-  if (device.GetMSAASamples() != VK_SAMPLE_COUNT_1_BIT) {
-    clearValues.emplace_back(VkClearValue{.color = {{0.0f, 0.0f, 0.0f, 1.0f}}});
+  if (GetAsyncPass(depthPyramidPass)) {
+    asyncCompute.RecordAcquire(commandBuffer, GetDepthQueueTransfer(),
+                               QueueType::Graphics);
   }
-  if (GetEnableDeferred()) {
-    for (int i = 0; i < GBUFFER_SIZE; i++) {
-      clearValues.emplace_back(
-          VkClearValue{.color = {{0.0f, 0.0f, 0.0f, 1.0f}}});
-    }
+  if (GetEnableZPrePass() && GetSeparateZPrePass() == false) {
+    RecordZPrePass(commandBuffer, imageIndex);
   }
-  VkRenderPassBeginInfo renderPassBeginInfo{
-      .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-      .renderPass = colorRenderPass,
-      .framebuffer = swapChain.GetColorFrameBufferByIndex(imageIndex),
-      .clearValueCount = static_cast<uint32_t>(clearValues.size()),
-      .pClearValues = clearValues.data(),
-  };
-  renderPassBeginInfo.renderArea.offset = {0, 0};
-  renderPassBeginInfo.renderArea.extent = swapChain.GetExtent();
-
-  vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo,
-                       VK_SUBPASS_CONTENTS_INLINE);
-
-  const VkViewport viewport{
-      .x = 0.0f,
-      .y = 0.0f,
-      .width = static_cast<float>(swapChain.GetExtent().width),
-      .height = static_cast<float>(swapChain.GetExtent().height),
-      .minDepth = 0.0f,
-      .maxDepth = 1.0f,
-  };
-  vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+  renderGraph.BeginPass(commandBuffer, colorPass, imageIndex);
+  SetViewport(commandBuffer, renderGraph.GetExtent(colorPass));
 
-  const VkRect2D scissor{
-      .offset = {0, 0},
-      .extent = swapChain.GetExtent(),
-  };
-  vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-
-  for (Draw* draw : draws | std::views::values) {
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                      draw->GetColorGraphicsPipeline());
-
-    for (const auto& mesh : draw->GetMeshes()) {
-      const VkBuffer vertexBuffers[] = {mesh->GetVertexBuffer()};
-      constexpr VkDeviceSize offsets[] = {0};
-      vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-
-      vkCmdBindIndexBuffer(commandBuffer, mesh->GetIndexBuffer(), 0,
-                           VK_INDEX_TYPE_UINT32);
-
-      vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                              draw->GetColorPipelineLayout(), 0, 1,
-                              &mesh->GetColorDescriptorSetByIndex(currentFrame),
-                              0, nullptr);
-
-      vkCmdDrawIndexed(commandBuffer,
-                       static_cast<uint32_t>(mesh->GetIndices().size()), 1, 0,
-                       0, 0);
+  DrawStateCache state(commandBuffer, drawStats);
+  for (const auto& [key, draw, mesh] : drawList.GetPass(DrawPass::Color)) {
+    if (mesh->GetOccluded()) {
+      continue;
     }
+    state.BindPipeline(draw->GetColorGraphicsPipeline());
+    state.BindBuffers(mesh->GetVertexBuffer(), mesh->GetIndexBuffer(),
+                      mesh->GetIndexType());
+    state.BindDescriptorSet(draw->GetColorPipelineLayout(),
+                            mesh->GetColorDescriptorSetByIndex(currentFrame));
+
+    const MeshLod& lod = mesh->GetLod();
+    state.DrawIndexed(lod.indexCount, lod.indexOffset);
   }
+  renderGraph.EndPass(commandBuffer, colorPass);
   if (GetEnableDeferred()) {
-    vkCmdNextSubpass(commandBuffer, VK_SUBPASS_CONTENTS_INLINE);
+    lightingTimer.RecordBegin(commandBuffer, currentFrame);
+    if (GetEnableTileClassification()) {
+      lightingTiles.RecordClassify(commandBuffer, currentFrame);
+    }
+    renderGraph.BeginPass(commandBuffer, lightingPass, imageIndex);
+    SetViewport(commandBuffer, renderGraph.GetExtent(lightingPass));
+    const DeferredViewData viewData = GetDeferredViewData();
     for (Draw* draw : draws | std::views::values) {
       vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
                         draw->GetDeferredGraphicsPipeline());
@@ -773,35 +564,88 @@ void Render::RecordColorCommandBuffer(
           commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
           draw->GetDeferredPipelineLayout(), 0, 1,
           &draw->GetDeferredDescriptorSetByIndex(currentFrame), 0, nullptr);
+      if (GetEnableCompactGBuffer()) {
+        vkCmdPushConstants(commandBuffer, draw->GetDeferredPipelineLayout(),
+                           VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(viewData),
+                           &viewData);
+      }
 
-      vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+      if (GetEnableTileClassification()) {
+        lightingTiles.RecordDraw(commandBuffer, draw->GetPipelineId());
+      } else {
+        vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+      }
     }
+    renderGraph.EndPass(commandBuffer, lightingPass);
+    lightingTimer.RecordEnd(commandBuffer, currentFrame);
   }
-  vkCmdEndRenderPass(commandBuffer);
   if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
     PRINT_AND_THROW_ERROR("failed to record command buffer!");
   }
 }
 
+DeferredViewData Render::GetDeferredViewData() const {
+  // Meshes share the camera, any of them carries its matrices
+  const std::span<const DrawItem> items = drawList.GetPass(DrawPass::Color);
+  if (items.empty()) {
+    return {};
+  }
+  const TransformData& transform =
+      items.front().mesh->GetTransformData(currentFrame);
+  const glm::mat4 cameraToWorld = glm::inverse(transform.viewMatrix);
+
+  // gl_FragCoord to normalized device coordinates, depth is kept as is
+  const VkExtent2D& extent = swapChain.GetExtent();
+  const glm::mat4 screenToNdc =
+      glm::scale(glm::translate(glm::mat4(1), glm::vec3(-1, -1, 0)),
+                 glm::vec3(2.0f / static_cast<float>(extent.width),
+                           2.0f / static_cast<float>(extent.height), 1));
+  return {
+      .screenToWorld =
+          glm::inverse(transform.projMatrix * transform.viewMatrix) *
+          screenToNdc,
+      .cameraPosition = cameraToWorld[3],
+      .cameraNormal = -cameraToWorld[2],
+  };
+}
+
 void Render::SubmitCommandBuffer(const Device& device,
                                  const VkSemaphore& waitSemaphore,
                                  const VkCommandBuffer& commandBuffer,
                                  const VkSemaphore& signalSemaphore,
-                                 const VkFence waitFence) {
-  constexpr VkPipelineStageFlags waitStages[] = {
+                                 const VkFence waitFence,
+                                 const TimelinePoint& timelineWait,
+                                 const TimelinePoint& timelineSignal) {
+  const std::array waitSemaphores{waitSemaphore, timelineWait.semaphore};
+  const std::array<VkPipelineStageFlags, 2> waitStages{
       VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
-      VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+      timelineWait.stages,
+  };
+  const std::array signalSemaphores{signalSemaphore, timelineSignal.semaphore};
+  // Binary semaphores ignore their values
+  const std::array<uint64_t, 2> waitValues{0, timelineWait.value};
+  const std::array<uint64_t, 2> signalValues{0, timelineSignal.value};
+  const uint32_t waitCount = timelineWait.semaphore != VK_NULL_HANDLE ? 2 : 1;
+  const uint32_t signalCount =
+      timelineSignal.semaphore != VK_NULL_HANDLE ? 2 : 1;
+
+  const VkTimelineSemaphoreSubmitInfo timelineInfo{
+      .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+      .waitSemaphoreValueCount = waitCount,
+      .pWaitSemaphoreValues = waitValues.data(),
+      .signalSemaphoreValueCount = signalCount,
+      .pSignalSemaphoreValues = signalValues.data(),
   };
-
   const VkSubmitInfo submitInfo{
       .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-      .waitSemaphoreCount = 1,
-      .pWaitSemaphores = &waitSemaphore,
-      .pWaitDstStageMask = waitStages,
+      .pNext = &timelineInfo,
+      .waitSemaphoreCount = waitCount,
+      .pWaitSemaphores = waitSemaphores.data(),
+      .pWaitDstStageMask = waitStages.data(),
       .commandBufferCount = 1,
       .pCommandBuffers = &commandBuffer,
-      .signalSemaphoreCount = 1,
-      .pSignalSemaphores = &signalSemaphore,
+      .signalSemaphoreCount = signalCount,
+      .pSignalSemaphores = signalSemaphores.data(),
   };
   if (vkQueueSubmit(device.GetGraphicsQueue(), 1, &submitInfo, waitFence) !=
       VK_SUCCESS) {
@@ -814,7 +658,7 @@ void Render::WaitFences(
     std::unordered_map<int, std::weak_ptr<BaseLight>>& lightsById) {
   vkWaitForFences(device.GetLogical(), 1, &colorInFlightFences[currentFrame],
                   VK_TRUE, UINT64_MAX);
-  if (GetEnableZPrePass()) {
+  if (GetSeparateZPrePass()) {
     vkWaitForFences(device.GetLogical(), 1,
                     &zPrePassInFlightFences[currentFrame], VK_TRUE, UINT64_MAX);
   }
@@ -835,7 +679,7 @@ void Render::ResetFences(
     const Device& device,
     std::unordered_map<int, std::weak_ptr<BaseLight>>& lightsById) {
   vkResetFences(device.GetLogical(), 1, &colorInFlightFences[currentFrame]);
-  if (GetEnableZPrePass()) {
+  if (GetSeparateZPrePass()) {
     vkResetFences(device.GetLogical(), 1,
                   &zPrePassInFlightFences[currentFrame]);
   }
@@ -852,7 +696,7 @@ void Render::ResetFences(
 }
 
 void Render::DrawFrame(
-    const Device& device, std::unordered_map<std::string, Draw*>& draws,
+    const Device& device, std::unordered_map<StringId, Draw*>& draws,
     std::unordered_map<int, std::weak_ptr<BaseLight>>& lightsById,
     VkWindow& window) {
   WaitFences(device, lightsById);
@@ -862,29 +706,45 @@ void Render::DrawFrame(
       imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
 
   if (result == VK_ERROR_OUT_OF_DATE_KHR) {
-    swapChain.RecreateSwapChain(device, window, draws);
+    RecreateSwapChain(device, window, draws);
     return;
   }
   if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
     PRINT_AND_THROW_ERROR("failed to acquire swap chain image!");
   }
   ResetFences(device, lightsById);
+  if (GetEnableTileClassification()) {
+    CountLightingTiles(draws);
+  }
+  if (GetEnableDeferred()) {
+    lightingTimer.ReadTime(device.GetLogical(), currentFrame);
+  }
 
-  if (GetEnableZPrePass()) {
+  drawStats = {};
+  depthPyramidDone = {};
+  drawList.Build(draws, currentFrame, GetEnableZPrePass(),
+                 GetEnableShadowMap());
+
+  if (GetSeparateZPrePass()) {
     vkResetCommandBuffer(zPrePassCommandBuffers[currentFrame],
                          /*VkCommandBufferResetFlagBits*/
                          0);
     RecordZPrePassCommandBuffer(device, draws);
+    const TimelinePoint zPrePassDone = GetAsyncPass(depthPyramidPass)
+                                           ? asyncCompute.SignalGraphics()
+                                           : TimelinePoint{};
     SubmitCommandBuffer(device, imageAvailableSemaphores[currentFrame],
                         zPrePassCommandBuffers[currentFrame],
                         zPrePassFinishedSemaphores[currentFrame],
-                        zPrePassInFlightFences[currentFrame]);
-  } else if (GetEnableShadowMap()) {
-    ConvertShaderSourceToShadowMapDepth(device);
+                        zPrePassInFlightFences[currentFrame], {},
+                        zPrePassDone);
+    if (GetAsyncPass(depthPyramidPass)) {
+      SubmitDepthPyramid(device, zPrePassDone);
+    }
   }
 
   VkSemaphore lastSemaphore = imageAvailableSemaphores[currentFrame];
-  if (GetEnableZPrePass()) {
+  if (GetSeparateZPrePass()) {
     lastSemaphore = zPrePassFinishedSemaphores[currentFrame];
   }
 
@@ -908,13 +768,16 @@ void Render::DrawFrame(
     }
   }
 
+  if (GetEnableOcclusionCulling()) {
+    CullOccludedMeshes(device, draws);
+  }
   vkResetCommandBuffer(colorCommandBuffers[currentFrame],
                        /*VkCommandBufferResetFlagBits*/
                        0);
   RecordColorCommandBuffer(device, draws, imageIndex);
   SubmitCommandBuffer(device, lastSemaphore, colorCommandBuffers[currentFrame],
                       renderFinishedSemaphores[currentFrame],
-                      colorInFlightFences[currentFrame]);
+                      colorInFlightFences[currentFrame], depthPyramidDone);
 
   const VkPresentInfoKHR presentInfo{
       .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
@@ -929,19 +792,81 @@ void Render::DrawFrame(
   if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR ||
       window.GetFrameBufferResized()) {
     window.SetFrameBufferResized(false);
-    swapChain.RecreateSwapChain(device, window, draws);
+    RecreateSwapChain(device, window, draws);
   } else if (result != VK_SUCCESS) {
     PRINT_AND_THROW_ERROR("failed to present swap chain image!");
   }
   currentFrame = (currentFrame + 1) % maxFramesInFlight;
 }
 
+void Render::CullOccludedMeshes(const Device& device,
+                                std::unordered_map<StringId, Draw*>& draws) {
+  if (GetAsyncPass(depthPyramidPass)) {
+    asyncCompute.Wait(device.GetLogical(), depthPyramidDone);
+  } else {
+    vkWaitForFences(device.GetLogical(), 1,
+                    &zPrePassInFlightFences[currentFrame], VK_TRUE,
+                    UINT64_MAX);
+  }
+  occlusionStats = {};
+  for (Draw* draw : draws | std::views::values) {
+    for (const auto& mesh : draw->GetMeshes()) {
+      occlusionStats.tested++;
+      if (mesh->TestOcclusion(occlusionCulling, currentFrame)) {
+        occlusionStats.culled++;
+      }
+    }
+  }
+}
+
+void Render::CountLightingTiles(std::unordered_map<StringId, Draw*>& draws) {
+  lightingTileStats = {};
+  for (Draw* draw : draws | std::views::values) {
+    lightingTileStats.shaded +=
+        lightingTiles.GetTileCount(currentFrame, draw->GetPipelineId());
+    lightingTileStats.fullscreen += lightingTiles.GetTileCount();
+  }
+}
+
+void Render::RecreateSwapChain(const Device& device, const VkWindow& window,
+                               std::unordered_map<StringId, Draw*>& draws) {
+  device.WaitIdle();
+  renderGraph.DestroyResources(device.GetLogical());
+  swapChain.RecreateSwapChain(device, window);
+  CreateRenderGraphResources(device);
+  if (GetEnableOcclusionCulling()) {
+    occlusionCulling.DestroyPyramid(device.GetLogical());
+    occlusionCulling.CreatePyramid(device, *this, swapChain.GetZPrePassDepth(),
+                                   swapChain.GetExtent());
+  }
+  if (GetEnableTileClassification()) {
+    lightingTiles.DestroyTiles(device.GetLogical());
+    lightingTiles.CreateTiles(device, *this, GetGBufferPipelineIdView(),
+                              swapChain.GetExtent());
+  }
+
+  for (Draw* draw : draws | std::views::values) {
+    if (GetEnableShadowMap()) {
+      if (GetEnableDeferred()) {
+        draw->UpdateDeferredShadowMapDescriptorSets(device.GetLogical(), *this);
+      } else {
+        for (const auto& mesh : draw->GetMeshes()) {
+          mesh->UpdateColorShadowMapDescriptorSets(device.GetLogical(), *this);
+        }
+      }
+    }
+    if (GetEnableDeferred()) {
+      draw->UpdateDeferredGBufferDescriptorSets(device.GetLogical(), *this);
+    }
+  }
+}
+
 void Render::CreateSyncObjects(const VkDevice& device) {
   imageAvailableSemaphores.resize(maxFramesInFlight);
   renderFinishedSemaphores.resize(maxFramesInFlight);
   colorInFlightFences.resize(maxFramesInFlight);
 
-  if (GetEnableZPrePass()) {
+  if (GetSeparateZPrePass()) {
     zPrePassFinishedSemaphores.resize(maxFramesInFlight);
     zPrePassInFlightFences.resize(maxFramesInFlight);
   }
@@ -968,14 +893,14 @@ void Render::CreateSyncObjects(const VkDevice& device) {
   for (int i = 0; i < maxFramesInFlight; i++) {
     if (vkCreateSemaphore(device, &semaphoreInfo, nullptr,
                           &imageAvailableSemaphores[i]) != VK_SUCCESS ||
-        (GetEnableZPrePass() &&
+        (GetSeparateZPrePass() &&
          vkCreateSemaphore(device, &semaphoreInfo, nullptr,
                            &zPrePassFinishedSemaphores[i]) != VK_SUCCESS) ||
         vkCreateSemaphore(device, &semaphoreInfo, nullptr,
                           &renderFinishedSemaphores[i]) != VK_SUCCESS ||
         vkCreateFence(device, &fenceInfo, nullptr, &colorInFlightFences[i]) !=
             VK_SUCCESS ||
-        (GetEnableZPrePass() &&
+        (GetSeparateZPrePass() &&
          vkCreateFence(device, &fenceInfo, nullptr,
                        &zPrePassInFlightFences[i]) != VK_SUCCESS)) {
       PRINT_AND_THROW_ERROR("failed to create render semaphores or fences!");
@@ -996,16 +921,6 @@ void Render::CreateSyncObjects(const VkDevice& device) {
   }
 }
 
-void Render::DestroyRenderPasses(const VkDevice& device) const {
-  vkDestroyRenderPass(device, colorRenderPass, nullptr);
-  if (GetEnableZPrePass()) {
-    vkDestroyRenderPass(device, zPrePassRenderPass, nullptr);
-  }
-  if (GetEnableShadowMap()) {
-    vkDestroyRenderPass(device, shadowMapRenderPass, nullptr);
-  }
-}
-
 void Render::DestroyCommandPool(const VkDevice& device) const {
   vkDestroyCommandPool(device, commandPool, nullptr);
 }
@@ -1016,7 +931,7 @@ void Render::DestroySyncObjects(const VkDevice& device) {
     vkDestroySemaphore(device, imageAvailableSemaphores[i], nullptr);
     vkDestroyFence(device, colorInFlightFences[i], nullptr);
 
-    if (GetEnableZPrePass()) {
+    if (GetSeparateZPrePass()) {
       vkDestroySemaphore(device, zPrePassFinishedSemaphores[i], nullptr);
       vkDestroyFence(device, zPrePassInFlightFences[i], nullptr);
     }
@@ -1028,6 +943,4 @@ void Render::DestroySyncObjects(const VkDevice& device) {
       }
     }
   }
-}
-
-#undef AddGBufferAttachment
\ No newline at end of file
+}
\ No newline at end of file
@@ -0,0 +1,766 @@
+#include "../include/rendergraph.h"
+
+#include <Engine/Utility/include/TypeUtils.h>
+
+#include <algorithm>
+
+#include "../include/device.h"
+#include "../include/texture.h"
+
+namespace {
+std::optional<uint32_t> FindMemoryType(const VkPhysicalDevice& device,
+                                       const uint32_t typeBits,
+                                       const VkMemoryPropertyFlags properties) {
+  VkPhysicalDeviceMemoryProperties memoryProperties;
+  vkGetPhysicalDeviceMemoryProperties(device, &memoryProperties);
+  for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+    if ((typeBits & (1u << i)) &&
+        (memoryProperties.memoryTypes[i].propertyFlags & properties) ==
+            properties) {
+      return i;
+    }
+  }
+  return std::nullopt;
+}
+}  // namespace
+
+RenderGraph::ImageId RenderGraph::AddImage(
+    const std::string& name, const VkFormat format,
+    const VkSampleCountFlagBits samples) {
+  images.push_back({
+      .name = name,
+      .format = format,
+      .samples = samples,
+      .imported = false,
+      .finalLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+  });
+  return static_cast<ImageId>(images.size() - 1);
+}
+
+RenderGraph::ImageId RenderGraph::ImportImage(
+    const std::string& name, const VkFormat format,
+    const VkSampleCountFlagBits samples, const VkImageLayout finalLayout) {
+  images.push_back({
+      .name = name,
+      .format = format,
+      .samples = samples,
+      .imported = true,
+      .finalLayout = finalLayout,
+  });
+  return static_cast<ImageId>(images.size() - 1);
+}
+
+RenderGraph::PassId RenderGraph::AddPass(const RenderGraphPassDesc& desc) {
+  const auto pass = static_cast<PassId>(passes.size());
+  if (desc.queue == QueueType::Compute && desc.compute == false) {
+    PRINT_AND_THROW_ERROR("render pass " + desc.name +
+                          " may not run on the compute queue!");
+  }
+  passes.push_back(desc);
+  for (const RenderGraphOutput& color : desc.colors) {
+    AddUse(color.image, pass, UseType::Color, color.clear);
+    if (color.resolve != RenderGraphNone) {
+      AddUse(color.resolve, pass, UseType::Resolve, false);
+    }
+  }
+  if (desc.depth.has_value()) {
+    AddUse(desc.depth->image, pass, UseType::Depth, desc.depth->clear);
+  }
+  for (const ImageId image : desc.inputs) {
+    AddUse(image, pass, UseType::Input, false);
+  }
+  for (const ImageId image : desc.sampled) {
+    AddUse(image, pass, UseType::Sampled, false);
+  }
+  return pass;
+}
+
+void RenderGraph::AddUse(const ImageId image, const PassId pass,
+                         const UseType type, const bool clear) {
+  if (image >= images.size()) {
+    PRINT_AND_THROW_ERROR("pass " + passes[pass].name +
+                          " uses an unknown render graph image!");
+  }
+  std::vector<Use>& uses = images[image].uses;
+  if (uses.empty() == false && uses.back().pass == pass) {
+    PRINT_AND_THROW_ERROR("pass " + passes[pass].name + " uses " +
+                          images[image].name + " more than once!");
+  }
+  if (passes[pass].compute && type != UseType::Sampled) {
+    PRINT_AND_THROW_ERROR("compute pass " + passes[pass].name +
+                          " may only sample " + images[image].name + "!");
+  }
+  uses.push_back({pass, type, clear});
+}
+
+bool RenderGraph::IsDepthFormat(const VkFormat format) {
+  return format == VK_FORMAT_D16_UNORM || format == VK_FORMAT_D32_SFLOAT ||
+         format == VK_FORMAT_X8_D24_UNORM_PACK32 ||
+         format == VK_FORMAT_D16_UNORM_S8_UINT ||
+         format == VK_FORMAT_D24_UNORM_S8_UINT ||
+         format == VK_FORMAT_D32_SFLOAT_S8_UINT;
+}
+
+bool RenderGraph::NeedsContents(const Use& use) {
+  switch (use.type) {
+    case UseType::Color:
+    case UseType::Depth:
+      return use.clear == false;
+    case UseType::Resolve:
+      return false;
+    default:
+      return true;
+  }
+}
+
+VkImageLayout RenderGraph::GetLayout(const ImageId image,
+                                     const Use& use) const {
+  switch (use.type) {
+    case UseType::Color:
+    case UseType::Resolve:
+      return VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    case UseType::Depth:
+      return VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    case UseType::Input:
+      return IsDepthFormat(images[image].format)
+                 ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL
+                 : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    default:
+      return VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+  }
+}
+
+VkPipelineStageFlags RenderGraph::GetStages(const Use& use) const {
+  switch (use.type) {
+    case UseType::Color:
+    case UseType::Resolve:
+      return VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    case UseType::Depth:
+      return VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT |
+             VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    default:
+      return passes[use.pass].compute ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT
+                                      : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+  }
+}
+
+VkAccessFlags RenderGraph::GetAccesses(const Use& use) const {
+  switch (use.type) {
+    case UseType::Color:
+      return VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+             (NeedsContents(use) ? VK_ACCESS_COLOR_ATTACHMENT_READ_BIT : 0);
+    case UseType::Resolve:
+      return VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    case UseType::Depth:
+      return VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
+             VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    case UseType::Input:
+      return VK_ACCESS_INPUT_ATTACHMENT_READ_BIT;
+    default:
+      return VK_ACCESS_SHADER_READ_BIT;
+  }
+}
+
+VkAccessFlags RenderGraph::GetWriteAccesses(const Use& use) const {
+  // Reads only need to have finished before a later write, which an
+  // execution dependency already ensures
+  return GetAccesses(use) & (VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                             VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
+}
+
+size_t RenderGraph::FindUse(const ImageId image, const PassId pass) const {
+  const std::vector<Use>& uses = images[image].uses;
+  return std::ranges::find(uses, pass, &Use::pass) - uses.begin();
+}
+
+const RenderGraph::Use& RenderGraph::GetPreviousUse(const ImageId image,
+                                                    const size_t index) const {
+  const std::vector<Use>& uses = images[image].uses;
+  return uses[(index + uses.size() - 1) % uses.size()];
+}
+
+const RenderGraph::Use& RenderGraph::GetNextUse(const ImageId image,
+                                                const size_t index) const {
+  const std::vector<Use>& uses = images[image].uses;
+  return uses[(index + 1) % uses.size()];
+}
+
+VkImageLayout RenderGraph::GetFinalLayout(const ImageId image,
+                                          const size_t lastIndex) const {
+  const Image& desc = images[image];
+  if (desc.finalLayout != VK_IMAGE_LAYOUT_UNDEFINED &&
+      lastIndex + 1 == desc.uses.size()) {
+    return desc.finalLayout;
+  }
+  // Left ready to be sampled, what samples it is not a render pass that
+  // could transition it
+  if (const Use& next = GetNextUse(image, lastIndex); !IsAttachment(next)) {
+    return GetLayout(image, next);
+  }
+  return GetLayout(image, desc.uses[lastIndex]);
+}
+
+VkImageLayout RenderGraph::GetLayoutAfter(const ImageId image,
+                                          const size_t index) const {
+  const std::vector<Use>& uses = images[image].uses;
+  if (IsAttachment(uses[index]) == false) {
+    return GetLayout(image, uses[index]);
+  }
+  size_t last = index;
+  while (last + 1 < uses.size() &&
+         passSteps[uses[last + 1].pass] == passSteps[uses[index].pass]) {
+    last++;
+  }
+  return GetFinalLayout(image, last);
+}
+
+VkExtent2D RenderGraph::GetStepExtent(const Step& step) const {
+  return step.extent.width == 0 ? extent : step.extent;
+}
+
+bool RenderGraph::CanMerge(const Step& step, const PassId pass) const {
+  const RenderGraphPassDesc& desc = passes[pass];
+  if (step.compute || desc.compute || step.extent.width != desc.extent.width ||
+      step.extent.height != desc.extent.height) {
+    return false;
+  }
+  bool consumes = false;
+  for (const Image& image : images) {
+    bool written = false;
+    bool sampled = false;
+    for (const Use& use : image.uses) {
+      if (use.pass == pass) {
+        // What the render pass wrote can only be sampled once it has ended,
+        // and what it sampled cannot become an attachment within it
+        if ((use.type == UseType::Sampled && written) ||
+            (use.type != UseType::Sampled && sampled)) {
+          return false;
+        }
+        consumes |= written && NeedsContents(use);
+        break;
+      }
+      if (std::ranges::find(step.passes, use.pass) != step.passes.end()) {
+        written |= use.type != UseType::Sampled && use.type != UseType::Input;
+        sampled |= use.type == UseType::Sampled;
+      }
+    }
+  }
+  // Passes that do not read the render pass's attachments in place gain
+  // nothing from being its subpasses
+  return consumes;
+}
+
+void RenderGraph::AssignAliasSlots() {
+  // Transient images whose first use keeps nothing, by their first step
+  std::vector<ImageId> order;
+  for (ImageId image = 0; image < images.size(); image++) {
+    const Image& desc = images[image];
+    if (desc.imported == false && desc.uses.empty() == false &&
+        NeedsContents(desc.uses.front()) == false) {
+      order.push_back(image);
+    }
+  }
+  std::ranges::stable_sort(order, {}, [this](const ImageId image) {
+    return passSteps[images[image].uses.front().pass];
+  });
+
+  // Each image goes into the first slot whose last image is done by its first
+  // step, which needs the fewest slots for the lifetimes
+  std::vector<std::vector<ImageId>> slots;
+  for (const ImageId image : order) {
+    const uint32_t firstStep = passSteps[images[image].uses.front().pass];
+    auto slot = std::ranges::find_if(slots, [&](const auto& occupants) {
+      return passSteps[images[occupants.back()].uses.back().pass] < firstStep;
+    });
+    if (slot == slots.end()) {
+      slot = slots.emplace(slots.end());
+    }
+    images[image].slot = static_cast<uint32_t>(slot - slots.begin());
+    slot->push_back(image);
+  }
+  for (const std::vector<ImageId>& occupants : slots) {
+    if (occupants.size() < 2) {
+      continue;
+    }
+    for (size_t i = 0; i < occupants.size(); i++) {
+      const ImageId previous =
+          occupants[(i + occupants.size() - 1) % occupants.size()];
+      images[occupants[i]].aliasPredecessor = images[previous].uses.back();
+    }
+  }
+}
+
+void RenderGraph::Compile(const VkDevice& device) {
+  passSteps.resize(passes.size());
+  for (PassId pass = 0; pass < passes.size(); pass++) {
+    if (steps.empty() || CanMerge(steps.back(), pass) == false) {
+      steps.push_back({
+          .compute = passes[pass].compute,
+          .extent = passes[pass].extent,
+      });
+    }
+    steps.back().passes.push_back(pass);
+    passSteps[pass] = static_cast<uint32_t>(steps.size() - 1);
+  }
+  AssignAliasSlots();
+  for (Step& step : steps) {
+    if (step.compute == false) {
+      CreateRenderPass(device, step);
+    }
+  }
+}
+
+void RenderGraph::CreateRenderPass(const VkDevice& device, Step& step) {
+  const uint32_t stepIndex = passSteps[step.passes.front()];
+  const auto getSubpass = [&step](const PassId pass) {
+    return static_cast<uint32_t>(std::ranges::find(step.passes, pass) -
+                                 step.passes.begin());
+  };
+  for (const PassId pass : step.passes) {
+    for (ImageId image = 0; image < images.size(); image++) {
+      const size_t index = FindUse(image, pass);
+      if (index < images[image].uses.size() &&
+          IsAttachment(images[image].uses[index]) &&
+          std::ranges::find(step.attachments, image) ==
+              step.attachments.end()) {
+        step.attachments.push_back(image);
+      }
+    }
+  }
+  const auto getAttachment = [&step](const ImageId image) {
+    return static_cast<uint32_t>(std::ranges::find(step.attachments, image) -
+                                 step.attachments.begin());
+  };
+
+  std::vector<VkAttachmentDescription> attachments;
+  std::vector<VkSubpassDependency> dependencies;
+  const auto addDependency =
+      [&dependencies](const uint32_t src, const uint32_t dst,
+                      const VkPipelineStageFlags srcStages,
+                      const VkAccessFlags srcAccesses,
+                      const VkPipelineStageFlags dstStages,
+                      const VkAccessFlags dstAccesses) {
+        const VkDependencyFlags flags =
+            src != VK_SUBPASS_EXTERNAL && dst != VK_SUBPASS_EXTERNAL
+                ? VK_DEPENDENCY_BY_REGION_BIT
+                : 0;
+        const auto it = std::ranges::find_if(
+            dependencies, [&](const VkSubpassDependency& dependency) {
+              return dependency.srcSubpass == src &&
+                     dependency.dstSubpass == dst;
+            });
+        if (it == dependencies.end()) {
+          dependencies.push_back({src, dst, srcStages, dstStages, srcAccesses,
+                                  dstAccesses, flags});
+          return;
+        }
+        it->srcStageMask |= srcStages;
+        it->dstStageMask |= dstStages;
+        it->srcAccessMask |= srcAccesses;
+        it->dstAccessMask |= dstAccesses;
+      };
+
+  for (const ImageId image : step.attachments) {
+    const Image& desc = images[image];
+    const std::vector<Use>& uses = desc.uses;
+    size_t first = 0;
+    while (passSteps[uses[first].pass] != stepIndex) {
+      first++;
+    }
+    size_t last = first;
+    while (last + 1 < uses.size() &&
+           passSteps[uses[last + 1].pass] == stepIndex) {
+      last++;
+    }
+
+    VkAttachmentLoadOp loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    if (uses[first].type != UseType::Resolve && uses[first].clear) {
+      loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    } else if (NeedsContents(uses[first])) {
+      loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    }
+    const bool store = (desc.finalLayout != VK_IMAGE_LAYOUT_UNDEFINED &&
+                        last + 1 == uses.size()) ||
+                       NeedsContents(GetNextUse(image, last));
+    attachments.push_back({
+        .format = desc.format,
+        .samples = desc.samples,
+        .loadOp = loadOp,
+        .storeOp = store ? VK_ATTACHMENT_STORE_OP_STORE
+                         : VK_ATTACHMENT_STORE_OP_DONT_CARE,
+        .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
+        .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
+        .initialLayout =
+            loadOp == VK_ATTACHMENT_LOAD_OP_LOAD
+                ? GetLayoutAfter(image, (first + uses.size() - 1) % uses.size())
+                : VK_IMAGE_LAYOUT_UNDEFINED,
+        .finalLayout = GetFinalLayout(image, last),
+    });
+    step.clearValues.push_back(
+        IsDepthFormat(desc.format)
+            ? VkClearValue{.depthStencil = {1.0f, 0}}
+            : VkClearValue{.color = {{0.0f, 0.0f, 0.0f, 1.0f}}});
+
+    // After what earlier passes or the previous frame did with it, and after
+    // the image it aliases
+    const Use& previous = GetPreviousUse(image, first);
+    addDependency(VK_SUBPASS_EXTERNAL, getSubpass(uses[first].pass),
+                  GetStages(previous), GetWriteAccesses(previous),
+                  GetStages(uses[first]), GetAccesses(uses[first]));
+    if (desc.aliasPredecessor.has_value() && first == 0) {
+      addDependency(VK_SUBPASS_EXTERNAL, getSubpass(uses[first].pass),
+                    GetStages(*desc.aliasPredecessor),
+                    GetWriteAccesses(*desc.aliasPredecessor),
+                    GetStages(uses[first]), GetAccesses(uses[first]));
+    }
+    for (size_t i = first + 1; i <= last; i++) {
+      addDependency(getSubpass(uses[i - 1].pass), getSubpass(uses[i].pass),
+                    GetStages(uses[i - 1]), GetWriteAccesses(uses[i - 1]),
+                    GetStages(uses[i]), GetAccesses(uses[i]));
+    }
+    // Samplers come after the render pass and cannot wait on their own
+    VkPipelineStageFlags samplerStages = 0;
+    for (size_t i = 1; i < uses.size(); i++) {
+      const Use& next = uses[(last + i) % uses.size()];
+      if (IsAttachment(next)) {
+        break;
+      }
+      samplerStages |= GetStages(next);
+    }
+    if (samplerStages != 0) {
+      addDependency(getSubpass(uses[last].pass), VK_SUBPASS_EXTERNAL,
+                    GetStages(uses[last]), GetWriteAccesses(uses[last]),
+                    samplerStages, VK_ACCESS_SHADER_READ_BIT);
+    }
+  }
+
+  struct SubpassReferences {
+    std::vector<VkAttachmentReference> colors;
+    std::vector<VkAttachmentReference> resolves;
+    std::vector<VkAttachmentReference> inputs;
+    std::optional<VkAttachmentReference> depth;
+    std::vector<uint32_t> preserves;
+  };
+  const auto getReference = [&](const ImageId image, const PassId pass) {
+    return VkAttachmentReference{
+        getAttachment(image),
+        GetLayout(image, images[image].uses[FindUse(image, pass)]),
+    };
+  };
+  std::vector<SubpassReferences> references(step.passes.size());
+  for (uint32_t subpass = 0; subpass < step.passes.size(); subpass++) {
+    const PassId pass = step.passes[subpass];
+    const RenderGraphPassDesc& desc = passes[pass];
+    SubpassReferences& reference = references[subpass];
+    bool resolves = false;
+    for (const RenderGraphOutput& color : desc.colors) {
+      reference.colors.push_back(getReference(color.image, pass));
+      reference.resolves.push_back(
+          color.resolve == RenderGraphNone
+              ? VkAttachmentReference{VK_ATTACHMENT_UNUSED,
+                                      VK_IMAGE_LAYOUT_UNDEFINED}
+              : getReference(color.resolve, pass));
+      resolves |= color.resolve != RenderGraphNone;
+    }
+    if (resolves == false) {
+      reference.resolves.clear();
+    }
+    if (desc.depth.has_value()) {
+      reference.depth = getReference(desc.depth->image, pass);
+    }
+    for (const ImageId image : desc.inputs) {
+      reference.inputs.push_back(getReference(image, pass));
+    }
+    // Attachments used before and after a subpass must outlive it
+    for (const ImageId image : step.attachments) {
+      uint32_t firstSubpass = RenderGraphNone;
+      uint32_t lastSubpass = 0;
+      for (const Use& use : images[image].uses) {
+        if (passSteps[use.pass] == stepIndex) {
+          firstSubpass = std::min(firstSubpass, getSubpass(use.pass));
+          lastSubpass = std::max(lastSubpass, getSubpass(use.pass));
+        }
+      }
+      if (firstSubpass < subpass && subpass < lastSubpass &&
+          FindUse(image, pass) == images[image].uses.size()) {
+        reference.preserves.push_back(getAttachment(image));
+      }
+    }
+  }
+  std::vector<VkSubpassDescription> subpasses;
+  for (const SubpassReferences& reference : references) {
+    subpasses.push_back({
+        .pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS,
+        .inputAttachmentCount = static_cast<uint32_t>(reference.inputs.size()),
+        .pInputAttachments = reference.inputs.data(),
+        .colorAttachmentCount = static_cast<uint32_t>(reference.colors.size()),
+        .pColorAttachments = reference.colors.data(),
+        .pResolveAttachments =
+            reference.resolves.empty() ? nullptr : reference.resolves.data(),
+        .pDepthStencilAttachment =
+            reference.depth.has_value() ? &*reference.depth : nullptr,
+        .preserveAttachmentCount =
+            static_cast<uint32_t>(reference.preserves.size()),
+        .pPreserveAttachments = reference.preserves.data(),
+    });
+  }
+
+  const VkRenderPassCreateInfo renderPassInfo{
+      .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
+      .attachmentCount = static_cast<uint32_t>(attachments.size()),
+      .pAttachments = attachments.data(),
+      .subpassCount = static_cast<uint32_t>(subpasses.size()),
+      .pSubpasses = subpasses.data(),
+      .dependencyCount = static_cast<uint32_t>(dependencies.size()),
+      .pDependencies = dependencies.data(),
+  };
+  if (vkCreateRenderPass(device, &renderPassInfo, nullptr, &step.renderPass) !=
+      VK_SUCCESS) {
+    PRINT_AND_THROW_ERROR("failed to create render pass of " +
+                          passes[step.passes.front()].name + "!");
+  }
+}
+
+void RenderGraph::SetImportedViews(const ImageId image,
+                                   const std::vector<VkImageView>& views) {
+  images[image].views = views;
+}
+
+void RenderGraph::CreateResources(const Device& device,
+                                  const VkExtent2D& screenExtent) {
+  extent = screenExtent;
+
+  struct Allocation {
+    uint32_t slot;
+    uint32_t memoryType;
+    VkDeviceSize size;
+    std::vector<ImageId> images;
+  };
+  std::vector<Allocation> allocations;
+  VkDeviceSize imagesSize = 0;
+  for (ImageId image = 0; image < images.size(); image++) {
+    Image& desc = images[image];
+    if (desc.imported || desc.uses.empty()) {
+      continue;
+    }
+    VkImageUsageFlags usage = 0;
+    bool singleStep = true;
+    for (const Use& use : desc.uses) {
+      switch (use.type) {
+        case UseType::Color:
+        case UseType::Resolve:
+          usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+          break;
+        case UseType::Depth:
+          usage |= VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+          break;
+        case UseType::Input:
+          usage |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
+          break;
+        default:
+          usage |= VK_IMAGE_USAGE_SAMPLED_BIT;
+      }
+      singleStep &= passSteps[use.pass] == passSteps[desc.uses[0].pass];
+    }
+    // Never loaded nor stored, tile based GPUs need not back it with memory
+    const bool lazy = singleStep && (usage & VK_IMAGE_USAGE_SAMPLED_BIT) == 0 &&
+                      NeedsContents(desc.uses.front()) == false;
+    if (lazy) {
+      usage |= VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
+    }
+
+    const VkExtent2D imageExtent =
+        GetStepExtent(steps[passSteps[desc.uses.front().pass]]);
+    const VkImageCreateInfo imageInfo{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .imageType = VK_IMAGE_TYPE_2D,
+        .format = desc.format,
+        .extent = {imageExtent.width, imageExtent.height, 1},
+        .mipLevels = 1,
+        .arrayLayers = 1,
+        .samples = desc.samples,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = usage,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+    };
+    if (vkCreateImage(device.GetLogical(), &imageInfo, nullptr, &desc.image) !=
+        VK_SUCCESS) {
+      PRINT_AND_THROW_ERROR("failed to create render graph image " +
+                            desc.name + "!");
+    }
+    VkMemoryRequirements requirements;
+    vkGetImageMemoryRequirements(device.GetLogical(), desc.image,
+                                 &requirements);
+    desc.memorySize = requirements.size;
+    imagesSize += requirements.size;
+
+    std::optional<uint32_t> memoryType;
+    if (lazy) {
+      memoryType = FindMemoryType(device.GetPhysical(),
+                                  requirements.memoryTypeBits,
+                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                                      VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT);
+    }
+    if (memoryType.has_value() == false) {
+      memoryType =
+          FindMemoryType(device.GetPhysical(), requirements.memoryTypeBits,
+                         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+    if (memoryType.has_value() == false) {
+      PRINT_AND_THROW_ERROR("failed to find memory for render graph image " +
+                            desc.name + "!");
+    }
+
+    // Images of a slot share memory when they agree on its type, all bound
+    // at offset zero, which meets any alignment
+    auto allocation = std::ranges::find_if(
+        allocations, [&desc, &memoryType](const Allocation& allocation) {
+          return desc.slot != RenderGraphNone && allocation.slot == desc.slot &&
+                 allocation.memoryType == *memoryType;
+        });
+    if (allocation == allocations.end()) {
+      allocation = allocations.insert(allocations.end(),
+                                      {desc.slot, *memoryType, 0, {}});
+    }
+    allocation->size = std::max(allocation->size, requirements.size);
+    allocation->images.push_back(image);
+  }
+
+  memorySize = 0;
+  for (const Allocation& allocation : allocations) {
+    const VkMemoryAllocateInfo allocInfo{
+        .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+        .allocationSize = allocation.size,
+        .memoryTypeIndex = allocation.memoryType,
+    };
+    VkDeviceMemory memory;
+    if (vkAllocateMemory(device.GetLogical(), &allocInfo, nullptr, &memory) !=
+        VK_SUCCESS) {
+      PRINT_AND_THROW_ERROR("failed to allocate render graph memory!");
+    }
+    memories.push_back(memory);
+    memorySize += allocation.size;
+    for (const ImageId image : allocation.images) {
+      Image& desc = images[image];
+      vkBindImageMemory(device.GetLogical(), desc.image, memory, 0);
+      desc.views = {Texture::CreateImageView(
+          device.GetLogical(), desc.image, 1, desc.format,
+          IsDepthFormat(desc.format) ? VK_IMAGE_ASPECT_DEPTH_BIT
+                                     : VK_IMAGE_ASPECT_COLOR_BIT)};
+    }
+  }
+  aliasedMemorySize = imagesSize - memorySize;
+
+  for (Step& step : steps) {
+    if (step.compute) {
+      continue;
+    }
+    size_t frameBufferCount = 1;
+    for (const ImageId image : step.attachments) {
+      if (images[image].views.empty()) {
+        PRINT_AND_THROW_ERROR("render graph image " + images[image].name +
+                              " has no view!");
+      }
+      frameBufferCount = std::max(frameBufferCount, images[image].views.size());
+    }
+    const VkExtent2D stepExtent = GetStepExtent(step);
+    step.frameBuffers.resize(frameBufferCount);
+    for (size_t i = 0; i < frameBufferCount; i++) {
+      std::vector<VkImageView> views;
+      for (const ImageId image : step.attachments) {
+        views.push_back(images[image].views[i % images[image].views.size()]);
+      }
+      const VkFramebufferCreateInfo frameBufferInfo{
+          .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
+          .renderPass = step.renderPass,
+          .attachmentCount = static_cast<uint32_t>(views.size()),
+          .pAttachments = views.data(),
+          .width = stepExtent.width,
+          .height = stepExtent.height,
+          .layers = 1,
+      };
+      if (vkCreateFramebuffer(device.GetLogical(), &frameBufferInfo, nullptr,
+                              &step.frameBuffers[i]) != VK_SUCCESS) {
+        PRINT_AND_THROW_ERROR("failed to create frame buffer!");
+      }
+    }
+  }
+}
+
+void RenderGraph::DestroyResources(const VkDevice& device) {
+  for (Step& step : steps) {
+    for (const VkFramebuffer frameBuffer : step.frameBuffers) {
+      vkDestroyFramebuffer(device, frameBuffer, nullptr);
+    }
+    step.frameBuffers.clear();
+  }
+  for (Image& image : images) {
+    if (image.imported || image.image == VK_NULL_HANDLE) {
+      continue;
+    }
+    for (const VkImageView view : image.views) {
+      vkDestroyImageView(device, view, nullptr);
+    }
+    image.views.clear();
+    vkDestroyImage(device, image.image, nullptr);
+    image.image = VK_NULL_HANDLE;
+    image.memorySize = 0;
+  }
+  for (const VkDeviceMemory memory : memories) {
+    vkFreeMemory(device, memory, nullptr);
+  }
+  memories.clear();
+  memorySize = 0;
+  aliasedMemorySize = 0;
+}
+
+void RenderGraph::Destroy(const VkDevice& device) {
+  DestroyResources(device);
+  for (const Step& step : steps) {
+    if (step.renderPass != VK_NULL_HANDLE) {
+      vkDestroyRenderPass(device, step.renderPass, nullptr);
+    }
+  }
+  steps.clear();
+  passSteps.clear();
+  passes.clear();
+  images.clear();
+}
+
+void RenderGraph::BeginPass(VkCommandBuffer commandBuffer, const PassId pass,
+                            const uint32_t frameBufferIndex) const {
+  const Step& step = steps[passSteps[pass]];
+  if (step.compute) {
+    return;
+  }
+  if (step.passes.front() != pass) {
+    vkCmdNextSubpass(commandBuffer, VK_SUBPASS_CONTENTS_INLINE);
+    return;
+  }
+  const VkRenderPassBeginInfo renderPassBeginInfo{
+      .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+      .renderPass = step.renderPass,
+      .framebuffer =
+          step.frameBuffers[frameBufferIndex % step.frameBuffers.size()],
+      .renderArea = {{0, 0}, GetStepExtent(step)},
+      .clearValueCount = static_cast<uint32_t>(step.clearValues.size()),
+      .pClearValues = step.clearValues.data(),
+  };
+  vkCmdBeginRenderPass(commandBuffer, &renderPassBeginInfo,
+                       VK_SUBPASS_CONTENTS_INLINE);
+}
+
+void RenderGraph::EndPass(VkCommandBuffer commandBuffer,
+                          const PassId pass) const {
+  const Step& step = steps[passSteps[pass]];
+  if (step.compute == false && step.passes.back() == pass) {
+    vkCmdEndRenderPass(commandBuffer);
+  }
+}
+
+uint32_t RenderGraph::GetSubpass(const PassId pass) const {
+  const std::vector<PassId>& stepPasses = steps[passSteps[pass]].passes;
+  return static_cast<uint32_t>(std::ranges::find(stepPasses, pass) -
+                               stepPasses.begin());
+}
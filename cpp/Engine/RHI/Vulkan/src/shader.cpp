@@ -38,9 +38,10 @@ void Shader::CompileFromGLSLToSPV(const std::string& glslPath,
       glslPath.c_str(), options);
 
   if (module.GetCompilationStatus() != shaderc_compilation_status_success) {
-    std::cerr << module.GetErrorMessage();
+    PRINT_AND_THROW_ERROR(module.GetErrorMessage());
   }
   const std::vector spvCode(module.cbegin(), module.cend());
+  std::filesystem::create_directories(shaderPath + "/../spv");
   FileUtils::WriteFileAsUIntegers(shaderPath + "/../spv/" + glslPath,
                                   std::ios::binary, spvCode);
 }
@@ -53,8 +54,17 @@ UIntegers Shader::ReadSPVFileAsBinary(const std::string& spvPath,
 
 UIntegers Shader::ReadGLSLFileAsBinary(const std::string& glslPath,
                                        const std::string& shaderPath) {
+  const std::string filePath = shaderPath + "/" + glslPath;
+  const auto writeTime = std::filesystem::last_write_time(filePath);
+  if (const auto it = compiledCode.find(filePath);
+      it != compiledCode.end() && it->second.writeTime == writeTime) {
+    return it->second.code;
+  }
   CompileFromGLSLToSPV(glslPath, shaderPath);
-  return ReadSPVFileAsBinary(glslPath, shaderPath);
+  auto& compiled = compiledCode[filePath];
+  compiled.writeTime = writeTime;
+  compiled.code = ReadSPVFileAsBinary(glslPath, shaderPath);
+  return compiled.code;
 }
 
 VkShaderModule Shader::CreateModule(const UIntegers& code,
@@ -100,8 +110,15 @@ ShaderStages Shader::AutoCreateStages(const VkDevice& device,
     const std::vector<std::string>& shaderPaths) {
   std::vector<ShaderStages> shaderStagesSet;
   for (const std::string& shaderPath : shaderPaths) {
-    shaderStagesSet.emplace_back(
-        AutoCreateStages(device, rootPath, shaderPath));
+    // A path that fails to compile is left empty, so the pipeline falls
+    // through to the next one, ending at the error shader
+    try {
+      shaderStagesSet.emplace_back(
+          AutoCreateStages(device, rootPath, shaderPath));
+    } catch (const std::exception& e) {
+      PRINT_ERROR(e.what());
+      shaderStagesSet.emplace_back();
+    }
   }
   return shaderStagesSet;
 }
@@ -0,0 +1,155 @@
+#include "../include/staging.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "../include/buffer.h"
+#include "../include/device.h"
+#include "../include/vertex.h"
+
+namespace {
+VkDeviceSize AlignUp(const VkDeviceSize value, const VkDeviceSize alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+}  // namespace
+
+void StagingPool::CreateStagingPool(const Device& inDevice,
+                                    const VkDeviceSize size) {
+  std::lock_guard lock(mutex);
+  device = &inDevice;
+  DataBuffer::CreateBuffer(*device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                               VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                           buffer, memory);
+  vkMapMemory(device->GetLogical(), memory, 0, size, 0,
+              reinterpret_cast<void**>(&mapped));
+  freeRanges.emplace(0, size);
+}
+
+void StagingPool::DestroyStagingPool() {
+  std::lock_guard lock(mutex);
+  if (device == nullptr) {
+    return;
+  }
+  for (const auto& [dedicatedBuffer, dedicatedMemory] : dedicatedBuffers) {
+    vkDestroyBuffer(device->GetLogical(), dedicatedBuffer, nullptr);
+    vkFreeMemory(device->GetLogical(), dedicatedMemory, nullptr);
+  }
+  dedicatedBuffers.clear();
+  vkDestroyBuffer(device->GetLogical(), buffer, nullptr);
+  vkFreeMemory(device->GetLogical(), memory, nullptr);
+  freeRanges.clear();
+  mapped = nullptr;
+  device = nullptr;
+}
+
+std::optional<StagingRange> StagingPool::Allocate(VkDeviceSize size) {
+  size = AlignUp(std::max<VkDeviceSize>(size, 1), Alignment);
+  std::lock_guard lock(mutex);
+  if (device == nullptr) {
+    return std::nullopt;
+  }
+  for (auto iter = freeRanges.begin(); iter != freeRanges.end(); ++iter) {
+    const auto [offset, freeSize] = *iter;
+    if (freeSize < size) {
+      continue;
+    }
+    freeRanges.erase(iter);
+    if (freeSize > size) {
+      freeRanges.emplace(offset + size, freeSize - size);
+    }
+    return StagingRange{buffer, offset, size, mapped + offset};
+  }
+
+  StagingRange range{.size = size};
+  VkDeviceMemory dedicatedMemory;
+  DataBuffer::CreateBuffer(*device, size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                           VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                               VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                           range.buffer, dedicatedMemory);
+  vkMapMemory(device->GetLogical(), dedicatedMemory, 0, size, 0,
+              reinterpret_cast<void**>(&range.mapped));
+  dedicatedBuffers.emplace(range.buffer, dedicatedMemory);
+  return range;
+}
+
+void StagingPool::Release(const StagingRange& range) {
+  std::lock_guard lock(mutex);
+  if (device == nullptr) {
+    return;
+  }
+  if (range.buffer != buffer) {
+    if (const auto iter = dedicatedBuffers.find(range.buffer);
+        iter != dedicatedBuffers.end()) {
+      vkDestroyBuffer(device->GetLogical(), iter->first, nullptr);
+      vkFreeMemory(device->GetLogical(), iter->second, nullptr);
+      dedicatedBuffers.erase(iter);
+    }
+    return;
+  }
+
+  VkDeviceSize offset = range.offset, size = range.size;
+  auto next = freeRanges.lower_bound(offset);
+  if (next != freeRanges.end() && offset + size == next->first) {
+    size += next->second;
+    next = freeRanges.erase(next);
+  }
+  if (next != freeRanges.begin()) {
+    if (const auto prev = std::prev(next);
+        prev->first + prev->second == offset) {
+      prev->second += size;
+      return;
+    }
+  }
+  freeRanges.emplace(offset, size);
+}
+
+MeshStagingTicket::MeshStagingTicket(std::shared_ptr<StagingPool> pool,
+                                     const StagingRange& range,
+                                     const uint32_t vertexFormat,
+                                     const size_t vertexCount,
+                                     const size_t indexCount)
+    : pool(std::move(pool)),
+      range(range),
+      vertexFormat(vertexFormat),
+      vertexSize(VertexLayout::GetStride(vertexFormat) * vertexCount),
+      indexOffset(range.offset + AlignUp(vertexSize, sizeof(uint32_t))),
+      indexType(DataBuffer::IndexType(vertexCount)) {
+  this->indexCount = indexCount;
+  this->vertexCount = vertexCount;
+}
+
+std::unique_ptr<MeshStaging> MeshStagingTicket::Allocate(
+    std::shared_ptr<StagingPool> pool, const uint32_t vertexFormat,
+    const size_t vertexCount, const size_t indexCount) {
+  const VkDeviceSize vertexSize =
+      VertexLayout::GetStride(vertexFormat) * vertexCount;
+  const std::optional<StagingRange> range = pool->Allocate(
+      AlignUp(vertexSize, sizeof(uint32_t)) +
+      DataBuffer::IndexSize(DataBuffer::IndexType(vertexCount)) * indexCount);
+  if (range.has_value() == false) {
+    return nullptr;
+  }
+  return std::make_unique<MeshStagingTicket>(std::move(pool), *range,
+                                             vertexFormat, vertexCount,
+                                             indexCount);
+}
+
+void MeshStagingTicket::WriteVertices(const std::vector<VertexData>& vertices,
+                                      const VertexDequantData& dequant) {
+  if (vertices.size() != vertexCount) {
+    PRINT_AND_THROW_ERROR("vertex count does not match the staging ticket!");
+  }
+  VertexLayout::Encode(vertexFormat, vertices, dequant, range.mapped);
+}
+
+void MeshStagingTicket::WriteIndices(const std::vector<uint32_t>& indices) {
+  if (indices.size() != indexCount) {
+    PRINT_AND_THROW_ERROR("index count does not match the staging ticket!");
+  }
+  DataBuffer::WriteIndices(indices, indexType, GetIndexData());
+}
+
+VkDeviceSize MeshStagingTicket::GetIndexSize() const {
+  return DataBuffer::IndexSize(indexType) * indexCount;
+}
@@ -2,24 +2,22 @@
 
 #include <algorithm>
 #include <array>
-#include <ranges>
 #include <stdexcept>
 
 #include "../include/depth.h"
 #include "../include/device.h"
-#include "../include/draw.h"
 #include "../include/render.h"
 #include "../include/texture.h"
 #include "../include/window.h"
 
-bool SwapChain::GetEnableZPrePass() const {
-  return static_cast<Render*>(owner)->GetEnableZPrePass();
-}
 bool SwapChain::GetEnableShadowMap() const {
   return static_cast<Render*>(owner)->GetEnableShadowMap();
 }
-bool SwapChain::GetEnableDeferred() const {
-  return static_cast<Render*>(owner)->GetEnableDeferred();
+bool SwapChain::GetEnableCompactGBuffer() const {
+  return static_cast<Render*>(owner)->GetEnableCompactGBuffer();
+}
+bool SwapChain::GetEnableOcclusionCulling() const {
+  return static_cast<Render*>(owner)->GetEnableOcclusionCulling();
 }
 
 uint32_t SwapChain::GetShadowMapWidth() const {
@@ -29,16 +27,6 @@ uint32_t SwapChain::GetShadowMapHeight() const {
   return static_cast<Render*>(owner)->GetShadowMapHeight();
 }
 
-const VkRenderPass& SwapChain::GetColorRenderPass() const {
-  return static_cast<Render*>(owner)->GetColorRenderPass();
-}
-const VkRenderPass& SwapChain::GetZPrePassRenderPass() const {
-  return static_cast<Render*>(owner)->GetZPrePassRenderPass();
-}
-const VkRenderPass& SwapChain::GetShadowMapRenderPass() const {
-  return static_cast<Render*>(owner)->GetShadowMapRenderPass();
-}
-
 VkSurfaceFormatKHR SwapChain::ChooseSurfaceFormat(
     const SurfaceFormats& availableFormats) const {
   for (const auto& format : availableFormats) {
@@ -141,142 +129,24 @@ void SwapChain::CreateImageViews(const VkDevice& device) {
   }
 }
 
-void SwapChain::DestroyColorResource(const Device& device) {
-  if (device.GetMSAASamples() != VK_SAMPLE_COUNT_1_BIT) {
-    vkDestroyImageView(device.GetLogical(), colorImageView, nullptr);
-    vkDestroyImage(device.GetLogical(), colorImage, nullptr);
-    vkFreeMemory(device.GetLogical(), colorImageMemory, nullptr);
-  }
-  if (GetEnableDeferred()) {
-    for (const auto& imageView : gBufferImageViews) {
-      vkDestroyImageView(device.GetLogical(), imageView, nullptr);
-    }
-    gBufferImageViews.clear();
-    for (const auto& image : gBufferImages) {
-      vkDestroyImage(device.GetLogical(), image, nullptr);
-    }
-    gBufferImages.clear();
-    for (const auto& imageMemory : gBufferImageMemories) {
-      vkFreeMemory(device.GetLogical(), imageMemory, nullptr);
-    }
-    gBufferImageMemories.clear();
-  }
-}
-
 void SwapChain::CleanupRenderTarget(const Device& device) const {
-  for (const auto& frameBuffer : colorFrameBuffers) {
-    vkDestroyFramebuffer(device.GetLogical(), frameBuffer, nullptr);
-  }
-  if (GetEnableZPrePass()) {
-    vkDestroyFramebuffer(device.GetLogical(), zPrePassFrameBuffer, nullptr);
-  }
-  if (GetEnableShadowMap()) {
-    for (const auto& frameBuffer : shadowMapFrameBuffers) {
-      vkDestroyFramebuffer(device.GetLogical(), frameBuffer, nullptr);
-    }
-  }
   for (const auto& imageView : swapChainImageViews) {
     vkDestroyImageView(device.GetLogical(), imageView, nullptr);
   }
   vkDestroySwapchainKHR(device.GetLogical(), chain, nullptr);
 }
 
-void SwapChain::CreateColorFrameBuffers(const Device& device) {
-  colorFrameBuffers.resize(swapChainImageViews.size());
-  for (size_t i = 0; i < swapChainImageViews.size(); i++) {
-    std::vector attachments = {swapChainImageViews[i],
-                               zPrePassDepth.GetDepthImageView()};
-    if (device.GetMSAASamples() != VK_SAMPLE_COUNT_1_BIT) {
-      attachments = {colorImageView, zPrePassDepth.GetDepthImageView(),
-                     swapChainImageViews[i]};
-    }
-    if (GetEnableDeferred()) {
-      for (VkImageView imageView : gBufferImageViews) {
-        attachments.push_back(imageView);
-      }
-    }
-    VkFramebufferCreateInfo frameBufferInfo{
-        .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
-        .renderPass = GetColorRenderPass(),
-        .attachmentCount = static_cast<uint32_t>(attachments.size()),
-        .pAttachments = attachments.data(),
-        .width = extent.width,
-        .height = extent.height,
-        .layers = 1,
-    };
-    if (vkCreateFramebuffer(device.GetLogical(), &frameBufferInfo, nullptr,
-                            &colorFrameBuffers[i]) != VK_SUCCESS) {
-      PRINT_AND_THROW_ERROR("failed to create frame buffer!");
-    }
-  }
-}
-void SwapChain::CreateZPrePassFrameBuffer(const VkDevice& device) {
-  VkFramebufferCreateInfo frameBufferInfo{
-      .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
-      .renderPass = GetZPrePassRenderPass(),
-      .attachmentCount = 1,
-      .pAttachments = &zPrePassDepth.GetDepthImageView(),
-      .width = extent.width,
-      .height = extent.height,
-      .layers = 1,
-  };
-  if (vkCreateFramebuffer(device, &frameBufferInfo, nullptr,
-                          &zPrePassFrameBuffer) != VK_SUCCESS) {
-    PRINT_AND_THROW_ERROR("failed to create frame buffer!");
-  }
-}
-void SwapChain::CreateShadowMapFrameBuffers(const VkDevice& device) {
-  shadowMapFrameBuffers.resize(shadowMapDepths.size());
-  for (size_t i = 0; i < shadowMapDepths.size(); i++) {
-    VkFramebufferCreateInfo frameBufferInfo{
-        .sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO,
-        .renderPass = GetShadowMapRenderPass(),
-        .attachmentCount = 1,
-        .pAttachments = &shadowMapDepths[i].GetDepthImageView(),
-        .width = GetShadowMapWidth(),
-        .height = GetShadowMapHeight(),
-        .layers = 1,
-    };
-    if (vkCreateFramebuffer(device, &frameBufferInfo, nullptr,
-                            &shadowMapFrameBuffers[i]) != VK_SUCCESS) {
-      PRINT_AND_THROW_ERROR("failed to create frame buffer!");
-    }
-  }
-}
-
-void SwapChain::RecreateSwapChain(
-    const Device& device, const VkWindow& window,
-    std::unordered_map<std::string, Draw*>& draws) {
+void SwapChain::RecreateSwapChain(const Device& device,
+                                  const VkWindow& window) {
   window.OnRecreateSwapChain();
   device.WaitIdle();
 
-  DestroyColorResource(device);
   DestroyDepthResource(device.GetLogical());
   CleanupRenderTarget(device);
 
   CreateRenderTarget(device, window);
-  CreateColorResource(device);
   CreateDepthResources(device);
   TransitionDepthImageLayout(device);
-
-  for (Draw* draw : draws | std::views::values) {
-    if (GetEnableShadowMap()) {
-      if (GetEnableDeferred()) {
-        draw->UpdateDeferredShadowMapDescriptorSets(
-            device.GetLogical(), *static_cast<Render*>(owner));
-      } else {
-        for (const auto& mesh : draw->GetMeshes()) {
-          mesh->UpdateColorShadowMapDescriptorSets(
-              device.GetLogical(), *static_cast<Render*>(owner));
-        }
-      }
-    }
-    if (GetEnableDeferred()) {
-      draw->UpdateDeferredGBufferDescriptorSets(device.GetLogical(),
-                                                *static_cast<Render*>(owner));
-    }
-  }
-  CreateFrameBuffers(device);
 }
 
 void SwapChain::CreateRenderTarget(const Device& device,
@@ -295,46 +165,18 @@ void SwapChain::CreateRenderTarget(const std::string& format,
   CreateImageViews(device.GetLogical());
 }
 
-void SwapChain::CreateColorResource(const Device& device) {
-  if (device.GetMSAASamples() != VK_SAMPLE_COUNT_1_BIT) {
-    auto [image, memory] = Texture::CreateImage(
-        device, extent.width, extent.height, 1, device.GetMSAASamples(),
-        imageFormat, VK_IMAGE_TILING_OPTIMAL,
-        VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT |
-            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
-        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-    colorImage = image;
-    colorImageMemory = memory;
-    colorImageView =
-        Texture::CreateImageView(device.GetLogical(), colorImage, 1,
-                                 imageFormat, VK_IMAGE_ASPECT_COLOR_BIT);
+void SwapChain::CreateDepthResources(const Device& device) {
+  // The depth pyramid is built from the sampled Z-prepass depth
+  VkImageUsageFlags zPrePassUsage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+  if (GetEnableOcclusionCulling()) {
+    zPrePassUsage |= VK_IMAGE_USAGE_SAMPLED_BIT;
   }
-  if (GetEnableDeferred()) {
-    for (int i = 0; i < GBUFFER_SIZE; i++) {
-      VkFormat format = VK_FORMAT_R32G32B32A32_SFLOAT;
-      if (i == 0) {
-        format = imageFormat;
-      }
-      auto [image, memory] = Texture::CreateImage(
-          device, extent.width, extent.height, 1, device.GetMSAASamples(),
-          format, VK_IMAGE_TILING_OPTIMAL,
-          VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT |
-              VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
-              VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT,
-          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
-      gBufferImages.push_back(image);
-      gBufferImageMemories.push_back(memory);
-      gBufferImageViews.push_back(
-          Texture::CreateImageView(device.GetLogical(), gBufferImages.back(), 1,
-                                   format, VK_IMAGE_ASPECT_COLOR_BIT));
-    }
+  // The compact G-buffer reconstructs position from it
+  if (GetEnableCompactGBuffer()) {
+    zPrePassUsage |= VK_IMAGE_USAGE_INPUT_ATTACHMENT_BIT;
   }
-}
-
-void SwapChain::CreateDepthResources(const Device& device) {
-  zPrePassDepth.CreateDepthResources(
-      device, extent.width, extent.height, device.GetMSAASamples(),
-      VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT);
+  zPrePassDepth.CreateDepthResources(device, extent.width, extent.height,
+                                     device.GetMSAASamples(), zPrePassUsage);
 
   if (GetEnableShadowMap()) {
     for (Depth& depth : shadowMapDepths) {
@@ -347,10 +189,8 @@ void SwapChain::CreateDepthResources(const Device& device) {
 }
 
 void SwapChain::TransitionDepthImageLayout(const Device& device) {
-  zPrePassDepth.TransitionDepthImageLayout(
-      device, *static_cast<Render*>(owner), VK_IMAGE_LAYOUT_UNDEFINED,
-      VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
-
+  // The render graph transitions the depth images its passes use, shadow maps
+  // of lights without a pass stay bound and must be readable from the start
   if (GetEnableShadowMap()) {
     for (Depth& depth : shadowMapDepths) {
       depth.TransitionDepthImageLayout(
@@ -358,14 +198,4 @@ void SwapChain::TransitionDepthImageLayout(const Device& device) {
           VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
     }
   }
-}
-
-void SwapChain::CreateFrameBuffers(const Device& device) {
-  CreateColorFrameBuffers(device);
-  if (GetEnableZPrePass()) {
-    CreateZPrePassFrameBuffer(device.GetLogical());
-  }
-  if (GetEnableShadowMap()) {
-    CreateShadowMapFrameBuffers(device.GetLogical());
-  }
 }
\ No newline at end of file
@@ -116,7 +116,8 @@ VkSampler Texture::CreateSampler(const Device& device, const uint32_t mipLevels,
 void Texture::GenerateMipmaps(const Device& device, const Render& render,
                               const VkImage image, const int32_t width,
                               const int32_t height, const uint32_t mipLevels,
-                              const VkFormat imageFormat) {
+                              const VkFormat imageFormat,
+                              VkCommandBuffer commandBuffer) {
   VkFormatProperties formatProperties;
   vkGetPhysicalDeviceFormatProperties(device.GetPhysical(), imageFormat,
                                       &formatProperties);
@@ -127,8 +128,13 @@ void Texture::GenerateMipmaps(const Device& device, const Render& render,
         "texture image format does not support linear blitting!");
   }
 
-  VkCommandBuffer commandBuffer;
-  render.BeginSingleTimeCommands(device.GetLogical(), &commandBuffer);
+  bool requireOneTimeCommandBuffer = false;
+  if (commandBuffer == VK_NULL_HANDLE) {
+    requireOneTimeCommandBuffer = true;
+
+    commandBuffer = {};
+    render.BeginSingleTimeCommands(device.GetLogical(), &commandBuffer);
+  }
 
   VkImageMemoryBarrier barrier{
       .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
@@ -207,13 +213,17 @@ void Texture::GenerateMipmaps(const Device& device, const Render& render,
   vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
                        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0,
                        nullptr, 1, &barrier);
-  render.EndSingleTimeCommands(device, &commandBuffer);
+
+  if (requireOneTimeCommandBuffer == true) {
+    render.EndSingleTimeCommands(device, &commandBuffer);
+  }
 }
 
 void Texture::CreateTextureImage(const Device& device, const Render& render,
                                  const int texWidth, const int texHeight,
                                  const int texChannels,
-                                 std::weak_ptr<TextureDataContent> pixelsPtr) {
+                                 std::weak_ptr<TextureDataContent> pixelsPtr,
+                                 UploadBatch& batch) {
   const VkDeviceSize imageSize =
       static_cast<VkDeviceSize>(texWidth) * texHeight * 4;
 
@@ -223,7 +233,6 @@ void Texture::CreateTextureImage(const Device& device, const Render& render,
     createInterrupted = true;
     return;
   }
-  pixels->inUse.lock();
 
   VkBuffer stagingBuffer;
   VkDeviceMemory stagingBufferMemory;
@@ -231,12 +240,15 @@ void Texture::CreateTextureImage(const Device& device, const Render& render,
                            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
                                VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
                            stagingBuffer, stagingBufferMemory);
+  batch.stagingBuffers.emplace_back(stagingBuffer, stagingBufferMemory);
 
   void* imageData = nullptr;
   vkMapMemory(device.GetLogical(), stagingBufferMemory, 0, imageSize, 0,
               &imageData);
 
+  pixels->inUse.lock();
   memcpy(imageData, pixels->content, imageSize);
+  pixels->inUse.unlock();
   vkUnmapMemory(device.GetLogical(), stagingBufferMemory);
 
   auto [image, imageMemory] = CreateImage(
@@ -250,22 +262,21 @@ void Texture::CreateTextureImage(const Device& device, const Render& render,
 
   TransitionImageLayout(device, render, textureImage, mipLevels, imageFormat,
                         VK_IMAGE_LAYOUT_UNDEFINED,
-                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-  CopyBufferToImage(device, render, stagingBuffer, textureImage,
+                        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                        VK_IMAGE_ASPECT_COLOR_BIT, batch.commandBuffer);
+  CopyBufferToImage(batch.commandBuffer, stagingBuffer, textureImage,
                     static_cast<uint32_t>(texWidth),
                     static_cast<uint32_t>(texHeight));
-  vkDestroyBuffer(device.GetLogical(), stagingBuffer, nullptr);
-  vkFreeMemory(device.GetLogical(), stagingBufferMemory, nullptr);
 
   if (render.GetEnableMipmap()) {
     GenerateMipmaps(device, render, image, texWidth, texHeight, mipLevels,
-                    imageFormat);
+                    imageFormat, batch.commandBuffer);
   } else {
     TransitionImageLayout(device, render, textureImage, mipLevels, imageFormat,
                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+                          VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                          VK_IMAGE_ASPECT_COLOR_BIT, batch.commandBuffer);
   }
-  pixels->inUse.unlock();
 }
 
 void Texture::CreateTextureImageView(const VkDevice& device) {
@@ -371,12 +382,9 @@ void Texture::TransitionImageLayout(
   }
 }
 
-void Texture::CopyBufferToImage(const Device& device, const Render& render,
+void Texture::CopyBufferToImage(const VkCommandBuffer commandBuffer,
                                 const VkBuffer buffer, const VkImage image,
                                 const uint32_t width, const uint32_t height) {
-  VkCommandBuffer commandBuffer;
-  render.BeginSingleTimeCommands(device.GetLogical(), &commandBuffer);
-
   const VkBufferImageCopy region{
       .bufferOffset = 0,
       .bufferRowLength = 0,
@@ -394,13 +402,13 @@ void Texture::CopyBufferToImage(const Device& device, const Render& render,
 
   vkCmdCopyBufferToImage(commandBuffer, buffer, image,
                          VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
-  render.EndSingleTimeCommands(device, &commandBuffer);
 }
 
 void Texture::CreateTexture(const Device& device, const Render& render,
                             const int width, const int height,
                             const int channels,
-                            std::weak_ptr<TextureDataContent> data) {
+                            std::weak_ptr<TextureDataContent> data,
+                            UploadBatch& batch) {
   if (render.GetEnableMipmap()) {
     mipLevels =
         static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) +
@@ -408,7 +416,7 @@ void Texture::CreateTexture(const Device& device, const Render& render,
   } else {
     mipLevels = 1;
   }
-  CreateTextureImage(device, render, width, height, channels, data);
+  CreateTextureImage(device, render, width, height, channels, data, batch);
   if (createInterrupted) {
     return;
   }
@@ -413,11 +413,13 @@ void TransformBuffer::UpdateUniformBuffer(const uint32_t currentImage) {
       TransformData* buffer =
           reinterpret_cast<TransformData*>(uniformBuffersMapped[currentImage]);
 
-      const glm::mat4x4* modelMatrix = bridgePtr->uniform.modelMatrix;
+      const glm::mat4x4* modelMatrix = bridgePtr->uniform.modelMatrix.load();
       buffer->modelMatrix = modelMatrix ? *modelMatrix : Mat4x4Zero;
+      buffer->dequantMatrix = bridgePtr->dequant.position;
+      buffer->texCoordDequant = bridgePtr->dequant.texCoord;
 
+      buffer->viewMatrix = camera->GetRenderViewMatrix();
       camera->GetMatrixLock().lock();
-      buffer->viewMatrix = camera->GetViewMatrix();
       buffer->projMatrix = camera->GetProjMatrix();
       camera->GetMatrixLock().unlock();
     }
@@ -430,8 +432,9 @@ void ShadowMapBuffer::UpdateUniformBuffer(const uint32_t currentImage,
     TransformData* buffer =
         reinterpret_cast<TransformData*>(uniformBuffersMapped[currentImage]);
 
-    const glm::mat4x4* modelMatrix = bridgePtr->uniform.modelMatrix;
+    const glm::mat4x4* modelMatrix = bridgePtr->uniform.modelMatrix.load();
     buffer->modelMatrix = modelMatrix ? *modelMatrix : Mat4x4Zero;
+    buffer->dequantMatrix = bridgePtr->dequant.position;
 
     shadowMapLight->GetMatrixLock().lock();
     buffer->viewMatrix = shadowMapLight->GetViewMatrix();
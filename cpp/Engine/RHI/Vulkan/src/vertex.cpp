@@ -1,42 +1,177 @@
 #include "../include/vertex.h"
 
-VkVertexInputBindingDescription Vertex::GetBindingDescription() {
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace {
+enum class Attribute : uint32_t {
+  Position = 0,
+  Color = 1,
+  Normal = 2,
+  Tangent = 3,
+  TexCoord = 4,
+};
+
+struct AttributeInfo {
+  Attribute attribute;
+  VkFormat format;
+  uint32_t size;
+};
+
+std::vector<AttributeInfo> GetAttributes(const uint32_t format) {
+  std::vector<AttributeInfo> attributes;
+  if (format & QuantizedPositionVertexFormat) {
+    attributes.push_back(
+        {Attribute::Position, VK_FORMAT_R16G16B16A16_UNORM, 8});
+  } else {
+    attributes.push_back({Attribute::Position, VK_FORMAT_R32G32B32_SFLOAT, 12});
+  }
+  if ((format & NoColorVertexFormat) == 0) {
+    attributes.push_back({Attribute::Color, VK_FORMAT_R32G32B32A32_SFLOAT, 16});
+  }
+  if (format & OctahedralNormalVertexFormat) {
+    attributes.push_back({Attribute::Normal, VK_FORMAT_R16G16_SNORM, 4});
+    attributes.push_back({Attribute::Tangent, VK_FORMAT_R16G16_SNORM, 4});
+  } else {
+    attributes.push_back({Attribute::Normal, VK_FORMAT_R32G32B32_SFLOAT, 12});
+    attributes.push_back({Attribute::Tangent, VK_FORMAT_R32G32B32_SFLOAT, 12});
+  }
+  if (format & SnormTexCoordVertexFormat) {
+    attributes.push_back({Attribute::TexCoord, VK_FORMAT_R16G16_SNORM, 4});
+  } else {
+    attributes.push_back({Attribute::TexCoord, VK_FORMAT_R32G32_SFLOAT, 8});
+  }
+  return attributes;
+}
+
+uint16_t ToUnorm16(const float value) {
+  return static_cast<uint16_t>(
+      std::lround(std::clamp(value, 0.0f, 1.0f) * 65535.0f));
+}
+int16_t ToSnorm16(const float value) {
+  return static_cast<int16_t>(
+      std::lround(std::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+template <typename T>
+void Write(uint8_t*& dst, const T& value) {
+  memcpy(dst, &value, sizeof(T));
+  dst += sizeof(T);
+}
+
+void WriteDirection(uint8_t*& dst, const glm::vec3& direction,
+                    const bool octahedral) {
+  if (octahedral) {
+    const glm::vec2 encoded = MathUtils::OctahedralEncode(direction);
+    Write(dst, std::array{ToSnorm16(encoded.x), ToSnorm16(encoded.y)});
+  } else {
+    Write(dst, direction);
+  }
+}
+}  // namespace
+
+uint32_t VertexLayout::GetStride(const uint32_t format) {
+  uint32_t stride = 0;
+  for (const auto& attribute : GetAttributes(format)) {
+    stride += attribute.size;
+  }
+  return stride;
+}
+
+VkVertexInputBindingDescription VertexLayout::GetBindingDescription(
+    const uint32_t format) {
   return {
       .binding = 0,
-      .stride = sizeof(Vertex),
+      .stride = GetStride(format),
       .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
   };
 }
 
-AttributeDescriptions Vertex::GetAttributeDescriptions() {
-  return {VkVertexInputAttributeDescription{
-              .location = 0,
-              .binding = 0,
-              .format = VK_FORMAT_R32G32B32_SFLOAT,
-              .offset = offsetof(Vertex, pos),
-          },
-          VkVertexInputAttributeDescription{
-              .location = 1,
-              .binding = 0,
-              .format = VK_FORMAT_R32G32B32A32_SFLOAT,
-              .offset = offsetof(Vertex, color),
-          },
-          VkVertexInputAttributeDescription{
-              .location = 2,
-              .binding = 0,
-              .format = VK_FORMAT_R32G32B32_SFLOAT,
-              .offset = offsetof(Vertex, normal),
-          },
-          VkVertexInputAttributeDescription{
-              .location = 3,
-              .binding = 0,
-              .format = VK_FORMAT_R32G32B32_SFLOAT,
-              .offset = offsetof(Vertex, tangent),
-          },
-          VkVertexInputAttributeDescription{
-              .location = 4,
-              .binding = 0,
-              .format = VK_FORMAT_R32G32_SFLOAT,
-              .offset = offsetof(Vertex, texCoord),
-          }};
+AttributeDescriptions VertexLayout::GetAttributeDescriptions(
+    const uint32_t format) {
+  AttributeDescriptions descriptions;
+  uint32_t offset = 0;
+  for (const auto& [attribute, attributeFormat, size] : GetAttributes(format)) {
+    descriptions.push_back({
+        .location = static_cast<uint32_t>(attribute),
+        .binding = 0,
+        .format = attributeFormat,
+        .offset = offset,
+    });
+    offset += size;
+  }
+  return descriptions;
+}
+
+std::vector<std::pair<std::string, std::string>> VertexLayout::GetDefinitions(
+    const uint32_t format) {
+  std::vector<std::pair<std::string, std::string>> definitions;
+  if (format & QuantizedPositionVertexFormat) {
+    definitions.emplace_back("VertexQuantizedPosition", "1");
+  }
+  if (format & OctahedralNormalVertexFormat) {
+    definitions.emplace_back("VertexOctahedralNormal", "1");
+  }
+  if (format & SnormTexCoordVertexFormat) {
+    definitions.emplace_back("VertexSnormTexCoord", "1");
+  }
+  if (format & NoColorVertexFormat) {
+    definitions.emplace_back("VertexNoColor", "1");
+  }
+  return definitions;
+}
+
+std::vector<uint8_t> VertexLayout::Encode(
+    const uint32_t format, const std::vector<VertexData>& vertices,
+    const VertexDequantData& dequant) {
+  std::vector<uint8_t> encoded(GetStride(format) * vertices.size());
+  Encode(format, vertices, dequant, encoded.data());
+  return encoded;
+}
+
+void VertexLayout::Encode(const uint32_t format,
+                          const std::vector<VertexData>& vertices,
+                          const VertexDequantData& dequant, uint8_t* dst) {
+  const glm::mat4 quantMatrix = glm::inverse(dequant.position);
+  const glm::vec2 texCoordScale(dequant.texCoord.x, dequant.texCoord.y);
+  const glm::vec2 texCoordOffset(dequant.texCoord.z, dequant.texCoord.w);
+  const auto attributes = GetAttributes(format);
+
+  for (const VertexData& vertex : vertices) {
+    for (const auto& info : attributes) {
+      switch (info.attribute) {
+        case Attribute::Position:
+          if (format & QuantizedPositionVertexFormat) {
+            const glm::vec4 q = quantMatrix * glm::vec4(vertex.pos, 1);
+            Write(dst, std::array{ToUnorm16(q.x), ToUnorm16(q.y),
+                                  ToUnorm16(q.z), uint16_t(0)});
+          } else {
+            Write(dst, vertex.pos);
+          }
+          break;
+        case Attribute::Color:
+          Write(dst, vertex.color);
+          break;
+        case Attribute::Normal:
+          WriteDirection(dst, vertex.normal,
+                         format & OctahedralNormalVertexFormat);
+          break;
+        case Attribute::Tangent:
+          WriteDirection(dst, vertex.tangent,
+                         format & OctahedralNormalVertexFormat);
+          break;
+        case Attribute::TexCoord:
+          if (format & SnormTexCoordVertexFormat) {
+            const glm::vec2 q =
+                (vertex.texCoord - texCoordOffset) / texCoordScale;
+            Write(dst, std::array{ToSnorm16(q.x), ToSnorm16(q.y)});
+          } else {
+            Write(dst, vertex.texCoord);
+          }
+          break;
+      }
+    }
+  }
 }
@@ -1,15 +1,22 @@
 #include <Engine/Model/include/BaseMaterial.h>
+#include <Engine/Model/include/TransformSystem.h>
 #include <Engine/RHI/Vulkan/include/vulkan.h>
+#include <Engine/Scene/include/BaseScene.h>
 #include <Engine/System/include/Application.h>
 #include <Engine/System/include/BaseInput.h>
 #include <Engine/Utility/include/JsonUtils.h>
 
+#include <algorithm>
+#include <filesystem>
 #include <mutex>
+#include <ranges>
 #include <thread>
 
 void Vulkan::CreateWindow(const std::string& title) {
-  int width = JSON_CONFIG(Int, "DefaultWindowWidth");
-  int height = JSON_CONFIG(Int, "DefaultWindowHeight");
+  GetAppPointer();
+  const auto config = appPointer->GetGraphicsConfig();
+  int width = config->defaultWindowWidth;
+  int height = config->defaultWindowHeight;
 
   windowWidth = width == 0 ? VulkanConfig::DEFAULT_WINDOW_WIDTH : width;
   windowHeight = height == 0 ? VulkanConfig::DEFAULT_WINDOW_HEIGHT : height;
@@ -18,22 +25,36 @@ void Vulkan::CreateWindow(const std::string& title) {
 }
 
 void Vulkan::InitConfig() {
-  showRenderFrameCount = JSON_CONFIG(Bool, "ShowRenderFrameCount");
-  showGameFrameCount = JSON_CONFIG(Bool, "ShowGameFrameCount");
-
-  enableMipmap = JSON_CONFIG(Bool, "EnableMipmap");
-  enableZPrePass = JSON_CONFIG(Bool, "EnableZPrePass");
-  enableShadowMap = JSON_CONFIG(Bool, "EnableShadowMap");
-  enableDeferred = JSON_CONFIG(Bool, "EnableDeferred");
-  enableShaderDebug = JSON_CONFIG(Bool, "EnableShaderDebug");
-
-  shadowMapWidth = JSON_CONFIG(Int, "ShadowMapWidth");
-  shadowMapHeight = JSON_CONFIG(Int, "ShadowMapHeight");
-
-  msaaSamples = JSON_CONFIG(Int, "MSAAMaxSamples");
-  depthBiasClamp = JSON_CONFIG(Float, "DepthBiasClamp");
-  depthBiasSlopeFactor = JSON_CONFIG(Float, "DepthBiasSlopeFactor");
-  depthBiasConstantFactor = JSON_CONFIG(Float, "DepthBiasConstantFactor");
+  GetAppPointer();
+  const auto config = appPointer->GetGraphicsConfig();
+  showRenderFrameCount = config->showRenderFrameCount;
+  showGameFrameCount = config->showGameFrameCount;
+
+  enableMipmap = config->enableMipmap;
+  enableZPrePass = config->enableZPrePass;
+  enableShadowMap = config->enableShadowMap;
+  enableDeferred = config->enableDeferred;
+  enableCompactGBuffer = config->enableCompactGBuffer;
+  enableOcclusionCulling = config->enableOcclusionCulling;
+  enableTileClassification = config->enableTileClassification;
+  enableAsyncCompute = config->enableAsyncCompute;
+  enableShaderDebug = config->enableShaderDebug;
+
+  shadowMapWidth = config->shadowMapWidth;
+  shadowMapHeight = config->shadowMapHeight;
+
+  msaaSamples = config->msaaMaxSamples;
+  depthBiasClamp = config->depthBiasClamp;
+  depthBiasSlopeFactor = config->depthBiasSlopeFactor;
+  depthBiasConstantFactor = config->depthBiasConstantFactor;
+
+  TransformSystem::SetParallelUpdate(config->enableParallelTransform);
+
+  enableFixedTimeStep = config->enableFixedTimeStep;
+  enableTransformInterpolation = config->enableTransformInterpolation;
+  fixedTimeStep = config->fixedTimeStep;
+  maxStepsPerFrame = config->maxStepsPerFrame;
+  maxGameFrameRate = config->maxGameFrameRate;
 }
 
 void Vulkan::InitGraphics() {
@@ -46,16 +67,27 @@ void Vulkan::InitGraphics() {
 
   device.PickPhysicalDevice(instance.GetVkInstance(), window.GetSurface());
   device.CreateLogicalDevice(window.GetSurface(), validation);
-
-  render.CreateRenderResources(
-      device, window, JSON_CONFIG(String, "SwapChainSurfaceImageFormat"),
-      JSON_CONFIG(String, "SwapChainSurfaceColorSpace"));
+  separateComputeQueue = device.GetSeparateComputeQueue();
+  timelineSemaphoreSupport = device.GetTimelineSemaphoreSupport();
+
+  const auto config = appPointer->GetGraphicsConfig();
+  render.CreateRenderResources(device, window,
+                               config->swapChainSurfaceImageFormat,
+                               config->swapChainSurfaceColorSpace);
+  if (render.GetEnableOcclusionCulling()) {
+    render.CreateOcclusionCulling(device, GetRoot(), config->hiZShaderPath);
+  }
+  if (render.GetEnableTileClassification()) {
+    render.CreateLightingTiles(device, GetRoot(),
+                               config->lightingTileShaderPath);
+  }
 }
 
 void Vulkan::TriggerOnUpdate(
     std::unordered_map<int, std::weak_ptr<BaseLight>>& lightsById) {
   auto drawIter = drawsByShader.begin();
   while (drawIter != drawsByShader.end()) {
+    drawIter->second->PromoteCreatedMeshes(device.GetLogical(), render);
     auto& meshes = drawIter->second->GetMeshes();
     auto meshIter = meshes.begin();
     while (meshIter != meshes.end()) {
@@ -65,7 +97,9 @@ void Vulkan::TriggerOnUpdate(
         (*meshIter)->Destroy();
         meshIter = meshes.erase(meshIter);
       } else {
-        // Update uniform buffer if mesh alive
+        // Update uniform buffer and level of detail if mesh alive
+        (*meshIter)->SelectLod(
+            static_cast<float>(render.GetSwapChainExtentHeight()));
         (*meshIter)->UpdateUniformBuffer(render.GetCurrentFrame());
         if (GetEnableShadowMap()) {
           (*meshIter)->UpdateShadowMapUniformBuffers(
@@ -74,7 +108,7 @@ void Vulkan::TriggerOnUpdate(
         meshIter++;
       }
     }
-    if (meshes.empty()) {
+    if (meshes.empty() && drawIter->second->HasPendingMeshes() == false) {
       // Destroy the draw if meshes empty
       Draw* needToDestroy = drawIter->second;
       drawIter = drawsByShader.erase(drawIter);
@@ -155,46 +189,209 @@ void Vulkan::ShowRenderFrameCount() {
   }
 }
 
-void Vulkan::GameLoop() {
-  SetGameLoopEnd(false);
+void Vulkan::TickGame() {
+  if (showGameFrameCount == true) {
+    ShowGameFrameCount();
+  }
+  Input::Snapshot();
+  appPointer->TriggerOnUpdate();
+  TransformSystem::UpdateWorldTransforms();
+}
+
+void Vulkan::PaceGameLoop(std::chrono::steady_clock::time_point until) {
+  // Sleep for the bulk of the wait, the scheduler wakes up late by up to a
+  // millisecond, then yield the rest away.
+  std::this_thread::sleep_until(
+      until - std::chrono::duration_cast<std::chrono::nanoseconds>(
+                  paceYieldMargin));
+  while (std::chrono::steady_clock::now() < until &&
+         GetRenderLoopEnd() == false) {
+    std::this_thread::yield();
+  }
+}
+
+void Vulkan::RunFixedGameLoop() {
+  const seconds timeStep(fixedTimeStep);
+  const seconds maxFrameTime = timeStep * static_cast<float>(maxStepsPerFrame);
+
+  auto lastTime = std::chrono::steady_clock::now();
+  seconds accumulator = timeStep;
   while (GetRenderLoopEnd() == false) {
+    auto nowTime = std::chrono::steady_clock::now();
+    accumulator += std::min<seconds>(nowTime - lastTime, maxFrameTime);
+    lastTime = nowTime;
+
+    while (accumulator >= timeStep) {
+      GameDeltaTime = timeStep.count();
+      if (enableTransformInterpolation) {
+        TransformSystem::SaveTransformsForInterpolation();
+      }
+      TickGame();
+      lastGameTickTime = std::chrono::steady_clock::now();
+      accumulator -= timeStep;
+    }
+    PaceGameLoop(lastTime +
+                 std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     timeStep - accumulator));
+  }
+}
+
+void Vulkan::RunVariableGameLoop() {
+  while (GetRenderLoopEnd() == false) {
+    auto frameStart = std::chrono::steady_clock::now();
     UpdateGameDeltaTime();
-    if (showGameFrameCount == true) {
-      ShowGameFrameCount();
+    TickGame();
+    lastGameTickTime = std::chrono::steady_clock::now();
+
+    if (maxGameFrameRate > 0) {
+      PaceGameLoop(frameStart +
+                   std::chrono::duration_cast<std::chrono::nanoseconds>(
+                       seconds(1.0f / maxGameFrameRate)));
+    } else {
+      std::this_thread::yield();
     }
-    Input::RecordDownUpFlags();
-    appPointer->TriggerOnUpdate();
-    Input::ResetDownUpFlags();
   }
-  SetGameLoopEnd(true);
+}
+
+void Vulkan::GameLoop() {
+  if (enableFixedTimeStep) {
+    RunFixedGameLoop();
+  } else {
+    RunVariableGameLoop();
+  }
+}
+
+void Vulkan::UpdateRenderTransforms() {
+  float alpha = 1.0f;
+  if (enableFixedTimeStep && enableTransformInterpolation) {
+    seconds sinceTick =
+        std::chrono::steady_clock::now() - lastGameTickTime.load();
+    alpha = std::clamp(sinceTick.count() / fixedTimeStep, 0.0f, 1.0f);
+  }
+  TransformSystem::InterpolateRenderTransforms(alpha);
+}
+
+void Vulkan::StartHotReload() {
+  const auto config = appPointer->GetGraphicsConfig();
+  if (config->enableHotReload == false) {
+    return;
+  }
+  for (const std::string& path : config->hotReloadPaths) {
+    hotReloadWatcher.WatchDirectory(GetRoot() + path);
+  }
+  hotReloadWatcher.Start(hotReloadPollInterval);
+}
+
+void Vulkan::RebuildPipelines(
+    const std::unordered_map<Draw*, uint32_t>& variants) {
+  // Runs between frames on the render thread, so the swap chain and render
+  // passes stay as they are, and every frame ends with WaitIdle, so the
+  // replaced pipelines are unused
+  for (const auto& [draw, drawVariants] : variants) {
+    try {
+      draw->SwapPipelines(device.GetLogical(),
+                          draw->RebuildPipelines(device, render, drawVariants));
+    } catch (const std::exception& e) {
+      // Keep the old pipelines until the shader compiles again
+      PRINT_ERROR(e.what());
+    }
+  }
+}
+
+void Vulkan::ProcessHotReload() {
+  const auto config = appPointer->GetGraphicsConfig();
+  const auto glslDirectory = [this](const std::string& shaderPath) {
+    return std::filesystem::path(GetRoot() + shaderPath + "/glsl")
+        .lexically_normal();
+  };
+  std::unordered_map<Draw*, uint32_t> variants;
+  const auto addVariantsToAllDraws = [this, &variants](uint32_t variant) {
+    for (Draw* draw : drawsByShader | std::views::values) {
+      variants[draw] |= variant;
+    }
+  };
+
+  for (const std::string& path : hotReloadWatcher.TakeChanges()) {
+    const std::filesystem::path filePath(path);
+    const std::filesystem::path directory = filePath.parent_path();
+    if (filePath.extension() == ".json") {
+      // Material params reach the material uniform buffer on the next frame
+      const std::string documentPath = JsonUtils::GetDocumentPath(path);
+      JsonUtils::InvalidateDocument(documentPath);
+      if (auto scene = appPointer->GetScene().lock()) {
+        scene->ReloadMaterials(documentPath);
+      }
+    } else if (filePath.extension() == ".glsl") {
+      // Library files may be included by any stage
+      for (Draw* draw : drawsByShader | std::views::values) {
+        draw->ClearCompiledShaders();
+      }
+      addVariantsToAllDraws(AllPipelineVariants);
+    } else if (directory == glslDirectory(config->zPrePassShaderPath)) {
+      addVariantsToAllDraws(ZPrePassPipelineVariant);
+    } else if (directory == glslDirectory(config->shadowMapShaderPath)) {
+      addVariantsToAllDraws(ShadowMapPipelineVariant);
+    } else {
+      for (Draw* draw : drawsByShader | std::views::values) {
+        if (directory == glslDirectory(draw->GetShaderPath())) {
+          variants[draw] |= ColorPipelineVariant;
+        }
+      }
+    }
+  }
+  if (variants.empty() == false) {
+    RebuildPipelines(variants);
+  }
 }
 
 void Vulkan::RenderLoop() {
   SetRenderLoopEnd(false);
-  std::thread(&Vulkan::GameLoop, this).detach();
+  lastGameTickTime = std::chrono::steady_clock::now();
+  gameThread = std::thread(&Vulkan::GameLoop, this);
+  StartHotReload();
 
   while (!GetRenderLoopShouldEnd() &&
          !glfwWindowShouldClose(window.GetWindow())) {
     glfwPollEvents();
+    ProcessHotReload();
+    render.ResumeCompletedUploads(device.GetLogical());
 
     if (showRenderFrameCount == true) {
       UpdateRenderDeltaTime();
       ShowRenderFrameCount();
     }
     ParseMeshData();
+    UpdateRenderTransforms();
     TriggerOnUpdate(appPointer->GetLightsById());
     ReleaseBufferLocks();
 
     render.DrawFrame(device, drawsByShader, appPointer->GetLightsById(),
                      window);
+    occlusionTestedCount = render.GetOcclusionStats().tested;
+    occlusionCulledCount = render.GetOcclusionStats().culled;
+    drawCallCount = render.GetDrawStats().drawCalls;
+    bindCount = render.GetDrawStats().binds;
+    skippedBindCount = render.GetDrawStats().skippedBinds;
+    gBufferMemorySize = render.GetGBufferMemorySize();
+    transientMemorySize = render.GetTransientMemorySize();
+    aliasedMemorySize = render.GetAliasedMemorySize();
+    lightingTileCount = render.GetLightingTileStats().shaded;
+    lightingFullscreenTileCount = render.GetLightingTileStats().fullscreen;
+    lightingGpuTime = render.GetLightingTime();
     device.WaitIdle();
   }
+  // Loaders blocked on a full queue must not wait for a stopped render loop
+  meshDataQueue.Close();
   SetRenderLoopEnd(true);
-  while (GetGameLoopEnd() == false) {
+  if (gameThread.joinable()) {
+    gameThread.join();
   }
 }
 
 void Vulkan::CleanupGraphics() {
+  render.FlushUploads(device.GetLogical());
+  hotReloadWatcher.Stop();
+
   auto drawIter = drawsByShader.begin();
   while (drawIter != drawsByShader.end()) {
     drawIter->second->DestroyDrawResource(device.GetLogical(), render);
@@ -211,84 +408,88 @@ void Vulkan::CleanupGraphics() {
   window.DestroyWindow();
 }
 
-void Vulkan::ParseMeshData() {
-  if (needToUpdateMeshDatas) {
-    updateMeshDataMutex.lock();
-
-    if (meshDataQueue.empty() == false) {
-      if (auto mesh = meshDataQueue.front().lock()) {
-        if (auto materialPtr = mesh->uniform.material.lock()) {
-          std::vector<std::string>& shaders = materialPtr->GetShaders();
-          if (shaders.empty()) {
-            return;
-          }
+void Vulkan::LoadMeshToDraw(std::shared_ptr<MeshData> mesh) {
+  if (auto materialPtr = mesh->uniform.material.lock()) {
+    std::vector<std::string>& shaders = materialPtr->GetShaders();
+    std::vector<StringId>& shaderIds = materialPtr->GetShaderIds();
+    if (shaders.empty()) {
+      return;
+    }
+    const auto drawKey = [&mesh](const StringId shaderId) {
+      return Draw::GetDrawKey(shaderId, mesh->vertexFormat);
+    };
+
+    if (const auto drawIter = drawsByShader.find(drawKey(shaderIds[0]));
+        drawIter != drawsByShader.end()) {
+      drawIter->second->LoadDrawResource(device, render, mesh);
+    } else {
+      int findFallbackIndex = -1;
+      for (int i = 1; i < shaderIds.size(); i++) {
+        if (drawsByShader.contains(drawKey(shaderIds[i]))) {
+          findFallbackIndex = i;
+          break;
+        }
+      }
 
-          if (drawsByShader.contains(shaders[0])) {
-            drawsByShader[shaders[0]]->LoadDrawResource(device, render, mesh);
-          } else {
-            int findFallbackIndex = -1;
-            for (int i = 1; i < shaders.size(); i++) {
-              if (drawsByShader.contains(shaders[i])) {
-                findFallbackIndex = i;
-                break;
-              }
-            }
-
-            Draw* draw = Base::Create<Draw>(
-                device, render, GetRoot(), mesh->textures.size(), shaders,
-                JSON_CONFIG(String, "ZPrePassShaderPath"),
-                JSON_CONFIG(String, "ShadowMapShaderPath"));
-            int createFallbackIndex = draw->GetShaderFallbackIndex();
-
-            if (findFallbackIndex != -1 &&
-                findFallbackIndex < createFallbackIndex) {
-              drawsByShader[shaders[findFallbackIndex]]->LoadDrawResource(
-                  device, render, mesh);
-              draw->DestroyDrawResource(device.GetLogical(), render);
-              draw->Destroy();
-            } else if (createFallbackIndex != -1) {
-              draw->LoadDrawResource(device, render, mesh);
-
-              const std::string& shaderPath = shaders[createFallbackIndex];
-              draw->SetShaderPath(shaderPath);
-              drawsByShader[shaderPath] = draw;
-
-              int pipelineId = 0;
-              while (pipelineId < MaxPipelineNum) {
-                if (drawsByPipeline.contains(pipelineId) == false) {
-                  draw->SetPipelineId(render, pipelineId);
-                  drawsByPipeline[pipelineId] = draw;
-                  break;
-                }
-                pipelineId++;
-              }
-              if (pipelineId >= MaxPipelineNum) {
-                PRINT_AND_THROW_ERROR("pipeline num exceeds maximum!");
-              }
-            } else {
-              PRINT_AND_THROW_ERROR("could not fallback to a valid shader!");
-            }
+      const auto config = appPointer->GetGraphicsConfig();
+      Draw* draw = Base::Create<Draw>(
+          device, render, GetRoot(), mesh->textures.size(), mesh->vertexFormat,
+          shaders, config->zPrePassShaderPath, config->shadowMapShaderPath);
+      int createFallbackIndex = draw->GetShaderFallbackIndex();
+
+      if (findFallbackIndex != -1 && findFallbackIndex < createFallbackIndex) {
+        drawsByShader[drawKey(shaderIds[findFallbackIndex])]->LoadDrawResource(
+            device, render, mesh);
+        draw->DestroyDrawResource(device.GetLogical(), render);
+        draw->Destroy();
+      } else if (createFallbackIndex != -1) {
+        draw->LoadDrawResource(device, render, mesh);
+
+        draw->SetShaderPath(shaders[createFallbackIndex]);
+        drawsByShader[drawKey(shaderIds[createFallbackIndex])] = draw;
+
+        int pipelineId = 0;
+        while (pipelineId < MaxPipelineNum) {
+          if (drawsByPipeline.contains(pipelineId) == false) {
+            draw->SetPipelineId(render, pipelineId);
+            drawsByPipeline[pipelineId] = draw;
+            break;
           }
+          pipelineId++;
         }
+        if (pipelineId >= MaxPipelineNum) {
+          PRINT_AND_THROW_ERROR("pipeline num exceeds maximum!");
+        }
+      } else {
+        PRINT_AND_THROW_ERROR("could not fallback to a valid shader!");
       }
-      meshDataQueue.pop();
-    } else {
-      needToUpdateMeshDatas = false;
     }
-    updateMeshDataMutex.unlock();
+  }
+}
+
+void Vulkan::ParseMeshData() {
+  std::weak_ptr<MeshData> meshData;
+  while (meshDataQueue.TryPop(meshData)) {
+    if (auto mesh = meshData.lock()) {
+      LoadMeshToDraw(mesh);
+    }
   }
 }
 
 void Vulkan::ParseMeshData(std::weak_ptr<MeshData> meshData) {
-  updateMeshDataMutex.lock();
-  needToUpdateMeshDatas = true;
-  meshDataQueue.emplace(meshData);
-  updateMeshDataMutex.unlock();
+  meshDataQueue.Push(meshData);
+}
+
+std::unique_ptr<MeshStaging> Vulkan::AllocateMeshStaging(
+    const uint32_t vertexFormat, const size_t vertexCount,
+    const size_t indexCount) {
+  return MeshStagingTicket::Allocate(render.GetStagingPool(), vertexFormat,
+                                     vertexCount, indexCount);
 }
 
 float Vulkan::GetViewportAspect() { return render.GetViewportAspect(); }
 std::weak_ptr<LightChannel> Vulkan::GetLightChannelByName(
-    const std::string& name) {
+    const StringId name) {
   GetAppPointer();
   return appPointer->GetLightChannelByName(name);
 }
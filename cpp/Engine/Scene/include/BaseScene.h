@@ -1,6 +1,10 @@
 #pragma once
 
 #include <Engine/System/include/BaseObject.h>
+#include <Engine/Utility/include/Coroutine.h>
+#include <Engine/Utility/include/StringIdUtils.h>
+
+#include <mutex>
 
 class BaseLight;
 class BaseModel;
@@ -8,6 +12,7 @@ class BaseCamera;
 class SceneObject;
 class LightChannel;
 class BaseMaterial;
+class BaseResource;
 class GraphicsInterface;
 
 struct aiMaterial;
@@ -17,10 +22,11 @@ class BaseScene final : public BaseObject {
   std::weak_ptr<GraphicsInterface> graphics;
   std::unordered_map<int, std::weak_ptr<BaseLight>> lightsById;
 
-  std::unordered_map<std::string, std::shared_ptr<BaseMaterial>> materials;
-  std::unordered_map<std::string, std::shared_ptr<BaseCamera>> cameras;
-  std::unordered_map<std::string, std::shared_ptr<BaseLight>> lights;
-  std::unordered_map<std::string, std::shared_ptr<LightChannel>> lightChannels;
+  std::mutex materialsMutex;
+  std::unordered_map<StringId, std::shared_ptr<BaseMaterial>> materials;
+  std::unordered_map<StringId, std::shared_ptr<BaseCamera>> cameras;
+  std::unordered_map<StringId, std::shared_ptr<BaseLight>> lights;
+  std::unordered_map<StringId, std::shared_ptr<LightChannel>> lightChannels;
 
  public:
   int GetAvailableLightId();
@@ -31,22 +37,22 @@ class BaseScene final : public BaseObject {
 
   std::weak_ptr<BaseMaterial> GetMaterialByPath(const std::string& path,
                                                 aiMaterial* matData);
-  std::weak_ptr<BaseCamera> GetCameraByName(const std::string& name);
-  const std::unordered_map<std::string, std::shared_ptr<BaseLight>>& GetLights()
+  std::weak_ptr<BaseCamera> GetCameraByName(StringId name);
+  const std::unordered_map<StringId, std::shared_ptr<BaseLight>>& GetLights()
       const;
-  std::weak_ptr<BaseLight> GetLightByName(const std::string& name);
-  std::weak_ptr<LightChannel> GetLightChannelByName(const std::string& name);
+  std::weak_ptr<BaseLight> GetLightByName(StringId name);
+  std::weak_ptr<LightChannel> GetLightChannelByName(StringId name);
 
-  void RegisterCamera(const std::string& name,
-                      std::shared_ptr<BaseCamera> camera);
-  int RegisterLight(const std::string& name, std::shared_ptr<BaseLight> light);
-  void RegisterLightChannel(const std::string& name,
+  void RegisterCamera(StringId name, std::shared_ptr<BaseCamera> camera);
+  int RegisterLight(StringId name, std::shared_ptr<BaseLight> light);
+  void RegisterLightChannel(StringId name,
                             std::shared_ptr<LightChannel> channel);
 
-  void UnregisterMaterial(const std::string& name);
-  void UnregisterCamera(const std::string& name);
-  void UnregisterLight(const std::string& name);
-  void UnregisterLightChannel(const std::string& name);
+  void UnregisterMaterial(StringId name);
+  bool ReloadMaterials(const std::string& filePath);
+  void UnregisterCamera(StringId name);
+  void UnregisterLight(StringId name);
+  void UnregisterLightChannel(StringId name);
 
   template <typename... Args>
   explicit BaseScene(std::weak_ptr<GraphicsInterface> graphics, Args&&... args)
@@ -56,13 +62,12 @@ class BaseScene final : public BaseObject {
   [[nodiscard]] std::weak_ptr<GraphicsInterface> GetGraphics() const {
     return graphics;
   }
-  void AddModelToResourceWaitQueue(std::function<void()> func,
-                                   std::shared_ptr<BaseObject> obj);
+  void AddModelLoadTask(
+      std::function<Coroutine::Task<void>(BaseResource&)> load);
   std::weak_ptr<SceneObject> GetRootObject() { return rootObject; }
 
   virtual void OnCreate() override;
   virtual void OnStart() override;
-  virtual void OnUpdate() override { BaseObject::OnUpdate(); }
   virtual void OnStop() override { BaseObject::OnStop(); }
   virtual void OnDestroy() override;
 };
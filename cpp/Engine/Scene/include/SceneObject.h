@@ -49,28 +49,31 @@ class SceneObject : public BaseObject {
   void UpdateRelativeTransform() { transform.UpdateRelativeTransform(); }
   void UpdateAbsoluteTransform() { transform.UpdateAbsoluteTransform(); }
 
-  const glm::mat4x4& GetRelativeTransform() const {
+  glm::mat4x4 GetRelativeTransform() const {
     return transform.GetRelativeTransform();
   }
-  const glm::mat4x4& GetAbsoluteTransform() const {
+  glm::mat4x4 GetAbsoluteTransform() const {
     return transform.GetAbsoluteTransform();
   }
-  const glm::vec3& GetRelativePosition() const {
+  glm::mat4x4 GetRenderTransform() const {
+    return transform.GetRenderTransform();
+  }
+  glm::vec3 GetRelativePosition() const {
     return transform.GetRelativePosition();
   }
-  const glm::vec3& GetAbsolutePosition() const {
+  glm::vec3 GetAbsolutePosition() const {
     return transform.GetAbsolutePosition();
   }
-  const glm::vec3& GetRelativeRotation() const {
+  glm::vec3 GetRelativeRotation() const {
     return transform.GetRelativeRotation();
   }
-  const glm::vec3& GetAbsoluteRotation() const {
+  glm::vec3 GetAbsoluteRotation() const {
     return transform.GetAbsoluteRotation();
   }
-  const glm::vec3& GetRelativeScale() const {
+  glm::vec3 GetRelativeScale() const {
     return transform.GetRelativeScale();
   }
-  const glm::vec3& GetAbsoluteScale() const {
+  glm::vec3 GetAbsoluteScale() const {
     return transform.GetAbsoluteScale();
   }
 
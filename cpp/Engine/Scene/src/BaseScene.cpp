@@ -7,8 +7,10 @@
 #include <Engine/Scene/include/SceneObject.h>
 #include <Engine/System/include/Application.h>
 #include <Engine/System/include/BaseObject.h>
+#include <Engine/Utility/include/SceneBinaryUtils.h>
 #include <assimp/types.h>
 
+#include <filesystem>
 #include <ranges>
 
 void BaseScene::OnCreate() {
@@ -16,11 +18,14 @@ void BaseScene::OnCreate() {
 
   rootObject =
       Create<SceneObject>(rootObject, "RootObject", GetRoot(), GetFile());
-  JsonUtils::ParseSceneObjectTree(graphics, rootObject, GetRoot(), GetFile(),
-                                  shared_from_this());
-  JsonUtils::ParseSceneLightChannels(
-      GetRoot(), GetFile(),
-      std::static_pointer_cast<BaseScene>(shared_from_this()));
+  std::shared_ptr<BaseScene> scene =
+      std::static_pointer_cast<BaseScene>(shared_from_this());
+  if (!SceneBinaryUtils::LoadBinaryScene(graphics, rootObject, GetRoot(),
+                                         GetFile(), scene)) {
+    JsonUtils::ParseSceneObjectTree(graphics, rootObject, GetRoot(), GetFile(),
+                                    scene);
+    JsonUtils::ParseSceneLightChannels(GetRoot(), GetFile(), scene);
+  }
 }
 
 void BaseScene::OnStart() {
@@ -47,25 +52,27 @@ void BaseScene::OnDestroy() {
 std::weak_ptr<BaseMaterial> BaseScene::GetMaterialByPath(
     const std::string& path, aiMaterial* matData) {
   std::string name = path + ": " + matData->GetName().C_Str();
-  if (materials.contains(name) == false) {
-    materials[name] =
-        Create<BaseMaterial>(matData, name, false, GetRoot(), path);
+  const StringId id = StringIdUtils::Intern(name);
+  std::lock_guard lock(materialsMutex);
+  if (const auto iter = materials.find(id); iter != materials.end()) {
+    return iter->second;
   }
-  return materials[name];
+  return materials[id] =
+             Create<BaseMaterial>(matData, name, false, GetRoot(), path);
 }
-std::weak_ptr<BaseCamera> BaseScene::GetCameraByName(const std::string& name) {
-  if (cameras.contains(name)) {
-    return cameras[name];
+std::weak_ptr<BaseCamera> BaseScene::GetCameraByName(const StringId name) {
+  if (const auto iter = cameras.find(name); iter != cameras.end()) {
+    return iter->second;
   }
   return std::shared_ptr<BaseCamera>(nullptr);
 }
-const std::unordered_map<std::string, std::shared_ptr<BaseLight>>&
+const std::unordered_map<StringId, std::shared_ptr<BaseLight>>&
 BaseScene::GetLights() const {
   return lights;
 }
-std::weak_ptr<BaseLight> BaseScene::GetLightByName(const std::string& name) {
-  if (lights.contains(name)) {
-    return lights[name];
+std::weak_ptr<BaseLight> BaseScene::GetLightByName(const StringId name) {
+  if (const auto iter = lights.find(name); iter != lights.end()) {
+    return iter->second;
   }
   return std::shared_ptr<BaseLight>(nullptr);
 }
@@ -76,13 +83,14 @@ std::weak_ptr<BaseLight> BaseScene::GetLightById(int id) {
   return std::shared_ptr<BaseLight>(nullptr);
 }
 std::weak_ptr<LightChannel> BaseScene::GetLightChannelByName(
-    const std::string& name) {
-  if (lightChannels.contains(name)) {
-    return lightChannels[name];
+    const StringId name) {
+  if (const auto iter = lightChannels.find(name);
+      iter != lightChannels.end()) {
+    return iter->second;
   }
   return std::shared_ptr<LightChannel>(nullptr);
 }
-void BaseScene::RegisterCamera(const std::string& name,
+void BaseScene::RegisterCamera(const StringId name,
                                std::shared_ptr<BaseCamera> camera) {
   cameras[name] = camera;
 }
@@ -95,33 +103,46 @@ int BaseScene::GetAvailableLightId() {
   }
   PRINT_AND_THROW_ERROR("light id exceed max num!");
 }
-int BaseScene::RegisterLight(const std::string& name,
+int BaseScene::RegisterLight(const StringId name,
                              std::shared_ptr<BaseLight> light) {
   lights[name] = light;
   int id = GetAvailableLightId();
   lightsById[id] = lights[name];
   return id;
 }
-void BaseScene::RegisterLightChannel(const std::string& name,
+void BaseScene::RegisterLightChannel(const StringId name,
                                      std::shared_ptr<LightChannel> channel) {
   lightChannels[name] = channel;
 }
-void BaseScene::UnregisterMaterial(const std::string& name) {
+void BaseScene::UnregisterMaterial(const StringId name) {
+  std::lock_guard lock(materialsMutex);
   materials.erase(name);
 }
-void BaseScene::UnregisterCamera(const std::string& name) {
-  cameras.erase(name);
+bool BaseScene::ReloadMaterials(const std::string& filePath) {
+  const auto normalPath = std::filesystem::path(filePath).lexically_normal();
+  bool reloaded = false;
+  std::lock_guard lock(materialsMutex);
+  for (const std::shared_ptr<BaseMaterial>& material :
+       materials | std::views::values) {
+    if (std::filesystem::path(material->GetRoot() + material->GetFile())
+            .lexically_normal() == normalPath) {
+      material->ReloadParams();
+      reloaded = true;
+    }
+  }
+  return reloaded;
 }
-void BaseScene::UnregisterLight(const std::string& name) { lights.erase(name); }
-void BaseScene::UnregisterLightChannel(const std::string& name) {
+void BaseScene::UnregisterCamera(const StringId name) { cameras.erase(name); }
+void BaseScene::UnregisterLight(const StringId name) { lights.erase(name); }
+void BaseScene::UnregisterLightChannel(const StringId name) {
   lightChannels.erase(name);
 }
 
-void BaseScene::AddModelToResourceWaitQueue(std::function<void()> func,
-                                            std::shared_ptr<BaseObject> obj) {
+void BaseScene::AddModelLoadTask(
+    std::function<Coroutine::Task<void>(BaseResource&)> load) {
   if (auto ownerPtr = _owner.lock()) {
     if (auto appPtr = static_pointer_cast<Application>(ownerPtr)) {
-      appPtr->AddModelToResourceWaitQueue(func, obj);
+      appPtr->AddModelLoadTask(load);
     }
   }
 }
\ No newline at end of file
@@ -3,10 +3,14 @@
 #include <Engine/Editor/include/BaseEditor.h>
 #include <Engine/System/include/BaseObject.h>
 #include <Engine/System/include/BaseResource.h>
+#include <Engine/System/include/GraphicsConfig.h>
+#include <Engine/Utility/include/ConfigSnapshot.h>
 #include <Engine/Utility/include/JsonUtils.h>
+#include <Engine/Utility/include/StringIdUtils.h>
 
 #include <memory>
 #include <ranges>
+#include <thread>
 
 class BaseScene;
 class GraphicsInterface;
@@ -17,13 +21,16 @@ class Application final : public BaseObject {
   BaseResource modelResourceManager;
 
   std::list<std::shared_ptr<BaseObject>> passiveObjects;
-  std::list<std::shared_ptr<BaseObject>> activeObjects;
+  std::list<std::shared_ptr<BaseObject>> stoppingObjects;
+  EntityStorage activeObjects;
 
   std::shared_ptr<BaseScene> scene;
   std::shared_ptr<BaseEditor> editor;
   std::shared_ptr<GraphicsInterface> graphics;
+  std::thread renderThread;
 
   std::string scenePath = "Unset";
+  ConfigSnapshot<GraphicsConfig> graphicsConfig;
   bool graphicsSettingsModified = false;
   std::atomic<SceneState> sceneState = SceneState::Unset;
   void CreateGraphics();
@@ -45,12 +52,10 @@ class Application final : public BaseObject {
 
   virtual void OnCreate() override;
   virtual void OnStart() override;
-  virtual void OnUpdate() override;
   virtual void OnStop() override;
   virtual void OnDestroy() override;
 
-  std::weak_ptr<LightChannel> GetLightChannelByName(
-      const std::string& name) const;
+  std::weak_ptr<LightChannel> GetLightChannelByName(StringId name) const;
 
   void CreateEditor();
   void UpdateEditor();
@@ -70,12 +75,19 @@ class Application final : public BaseObject {
     return graphicsSettingsModified;
   }
   virtual void SetGraphicsSettingsModified(bool modified) {
+    if (modified) {
+      graphicsConfig.Reload();
+    }
     graphicsSettingsModified = modified;
   }
+  // Hold the returned pointer for as long as the config is read
+  std::shared_ptr<const GraphicsConfig> GetGraphicsConfig() const {
+    return graphicsConfig.Get();
+  }
   void SetScenePath(const std::string& path);
-  void AddModelToResourceWaitQueue(std::function<void()> func,
-                                   std::shared_ptr<BaseObject> obj) {
-    modelResourceManager.AddToWaitQueue(func, obj);
+  void AddModelLoadTask(
+      std::function<Coroutine::Task<void>(BaseResource&)> load) {
+    modelResourceManager.AddTask(load(modelResourceManager));
   }
   std::weak_ptr<SceneObject> GetSceneRootObject();
 
@@ -91,11 +103,28 @@ class Application final : public BaseObject {
 
   uint32_t GetRenderFrameCount() const;
   uint32_t GetGameFrameCount() const;
+  uint32_t GetOcclusionTestedCount() const;
+  uint32_t GetOcclusionCulledCount() const;
+  uint32_t GetDrawCallCount() const;
+  uint32_t GetBindCount() const;
+  uint32_t GetSkippedBindCount() const;
+  uint64_t GetGBufferMemorySize() const;
+  uint64_t GetTransientMemorySize() const;
+  uint64_t GetAliasedMemorySize() const;
+  uint32_t GetLightingTileCount() const;
+  uint32_t GetLightingFullscreenTileCount() const;
+  float GetLightingGpuTime() const;
+  bool GetSeparateComputeQueue() const;
+  bool GetTimelineSemaphoreSupport() const;
 
   int GetMSAASamples() const;
   bool GetEnableMipmap() const;
   bool GetEnableZPrePass() const;
   bool GetEnableShadowMap() const;
   bool GetEnableDeferred() const;
+  bool GetEnableCompactGBuffer() const;
+  bool GetEnableOcclusionCulling() const;
+  bool GetEnableTileClassification() const;
+  bool GetEnableAsyncCompute() const;
   bool GetEnableShaderDebug() const;
 };
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <Engine/System/include/EntityStorage.h>
+#include <Engine/System/include/ObjectPool.h>
 #include <Engine/Utility/include/JsonUtils.h>
 #include <Engine/Utility/include/TypeUtils.h>
 
@@ -12,11 +14,14 @@
 class Application;
 class BaseObject : public std::enable_shared_from_this<BaseObject> {
   friend class Application;
+  friend class EntityStorage;
 
  protected:
   static float GameDeltaTime;
   static float RenderDeltaTime;
   bool _alive, _active, _locked;
+  size_t _updateGroup = 0;
+  size_t _storageIndex = EntityStorage::NotStored;
   std::weak_ptr<BaseObject> _owner;
   std::weak_ptr<Application> _app;
 
@@ -53,6 +58,7 @@ class BaseObject : public std::enable_shared_from_this<BaseObject> {
     }
   }
   static void AddObjectToPassiveObjects(std::shared_ptr<BaseObject> inst);
+  void AddObjectToStoppingObjects();
 
  public:
   BaseObject() = delete;
@@ -62,7 +68,9 @@ class BaseObject : public std::enable_shared_from_this<BaseObject> {
       typename T, typename... Args,
       typename std::enable_if<std::is_base_of<BaseObject, T>{}, int>::type = 0>
   static std::shared_ptr<T> CreateImmediately(Args&&... args) {
-    std::shared_ptr<T> ret = std::make_shared<T>(std::forward<Args>(args)...);
+    std::shared_ptr<T> ret = std::allocate_shared<T>(
+        PoolAllocator<T>(), std::forward<Args>(args)...);
+    ret->_updateGroup = EntityStorage::GetUpdateGroup<T>();
     AddObjectToPassiveObjects(ret);
     ret->OnCreate();
     return ret;
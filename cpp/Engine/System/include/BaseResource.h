@@ -1,7 +1,12 @@
 #pragma once
 
-#include <atomic>
+#include <Engine/Utility/include/Coroutine.h>
+
+#include <algorithm>
+#include <condition_variable>
 #include <functional>
+#include <list>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <thread>
@@ -9,14 +14,26 @@
 class BaseObject;
 class GraphicsInterface;
 
+// Runs jobs on up to maxWorkers detached threads, which exit once the queue
+// is drained. Coroutines resume on these threads by awaiting
+// Coroutine::Schedule, and tasks handed to AddTask are kept alive until they
+// complete.
 class BaseResource {
   std::mutex updateWaitQueueMutex;
-  std::queue<std::pair<std::function<void()>, std::weak_ptr<BaseObject>>>
-      waitQueue;
+  std::condition_variable idleCondition;
+  std::queue<std::function<void()>> waitQueue;
+  std::list<Coroutine::Task<void>> tasks;
+  unsigned int activeWorkers = 0;
+  const unsigned int maxWorkers =
+      std::max(2u, std::thread::hardware_concurrency()) - 1;
   void ParseWaitQueue();
+  bool IsIdle();
 
  public:
-  std::atomic<bool> processFinished = true;
+  void Post(std::function<void()> func);
   void AddToWaitQueue(std::function<void()> func,
                       std::weak_ptr<BaseObject> obj);
+  void AddTask(Coroutine::Task<void>&& task);
+  // Blocks until every queued job has run and every task has completed
+  void WaitForIdle();
 };
\ No newline at end of file
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+class BaseObject;
+using UpdateFunc = void (*)(BaseObject*);
+
+// Active objects are grouped by their concrete type. Each group keeps a
+// devirtualized update entry and an array of pointers to its objects, so a
+// frame only visits the types that really override OnUpdate. The objects
+// themselves stay where they were allocated; their data is not contiguous.
+class EntityStorage {
+  struct UpdateGroup {
+    UpdateFunc update = nullptr;
+    std::vector<BaseObject*> objects;
+    std::vector<std::shared_ptr<BaseObject>> owners;
+  };
+  std::vector<UpdateGroup> updateGroups;
+  size_t objectCount = 0;
+
+  static size_t RegisterUpdateGroup(UpdateFunc update);
+  static UpdateFunc GetGroupUpdate(size_t group);
+
+ public:
+  static constexpr size_t NotStored = SIZE_MAX;
+
+  template <typename T>
+  static size_t GetUpdateGroup() {
+    static const size_t group = [] {
+      if constexpr (std::is_same_v<decltype(&T::OnUpdate),
+                                   void (BaseObject::*)()>) {
+        return RegisterUpdateGroup(nullptr);
+      } else {
+        return RegisterUpdateGroup([](BaseObject* object) {
+          static_cast<T*>(object)->T::OnUpdate();
+        });
+      }
+    }();
+    return group;
+  }
+
+  void AddObject(std::shared_ptr<BaseObject> object);
+  void RemoveObject(BaseObject* object);
+  void UpdateObjects();
+  void Clear();
+
+  size_t GetObjectCount() const { return objectCount; }
+};
\ No newline at end of file
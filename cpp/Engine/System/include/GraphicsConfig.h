@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Graphics settings parsed once from the graphics config file, read through
+// Application::GetGraphicsConfig instead of per-key JSON lookups.
+struct GraphicsConfig {
+  std::string renderHardwareInterface = "Unset";
+  int defaultWindowWidth = 0;
+  int defaultWindowHeight = 0;
+  std::string swapChainSurfaceImageFormat = "Unset";
+  std::string swapChainSurfaceColorSpace = "Unset";
+
+  int shadowMapWidth = 0;
+  int shadowMapHeight = 0;
+  std::string zPrePassShaderPath = "Unset";
+  std::string shadowMapShaderPath = "Unset";
+  std::string hiZShaderPath = "Unset";
+  std::string lightingTileShaderPath = "Unset";
+  float depthBiasConstantFactor = 0;
+  float depthBiasClamp = 0;
+  float depthBiasSlopeFactor = 0;
+
+  bool showRenderFrameCount = false;
+  bool showGameFrameCount = false;
+
+  int msaaMaxSamples = 0;
+  bool enableMipmap = false;
+  bool enableZPrePass = false;
+  bool enableShadowMap = false;
+  bool enableDeferred = false;
+  bool enableCompactGBuffer = false;
+  bool enableOcclusionCulling = false;
+  bool enableTileClassification = false;
+  bool enableAsyncCompute = false;
+  bool enableShaderDebug = false;
+
+  bool enableHotReload = false;
+  std::vector<std::string> hotReloadPaths;
+
+  bool enableParallelTransform = false;
+  bool enableFixedTimeStep = false;
+  bool enableTransformInterpolation = false;
+  float fixedTimeStep = 1.0f / 60;
+  int maxStepsPerFrame = 5;
+  float maxGameFrameRate = 0;
+
+  static GraphicsConfig Parse(const std::string& filePath);
+};
\ No newline at end of file
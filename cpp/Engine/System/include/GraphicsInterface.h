@@ -7,10 +7,10 @@
 #include <mutex>
 
 struct MeshData;
+struct MeshStaging;
 
 class GraphicsInterface : public BaseObject {
   std::atomic<bool> renderLoopEnd = false;
-  std::atomic<bool> gameLoopEnd = false;
   std::atomic<bool> renderLoopShouldEnd = false;
 
  protected:
@@ -19,13 +19,36 @@ class GraphicsInterface : public BaseObject {
   bool enableZPrePass = false;
   bool enableShadowMap = false;
   bool enableDeferred = false;
+  bool enableCompactGBuffer = false;
+  bool enableOcclusionCulling = false;
+  bool enableTileClassification = false;
+  bool enableAsyncCompute = false;
   bool enableShaderDebug = false;
 
   bool showRenderFrameCount = false;
   bool showGameFrameCount = false;
 
+  bool enableFixedTimeStep = true;
+  bool enableTransformInterpolation = true;
+  float fixedTimeStep = 1.0f / 60;
+  float maxGameFrameRate = 0;
+  int maxStepsPerFrame = 5;
+
   uint32_t renderFrameCount = 0;
   uint32_t gameFrameCount = 0;
+  uint32_t occlusionTestedCount = 0;
+  uint32_t occlusionCulledCount = 0;
+  uint32_t drawCallCount = 0;
+  uint32_t bindCount = 0;
+  uint32_t skippedBindCount = 0;
+  uint64_t gBufferMemorySize = 0;
+  uint64_t transientMemorySize = 0;
+  uint64_t aliasedMemorySize = 0;
+  uint32_t lightingTileCount = 0;
+  uint32_t lightingFullscreenTileCount = 0;
+  float lightingGpuTime = 0;
+  bool separateComputeQueue = false;
+  bool timelineSemaphoreSupport = false;
 
   int shadowMapWidth = -1;
   int shadowMapHeight = -1;
@@ -49,6 +72,10 @@ class GraphicsInterface : public BaseObject {
 
   virtual void ParseMeshData() = 0;
   virtual void ParseMeshData(std::weak_ptr<MeshData> meshData) = 0;
+  // Callable from any thread. Returns nullptr when there is no staging memory
+  // to hand out, the loader then keeps the mesh in MeshData's vectors.
+  virtual std::unique_ptr<MeshStaging> AllocateMeshStaging(
+      uint32_t vertexFormat, size_t vertexCount, size_t indexCount) = 0;
 
   virtual GLFWwindow* GetWindow() const = 0;
   virtual float GetViewportAspect() = 0;
@@ -57,9 +84,7 @@ class GraphicsInterface : public BaseObject {
   virtual int GetWindowHeight() = 0;
 
   virtual bool GetRenderLoopEnd() { return renderLoopEnd; }
-  virtual bool GetGameLoopEnd() { return gameLoopEnd; }
   virtual void SetRenderLoopEnd(bool inEnd) { renderLoopEnd = inEnd; }
-  virtual void SetGameLoopEnd(bool inEnd) { gameLoopEnd = inEnd; }
 
   virtual bool GetRenderLoopShouldEnd() { return renderLoopShouldEnd; }
   virtual void SetRenderLoopShouldEnd(bool inEnd) {
@@ -71,6 +96,14 @@ class GraphicsInterface : public BaseObject {
   virtual bool GetEnableZPrePass() const { return enableZPrePass; }
   virtual bool GetEnableShadowMap() const { return enableShadowMap; }
   virtual bool GetEnableDeferred() const { return enableDeferred; }
+  virtual bool GetEnableCompactGBuffer() const { return enableCompactGBuffer; }
+  virtual bool GetEnableOcclusionCulling() const {
+    return enableOcclusionCulling;
+  }
+  virtual bool GetEnableTileClassification() const {
+    return enableTileClassification;
+  }
+  virtual bool GetEnableAsyncCompute() const { return enableAsyncCompute; }
   virtual bool GetEnableShaderDebug() const { return enableShaderDebug; }
 
   virtual float GetDepthBiasClamp() const { return depthBiasClamp; }
@@ -84,4 +117,39 @@ class GraphicsInterface : public BaseObject {
 
   virtual uint32_t GetRenderFrameCount() const { return renderFrameCount; }
   virtual uint32_t GetGameFrameCount() const { return gameFrameCount; }
+  // Meshes the last frame tested against the depth pyramid and skipped
+  virtual uint32_t GetOcclusionTestedCount() const {
+    return occlusionTestedCount;
+  }
+  virtual uint32_t GetOcclusionCulledCount() const {
+    return occlusionCulledCount;
+  }
+  // Binds the last frame asked for and those left out since already bound
+  virtual uint32_t GetDrawCallCount() const { return drawCallCount; }
+  virtual uint32_t GetBindCount() const { return bindCount; }
+  virtual uint32_t GetSkippedBindCount() const { return skippedBindCount; }
+  // Bytes allocated for the deferred G-buffer targets
+  virtual uint64_t GetGBufferMemorySize() const { return gBufferMemorySize; }
+  // Bytes allocated for the render graph's transient images, and those saved
+  // by aliasing them
+  virtual uint64_t GetTransientMemorySize() const {
+    return transientMemorySize;
+  }
+  virtual uint64_t GetAliasedMemorySize() const { return aliasedMemorySize; }
+  // Tiles the deferred lighting draws shaded, and those one fullscreen pass
+  // per draw would have
+  virtual uint32_t GetLightingTileCount() const { return lightingTileCount; }
+  virtual uint32_t GetLightingFullscreenTileCount() const {
+    return lightingFullscreenTileCount;
+  }
+  // Milliseconds of GPU time the lighting took, tile classification included
+  virtual float GetLightingGpuTime() const { return lightingGpuTime; }
+  // Whether async compute found a queue family of its own, or shares the
+  // graphics queue
+  virtual bool GetSeparateComputeQueue() const { return separateComputeQueue; }
+  // Async compute needs them, the compute passes stay on the graphics command
+  // buffers without
+  virtual bool GetTimelineSemaphoreSupport() const {
+    return timelineSemaphoreSupport;
+  }
 };
\ No newline at end of file
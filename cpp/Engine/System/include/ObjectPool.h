@@ -0,0 +1,122 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+struct PoolStats {
+  std::string name;
+  size_t blockSize = 0;
+  size_t capacity = 0;
+  size_t inUse = 0;
+  size_t highWater = 0;
+  size_t slabCount = 0;
+};
+
+// Slab pool of equally sized blocks. Each thread keeps a small free list, so
+// the shared list and its mutex are only touched to refill or flush a batch.
+class ObjectPool {
+  static constexpr size_t SlabBytes = 64 * 1024;
+  static constexpr size_t MinBlocksPerSlab = 16;
+  static constexpr size_t CacheBatch = 32;
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+ public:
+  struct ThreadCache {
+    ObjectPool* pool = nullptr;
+    FreeBlock* head = nullptr;
+    size_t count = 0;
+    ~ThreadCache();
+  };
+
+ private:
+  const std::string name;
+  const size_t blockAlign;
+  const size_t blockSize;
+
+  std::mutex poolMutex;
+  FreeBlock* freeList = nullptr;
+  std::vector<void*> slabs;
+  std::atomic<size_t> capacity = 0;
+  std::atomic<size_t> inUse = 0;
+  std::atomic<size_t> highWater = 0;
+
+  void AllocateSlab();
+  void Refill(ThreadCache& cache);
+  void Flush(ThreadCache& cache, size_t keep);
+
+ public:
+  ObjectPool(std::string name, size_t size, size_t align);
+  ObjectPool(const ObjectPool&) = delete;
+  ObjectPool& operator=(const ObjectPool&) = delete;
+
+  void* Allocate(ThreadCache& cache);
+  void Deallocate(ThreadCache& cache, void* ptr);
+  PoolStats GetStats();
+
+  // Pools are never destroyed, detached threads may still return blocks
+  // while the process is shutting down.
+  template <typename Tag, typename T>
+  static ObjectPool& Get() {
+    static ObjectPool* pool =
+        new ObjectPool(typeid(Tag).name(), sizeof(T), alignof(T));
+    return *pool;
+  }
+  // Keyed like Get, a cache only ever holds blocks of the pool it belongs to
+  // even when one tag is rebound to several types.
+  template <typename Tag, typename T>
+  static ThreadCache& GetThreadCache() {
+    thread_local ThreadCache cache;
+    return cache;
+  }
+};
+
+template <typename T, typename Tag = T>
+class PoolAllocator {
+ public:
+  using value_type = T;
+
+  PoolAllocator() noexcept = default;
+  template <typename U>
+  PoolAllocator(const PoolAllocator<U, Tag>&) noexcept {}
+
+  template <typename U>
+  struct rebind {
+    using other = PoolAllocator<U, Tag>;
+  };
+
+  T* allocate(size_t n) {
+    if (n != 1) {
+      return static_cast<T*>(::operator new(
+          n * sizeof(T), std::align_val_t(alignof(T))));
+    }
+    ObjectPool& pool = ObjectPool::Get<Tag, T>();
+    return static_cast<T*>(
+        pool.Allocate(ObjectPool::GetThreadCache<Tag, T>()));
+  }
+  void deallocate(T* ptr, size_t n) {
+    if (n != 1) {
+      ::operator delete(ptr, std::align_val_t(alignof(T)));
+      return;
+    }
+    ObjectPool& pool = ObjectPool::Get<Tag, T>();
+    pool.Deallocate(ObjectPool::GetThreadCache<Tag, T>(), ptr);
+  }
+
+  template <typename U>
+  bool operator==(const PoolAllocator<U, Tag>&) const noexcept {
+    return true;
+  }
+};
+
+namespace ObjectPoolUtils {
+std::vector<PoolStats> GetPoolStats();
+void PrintPoolStats();
+}  // namespace ObjectPoolUtils
\ No newline at end of file
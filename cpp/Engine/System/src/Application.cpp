@@ -14,8 +14,8 @@
 
 void Application::CreateGraphics() {
   const std::string apiPath = JSON_CONFIG(String, "GraphicsConfig");
-  if (const std::string rhiType = JsonUtils::ReadStringFromFile(
-          GetRoot() + apiPath, "RenderHardwareInterface");
+  if (const std::string rhiType =
+          graphicsConfig.Get()->renderHardwareInterface;
       rhiType == "Vulkan") {
     graphics = Create<Vulkan>(GetRoot(), apiPath);
   } else if (rhiType == "DirectX") {
@@ -46,7 +46,11 @@ void Application::LaunchScene() {
     graphicsSettingsModified = false;
     sceneState = SceneState::Launching;
     if (GetEnableEditor()) {
-      std::thread(&Application::StartRenderLoop, this).detach();
+      // The previous render thread has finished once the scene terminated
+      if (renderThread.joinable()) {
+        renderThread.join();
+      }
+      renderThread = std::thread(&Application::StartRenderLoop, this);
     } else {
       StartRenderLoop();
     }
@@ -54,6 +58,7 @@ void Application::LaunchScene() {
 }
 
 void Application::StartRenderLoop() {
+  graphicsConfig.Reload();
   CreateGraphics();
   CreateWindow();
   CreateLauncherScene();
@@ -61,14 +66,14 @@ void Application::StartRenderLoop() {
   graphics->RenderLoop();
   sceneState = SceneState::Terminating;
 
-  while (modelResourceManager.processFinished == false) {
-  }
+  modelResourceManager.WaitForIdle();
   scene->Destroy();
   graphics->CleanupGraphics();
   graphics->Destroy();
 
   passiveObjects.clear();
-  activeObjects.clear();
+  stoppingObjects.clear();
+  activeObjects.Clear();
 
   graphics.reset();
   scene.reset();
@@ -89,14 +94,15 @@ void Application::RunApplication() {
   const std::string configPath = JSON_CONFIG(String, "ApplicationConfig");
   EnableEditor =
       JsonUtils::ReadBoolFromFile(GetRoot() + configPath, "EnableEditor");
+  graphicsConfig.Load(GetRoot() + JSON_CONFIG(String, "GraphicsConfig"));
 
   sceneState = SceneState::Terminated;
   if (GetEnableEditor()) {
     CreateEditor();
     editor->LoopImgui();
     TerminateScene();
-    while (sceneState != SceneState::Unset &&
-           sceneState != SceneState::Terminated) {
+    if (renderThread.joinable()) {
+      renderThread.join();
     }
     DestroyEditor();
   } else {
@@ -105,12 +111,22 @@ void Application::RunApplication() {
 }
 
 void Application::TriggerOnUpdate() {
+  for (std::shared_ptr<BaseObject> obj : stoppingObjects) {
+    if (obj->_storageIndex != EntityStorage::NotStored &&
+        (obj->_alive == false || obj->_active == false)) {
+      activeObjects.RemoveObject(obj.get());
+      obj->OnStop();
+      passiveObjects.emplace_back(obj);
+    }
+  }
+  stoppingObjects.clear();
+
   for (std::shared_ptr<BaseObject> obj : passiveObjects) {
     if (obj->_alive == false) {
       obj->OnDestroy();
     } else if (obj->_active) {
       obj->OnStart();
-      activeObjects.emplace_back(obj);
+      activeObjects.AddObject(obj);
     } else {
       obj->OnDeactive();
       obj->_locked = false;
@@ -118,17 +134,7 @@ void Application::TriggerOnUpdate() {
   }
   passiveObjects.clear();
 
-  auto iter = activeObjects.begin();
-  while (iter != activeObjects.end()) {
-    if ((*iter)->_alive && (*iter)->_active) {
-      (*iter)->OnUpdate();
-      iter++;
-    } else {
-      (*iter)->OnStop();
-      passiveObjects.emplace_back(*iter);
-      iter = activeObjects.erase(iter);
-    }
-  }
+  activeObjects.UpdateObjects();
 }
 
 std::weak_ptr<SceneObject> Application::GetSceneRootObject() {
@@ -140,7 +146,6 @@ std::weak_ptr<SceneObject> Application::GetSceneRootObject() {
 
 void Application::OnCreate() { BaseObject::OnCreate(); }
 void Application::OnStart() { BaseObject::OnStart(); }
-void Application::OnUpdate() { BaseObject::OnUpdate(); }
 void Application::OnStop() { BaseObject::OnStop(); }
 void Application::OnDestroy() {
   JsonUtils::ClearDocumentCache();
@@ -152,7 +157,7 @@ Application::GetLightsById() {
   return scene->GetLightsById();
 }
 std::weak_ptr<LightChannel> Application::GetLightChannelByName(
-    const std::string& name) const {
+    const StringId name) const {
   return scene->GetLightChannelByName(name);
 }
 
@@ -185,52 +190,101 @@ uint32_t Application::GetRenderFrameCount() const {
 uint32_t Application::GetGameFrameCount() const {
   return graphics->GetGameFrameCount();
 }
+uint32_t Application::GetOcclusionTestedCount() const {
+  return graphics->GetOcclusionTestedCount();
+}
+uint32_t Application::GetOcclusionCulledCount() const {
+  return graphics->GetOcclusionCulledCount();
+}
+uint32_t Application::GetDrawCallCount() const {
+  return graphics->GetDrawCallCount();
+}
+uint32_t Application::GetBindCount() const { return graphics->GetBindCount(); }
+uint32_t Application::GetSkippedBindCount() const {
+  return graphics->GetSkippedBindCount();
+}
+uint64_t Application::GetGBufferMemorySize() const {
+  return graphics->GetGBufferMemorySize();
+}
+uint64_t Application::GetTransientMemorySize() const {
+  return graphics->GetTransientMemorySize();
+}
+uint64_t Application::GetAliasedMemorySize() const {
+  return graphics->GetAliasedMemorySize();
+}
+uint32_t Application::GetLightingTileCount() const {
+  return graphics->GetLightingTileCount();
+}
+uint32_t Application::GetLightingFullscreenTileCount() const {
+  return graphics->GetLightingFullscreenTileCount();
+}
+float Application::GetLightingGpuTime() const {
+  return graphics->GetLightingGpuTime();
+}
+bool Application::GetSeparateComputeQueue() const {
+  return graphics->GetSeparateComputeQueue();
+}
+bool Application::GetTimelineSemaphoreSupport() const {
+  return graphics->GetTimelineSemaphoreSupport();
+}
 
 int Application::GetMSAASamples() const {
   if (graphics) {
     return graphics->GetMSAASamples();
   }
-  std::string graphicsConfigPath = JSON_CONFIG(String, "GraphicsConfig");
-  return JsonUtils::ReadIntFromFile(GetRoot() + graphicsConfigPath,
-                                    "MSAAMaxSamples");
+  return graphicsConfig.Get()->msaaMaxSamples;
 }
 bool Application::GetEnableMipmap() const {
   if (graphics) {
     return graphics->GetEnableMipmap();
   }
-  std::string graphicsConfigPath = JSON_CONFIG(String, "GraphicsConfig");
-  return JsonUtils::ReadBoolFromFile(GetRoot() + graphicsConfigPath,
-                                     "EnableMipmap");
+  return graphicsConfig.Get()->enableMipmap;
 }
 bool Application::GetEnableZPrePass() const {
   if (graphics) {
     return graphics->GetEnableZPrePass();
   }
-  std::string graphicsConfigPath = JSON_CONFIG(String, "GraphicsConfig");
-  return JsonUtils::ReadBoolFromFile(GetRoot() + graphicsConfigPath,
-                                     "EnableZPrePass");
+  return graphicsConfig.Get()->enableZPrePass;
 }
 bool Application::GetEnableShadowMap() const {
   if (graphics) {
     return graphics->GetEnableShadowMap();
   }
-  std::string graphicsConfigPath = JSON_CONFIG(String, "GraphicsConfig");
-  return JsonUtils::ReadBoolFromFile(GetRoot() + graphicsConfigPath,
-                                     "EnableShadowMap");
+  return graphicsConfig.Get()->enableShadowMap;
 }
 bool Application::GetEnableDeferred() const {
   if (graphics) {
     return graphics->GetEnableDeferred();
   }
-  std::string graphicsConfigPath = JSON_CONFIG(String, "GraphicsConfig");
-  return JsonUtils::ReadBoolFromFile(GetRoot() + graphicsConfigPath,
-                                     "EnableDeferred");
+  return graphicsConfig.Get()->enableDeferred;
+}
+bool Application::GetEnableCompactGBuffer() const {
+  if (graphics) {
+    return graphics->GetEnableCompactGBuffer();
+  }
+  return graphicsConfig.Get()->enableCompactGBuffer;
+}
+bool Application::GetEnableOcclusionCulling() const {
+  if (graphics) {
+    return graphics->GetEnableOcclusionCulling();
+  }
+  return graphicsConfig.Get()->enableOcclusionCulling;
+}
+bool Application::GetEnableTileClassification() const {
+  if (graphics) {
+    return graphics->GetEnableTileClassification();
+  }
+  return graphicsConfig.Get()->enableTileClassification;
+}
+bool Application::GetEnableAsyncCompute() const {
+  if (graphics) {
+    return graphics->GetEnableAsyncCompute();
+  }
+  return graphicsConfig.Get()->enableAsyncCompute;
 }
 bool Application::GetEnableShaderDebug() const {
   if (graphics) {
     return graphics->GetEnableShaderDebug();
   }
-  std::string graphicsConfigPath = JSON_CONFIG(String, "GraphicsConfig");
-  return JsonUtils::ReadBoolFromFile(GetRoot() + graphicsConfigPath,
-                                     "EnableShaderDebug");
+  return graphicsConfig.Get()->enableShaderDebug;
 }
\ No newline at end of file
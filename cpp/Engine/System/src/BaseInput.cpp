@@ -1,2 +1,104 @@
 #include <Engine/System/include/BaseInput.h>
+#include <Engine/Utility/include/MPSCQueue.h>
 
+namespace {
+MPSCQueue<Input::Event> eventQueue(Input::MaxPendingEvents);
+Input::State states[2];
+std::atomic<int> frontIndex = 0;
+
+void PushEvent(Input::Event event) {
+  // Never stall the window thread on a slow game tick, drop the event instead
+  eventQueue.TryPush(event);
+}
+
+template <size_t N>
+void ApplyButton(const int code, const int action, std::bitset<N>& held,
+                 std::bitset<N>& down, std::bitset<N>& up) {
+  if (code < 0 || code >= static_cast<int>(N)) {
+    return;
+  }
+  if (action == GLFW_PRESS) {
+    held.set(code);
+    down.set(code);
+  }
+  if (action == GLFW_RELEASE) {
+    held.reset(code);
+    up.set(code);
+  }
+}
+
+void ApplyEvent(const Input::Event& event, Input::State& state) {
+  switch (event.type) {
+    case Input::EventType::Key:
+      ApplyButton(event.code, event.action, state.keys, state.keysDown,
+                  state.keysUp);
+      break;
+    case Input::EventType::MouseButton:
+      ApplyButton(event.code, event.action, state.buttons, state.buttonsDown,
+                  state.buttonsUp);
+      break;
+    case Input::EventType::MousePosition:
+      state.posX = event.x;
+      state.posY = event.y;
+      break;
+    case Input::EventType::Scroll:
+      state.scrollX += event.x;
+      state.scrollY += event.y;
+      break;
+  }
+  state.events.push_back(event);
+}
+}  // namespace
+
+void Input::Snapshot() {
+  const int front = frontIndex.load(std::memory_order_relaxed);
+  const State& prev = states[front];
+  State& next = states[1 - front];
+
+  // Held buttons and the cursor carry over, edges and scroll last one tick
+  next.keys = prev.keys;
+  next.buttons = prev.buttons;
+  next.posX = prev.posX;
+  next.posY = prev.posY;
+  next.keysDown.reset();
+  next.keysUp.reset();
+  next.buttonsDown.reset();
+  next.buttonsUp.reset();
+  next.scrollX = next.scrollY = 0;
+  next.events.clear();
+
+  Event event;
+  while (eventQueue.TryPop(event)) {
+    ApplyEvent(event, next);
+  }
+  frontIndex.store(1 - front, std::memory_order_release);
+}
+
+const Input::State& Input::GetState() {
+  return states[frontIndex.load(std::memory_order_acquire)];
+}
+
+void Input::Mouse::ScrollCallback([[maybe_unused]] GLFWwindow* window,
+                                  const double x, const double y) {
+  PushEvent({.type = EventType::Scroll, .x = x, .y = y});
+}
+
+void Input::Mouse::PositionCallback([[maybe_unused]] GLFWwindow* window,
+                                    const double x, const double y) {
+  PushEvent({.type = EventType::MousePosition, .x = x, .y = y});
+}
+
+void Input::Mouse::ButtonCallback([[maybe_unused]] GLFWwindow* window,
+                                  const int button, const int option,
+                                  [[maybe_unused]] const int mods) {
+  PushEvent(
+      {.type = EventType::MouseButton, .code = button, .action = option});
+}
+
+void Input::Key::ButtonCallback([[maybe_unused]] GLFWwindow* window,
+                                const int button,
+                                [[maybe_unused]] const int scancode,
+                                const int option,
+                                [[maybe_unused]] const int mods) {
+  PushEvent({.type = EventType::Key, .code = button, .action = option});
+}
\ No newline at end of file
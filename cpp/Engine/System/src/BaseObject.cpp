@@ -30,7 +30,7 @@ void BaseObject::Active() {
     OnActive();
     if (_locked == false) {
       if (auto appPtr = _app.lock()) {
-        appPtr->passiveObjects.emplace_back(this);
+        appPtr->passiveObjects.emplace_back(shared_from_this());
       }
     }
   }
@@ -40,6 +40,7 @@ void BaseObject::Deactive() {
   if (_alive == true && _active == true) {
     _active = false;
     _locked = true;
+    AddObjectToStoppingObjects();
   }
 }
 
@@ -49,4 +50,13 @@ void BaseObject::Destroy() {
   }
   _alive = false;
   _active = false;
+  AddObjectToStoppingObjects();
+}
+
+void BaseObject::AddObjectToStoppingObjects() {
+  if (_storageIndex != EntityStorage::NotStored) {
+    if (auto appPtr = _app.lock()) {
+      appPtr->stoppingObjects.emplace_back(shared_from_this());
+    }
+  }
 }
@@ -1,27 +1,57 @@
 #include <Engine/System/include/BaseResource.h>
 #include <Engine/System/include/GraphicsInterface.h>
+#include <Engine/Utility/include/TypeUtils.h>
 
 void BaseResource::ParseWaitQueue() {
+  std::unique_lock lock(updateWaitQueueMutex);
   while (waitQueue.empty() == false) {
-    if (updateWaitQueueMutex.try_lock()) {
-      if (waitQueue.front().second.lock()) {
-        waitQueue.front().first();
-      }
-      waitQueue.pop();
-      updateWaitQueueMutex.unlock();
-    }
+    auto func = std::move(waitQueue.front());
+    waitQueue.pop();
+    lock.unlock();
+    func();
+    lock.lock();
+  }
+  if (--activeWorkers == 0) {
+    idleCondition.notify_all();
   }
-  processFinished = true;
 }
 
-void BaseResource::AddToWaitQueue(std::function<void()> func,
-                                  std::weak_ptr<BaseObject> obj) {
-  processFinished = false;
-  updateWaitQueueMutex.lock();
-  bool requireThread = waitQueue.empty();
-  waitQueue.push(make_pair(func, obj));
-  updateWaitQueueMutex.unlock();
-  if (requireThread) {
+bool BaseResource::IsIdle() {
+  // Completed tasks are suspended at their final point and safe to destroy
+  tasks.remove_if([](Coroutine::Task<void>& task) { return task.done(); });
+  return activeWorkers == 0 && waitQueue.empty() && tasks.empty();
+}
+
+void BaseResource::Post(std::function<void()> func) {
+  std::lock_guard lock(updateWaitQueueMutex);
+  waitQueue.push(std::move(func));
+  if (activeWorkers < maxWorkers) {
+    ++activeWorkers;
     std::thread(&BaseResource::ParseWaitQueue, this).detach();
   }
+}
+
+void BaseResource::AddToWaitQueue(std::function<void()> func,
+                                  std::weak_ptr<BaseObject> obj) {
+  Post([func = std::move(func), obj = std::move(obj)] {
+    // Keep the object alive while its job runs
+    if (auto objPtr = obj.lock()) {
+      func();
+    }
+  });
+}
+
+void BaseResource::AddTask(Coroutine::Task<void>&& task) {
+  task.catching([](std::exception& e) { PRINT_ERROR(e.what()); });
+  task.finally([this] {
+    std::lock_guard lock(updateWaitQueueMutex);
+    idleCondition.notify_all();
+  });
+  std::lock_guard lock(updateWaitQueueMutex);
+  tasks.emplace_back(std::move(task));
+}
+
+void BaseResource::WaitForIdle() {
+  std::unique_lock lock(updateWaitQueueMutex);
+  idleCondition.wait(lock, [this] { return IsIdle(); });
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "../include/EntityStorage.h"
+
+#include <Engine/System/include/BaseObject.h>
+
+#include <mutex>
+
+namespace {
+std::mutex groupMutex;
+std::vector<UpdateFunc> groupUpdates;
+}  // namespace
+
+size_t EntityStorage::RegisterUpdateGroup(UpdateFunc update) {
+  std::lock_guard lock(groupMutex);
+  groupUpdates.emplace_back(update);
+  return groupUpdates.size() - 1;
+}
+
+UpdateFunc EntityStorage::GetGroupUpdate(size_t group) {
+  std::lock_guard lock(groupMutex);
+  return groupUpdates[group];
+}
+
+void EntityStorage::AddObject(std::shared_ptr<BaseObject> object) {
+  if (object->_storageIndex != NotStored) {
+    return;
+  }
+  if (updateGroups.size() <= object->_updateGroup) {
+    const size_t begin = updateGroups.size();
+    updateGroups.resize(object->_updateGroup + 1);
+    for (size_t i = begin; i < updateGroups.size(); i++) {
+      updateGroups[i].update = GetGroupUpdate(i);
+    }
+  }
+  UpdateGroup& group = updateGroups[object->_updateGroup];
+  object->_storageIndex = group.objects.size();
+  group.objects.emplace_back(object.get());
+  group.owners.emplace_back(std::move(object));
+  objectCount += 1;
+}
+
+void EntityStorage::RemoveObject(BaseObject* object) {
+  if (object->_storageIndex == NotStored) {
+    return;
+  }
+  UpdateGroup& group = updateGroups[object->_updateGroup];
+  const size_t index = object->_storageIndex;
+
+  group.objects[index] = group.objects.back();
+  group.objects[index]->_storageIndex = index;
+  group.objects.pop_back();
+  object->_storageIndex = NotStored;
+
+  std::shared_ptr<BaseObject> owner = std::move(group.owners[index]);
+  group.owners[index] = std::move(group.owners.back());
+  group.owners.pop_back();
+  objectCount -= 1;
+}
+
+void EntityStorage::UpdateObjects() {
+  for (const UpdateGroup& group : updateGroups) {
+    if (group.update == nullptr) {
+      continue;
+    }
+    for (size_t i = 0; i < group.objects.size(); i++) {
+      group.update(group.objects[i]);
+    }
+  }
+}
+
+void EntityStorage::Clear() {
+  for (UpdateGroup& group : updateGroups) {
+    for (BaseObject* object : group.objects) {
+      object->_storageIndex = NotStored;
+    }
+    group.objects.clear();
+    group.owners.clear();
+  }
+  objectCount = 0;
+}
\ No newline at end of file
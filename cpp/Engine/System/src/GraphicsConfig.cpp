@@ -0,0 +1,67 @@
+#include "../include/GraphicsConfig.h"
+
+#include <Engine/Utility/include/JsonUtils.h>
+
+#define READ_GRAPHICS_CONFIG(type, member, key) \
+  config.member = JsonUtils::Read##type##FromFile(filePath, key)
+
+GraphicsConfig GraphicsConfig::Parse(const std::string& filePath) {
+  GraphicsConfig config;
+
+  READ_GRAPHICS_CONFIG(String, renderHardwareInterface,
+                       "RenderHardwareInterface");
+  READ_GRAPHICS_CONFIG(Int, defaultWindowWidth, "DefaultWindowWidth");
+  READ_GRAPHICS_CONFIG(Int, defaultWindowHeight, "DefaultWindowHeight");
+  READ_GRAPHICS_CONFIG(String, swapChainSurfaceImageFormat,
+                       "SwapChainSurfaceImageFormat");
+  READ_GRAPHICS_CONFIG(String, swapChainSurfaceColorSpace,
+                       "SwapChainSurfaceColorSpace");
+
+  READ_GRAPHICS_CONFIG(Int, shadowMapWidth, "ShadowMapWidth");
+  READ_GRAPHICS_CONFIG(Int, shadowMapHeight, "ShadowMapHeight");
+  READ_GRAPHICS_CONFIG(String, zPrePassShaderPath, "ZPrePassShaderPath");
+  READ_GRAPHICS_CONFIG(String, shadowMapShaderPath, "ShadowMapShaderPath");
+  READ_GRAPHICS_CONFIG(String, hiZShaderPath, "HiZShaderPath");
+  READ_GRAPHICS_CONFIG(String, lightingTileShaderPath,
+                       "LightingTileShaderPath");
+  READ_GRAPHICS_CONFIG(Float, depthBiasConstantFactor,
+                       "DepthBiasConstantFactor");
+  READ_GRAPHICS_CONFIG(Float, depthBiasClamp, "DepthBiasClamp");
+  READ_GRAPHICS_CONFIG(Float, depthBiasSlopeFactor, "DepthBiasSlopeFactor");
+
+  READ_GRAPHICS_CONFIG(Bool, showRenderFrameCount, "ShowRenderFrameCount");
+  READ_GRAPHICS_CONFIG(Bool, showGameFrameCount, "ShowGameFrameCount");
+
+  READ_GRAPHICS_CONFIG(Int, msaaMaxSamples, "MSAAMaxSamples");
+  READ_GRAPHICS_CONFIG(Bool, enableMipmap, "EnableMipmap");
+  READ_GRAPHICS_CONFIG(Bool, enableZPrePass, "EnableZPrePass");
+  READ_GRAPHICS_CONFIG(Bool, enableShadowMap, "EnableShadowMap");
+  READ_GRAPHICS_CONFIG(Bool, enableDeferred, "EnableDeferred");
+  READ_GRAPHICS_CONFIG(Bool, enableCompactGBuffer, "EnableCompactGBuffer");
+  READ_GRAPHICS_CONFIG(Bool, enableOcclusionCulling,
+                       "EnableOcclusionCulling");
+  READ_GRAPHICS_CONFIG(Bool, enableTileClassification,
+                       "EnableTileClassification");
+  READ_GRAPHICS_CONFIG(Bool, enableAsyncCompute, "EnableAsyncCompute");
+  READ_GRAPHICS_CONFIG(Bool, enableShaderDebug, "EnableShaderDebug");
+
+  READ_GRAPHICS_CONFIG(Bool, enableHotReload, "EnableHotReload");
+  READ_GRAPHICS_CONFIG(Strings, hotReloadPaths, "HotReloadPaths");
+
+  READ_GRAPHICS_CONFIG(Bool, enableParallelTransform,
+                       "EnableParallelTransform");
+  READ_GRAPHICS_CONFIG(Bool, enableFixedTimeStep, "EnableFixedTimeStep");
+  READ_GRAPHICS_CONFIG(Bool, enableTransformInterpolation,
+                       "EnableTransformInterpolation");
+  if (float timeStep = JsonUtils::ReadFloatFromFile(filePath, "FixedTimeStep");
+      timeStep > 0) {
+    config.fixedTimeStep = timeStep;
+  }
+  if (int maxSteps = JsonUtils::ReadIntFromFile(filePath, "MaxStepsPerFrame");
+      maxSteps > 0) {
+    config.maxStepsPerFrame = maxSteps;
+  }
+  READ_GRAPHICS_CONFIG(Float, maxGameFrameRate, "MaxGameFrameRate");
+
+  return config;
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "../include/ObjectPool.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+namespace {
+std::mutex registryMutex;
+std::vector<ObjectPool*>& GetPools() {
+  static std::vector<ObjectPool*>* pools = new std::vector<ObjectPool*>();
+  return *pools;
+}
+}  // namespace
+
+ObjectPool::ThreadCache::~ThreadCache() {
+  if (pool) {
+    pool->Flush(*this, 0);
+  }
+}
+
+ObjectPool::ObjectPool(std::string name, size_t size, size_t align)
+    : name(std::move(name)),
+      blockAlign(std::max(align, alignof(FreeBlock))),
+      blockSize((std::max(size, sizeof(FreeBlock)) + blockAlign - 1) /
+                blockAlign * blockAlign) {
+  std::lock_guard lock(registryMutex);
+  GetPools().emplace_back(this);
+}
+
+void ObjectPool::AllocateSlab() {
+  const size_t blocksPerSlab =
+      std::max(MinBlocksPerSlab, SlabBytes / blockSize);
+  char* slab = static_cast<char*>(::operator new(
+      blocksPerSlab * blockSize, std::align_val_t(blockAlign)));
+  slabs.emplace_back(slab);
+
+  for (size_t i = blocksPerSlab; i > 0; i--) {
+    auto block = reinterpret_cast<FreeBlock*>(slab + (i - 1) * blockSize);
+    block->next = freeList;
+    freeList = block;
+  }
+  capacity += blocksPerSlab;
+}
+
+void ObjectPool::Refill(ThreadCache& cache) {
+  std::lock_guard lock(poolMutex);
+  for (size_t i = 0; i < CacheBatch; i++) {
+    if (freeList == nullptr) {
+      AllocateSlab();
+    }
+    FreeBlock* block = freeList;
+    freeList = block->next;
+    block->next = cache.head;
+    cache.head = block;
+    cache.count += 1;
+  }
+}
+
+void ObjectPool::Flush(ThreadCache& cache, size_t keep) {
+  std::lock_guard lock(poolMutex);
+  while (cache.count > keep) {
+    FreeBlock* block = cache.head;
+    cache.head = block->next;
+    block->next = freeList;
+    freeList = block;
+    cache.count -= 1;
+  }
+}
+
+void* ObjectPool::Allocate(ThreadCache& cache) {
+  cache.pool = this;
+  if (cache.head == nullptr) {
+    Refill(cache);
+  }
+  FreeBlock* block = cache.head;
+  cache.head = block->next;
+  cache.count -= 1;
+
+  const size_t used = ++inUse;
+  size_t peak = highWater.load(std::memory_order_relaxed);
+  while (used > peak && !highWater.compare_exchange_weak(peak, used)) {
+  }
+  return block;
+}
+
+void ObjectPool::Deallocate(ThreadCache& cache, void* ptr) {
+  cache.pool = this;
+  auto block = static_cast<FreeBlock*>(ptr);
+  block->next = cache.head;
+  cache.head = block;
+  cache.count += 1;
+  --inUse;
+
+  if (cache.count >= CacheBatch * 2) {
+    Flush(cache, CacheBatch);
+  }
+}
+
+PoolStats ObjectPool::GetStats() {
+  std::lock_guard lock(poolMutex);
+  return {
+      .name = name,
+      .blockSize = blockSize,
+      .capacity = capacity,
+      .inUse = inUse,
+      .highWater = highWater,
+      .slabCount = slabs.size(),
+  };
+}
+
+std::vector<PoolStats> ObjectPoolUtils::GetPoolStats() {
+  std::vector<ObjectPool*> pools;
+  {
+    std::lock_guard lock(registryMutex);
+    pools = GetPools();
+  }
+  std::vector<PoolStats> ret;
+  for (ObjectPool* pool : pools) {
+    ret.emplace_back(pool->GetStats());
+  }
+  return ret;
+}
+
+void ObjectPoolUtils::PrintPoolStats() {
+  std::cout << std::left << std::setw(40) << "Pool" << std::right
+            << std::setw(10) << "Block" << std::setw(10) << "InUse"
+            << std::setw(10) << "Peak" << std::setw(10) << "Capacity"
+            << std::setw(8) << "Slabs" << std::endl;
+  for (const PoolStats& stats : GetPoolStats()) {
+    std::cout << std::left << std::setw(40) << stats.name << std::right
+              << std::setw(10) << stats.blockSize << std::setw(10)
+              << stats.inUse << std::setw(10) << stats.highWater
+              << std::setw(10) << stats.capacity << std::setw(8)
+              << stats.slabCount << std::endl;
+  }
+}
\ No newline at end of file
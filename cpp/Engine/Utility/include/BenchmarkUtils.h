@@ -0,0 +1,49 @@
+#pragma once
+
+#include <Engine/Utility/include/TypeUtils.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace BenchmarkUtils {
+template <typename T>
+inline void DoNotOptimize(const T& value) {
+  static const void* volatile sink = nullptr;
+  sink = &value;
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+}
+
+struct Fixture {
+  std::string name;
+  size_t itemsPerRun = 1;
+  std::function<void()> setUp = [] {};
+  std::function<void()> run;
+  std::function<void()> tearDown = [] {};
+  // Overrides itemsPerRun when set, called after setUp
+  std::function<size_t()> countItems;
+};
+
+struct Result {
+  std::string name;
+  std::string aggregate;
+  int repetition = 0;
+  uint64_t iterations = 0;
+  double realTime = 0;
+  double cpuTime = 0;
+  double itemsPerSecond = 0;
+};
+
+void RegisterFixture(Fixture fixture);
+void RegisterEngineFixtures(const std::string& root, const std::string& file);
+
+std::vector<Result> RunFixtures(const std::string& filter, float minTime,
+                                int repetitions);
+void WriteResultsToFile(const std::string& filePath,
+                        const std::vector<Result>& results);
+
+int RunBenchmarks(const std::string& root, const std::string& file,
+                  const std::string& filter = "");
+}  // namespace BenchmarkUtils
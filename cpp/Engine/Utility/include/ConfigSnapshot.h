@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Holds a config file parsed into an immutable struct. Publish swaps in a new
+// version with a single atomic store, readers never take publishMutex. A
+// reader keeps the version it got from Get alive for as long as it holds the
+// pointer, so a publish never frees a version that is still being read.
+template <typename T>
+class ConfigSnapshot {
+  std::atomic<std::shared_ptr<const T>> current;
+  std::mutex publishMutex;
+  std::string filePath = "Unset";
+
+ public:
+  ConfigSnapshot() = default;
+  ConfigSnapshot(const ConfigSnapshot&) = delete;
+  ConfigSnapshot& operator=(const ConfigSnapshot&) = delete;
+
+  void Load(const std::string& path) {
+    {
+      std::lock_guard lock(publishMutex);
+      filePath = path;
+    }
+    Reload();
+  }
+  void Reload() {
+    std::string path;
+    {
+      std::lock_guard lock(publishMutex);
+      path = filePath;
+    }
+    if (path != "Unset") {
+      Publish(std::make_shared<const T>(T::Parse(path)));
+    }
+  }
+  void Publish(std::shared_ptr<const T> version) {
+    current.store(std::move(version), std::memory_order_release);
+  }
+
+  bool Loaded() const {
+    return current.load(std::memory_order_acquire) != nullptr;
+  }
+  std::shared_ptr<const T> Get() const {
+    return current.load(std::memory_order_acquire);
+  }
+};
\ No newline at end of file
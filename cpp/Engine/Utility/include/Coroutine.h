@@ -0,0 +1,226 @@
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace Coroutine {
+template <typename ResultType>
+struct Task;
+template <typename ResultType>
+struct TaskAwaiter;
+template <typename ResultType>
+struct SharedTaskAwaiter;
+
+template <typename T>
+struct Result {
+  explicit Result() = default;
+  explicit Result(T &&value) : _value(std::move(value)) {}
+  explicit Result(std::exception_ptr &&exception_ptr)
+      : _exception_ptr(exception_ptr) {}
+  T get_or_throw() {
+    if (_exception_ptr) {
+      std::rethrow_exception(_exception_ptr);
+    }
+    return _value;
+  }
+  T _value{};
+  std::exception_ptr _exception_ptr;
+};
+template <>
+struct Result<void> {
+  explicit Result() = default;
+  explicit Result(std::exception_ptr &&exception_ptr)
+      : _exception_ptr(exception_ptr) {}
+  void get_or_throw() {
+    if (_exception_ptr) {
+      std::rethrow_exception(_exception_ptr);
+    }
+  }
+  std::exception_ptr _exception_ptr;
+};
+
+// Completion is only published once the coroutine has reached its final
+// suspend point, so waiters and callbacks may destroy the task right away.
+template <typename ResultType>
+struct TaskPromiseBase {
+  struct FinalAwaiter {
+    constexpr bool await_ready() const noexcept { return false; }
+    template <typename Promise>
+    void await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+      handle.promise().notify_callbacks();
+    }
+    constexpr void await_resume() const noexcept {}
+  };
+
+  std::suspend_never initial_suspend() { return {}; }
+  FinalAwaiter final_suspend() noexcept { return {}; }
+  void unhandled_exception() {
+    result = Result<ResultType>(std::current_exception());
+  }
+  ResultType get_result() {
+    std::unique_lock lock(completion_lock);
+    completion.wait(lock, [this] { return completed; });
+    return result->get_or_throw();
+  }
+  bool is_completed() {
+    std::lock_guard lock(completion_lock);
+    return completed;
+  }
+  void on_completed(std::function<void(Result<ResultType>)> &&func) {
+    std::unique_lock lock(completion_lock);
+    if (completed) {
+      auto value = result.value();
+      lock.unlock();
+      func(value);
+    } else {
+      completion_callbacks.push_back(std::move(func));
+    }
+  }
+  void notify_callbacks() {
+    // Nothing in the frame may be touched once the lock is released
+    std::list<std::function<void(Result<ResultType>)>> callbacks;
+    auto value = result.value();
+    {
+      std::lock_guard lock(completion_lock);
+      completed = true;
+      callbacks.swap(completion_callbacks);
+      completion.notify_all();
+    }
+    for (auto &callback : callbacks) {
+      callback(value);
+    }
+  }
+
+  std::mutex completion_lock;
+  std::condition_variable completion;
+  bool completed = false;
+  std::optional<Result<ResultType>> result;
+  std::list<std::function<void(Result<ResultType>)>> completion_callbacks;
+};
+template <typename ResultType>
+struct TaskPromise : TaskPromiseBase<ResultType> {
+  Task<ResultType> get_return_object() {
+    return Task<ResultType>{
+        std::coroutine_handle<TaskPromise>::from_promise(*this)};
+  }
+  void return_value(ResultType value) {
+    this->result = Result<ResultType>(std::move(value));
+  }
+};
+template <>
+struct TaskPromise<void> : TaskPromiseBase<void> {
+  Task<void> get_return_object();
+  void return_void() { result = Result<void>(); }
+};
+
+template <typename ResultType>
+struct ThenCallback {
+  using type = std::function<void(ResultType)>;
+};
+template <>
+struct ThenCallback<void> {
+  using type = std::function<void()>;
+};
+
+template <typename ResultType>
+struct Task {
+  using promise_type = TaskPromise<ResultType>;
+
+  ResultType get_result() { return handle.promise().get_result(); }
+  bool done() { return handle.promise().is_completed(); }
+  Task &then(typename ThenCallback<ResultType>::type &&func) {
+    // A failed task skips func, its exception goes to catching
+    handle.promise().on_completed([func](auto result) {
+      if (result._exception_ptr) {
+        return;
+      }
+      if constexpr (std::is_void_v<ResultType>) {
+        func();
+      } else {
+        func(std::move(result._value));
+      }
+    });
+    return *this;
+  }
+  Task &catching(std::function<void(std::exception &)> &&func) {
+    handle.promise().on_completed([func](auto result) {
+      try {
+        result.get_or_throw();
+      } catch (std::exception &e) {
+        func(e);
+      }
+    });
+    return *this;
+  }
+  Task &finally(std::function<void()> &&func) {
+    handle.promise().on_completed([func](auto result) { func(); });
+    return *this;
+  }
+  TaskAwaiter<ResultType> operator co_await() && {
+    return TaskAwaiter<ResultType>(std::move(*this));
+  }
+  // Awaiting an lvalue leaves the task with its owner, so several coroutines
+  // can wait for the same result. The owner must outlive all of them.
+  SharedTaskAwaiter<ResultType> operator co_await() & {
+    return SharedTaskAwaiter<ResultType>(*this);
+  }
+  explicit Task(std::coroutine_handle<promise_type> handle) noexcept
+      : handle(handle) {}
+  Task(Task &&task) noexcept : handle(std::exchange(task.handle, {})) {}
+  Task(Task &) = delete;
+  Task &operator=(Task &) = delete;
+  ~Task() {
+    if (handle) handle.destroy();
+  }
+  std::coroutine_handle<promise_type> handle;
+};
+
+inline Task<void> TaskPromise<void>::get_return_object() {
+  return Task<void>{std::coroutine_handle<TaskPromise>::from_promise(*this)};
+}
+
+// The awaiting coroutine resumes on whichever thread completes the task
+template <typename R>
+struct TaskAwaiter {
+  explicit TaskAwaiter(Task<R> &&task) noexcept : task(std::move(task)) {}
+  constexpr bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> handle) {
+    task.finally([handle] { handle.resume(); });
+  }
+  R await_resume() { return task.get_result(); }
+  Task<R> task;
+};
+template <typename R>
+struct SharedTaskAwaiter {
+  explicit SharedTaskAwaiter(Task<R> &task) noexcept : task(task) {}
+  bool await_ready() { return task.done(); }
+  void await_suspend(std::coroutine_handle<> handle) {
+    task.finally([handle] { handle.resume(); });
+  }
+  R await_resume() { return task.get_result(); }
+  Task<R> &task;
+};
+
+// Resumes the awaiting coroutine on a job of the executor, which only needs a
+// Post(std::function<void()>) member.
+template <typename Executor>
+struct ScheduleAwaiter {
+  Executor &executor;
+  constexpr bool await_ready() const noexcept { return false; }
+  void await_suspend(std::coroutine_handle<> handle) {
+    executor.Post([handle] { handle.resume(); });
+  }
+  constexpr void await_resume() const noexcept {}
+};
+template <typename Executor>
+ScheduleAwaiter<Executor> Schedule(Executor &executor) {
+  return {executor};
+}
+}  // namespace Coroutine
\ No newline at end of file
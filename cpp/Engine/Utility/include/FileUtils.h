@@ -2,6 +2,7 @@
 
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "TypeUtils.h"
 
@@ -10,6 +11,7 @@ UIntegers ReadFileAsUIntegers(const std::string& filePath,
                               int readMode = std::ios::binary);
 
 std::string ReadFileAsString(const std::string& filePath);
+std::vector<char> ReadFileAsBytes(const std::string& filePath);
 
 void WriteFileAsUIntegers(const std::string& filePath,
                           int writeMode = std::ios::binary,
@@ -17,4 +19,8 @@ void WriteFileAsUIntegers(const std::string& filePath,
 
 void WriteFileAsString(const std::string& filePath,
                        const std::string& fileContent = {});
+void WriteFileAsBytes(const std::string& filePath,
+                      const std::vector<char>& fileContent);
+void WriteFileAtomically(const std::string& filePath,
+                         const std::string& fileContent);
 }  // namespace FileUtils
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Watches directory trees for modified, added or removed files. A background
+// thread polls write times, the owner drains the changed paths with
+// TakeChanges whenever it is ready to react to them.
+class FileWatcher {
+  using WriteTimes =
+      std::unordered_map<std::string, std::filesystem::file_time_type>;
+
+  std::mutex watchMutex;
+  std::condition_variable stopCondition;
+  std::thread pollThread;
+  bool stopping = false;
+
+  std::vector<std::string> directories;
+  WriteTimes writeTimes;
+  std::unordered_set<std::string> changes;
+
+  static void ScanDirectory(const std::string& directory, WriteTimes& times);
+  void Poll();
+  void PollLoop(std::chrono::milliseconds interval);
+
+ public:
+  FileWatcher() = default;
+  FileWatcher(const FileWatcher&) = delete;
+  FileWatcher& operator=(const FileWatcher&) = delete;
+  ~FileWatcher() { Stop(); }
+
+  void WatchDirectory(const std::string& directory);
+  void Start(std::chrono::milliseconds interval);
+  void Stop();
+
+  [[nodiscard]] std::vector<std::string> TakeChanges();
+};
@@ -6,6 +6,7 @@
 #include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
+#include <functional>
 #include <glm/glm.hpp>
 #include <string>
 #include <vector>
@@ -87,6 +88,15 @@ void ModifyBoolOfFile(const std::string& filePath, const std::string& key,
                       bool value);
 void ModifyIntOfFile(const std::string& filePath, const std::string& key,
                      int value);
+// Edits a copy of the cached document and publishes it in place of the
+// cached one, readers keep the version they already hold
+void EditDocument(const std::string& filePath,
+                  const std::function<void(rapidjson::Document&)>& edit);
+void FlushPendingWrites();
+// The path documents are cached and loaded by for a file on disk, without the
+// suffix and normalized
+std::string GetDocumentPath(const std::string& filePath);
+void InvalidateDocument(const std::string& filePath);
 void ClearDocumentCache();
 std::unordered_map<TextureType, std::string> GetCombineTextures(
     const std::string& filePath);
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+// Bounded queue for many producer threads and one consumer thread. Each cell
+// carries a sequence number telling whose turn it is, so pushes and pops are
+// lock free. Producers only take the mutex to sleep while the queue is full,
+// and the consumer only takes it when one of them is sleeping.
+template <typename T>
+class MPSCQueue {
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  std::unique_ptr<Cell[]> cells;
+  const size_t capacity;
+  const size_t mask;
+  alignas(64) std::atomic<size_t> enqueuePos = 0;
+  alignas(64) size_t dequeuePos = 0;
+
+  std::mutex fullMutex;
+  std::condition_variable fullCondition;
+  std::atomic<int> waitingProducers = 0;
+  bool closed = false;
+
+  static size_t RoundUpToPowerOfTwo(size_t value) {
+    size_t res = 1;
+    while (res < value) {
+      res <<= 1;
+    }
+    return res;
+  }
+
+ public:
+  explicit MPSCQueue(const size_t minCapacity)
+      : capacity(RoundUpToPowerOfTwo(minCapacity)), mask(capacity - 1) {
+    cells = std::make_unique<Cell[]>(capacity);
+    for (size_t i = 0; i < capacity; ++i) {
+      cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  // Never blocks, leaves the value untouched and returns false when the queue
+  // is full.
+  bool TryPush(T& value) {
+    size_t pos = enqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+      Cell& cell = cells[pos & mask];
+      const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      const intptr_t diff =
+          static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueuePos.compare_exchange_weak(pos, pos + 1,
+                                             std::memory_order_relaxed)) {
+          cell.value = std::move(value);
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        // The consumer has not freed this cell yet, the queue is full
+        return false;
+      } else {
+        pos = enqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  // Blocks while the queue is full. Returns false if the queue was closed
+  // before the value could be pushed.
+  bool Push(T value) {
+    if (TryPush(value)) {
+      return true;
+    }
+    std::unique_lock lock(fullMutex);
+    waitingProducers.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    bool pushed = false;
+    fullCondition.wait(lock, [this, &value, &pushed] {
+      return closed || (pushed = TryPush(value));
+    });
+    waitingProducers.fetch_sub(1);
+    return pushed;
+  }
+
+  // Consumer thread only
+  bool TryPop(T& value) {
+    Cell& cell = cells[dequeuePos & mask];
+    if (cell.sequence.load(std::memory_order_acquire) != dequeuePos + 1) {
+      return false;
+    }
+    value = std::move(cell.value);
+    cell.value = T();
+    cell.sequence.store(dequeuePos + capacity, std::memory_order_release);
+    ++dequeuePos;
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waitingProducers.load() > 0) {
+      std::lock_guard lock(fullMutex);
+      fullCondition.notify_all();
+    }
+    return true;
+  }
+
+  // Wakes producers blocked on a full queue and makes later pushes that would
+  // block fail, for when the consumer stops draining.
+  void Close() {
+    {
+      std::lock_guard lock(fullMutex);
+      closed = true;
+    }
+    fullCondition.notify_all();
+  }
+};
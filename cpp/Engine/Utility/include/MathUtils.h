@@ -25,6 +25,21 @@ inline glm::vec2 AiVector2D2GlmVec2(const aiVector2D& vec) {
   return {vec.x, vec.y};
 }
 
+// Maps a unit vector onto the [-1, 1] square, the inverse is in
+// GLSLLibrary/Binding/Vertex/VertexInput.glsl
+inline glm::vec2 OctahedralEncode(glm::vec3 n) {
+  const float sum = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+  if (sum == 0) {
+    return glm::vec2(0);
+  }
+  n /= sum;
+  if (n.z >= 0) {
+    return {n.x, n.y};
+  }
+  return {(1 - std::abs(n.y)) * (n.x >= 0 ? 1.0f : -1.0f),
+          (1 - std::abs(n.x)) * (n.y >= 0 ? 1.0f : -1.0f)};
+}
+
 #define RotateFunctions(LibType)                                \
   inline LibType rotateX(const LibType& p, const float a) {     \
     float c = cos(a), s = sin(a);                               \
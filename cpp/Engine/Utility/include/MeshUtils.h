@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Engine/Utility/include/TypeUtils.h>
+
+#include <cstdint>
+#include <vector>
+
+// Import time geometry passes over indexed triangle lists, run before a mesh
+// is encoded and uploaded. Cache statistics simulate a FIFO post-transform
+// cache of CacheSize entries: ACMR is the number of vertex shader runs per
+// triangle, ATVR per referenced vertex, so 1 is the best an ATVR can be.
+namespace MeshUtils {
+inline constexpr uint32_t CacheSize = 16;
+inline constexpr uint32_t MaxMeshletVertices = 64;
+inline constexpr uint32_t MaxMeshletTriangles = 124;
+inline constexpr float OverdrawThreshold = 1.05f;
+inline constexpr uint32_t MaxShortIndexVertices = 1 << 16;
+inline constexpr uint32_t MaxLodCount = 4;
+// Each level aims at this share of the previous one's triangles, and is
+// dropped along with the coarser ones when it keeps more than LodMinReduction
+inline constexpr float LodReduction = 0.5f;
+inline constexpr float LodMinReduction = 0.85f;
+
+struct VertexCacheStats {
+  float acmr = 0;
+  float atvr = 0;
+};
+
+struct MeshChunk {
+  std::vector<uint32_t> indices;
+  std::vector<VertexData> vertices;
+};
+
+VertexCacheStats AnalyzeVertexCache(const std::vector<uint32_t>& indices,
+                                    size_t vertexCount);
+
+// Reorders triangles for the post-transform cache (Forsyth's linear speed
+// algorithm)
+void OptimizeVertexCache(std::vector<uint32_t>& indices, size_t vertexCount);
+// Draws the clusters the cache order starts anew at outward facing first, so
+// the depth test rejects more of the rest. Kept only if the ACMR stays within
+// threshold times the current one.
+void OptimizeOverdraw(std::vector<uint32_t>& indices,
+                      const std::vector<VertexData>& vertices,
+                      float threshold = OverdrawThreshold);
+// Renumbers the vertices in the order the indices first use them, vertices
+// that no triangle uses are dropped
+void OptimizeVertexFetch(std::vector<uint32_t>& indices,
+                         std::vector<VertexData>& vertices);
+// Runs the selected index and vertex passes in dependency order
+void OptimizeGeometry(uint32_t passes, std::vector<uint32_t>& indices,
+                      std::vector<VertexData>& vertices);
+
+// Cuts the triangles, kept in their order, into chunks that use at most
+// maxVertices vertices each, so each chunk can be drawn with 16 bit indices
+std::vector<MeshChunk> SplitMesh(const std::vector<uint32_t>& indices,
+                                 const std::vector<VertexData>& vertices,
+                                 uint32_t maxVertices = MaxShortIndexVertices);
+
+MeshletData BuildMeshlets(const std::vector<uint32_t>& indices,
+                          const std::vector<VertexData>& vertices);
+
+// Collapses edges onto one of their vertices in the order of the quadric
+// error they add, until at most targetIndexCount indices are left or no edge
+// can go. Vertices on borders, attribute seams included, stay in place, and
+// collapses that flip a triangle are skipped. Returns the largest distance
+// error a collapse added.
+float SimplifyMesh(std::vector<uint32_t>& indices,
+                   const std::vector<VertexData>& vertices,
+                   size_t targetIndexCount);
+// Appends up to lodCount - 1 simplified levels to indices, each one built
+// from the previous level, and returns all levels including the full one
+std::vector<MeshLod> BuildLods(std::vector<uint32_t>& indices,
+                               const std::vector<VertexData>& vertices,
+                               uint32_t lodCount = MaxLodCount);
+// Center and radius of a sphere around the vertices
+glm::vec4 ComputeBounds(const std::vector<VertexData>& vertices);
+}  // namespace MeshUtils
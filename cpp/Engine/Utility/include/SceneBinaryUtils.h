@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+class BaseScene;
+class SceneObject;
+class GraphicsInterface;
+
+#define SCENESUFFIX ".eqscene"
+
+// Scenes converted from JSON into a flat binary table: a string table, one
+// fixed-size record per object in pre-order with its parent index, packed
+// transforms and params, and the light channel lists. Loading is a single
+// pass over the records with no JSON or string-to-vector parsing.
+namespace SceneBinaryUtils {
+inline constexpr uint32_t Version = 1;
+
+void ConvertSceneToBinary(const std::string& root, const std::string& file);
+
+// Returns false when the binary file is missing, older than the JSON scene or
+// of another version, so the caller can fall back to the JSON path.
+bool LoadBinaryScene(std::weak_ptr<GraphicsInterface> graphics,
+                     std::shared_ptr<SceneObject> parent,
+                     const std::string& root, const std::string& file,
+                     std::weak_ptr<BaseScene> owner);
+}  // namespace SceneBinaryUtils
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace SortUtils {
+// Stable least significant digit radix sort on a 64 bit key, one byte per
+// pass. Passes over a byte all keys share are skipped, so keys that only use
+// a few of their bits cost a few passes. scratch only saves the allocation
+// across calls.
+template <typename T, typename KeyOf>
+void RadixSort(std::vector<T>& items, std::vector<T>& scratch, KeyOf keyOf) {
+  scratch.resize(items.size());
+  for (uint32_t shift = 0; shift < 64; shift += 8) {
+    std::array<size_t, 256> offsets{};
+    for (const T& item : items) {
+      offsets[(keyOf(item) >> shift) & 0xff]++;
+    }
+    if (std::ranges::find(offsets, items.size()) != offsets.end()) {
+      continue;
+    }
+    size_t offset = 0;
+    for (size_t& count : offsets) {
+      offset += std::exchange(count, offset);
+    }
+    for (T& item : items) {
+      scratch[offsets[(keyOf(item) >> shift) & 0xff]++] = std::move(item);
+    }
+    items.swap(scratch);
+  }
+}
+}  // namespace SortUtils
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+using StringId = uint64_t;
+
+// Names of scene objects and shaders are keyed by their 64-bit FNV-1a hash.
+// The hash is the same at compile time and at run time, so literals can be
+// hashed with _sid. Debug builds keep the interned names for GetName and
+// report hash collisions.
+namespace StringIdUtils {
+inline constexpr StringId FNVOffsetBasis = 14695981039346656037ull;
+inline constexpr StringId FNVPrime = 1099511628211ull;
+
+constexpr StringId Hash(const std::string_view str) {
+  StringId hash = FNVOffsetBasis;
+  for (const char c : str) {
+    hash ^= static_cast<uint8_t>(c);
+    hash *= FNVPrime;
+  }
+  return hash;
+}
+
+StringId Intern(std::string_view str);
+std::string GetName(StringId id);
+}  // namespace StringIdUtils
+
+consteval StringId operator""_sid(const char* str, const size_t len) {
+  return StringIdUtils::Hash({str, len});
+}
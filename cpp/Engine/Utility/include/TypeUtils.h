@@ -7,6 +7,7 @@
 #include <stb_image.h>
 
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <glm/glm.hpp>
@@ -81,7 +82,112 @@ struct VertexData {
   glm::vec4 color;
   glm::vec3 normal;
   glm::vec3 tangent;
-  glm::vec3 texCoord;
+  glm::vec2 texCoord;
+};
+
+// Flags selecting how a mesh's vertices are packed on the GPU, see
+// VertexLayout in RHI/Vulkan/include/vertex.h
+enum VertexFormat : uint32_t {
+  FullVertexFormat = 0,
+  QuantizedPositionVertexFormat = 1 << 0,
+  OctahedralNormalVertexFormat = 1 << 1,
+  SnormTexCoordVertexFormat = 1 << 2,
+  NoColorVertexFormat = 1 << 3,
+  CompactVertexFormat = QuantizedPositionVertexFormat |
+                        OctahedralNormalVertexFormat |
+                        SnormTexCoordVertexFormat | NoColorVertexFormat,
+};
+
+inline std::unordered_map<std::string, VertexFormat> VertexFormatMap{
+    {"Full", FullVertexFormat},
+    {"QuantizedPosition", QuantizedPositionVertexFormat},
+    {"OctahedralNormal", OctahedralNormalVertexFormat},
+    {"SnormTexCoord", SnormTexCoordVertexFormat},
+    {"NoColor", NoColorVertexFormat},
+    {"Compact", CompactVertexFormat},
+};
+
+// Import time passes over a mesh's geometry, see MeshUtils
+enum GeometryPass : uint32_t {
+  NoGeometryPass = 0,
+  VertexCacheGeometryPass = 1 << 0,
+  OverdrawGeometryPass = 1 << 1,
+  VertexFetchGeometryPass = 1 << 2,
+  MeshletGeometryPass = 1 << 3,
+  // Meshes over 65536 vertices become several meshes with 16 bit indices
+  SplitGeometryPass = 1 << 4,
+  // Simplified levels of detail, see MeshLod
+  LodGeometryPass = 1 << 5,
+  OptimizeGeometryPass = VertexCacheGeometryPass | OverdrawGeometryPass |
+                         VertexFetchGeometryPass,
+};
+
+inline std::unordered_map<std::string, GeometryPass> GeometryPassMap{
+    {"VertexCache", VertexCacheGeometryPass},
+    {"Overdraw", OverdrawGeometryPass},
+    {"VertexFetch", VertexFetchGeometryPass},
+    {"Meshlet", MeshletGeometryPass},
+    {"Split", SplitGeometryPass},
+    {"Lod", LodGeometryPass},
+    {"Optimize", OptimizeGeometryPass},
+};
+
+// Up to MeshUtils::MaxMeshletVertices vertices and MaxMeshletTriangles
+// triangles. The cluster faces away from a camera at eye, and can be culled,
+// when dot(center - eye, coneAxis) >= coneCutoff * length(center - eye) +
+// radius.
+struct Meshlet {
+  uint32_t vertexOffset = 0;
+  uint32_t vertexCount = 0;
+  uint32_t triangleOffset = 0;
+  uint32_t triangleCount = 0;
+  glm::vec3 center{};
+  float radius = 0;
+  glm::vec3 coneAxis{};
+  float coneCutoff = 1;
+};
+
+// Meshlet offsets point into these arrays. Vertices index the mesh's
+// vertices, triangles are three bytes indexing the meshlet's vertices.
+struct MeshletData {
+  std::vector<Meshlet> meshlets;
+  std::vector<uint32_t> vertices;
+  std::vector<uint8_t> triangles;
+};
+
+// One level of detail, a range of the mesh's index buffer over the shared
+// vertices. Error is how far, in model space, the level may stray from the
+// full mesh, so it covers error * scale / distance of the view at a distance.
+struct MeshLod {
+  uint32_t indexOffset = 0;
+  uint32_t indexCount = 0;
+  float error = 0;
+};
+
+// Maps quantized attributes back to model space. Positions are unorm16 inside
+// the mesh bounds, texture coordinates snorm16 around their center.
+struct VertexDequantData {
+  glm::mat4 position = glm::mat4(1);
+  glm::vec4 texCoord = glm::vec4(1, 1, 0, 0);
+};
+
+// Staging memory the graphics backend hands a loader for one mesh, see
+// GraphicsInterface::AllocateMeshStaging. The writes pack vertices and
+// indices in the GPU layout, indices are narrowed to 16 bits when the vertex
+// count allows it. The memory goes back to the backend once the mesh upload
+// has completed.
+struct MeshStaging {
+  size_t indexCount = 0;
+  size_t vertexCount = 0;
+
+  virtual ~MeshStaging() = default;
+  virtual void WriteVertices(const std::vector<VertexData>& vertices,
+                             const VertexDequantData& dequant) = 0;
+  virtual void WriteIndices(const std::vector<uint32_t>& indices) = 0;
+  // Where indexCount indices go for loaders writing them in place, uint16_t
+  // when GetShortIndices is set and uint32_t otherwise
+  virtual void* GetIndexData() = 0;
+  [[nodiscard]] virtual bool GetShortIndices() const = 0;
 };
 
 enum class PipelineType {
@@ -89,6 +195,7 @@ enum class PipelineType {
   Forward = 1,
   DeferredOutputGBuffer = 2,
   DeferredProcessGBuffer = 3,
+  Compute = 4,
 };
 
 enum class TextureType {
@@ -148,6 +255,16 @@ struct TransformData {
   alignas(16) glm::mat4 modelMatrix;
   alignas(16) glm::mat4 viewMatrix;
   alignas(16) glm::mat4 projMatrix;
+  alignas(16) glm::mat4 dequantMatrix;
+  alignas(16) glm::vec4 texCoordDequant;
+};
+
+// Pushed to the lighting subpass of the compact G-buffer, which reconstructs
+// world position from gl_FragCoord and depth
+struct DeferredViewData {
+  alignas(16) glm::mat4 screenToWorld;
+  alignas(16) glm::vec4 cameraPosition;
+  alignas(16) glm::vec4 cameraNormal;
 };
 
 struct LightData {
@@ -167,7 +284,9 @@ struct LightChannelData {
 };
 
 struct UniformData {
-  const glm::mat4x4* modelMatrix;
+  // Cleared by the game thread when the transform goes away, so the render
+  // thread loads it once per use
+  std::atomic<const glm::mat4x4*> modelMatrix = nullptr;
   std::weak_ptr<BaseCamera> camera;
   std::weak_ptr<BaseMaterial> material;
   std::weak_ptr<LightChannel> lightChannel;
@@ -181,9 +300,19 @@ struct MeshData {
   StateData state;
   std::string name;
   UniformData uniform;
+  // Only filled when the backend had no staging memory for the mesh
   std::vector<uint32_t> indices;
   std::vector<VertexData> vertices;
+  std::unique_ptr<MeshStaging> staging;
   std::vector<TextureData> textures;
+  uint32_t vertexFormat = FullVertexFormat;
+  VertexDequantData dequant;
+  // Built over the uploaded index order when MeshletGeometryPass is set
+  MeshletData meshlets;
+  // Finest first, the indices hold every level one after another
+  std::vector<MeshLod> lods;
+  // Model space center and radius
+  glm::vec4 bounds{};
 };
 
 namespace FuncUtils {
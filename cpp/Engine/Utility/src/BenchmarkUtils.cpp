@@ -0,0 +1,667 @@
+#include "../include/BenchmarkUtils.h"
+
+#include <Engine/Light/include/LightChannel.h>
+#include <Engine/Light/include/SunLight.h>
+#include <Engine/Model/include/BaseModel.h>
+#include <Engine/Model/include/TransformSystem.h>
+#include <Engine/RHI/Vulkan/include/mesh.h>
+#include <Engine/RHI/Vulkan/include/vertex.h>
+#include <Engine/Scene/include/SceneObject.h>
+#include <Engine/System/include/ObjectPool.h>
+#include <Engine/Utility/include/FileUtils.h>
+#include <Engine/Utility/include/JsonUtils.h>
+#include <assimp/postprocess.h>
+#include <assimp/scene.h>
+#include <rapidjson/prettywriter.h>
+
+#include <algorithm>
+#include <assimp/Importer.hpp>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <format>
+#include <iomanip>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <unordered_map>
+
+using namespace rapidjson;
+
+std::vector<std::shared_ptr<MeshData>> ParseFbxMeshDatas(
+    BaseModel& model, const aiScene* scene, const std::string& dataPath);
+
+namespace BenchmarkUtils {
+struct MeshAccess {
+  static void SetBridge(Mesh& mesh, std::weak_ptr<MeshData> bridge) {
+    mesh.bridge = bridge;
+  }
+  static void ParseVertexAndIndex(Mesh& mesh) { mesh.ParseVertexAndIndex(); }
+};
+}  // namespace BenchmarkUtils
+
+namespace {
+constexpr uint64_t MaxIterations = 1000000000;
+constexpr unsigned int ModelParserFlags =
+    aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs |
+    aiProcess_CalcTangentSpace;
+
+std::vector<BenchmarkUtils::Fixture>& GetFixtures() {
+  static std::vector<BenchmarkUtils::Fixture> fixtures;
+  return fixtures;
+}
+
+std::vector<int> ReadIntsFromFile(const std::string& filePath,
+                                  const std::string& key) {
+  std::vector<int> ret;
+  if (std::shared_ptr<Document> doc = JsonUtils::GetJsonDocFromFile(filePath);
+      doc->HasMember(key.c_str())) {
+    const auto& values = (*doc)[key.c_str()];
+    for (SizeType i = 0; i < values.Size(); ++i) {
+      ret.emplace_back(values[i].GetInt());
+    }
+  }
+  return ret;
+}
+
+std::vector<VertexData> GenerateVertexDatas(std::mt19937& rng, size_t num) {
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<VertexData> vertices;
+  vertices.reserve(num);
+  for (size_t i = 0; i < num; i++) {
+    vertices.push_back({
+        .pos = {dist(rng), dist(rng), dist(rng)},
+        .color = Vec4One,
+        .normal = glm::normalize(glm::vec3(dist(rng), dist(rng), 1.0f)),
+        .tangent = glm::normalize(glm::vec3(1.0f, dist(rng), dist(rng))),
+        .texCoord = {dist(rng) * 0.5f + 0.5f, dist(rng) * 0.5f + 0.5f},
+    });
+  }
+  return vertices;
+}
+
+void BuildTransformHierarchy(std::shared_ptr<SceneObject> parent,
+                               const std::string& root,
+                               const std::string& file, int depth,
+                               int fanOut) {
+  if (depth <= 0) {
+    return;
+  }
+  for (int i = 0; i < fanOut; i++) {
+    std::shared_ptr<SceneObject> son =
+        BaseObject::CreateImmediately<SceneObject>(
+            parent, "BenchmarkNode", root, file,
+            std::shared_ptr<BaseObject>(nullptr));
+    BuildTransformHierarchy(son, root, file, depth - 1, fanOut);
+  }
+}
+
+void RegisterTransformFixtures(const std::string& root,
+                               const std::string& file) {
+  const std::vector<int> depths =
+      ReadIntsFromFile(root + file, "TransformDepths");
+  const std::vector<int> fanOuts =
+      ReadIntsFromFile(root + file, "TransformFanOuts");
+
+  for (size_t i = 0; i < std::min(depths.size(), fanOuts.size()); i++) {
+    const int depth = depths[i], fanOut = fanOuts[i];
+    const std::string suffix = "/Depth:" + std::to_string(depth) +
+                               "/FanOut:" + std::to_string(fanOut);
+
+    auto rootObject = std::make_shared<std::shared_ptr<SceneObject>>();
+    auto leafObject = std::make_shared<std::shared_ptr<SceneObject>>();
+    auto frame = std::make_shared<uint64_t>(0);
+
+    auto setUp = [=] {
+      *rootObject = BaseObject::CreateImmediately<SceneObject>(
+          std::shared_ptr<SceneObject>(nullptr), "BenchmarkRoot", root, file,
+          std::shared_ptr<BaseObject>(nullptr));
+      BuildTransformHierarchy(*rootObject, root, file, depth, fanOut);
+      *leafObject = *rootObject;
+      while ((*leafObject)->GetSons().empty() == false) {
+        *leafObject = (*leafObject)->GetSons().front();
+      }
+    };
+    auto tearDown = [=] {
+      leafObject->reset();
+      rootObject->reset();
+    };
+
+    size_t itemsPerRun = 1;
+    for (int d = 1, level = 1; d <= depth; d++) {
+      level *= fanOut;
+      itemsPerRun += level;
+    }
+
+    BenchmarkUtils::RegisterFixture({
+        .name = "BaseTransform/SetRelativePosition" + suffix,
+        .itemsPerRun = itemsPerRun,
+        .setUp = setUp,
+        .run =
+            [=] {
+              const float offset = static_cast<float>((*frame)++ % 64);
+              (*rootObject)->SetRelativePosition(glm::vec3(offset, 0, 0));
+              TransformSystem::UpdateWorldTransforms();
+            },
+        .tearDown = tearDown,
+    });
+    BenchmarkUtils::RegisterFixture({
+        .name = "BaseTransform/SetRelativeRotation" + suffix,
+        .itemsPerRun = itemsPerRun,
+        .setUp = setUp,
+        .run =
+            [=] {
+              const float angle = static_cast<float>((*frame)++ % 360);
+              (*rootObject)
+                  ->SetRelativeRotation(glm::radians(glm::vec3(0, angle, 0)));
+              TransformSystem::UpdateWorldTransforms();
+            },
+        .tearDown = tearDown,
+    });
+    BenchmarkUtils::RegisterFixture({
+        .name = "BaseTransform/SetAbsolutePositionOfLeaf" + suffix,
+        .setUp = setUp,
+        .run =
+            [=] {
+              const float offset = static_cast<float>((*frame)++ % 64);
+              (*leafObject)->SetAbsolutePosition(glm::vec3(0, offset, 0));
+              TransformSystem::UpdateWorldTransforms();
+            },
+        .tearDown = tearDown,
+    });
+  }
+}
+
+void RegisterObjectFixtures(const std::string& root, const std::string& file) {
+  for (const int objectCount :
+       ReadIntsFromFile(root + file, "ObjectCounts")) {
+    BenchmarkUtils::RegisterFixture({
+        .name = "BaseObject/CreateAndRelease/" + std::to_string(objectCount),
+        .itemsPerRun = static_cast<size_t>(objectCount),
+        .run =
+            [=] {
+              std::vector<std::shared_ptr<SceneObject>> objects;
+              objects.reserve(objectCount);
+              for (int i = 0; i < objectCount; i++) {
+                objects.emplace_back(
+                    BaseObject::CreateImmediately<SceneObject>(
+                        std::shared_ptr<SceneObject>(nullptr),
+                        "BenchmarkObject", root, file,
+                        std::shared_ptr<BaseObject>(nullptr)));
+              }
+              BenchmarkUtils::DoNotOptimize(objects);
+            },
+    });
+  }
+}
+
+void RegisterJsonFixtures(const std::string& root, const std::string& file) {
+  const std::string configPath =
+      root + JsonUtils::ReadStringFromFile(root + file, "JsonConfigFile");
+
+  BenchmarkUtils::RegisterFixture({
+      .name = "JsonUtils/ReadStringFromFile",
+      .run =
+          [=] {
+            BenchmarkUtils::DoNotOptimize(
+                JsonUtils::ReadStringFromFile(configPath, "Name"));
+          },
+  });
+  BenchmarkUtils::RegisterFixture({
+      .name = "JsonUtils/ReadBoolFromFile",
+      .run =
+          [=] {
+            BenchmarkUtils::DoNotOptimize(
+                JsonUtils::ReadBoolFromFile(configPath, "EnableDeferred"));
+          },
+  });
+  BenchmarkUtils::RegisterFixture({
+      .name = "JsonUtils/ReadFloatFromFile",
+      .run =
+          [=] {
+            BenchmarkUtils::DoNotOptimize(JsonUtils::ReadFloatFromFile(
+                configPath, "DepthBiasSlopeFactor"));
+          },
+  });
+  BenchmarkUtils::RegisterFixture({
+      .name = "JsonUtils/GetJsonDocFromFile/Uncached",
+      .run =
+          [=] {
+            JsonUtils::ClearDocumentCache();
+            BenchmarkUtils::DoNotOptimize(
+                JsonUtils::GetJsonDocFromFile(configPath));
+          },
+      .tearDown = [] { JsonUtils::ClearDocumentCache(); },
+  });
+  BenchmarkUtils::RegisterFixture({
+      .name = "JsonUtils/ParseGLMVec3",
+      .run =
+          [] {
+            BenchmarkUtils::DoNotOptimize(ParseGLMVec3("0.25,-10.5,3.75"));
+          },
+  });
+  BenchmarkUtils::RegisterFixture({
+      .name = "JsonUtils/ParseGLMVec4",
+      .run =
+          [] {
+            BenchmarkUtils::DoNotOptimize(ParseGLMVec4("1,0.5,0.25,1"));
+          },
+  });
+}
+
+void RegisterModelFixtures(const std::string& root, const std::string& file) {
+  for (const std::string& modelFile :
+       JsonUtils::ReadStringsFromFile(root + file, "Models")) {
+    const std::string modelPath = root + modelFile;
+    const std::string modelName =
+        JsonUtils::ReadStringFromFile(modelPath, "Name");
+    const std::string dataFile =
+        JsonUtils::ReadStringFromFile(modelPath, "ModelFile");
+    const std::string dataPath = root + dataFile;
+
+    // Imported when a fixture is set up, since tearDown frees the scene
+    auto importer = std::make_shared<Assimp::Importer>();
+    auto model = std::make_shared<std::shared_ptr<BaseModel>>();
+    auto setUp = [=] {
+      *model = BaseObject::CreateImmediately<BaseModel>(
+          std::weak_ptr<GraphicsInterface>(),
+          std::shared_ptr<SceneObject>(nullptr), modelName, root, modelFile,
+          std::shared_ptr<BaseObject>(nullptr));
+      const aiScene* sceneData = importer->ReadFile(dataPath, ModelParserFlags);
+      if (sceneData == nullptr ||
+          sceneData->mFlags & AI_SCENE_FLAGS_INCOMPLETE ||
+          sceneData->mRootNode == nullptr) {
+        PRINT_ERROR("skip model benchmark of " + modelName + ": " +
+                    importer->GetErrorString());
+        importer->FreeScene();
+      }
+    };
+    auto tearDown = [=] {
+      importer->FreeScene();
+      model->reset();
+    };
+    auto countVertices = [=] {
+      size_t vertexCount = 0;
+      if (const aiScene* sceneData = importer->GetScene()) {
+        for (unsigned int i = 0; i < sceneData->mNumMeshes; ++i) {
+          vertexCount += sceneData->mMeshes[i]->mNumVertices;
+        }
+      }
+      return vertexCount;
+    };
+
+    BenchmarkUtils::RegisterFixture({
+        .name = "BaseModel/ReadFile/" + modelName,
+        .setUp = setUp,
+        .run =
+            [=] {
+              Assimp::Importer benchImporter;
+              BenchmarkUtils::DoNotOptimize(
+                  benchImporter.ReadFile(dataPath, ModelParserFlags));
+            },
+        .tearDown = tearDown,
+        .countItems = countVertices,
+    });
+    BenchmarkUtils::RegisterFixture({
+        .name = "BaseModel/ParseFbxDatas/" + modelName,
+        .setUp = setUp,
+        .run =
+            [=] {
+              if (const aiScene* sceneData = importer->GetScene()) {
+                BenchmarkUtils::DoNotOptimize(
+                    ParseFbxMeshDatas(**model, sceneData, dataFile));
+              }
+            },
+        .tearDown = tearDown,
+        .countItems = countVertices,
+    });
+  }
+}
+
+void RegisterVertexFixtures(const std::string& root, const std::string& file,
+                            std::mt19937& rng) {
+  for (const int vertexCount :
+       ReadIntsFromFile(root + file, "VertexCounts")) {
+    const std::string suffix = "/" + std::to_string(vertexCount);
+
+    auto vertices = std::make_shared<std::vector<Vertex>>();
+    for (const auto& vert : GenerateVertexDatas(rng, vertexCount / 2 + 1)) {
+      vertices->emplace_back(vert);
+    }
+    std::uniform_int_distribution<size_t> pick(0, vertices->size() - 1);
+    auto duplicated = std::make_shared<std::vector<Vertex>>();
+    duplicated->reserve(vertexCount);
+    for (int i = 0; i < vertexCount; i++) {
+      duplicated->emplace_back((*vertices)[pick(rng)]);
+    }
+
+    BenchmarkUtils::RegisterFixture({
+        .name = "Vertex/HashFunction" + suffix,
+        .itemsPerRun = static_cast<size_t>(vertexCount),
+        .run =
+            [=] {
+              size_t hash = 0;
+              for (const Vertex& vertex : *duplicated) {
+                hash ^= Vertex::HashFunction()(vertex);
+              }
+              BenchmarkUtils::DoNotOptimize(hash);
+            },
+    });
+    BenchmarkUtils::RegisterFixture({
+        .name = "Vertex/Deduplicate" + suffix,
+        .itemsPerRun = static_cast<size_t>(vertexCount),
+        .run =
+            [=] {
+              std::unordered_map<Vertex, uint32_t, Vertex::HashFunction>
+                  uniqueVertices;
+              for (const Vertex& vertex : *duplicated) {
+                uniqueVertices.try_emplace(
+                    vertex, static_cast<uint32_t>(uniqueVertices.size()));
+              }
+              BenchmarkUtils::DoNotOptimize(uniqueVertices);
+            },
+    });
+  }
+}
+
+void RegisterLightChannelFixtures(const std::string& root,
+                                  const std::string& file) {
+  const std::string lightFile =
+      JsonUtils::ReadStringFromFile(root + file, "LightFile");
+
+  for (const int lightCount : ReadIntsFromFile(root + file, "LightCounts")) {
+    auto channel = std::make_shared<std::shared_ptr<LightChannel>>();
+    auto lights = std::make_shared<std::vector<std::shared_ptr<SunLight>>>();
+
+    BenchmarkUtils::RegisterFixture({
+        .name = "LightChannel/GetLights/" + std::to_string(lightCount),
+        .itemsPerRun = static_cast<size_t>(lightCount),
+        .setUp =
+            [=] {
+              *channel = BaseObject::CreateImmediately<LightChannel>(
+                  "BenchmarkChannel", false, root, file,
+                  std::shared_ptr<BaseObject>(nullptr));
+              for (int i = 0; i < lightCount; i++) {
+                lights->emplace_back(BaseObject::CreateImmediately<SunLight>(
+                    std::shared_ptr<SceneObject>(nullptr), "BenchmarkLight",
+                    root, lightFile, std::shared_ptr<BaseObject>(nullptr)));
+                (*channel)->AddLightToChannel(lights->back());
+              }
+            },
+        .run =
+            [=] {
+              float intensity = 0;
+              auto getLightsFunc = (*channel)->GetLights();
+              while (BaseLight* lightPtr = getLightsFunc()) {
+                intensity += lightPtr->GetIntensity();
+              }
+              BenchmarkUtils::DoNotOptimize(intensity);
+            },
+        .tearDown =
+            [=] {
+              lights->clear();
+              channel->reset();
+            },
+    });
+  }
+}
+
+void RegisterMeshFixtures(const std::string& root, const std::string& file,
+                          std::mt19937& rng) {
+  for (const int vertexCount :
+       ReadIntsFromFile(root + file, "VertexCounts")) {
+    auto meshData = std::make_shared<MeshData>();
+    meshData->state.alive = true;
+    meshData->vertices = GenerateVertexDatas(rng, vertexCount);
+
+    std::uniform_int_distribution<uint32_t> pick(0, vertexCount - 1);
+    meshData->indices.resize(static_cast<size_t>(vertexCount) / 2 * 3);
+    for (uint32_t& index : meshData->indices) {
+      index = pick(rng);
+    }
+    auto mesh = std::make_shared<Mesh*>(nullptr);
+
+    BenchmarkUtils::RegisterFixture({
+        .name = "Mesh/ParseVertexAndIndex/" + std::to_string(vertexCount),
+        .itemsPerRun = static_cast<size_t>(vertexCount),
+        .setUp =
+            [=] {
+              *mesh = new Mesh(nullptr);
+              BenchmarkUtils::MeshAccess::SetBridge(**mesh, meshData);
+            },
+        .run = [=] { BenchmarkUtils::MeshAccess::ParseVertexAndIndex(**mesh); },
+        .tearDown =
+            [=] {
+              (*mesh)->Destroy();
+              *mesh = nullptr;
+            },
+    });
+  }
+}
+
+std::pair<seconds, seconds> MeasureFixture(
+    const BenchmarkUtils::Fixture& fixture, uint64_t iterations) {
+  const std::clock_t cpuStart = std::clock();
+  const auto realStart = std::chrono::steady_clock::now();
+  for (uint64_t i = 0; i < iterations; i++) {
+    fixture.run();
+  }
+  const seconds realTime = std::chrono::steady_clock::now() - realStart;
+  const seconds cpuTime(static_cast<float>(std::clock() - cpuStart) /
+                        CLOCKS_PER_SEC);
+  return {realTime, cpuTime};
+}
+
+BenchmarkUtils::Result AggregateResults(
+    const std::vector<BenchmarkUtils::Result>& runs,
+    const std::string& aggregate) {
+  BenchmarkUtils::Result ret = runs.front();
+  ret.aggregate = aggregate;
+  ret.repetition = static_cast<int>(runs.size());
+
+  auto reduce = [&](double BenchmarkUtils::Result::*member) {
+    std::vector<double> values;
+    for (const auto& run : runs) {
+      values.emplace_back(run.*member);
+    }
+    const double mean = std::accumulate(values.begin(), values.end(), 0.0) /
+                        static_cast<double>(values.size());
+    if (aggregate == "median") {
+      std::sort(values.begin(), values.end());
+      const size_t mid = values.size() / 2;
+      return values.size() % 2 ? values[mid]
+                               : (values[mid - 1] + values[mid]) / 2;
+    }
+    if (aggregate == "stddev") {
+      if (values.size() < 2) {
+        return 0.0;
+      }
+      double variance = 0;
+      for (const double value : values) {
+        variance += (value - mean) * (value - mean);
+      }
+      return std::sqrt(variance / static_cast<double>(values.size() - 1));
+    }
+    return mean;
+  };
+  ret.realTime = reduce(&BenchmarkUtils::Result::realTime);
+  ret.cpuTime = reduce(&BenchmarkUtils::Result::cpuTime);
+  ret.itemsPerSecond = reduce(&BenchmarkUtils::Result::itemsPerSecond);
+  return ret;
+}
+
+void PrintResult(const BenchmarkUtils::Result& result) {
+  const std::string name = result.aggregate.empty()
+                               ? result.name
+                               : result.name + "_" + result.aggregate;
+  std::cout << std::left << std::setw(64) << name << std::right
+            << std::setw(16) << std::fixed << std::setprecision(1)
+            << result.realTime << " ns" << std::setw(16) << result.cpuTime
+            << " ns" << std::setw(14) << result.iterations << std::endl;
+}
+}  // namespace
+
+void BenchmarkUtils::RegisterFixture(Fixture fixture) {
+  GetFixtures().emplace_back(std::move(fixture));
+}
+
+void BenchmarkUtils::RegisterEngineFixtures(const std::string& root,
+                                            const std::string& file) {
+  std::mt19937 rng(JsonUtils::ReadIntFromFile(root + file, "Seed"));
+
+  RegisterTransformFixtures(root, file);
+  RegisterObjectFixtures(root, file);
+  RegisterJsonFixtures(root, file);
+  RegisterModelFixtures(root, file);
+  RegisterVertexFixtures(root, file, rng);
+  RegisterLightChannelFixtures(root, file);
+  RegisterMeshFixtures(root, file, rng);
+}
+
+std::vector<BenchmarkUtils::Result> BenchmarkUtils::RunFixtures(
+    const std::string& filter, float minTime, int repetitions) {
+  std::cout << std::left << std::setw(64) << "Benchmark" << std::right
+            << std::setw(19) << "Time" << std::setw(19) << "CPU"
+            << std::setw(14) << "Iterations" << std::endl;
+
+  std::vector<Result> results;
+  for (const Fixture& fixture : GetFixtures()) {
+    if (filter.empty() == false &&
+        fixture.name.find(filter) == std::string::npos) {
+      continue;
+    }
+    fixture.setUp();
+    const size_t itemsPerRun =
+        fixture.countItems ? fixture.countItems() : fixture.itemsPerRun;
+    fixture.run();
+
+    uint64_t iterations = 1;
+    while (true) {
+      const seconds realTime = MeasureFixture(fixture, iterations).first;
+      if (realTime.count() >= minTime || iterations >= MaxIterations) {
+        break;
+      }
+      const double multiplier =
+          realTime.count() > 0
+              ? std::clamp(minTime * 1.4 / realTime.count(), 2.0, 10.0)
+              : 10.0;
+      iterations = std::min(
+          MaxIterations, static_cast<uint64_t>(iterations * multiplier) + 1);
+    }
+
+    std::vector<Result> runs;
+    for (int i = 0; i < repetitions; i++) {
+      const auto [realTime, cpuTime] = MeasureFixture(fixture, iterations);
+      Result result{
+          .name = fixture.name,
+          .repetition = i,
+          .iterations = iterations,
+          .realTime = realTime.count() * 1e9 / iterations,
+          .cpuTime = cpuTime.count() * 1e9 / iterations,
+      };
+      if (realTime.count() > 0) {
+        result.itemsPerSecond =
+            static_cast<double>(itemsPerRun * iterations) /
+            realTime.count();
+      }
+      PrintResult(result);
+      runs.emplace_back(result);
+    }
+    fixture.tearDown();
+
+    results.insert(results.end(), runs.begin(), runs.end());
+    if (repetitions > 1) {
+      for (const std::string aggregate : {"mean", "median", "stddev"}) {
+        results.emplace_back(AggregateResults(runs, aggregate));
+        PrintResult(results.back());
+      }
+    }
+  }
+  return results;
+}
+
+void BenchmarkUtils::WriteResultsToFile(const std::string& filePath,
+                                        const std::vector<Result>& results) {
+  StringBuffer strBuf;
+  PrettyWriter writer(strBuf);
+
+  writer.StartObject();
+  writer.Key("context");
+  writer.StartObject();
+  writer.Key("date");
+  writer.String(std::format("{:%F %T}", std::chrono::floor<std::chrono::seconds>(
+                                            std::chrono::system_clock::now()))
+                    .c_str());
+  writer.Key("executable");
+  writer.String("EqnoEngine");
+  writer.Key("num_cpus");
+  writer.Uint(std::thread::hardware_concurrency());
+  writer.Key("library_build_type");
+#ifdef NDEBUG
+  writer.String("release");
+#else
+  writer.String("debug");
+#endif
+  writer.EndObject();
+
+  writer.Key("benchmarks");
+  writer.StartArray();
+  for (const Result& result : results) {
+    writer.StartObject();
+    writer.Key("name");
+    writer.String((result.aggregate.empty()
+                       ? result.name
+                       : result.name + "_" + result.aggregate)
+                      .c_str());
+    writer.Key("run_name");
+    writer.String(result.name.c_str());
+    writer.Key("run_type");
+    writer.String(result.aggregate.empty() ? "iteration" : "aggregate");
+    if (result.aggregate.empty()) {
+      writer.Key("repetition_index");
+      writer.Int(result.repetition);
+    } else {
+      writer.Key("repetitions");
+      writer.Int(result.repetition);
+      writer.Key("aggregate_name");
+      writer.String(result.aggregate.c_str());
+    }
+    writer.Key("threads");
+    writer.Int(1);
+    writer.Key("iterations");
+    writer.Uint64(result.iterations);
+    writer.Key("real_time");
+    writer.Double(result.realTime);
+    writer.Key("cpu_time");
+    writer.Double(result.cpuTime);
+    writer.Key("time_unit");
+    writer.String("ns");
+    writer.Key("items_per_second");
+    writer.Double(result.itemsPerSecond);
+    writer.EndObject();
+  }
+  writer.EndArray();
+  writer.EndObject();
+
+  FileUtils::WriteFileAsString(filePath + FILESUFFIX, strBuf.GetString());
+}
+
+int BenchmarkUtils::RunBenchmarks(const std::string& root,
+                                  const std::string& file,
+                                  const std::string& filter) {
+  const std::string filePath = root + file;
+  const float minTime = JsonUtils::ReadFloatFromFile(filePath, "MinTime");
+  const int repetitions = JsonUtils::ReadIntFromFile(filePath, "Repetitions");
+  const std::string outputFile =
+      JsonUtils::ReadStringFromFile(filePath, "OutputFile");
+
+  RegisterEngineFixtures(root, file);
+  const std::vector<Result> results = RunFixtures(
+      filter, minTime > 0 ? minTime : 0.5f, repetitions > 0 ? repetitions : 1);
+  WriteResultsToFile(root + outputFile, results);
+
+  std::cout << "Benchmark results: " << root + outputFile + FILESUFFIX
+            << std::endl;
+  ObjectPoolUtils::PrintPoolStats();
+  return EXIT_SUCCESS;
+}
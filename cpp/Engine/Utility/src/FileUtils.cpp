@@ -3,6 +3,7 @@
 #include <rapidjson/document.h>
 #include <rapidjson/rapidjson.h>
 
+#include <filesystem>
 #include <fstream>
 
 #include "Engine/System/include/Application.h"
@@ -36,6 +37,21 @@ std::string FileUtils::ReadFileAsString(const std::string& filePath) {
   throw std::runtime_error(errorMsg);
 }
 
+std::vector<char> FileUtils::ReadFileAsBytes(const std::string& filePath) {
+  if (std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+      file.is_open()) {
+    const size_t fileSize = file.tellg();
+    std::vector<char> buffer(fileSize);
+    file.seekg(0);
+    file.read(buffer.data(), static_cast<std::streamsize>(fileSize));
+    file.close();
+    return buffer;
+  }
+  std::string errorMsg = "failed to open file: " + filePath;
+  std::cout << errorMsg << std::endl;
+  throw std::runtime_error(errorMsg);
+}
+
 void FileUtils::WriteFileAsUIntegers(const std::string& filePath,
                                      const int writeMode,
                                      const UIntegers& fileContent) {
@@ -61,3 +77,37 @@ void FileUtils::WriteFileAsString(const std::string& filePath,
     throw std::runtime_error(errorMsg);
   }
 }
+
+void FileUtils::WriteFileAsBytes(const std::string& filePath,
+                                 const std::vector<char>& fileContent) {
+  if (std::ofstream file(filePath, std::ios::binary); file.is_open()) {
+    file.write(fileContent.data(),
+               static_cast<std::streamsize>(fileContent.size()));
+    file.close();
+  } else {
+    std::string errorMsg = "failed to open file: " + filePath;
+    std::cout << errorMsg << std::endl;
+    throw std::runtime_error(errorMsg);
+  }
+}
+
+void FileUtils::WriteFileAtomically(const std::string& filePath,
+                                    const std::string& fileContent) {
+  const std::string tempPath = filePath + ".tmp";
+  if (std::ofstream file(tempPath, std::ios::binary); file.is_open()) {
+    file.write(fileContent.data(),
+               static_cast<std::streamsize>(fileContent.size()));
+    file.close();
+    if (!file) {
+      std::filesystem::remove(tempPath);
+      std::string errorMsg = "failed to write file: " + tempPath;
+      std::cout << errorMsg << std::endl;
+      throw std::runtime_error(errorMsg);
+    }
+  } else {
+    std::string errorMsg = "failed to open file: " + tempPath;
+    std::cout << errorMsg << std::endl;
+    throw std::runtime_error(errorMsg);
+  }
+  std::filesystem::rename(tempPath, filePath);
+}
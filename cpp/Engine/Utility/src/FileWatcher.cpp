@@ -0,0 +1,95 @@
+#include "../include/FileWatcher.h"
+
+#include <ranges>
+
+void FileWatcher::ScanDirectory(const std::string& directory,
+                                WriteTimes& times) {
+  std::error_code error;
+  for (auto iter = std::filesystem::recursive_directory_iterator(directory,
+                                                                 error);
+       !error && iter != std::filesystem::recursive_directory_iterator();
+       iter.increment(error)) {
+    if (iter->is_regular_file(error)) {
+      // Files being rewritten may vanish between listing and stat
+      const auto writeTime = iter->last_write_time(error);
+      if (!error) {
+        times[iter->path().lexically_normal().generic_string()] = writeTime;
+      }
+      error.clear();
+    }
+  }
+}
+
+void FileWatcher::Poll() {
+  std::vector<std::string> watched;
+  {
+    std::lock_guard lock(watchMutex);
+    watched = directories;
+  }
+  // Scan without the lock, it touches the disk
+  WriteTimes current;
+  for (const std::string& directory : watched) {
+    ScanDirectory(directory, current);
+  }
+
+  std::lock_guard lock(watchMutex);
+  for (const auto& [path, writeTime] : current) {
+    if (const auto iter = writeTimes.find(path);
+        iter == writeTimes.end() || iter->second != writeTime) {
+      changes.insert(path);
+    }
+  }
+  for (const auto& path : writeTimes | std::views::keys) {
+    if (current.contains(path) == false) {
+      changes.insert(path);
+    }
+  }
+  writeTimes.swap(current);
+}
+
+void FileWatcher::PollLoop(const std::chrono::milliseconds interval) {
+  std::unique_lock lock(watchMutex);
+  while (stopping == false) {
+    if (stopCondition.wait_for(lock, interval, [this] { return stopping; })) {
+      break;
+    }
+    lock.unlock();
+    Poll();
+    lock.lock();
+  }
+}
+
+void FileWatcher::WatchDirectory(const std::string& directory) {
+  WriteTimes times;
+  ScanDirectory(directory, times);
+
+  std::lock_guard lock(watchMutex);
+  directories.push_back(directory);
+  writeTimes.merge(times);
+}
+
+void FileWatcher::Start(const std::chrono::milliseconds interval) {
+  std::lock_guard lock(watchMutex);
+  if (pollThread.joinable() == false) {
+    stopping = false;
+    pollThread = std::thread(&FileWatcher::PollLoop, this, interval);
+  }
+}
+
+void FileWatcher::Stop() {
+  {
+    std::lock_guard lock(watchMutex);
+    stopping = true;
+  }
+  stopCondition.notify_one();
+  if (pollThread.joinable()) {
+    pollThread.join();
+  }
+}
+
+std::vector<std::string> FileWatcher::TakeChanges() {
+  std::lock_guard lock(watchMutex);
+  std::vector<std::string> res(changes.begin(), changes.end());
+  changes.clear();
+  return res;
+}
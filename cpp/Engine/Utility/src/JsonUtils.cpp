@@ -8,22 +8,194 @@
 #include <Engine/Scene/include/SceneObject.h>
 #include <Engine/Utility/include/FileUtils.h>
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <mutex>
+#include <thread>
 #include <ranges>
 #include <unordered_map>
 
 using namespace rapidjson;
-std::unordered_map<std::string, std::shared_ptr<Document>> docCache;
+using DocumentCache =
+    std::unordered_map<std::string, std::shared_ptr<Document>>;
+
+// Readers take the whole cache with one atomic load. Writers copy the map and
+// the document they change, then publish the copy, so a document a reader
+// holds is never mutated or freed underneath it. Documents parsed on a miss
+// wait in recentDocs, under cacheMutex, until there are as many of them as
+// published ones, so loading N documents copies the map O(log N) times.
+std::atomic<std::shared_ptr<const DocumentCache>> docCache =
+    std::make_shared<const DocumentCache>();
+DocumentCache recentDocs;
+std::mutex cacheMutex;
+std::mutex writeMutex;
+
+// Called with cacheMutex held
+std::shared_ptr<DocumentCache> CopyDocumentCache() {
+  auto cache = std::make_shared<DocumentCache>(*docCache.load());
+  cache->merge(recentDocs);
+  recentDocs.clear();
+  return cache;
+}
+
+void PublishDocument(const std::string& filePath,
+                     std::shared_ptr<Document> doc) {
+  std::lock_guard lock(cacheMutex);
+  auto cache = CopyDocumentCache();
+  (*cache)[filePath] = std::move(doc);
+  docCache.store(std::move(cache));
+}
+
+// Changed documents are queued instead of written right away. Changes to one
+// file coalesce into a single write, which a background thread performs once
+// no change arrived for WriteDebounce, through a temp file and a rename.
+// Writes are keyed by document path, the form InvalidateDocument compares.
+class DocumentWriter {
+  static constexpr std::chrono::milliseconds WriteDebounce{500};
+
+  struct PendingWrite {
+    std::string filePath;
+    std::shared_ptr<const Document> doc;
+    std::string content;
+  };
+  using PendingWrites = std::unordered_map<std::string, PendingWrite>;
+
+  std::mutex pendingMutex;
+  std::mutex flushMutex;
+  std::condition_variable pendingCondition;
+  PendingWrites pending;
+  std::chrono::steady_clock::time_point lastQueued;
+  std::thread flushThread;
+  bool stopping = false;
+
+  static void WriteBatch(PendingWrites& batch) {
+    for (auto& write : batch | std::views::values) {
+      if (write.doc) {
+        StringBuffer strBuf;
+        Writer writer(strBuf);
+
+        write.doc->Accept(writer);
+        write.content = strBuf.GetString();
+      }
+      try {
+        FileUtils::WriteFileAtomically(write.filePath, write.content);
+      } catch (const std::exception& e) {
+        PRINT_ERROR(e.what());
+      }
+    }
+  }
+  void FlushLoop() {
+    std::unique_lock lock(pendingMutex);
+    while (true) {
+      pendingCondition.wait(lock,
+                            [this] { return stopping || !pending.empty(); });
+      if (stopping) {
+        break;
+      }
+      if (auto deadline = lastQueued + WriteDebounce;
+          std::chrono::steady_clock::now() < deadline) {
+        pendingCondition.wait_until(lock, deadline);
+        continue;
+      }
+      lock.unlock();
+      Flush();
+      lock.lock();
+    }
+  }
+  void Enqueue(PendingWrite write) {
+    const std::string documentPath = JsonUtils::GetDocumentPath(write.filePath);
+    {
+      std::lock_guard lock(pendingMutex);
+      pending[documentPath] = std::move(write);
+      lastQueued = std::chrono::steady_clock::now();
+      if (!flushThread.joinable()) {
+        flushThread = std::thread(&DocumentWriter::FlushLoop, this);
+      }
+    }
+    pendingCondition.notify_one();
+  }
+
+ public:
+  ~DocumentWriter() {
+    {
+      std::lock_guard lock(pendingMutex);
+      stopping = true;
+    }
+    pendingCondition.notify_one();
+    if (flushThread.joinable()) {
+      flushThread.join();
+    }
+    Flush();
+  }
+
+  void Queue(const std::string& filePath, std::shared_ptr<const Document> doc) {
+    Enqueue({filePath, std::move(doc), {}});
+  }
+  void Queue(const std::string& filePath, std::string content) {
+    Enqueue({filePath, nullptr, std::move(content)});
+  }
+  bool HasPending(const std::string& documentPath) {
+    std::lock_guard lock(pendingMutex);
+    return pending.contains(documentPath);
+  }
+  std::shared_ptr<const Document> GetPending(const std::string& documentPath) {
+    std::lock_guard lock(pendingMutex);
+    const auto writeIter = pending.find(documentPath);
+    return writeIter != pending.end() ? writeIter->second.doc : nullptr;
+  }
+  void Flush() {
+    std::lock_guard flushLock(flushMutex);
+    PendingWrites batch;
+    {
+      std::lock_guard lock(pendingMutex);
+      batch.swap(pending);
+    }
+    WriteBatch(batch);
+  }
+} documentWriter;
+
+std::shared_ptr<Document> CopyDocumentFromFile(const std::string& filePath) {
+  std::shared_ptr<Document> doc = std::make_shared<Document>();
+  doc->CopyFrom(*JsonUtils::GetJsonDocFromFile(filePath), doc->GetAllocator());
+  return doc;
+}
 
 std::shared_ptr<Document> JsonUtils::GetJsonDocFromFile(
     const std::string& filePath) {
-  std::shared_ptr<Document> doc;
-  if (const auto docIter = docCache.find(filePath); docIter != docCache.end()) {
-    doc = docIter->second;
-  } else {
-    doc = std::make_shared<Document>();
-    doc->SetObject();
-    doc->Parse(FileUtils::ReadFileAsString(filePath + FILESUFFIX).c_str());
-    docCache[filePath] = doc;
+  {
+    const std::shared_ptr<const DocumentCache> cache = docCache.load();
+    if (const auto docIter = cache->find(filePath); docIter != cache->end()) {
+      return docIter->second;
+    }
+  }
+  {
+    std::lock_guard lock(cacheMutex);
+    if (const auto docIter = recentDocs.find(filePath);
+        docIter != recentDocs.end()) {
+      return docIter->second;
+    }
+  }
+  // A write queued without a cached document is newer than the file
+  if (documentWriter.HasPending(GetDocumentPath(filePath))) {
+    documentWriter.Flush();
+  }
+  std::shared_ptr<Document> doc = std::make_shared<Document>();
+  doc->SetObject();
+  doc->Parse(FileUtils::ReadFileAsString(filePath + FILESUFFIX).c_str());
+
+  std::lock_guard lock(cacheMutex);
+  const std::shared_ptr<const DocumentCache> cache = docCache.load();
+  if (const auto docIter = cache->find(filePath); docIter != cache->end()) {
+    return docIter->second;
+  }
+  if (const auto [docIter, inserted] = recentDocs.try_emplace(filePath, doc);
+      !inserted) {
+    return docIter->second;
+  }
+  if (recentDocs.size() >= cache->size()) {
+    docCache.store(CopyDocumentCache());
   }
   return doc;
 }
@@ -169,7 +341,7 @@ void TravelSceneObjectTree(std::weak_ptr<GraphicsInterface> graphics,
           std::static_pointer_cast<BaseCamera>(object)->SetMoveSpeed(
               params["MoveSpeed"].GetFloat());
         }
-        if (params.HasMember("speedIncreasingRate")) {
+        if (params.HasMember("SpeedIncreasingRate")) {
           std::static_pointer_cast<BaseCamera>(object)->SetSpeedIncreasingRate(
               params["SpeedIncreasingRate"].GetFloat());
         }
@@ -308,15 +480,15 @@ void JsonUtils::ParseSceneLightChannels(const std::string& root,
                                                       false, root, file, owner);
       for (SizeType i = 0; i < iter->value.Size(); ++i) {
         if (auto ownerPtr = owner.lock()) {
-          std::weak_ptr<BaseLight> light =
-              ownerPtr->GetLightByName(iter->value[i].GetString());
+          std::weak_ptr<BaseLight> light = ownerPtr->GetLightByName(
+              StringIdUtils::Intern(iter->value[i].GetString()));
           object->AddLightToChannel(light);
         }
       }
     }
   }
   if (auto ownerPtr = owner.lock()) {
-    if (!ownerPtr->GetLightChannelByName("All").lock()) {
+    if (!ownerPtr->GetLightChannelByName("All"_sid).lock()) {
       std::shared_ptr<LightChannel> object =
           BaseObject::CreateImmediately<LightChannel>("All", false, root, file,
                                                       owner);
@@ -386,8 +558,8 @@ void JsonUtils::ParseMaterialParams(const std::string& filePath,
 void JsonUtils::WriteStringToFile(const std::string& filePath,
                                   const std::string& key,
                                   const std::string& value) {
+  std::lock_guard writeLock(writeMutex);
   std::shared_ptr<Document> doc = std::make_shared<Document>();
-  docCache[filePath] = doc;
 
   doc->SetObject();
   auto& allocator = doc->GetAllocator();
@@ -404,19 +576,16 @@ void JsonUtils::WriteStringToFile(const std::string& filePath,
     return;
   }
   doc->AddMember(strKey, strValue, allocator);
+  PublishDocument(filePath, doc);
 
-  StringBuffer strBuf;
-  Writer writer(strBuf);
-
-  doc->Accept(writer);
-  FileUtils::WriteFileAsString(filePath, strBuf.GetString());
+  documentWriter.Queue(filePath, doc);
 }
 
 void JsonUtils::WriteStringsToFile(const std::string& filePath,
                                    const std::string& key,
                                    const std::vector<std::string>& values) {
+  std::lock_guard writeLock(writeMutex);
   std::shared_ptr<Document> doc = std::make_shared<Document>();
-  docCache[filePath] = doc;
 
   doc->SetObject();
   auto& allocator = doc->GetAllocator();
@@ -438,18 +607,15 @@ void JsonUtils::WriteStringsToFile(const std::string& filePath,
     return;
   }
   doc->AddMember(strKey, strValue, allocator);
+  PublishDocument(filePath, doc);
 
-  StringBuffer strBuf;
-  Writer writer(strBuf);
-
-  doc->Accept(writer);
-  FileUtils::WriteFileAsString(filePath, strBuf.GetString());
+  documentWriter.Queue(filePath, doc);
 }
 
 void JsonUtils::WriteBoolToFile(const std::string& filePath,
                                 const std::string& key, bool value) {
+  std::lock_guard writeLock(writeMutex);
   std::shared_ptr<Document> doc = std::make_shared<Document>();
-  docCache[filePath] = doc;
 
   doc->SetObject();
   auto& allocator = doc->GetAllocator();
@@ -465,12 +631,9 @@ void JsonUtils::WriteBoolToFile(const std::string& filePath,
     return;
   }
   doc->AddMember(strKey, strValue, allocator);
+  PublishDocument(filePath, doc);
 
-  StringBuffer strBuf;
-  Writer writer(strBuf);
-
-  doc->Accept(writer);
-  FileUtils::WriteFileAsString(filePath + FILESUFFIX, strBuf.GetString());
+  documentWriter.Queue(filePath + FILESUFFIX, doc);
 }
 
 void JsonUtils::WriteDocumentToFile(const std::string& filePath,
@@ -481,15 +644,16 @@ void JsonUtils::WriteDocumentToFile(const std::string& filePath,
     Writer writer(strBuf);
 
     doc->Accept(writer);
-    FileUtils::WriteFileAsString(filePath + (withSuffix ? FILESUFFIX : ""),
-                                 strBuf.GetString());
+    documentWriter.Queue(filePath + (withSuffix ? FILESUFFIX : ""),
+                         strBuf.GetString());
   }
 }
 
 void JsonUtils::AppendStringToFile(const std::string& filePath,
                                    const std::string& key,
                                    const std::string& value) {
-  std::shared_ptr<Document> doc = GetJsonDocFromFile(filePath);
+  std::lock_guard writeLock(writeMutex);
+  std::shared_ptr<Document> doc = CopyDocumentFromFile(filePath);
   auto& allocator = doc->GetAllocator();
 
   if (doc->HasMember(key.c_str())) {
@@ -510,42 +674,87 @@ void JsonUtils::AppendStringToFile(const std::string& filePath,
     doc->AddMember(strKey, strValue, allocator);
   }
 
-  StringBuffer strBuf;
-  Writer writer(strBuf);
+  PublishDocument(filePath, doc);
 
-  doc->Accept(writer);
-  FileUtils::WriteFileAsString(filePath + FILESUFFIX, strBuf.GetString());
+  documentWriter.Queue(filePath + FILESUFFIX, doc);
 }
 
 void JsonUtils::ModifyBoolOfFile(const std::string& filePath,
                                  const std::string& key, bool value) {
-  if (std::shared_ptr<Document> doc = GetJsonDocFromFile(filePath);
+  std::lock_guard writeLock(writeMutex);
+  if (std::shared_ptr<Document> doc = CopyDocumentFromFile(filePath);
       doc->HasMember(key.c_str())) {
     (*doc)[key.c_str()].SetBool(value);
+    PublishDocument(filePath, doc);
 
-    StringBuffer strBuf;
-    Writer writer(strBuf);
-
-    doc->Accept(writer);
-    FileUtils::WriteFileAsString(filePath + FILESUFFIX, strBuf.GetString());
+    documentWriter.Queue(filePath + FILESUFFIX, doc);
   }
 }
 
 void JsonUtils::ModifyIntOfFile(const std::string& filePath,
                                 const std::string& key, int value) {
-  if (std::shared_ptr<Document> doc = GetJsonDocFromFile(filePath);
+  std::lock_guard writeLock(writeMutex);
+  if (std::shared_ptr<Document> doc = CopyDocumentFromFile(filePath);
       doc->HasMember(key.c_str())) {
     (*doc)[key.c_str()].SetInt(value);
+    PublishDocument(filePath, doc);
 
-    StringBuffer strBuf;
-    Writer writer(strBuf);
+    documentWriter.Queue(filePath + FILESUFFIX, doc);
+  }
+}
 
-    doc->Accept(writer);
-    FileUtils::WriteFileAsString(filePath + FILESUFFIX, strBuf.GetString());
+void JsonUtils::EditDocument(
+    const std::string& filePath,
+    const std::function<void(rapidjson::Document&)>& edit) {
+  std::lock_guard writeLock(writeMutex);
+  std::shared_ptr<Document> doc = CopyDocumentFromFile(filePath);
+  edit(*doc);
+  PublishDocument(filePath, doc);
+
+  documentWriter.Queue(filePath + FILESUFFIX, doc);
+}
+
+void JsonUtils::FlushPendingWrites() { documentWriter.Flush(); }
+
+std::string JsonUtils::GetDocumentPath(const std::string& filePath) {
+  std::string path = filePath;
+  if (path.ends_with(FILESUFFIX)) {
+    path.resize(path.size() - std::string_view(FILESUFFIX).size());
+  }
+  return std::filesystem::path(path).lexically_normal().string();
+}
+
+void JsonUtils::InvalidateDocument(const std::string& filePath) {
+  // Cached documents with queued writes are newer than the file
+  const std::string documentPath = GetDocumentPath(filePath);
+  std::lock_guard lock(cacheMutex);
+  if (documentWriter.HasPending(documentPath)) {
+#ifndef NDEBUG
+    // The edit that survives the reload must be the one being written
+    const std::shared_ptr<const Document> pendingDoc =
+        documentWriter.GetPending(documentPath);
+    for (const auto& [cachePath, doc] : *docCache.load()) {
+      if (pendingDoc && doc != pendingDoc &&
+          GetDocumentPath(cachePath) == documentPath) {
+        PRINT_ERROR("cached " + cachePath + " differs from its queued write");
+      }
+    }
+#endif
+    return;
   }
+  auto cache = CopyDocumentCache();
+  std::erase_if(*cache, [&documentPath](const auto& entry) {
+    return GetDocumentPath(entry.first) == documentPath;
+  });
+  docCache.store(std::move(cache));
 }
 
-void JsonUtils::ClearDocumentCache() { docCache.clear(); }
+void JsonUtils::ClearDocumentCache() {
+  documentWriter.Flush();
+  std::lock_guard lock(cacheMutex);
+  recentDocs.clear();
+  docCache.store(std::make_shared<const DocumentCache>());
+}
 
 std::unordered_map<TextureType, std::string> JsonUtils::GetCombineTextures(
     const std::string& filePath) {
@@ -0,0 +1,663 @@
+#include "../include/MeshUtils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <unordered_map>
+
+namespace {
+constexpr uint32_t Unassigned = std::numeric_limits<uint32_t>::max();
+
+// Forsyth's scoring, tuned for a cache larger than the one simulated
+constexpr int ScoreCacheSize = 32;
+constexpr float CacheDecayPower = 1.5f;
+constexpr float LastTriangleScore = 0.75f;
+constexpr float ValenceBoostScale = 2.0f;
+constexpr float ValenceBoostPower = 0.5f;
+
+float VertexScore(const int cachePosition, const uint32_t remaining) {
+  if (remaining == 0) {
+    return -1.0f;
+  }
+  float score = 0;
+  if (cachePosition >= 0 && cachePosition < 3) {
+    score = LastTriangleScore;
+  } else if (cachePosition >= 3) {
+    score = std::pow(1.0f - static_cast<float>(cachePosition - 3) /
+                                (ScoreCacheSize - 3),
+                     CacheDecayPower);
+  }
+  const float valence = static_cast<float>(remaining);
+  return score + ValenceBoostScale * std::pow(valence, -ValenceBoostPower);
+}
+
+// Counts the vertex shader runs of a FIFO cache, a vertex is cached while
+// fewer than CacheSize misses happened since it was loaded. Calls onTriangle
+// with the index of every triangle and the number of its vertices missed.
+template <typename Func>
+uint32_t SimulateVertexCache(const std::vector<uint32_t>& indices,
+                             const size_t vertexCount, Func&& onTriangle) {
+  std::vector<uint32_t> loadTime(vertexCount, 0);
+  uint32_t time = MeshUtils::CacheSize + 1;
+  uint32_t misses = 0;
+  for (size_t i = 0; i < indices.size(); i += 3) {
+    uint32_t triangleMisses = 0;
+    for (size_t j = 0; j < 3; j++) {
+      if (time - loadTime[indices[i + j]] > MeshUtils::CacheSize) {
+        loadTime[indices[i + j]] = time++;
+        triangleMisses++;
+      }
+    }
+    misses += triangleMisses;
+    onTriangle(i / 3, triangleMisses);
+  }
+  return misses;
+}
+
+glm::vec3 TriangleCross(const std::vector<uint32_t>& indices,
+                        const std::vector<VertexData>& vertices,
+                        const size_t triangle) {
+  const glm::vec3& p0 = vertices[indices[triangle * 3]].pos;
+  const glm::vec3& p1 = vertices[indices[triangle * 3 + 1]].pos;
+  const glm::vec3& p2 = vertices[indices[triangle * 3 + 2]].pos;
+  return glm::cross(p1 - p0, p2 - p0);
+}
+
+glm::vec3 TriangleCentroid(const std::vector<uint32_t>& indices,
+                           const std::vector<VertexData>& vertices,
+                           const size_t triangle) {
+  return (vertices[indices[triangle * 3]].pos +
+          vertices[indices[triangle * 3 + 1]].pos +
+          vertices[indices[triangle * 3 + 2]].pos) /
+         3.0f;
+}
+
+void ComputeMeshletBounds(Meshlet& meshlet, const MeshletData& data,
+                          const std::vector<VertexData>& vertices) {
+  const auto position = [&](const uint32_t local) -> const glm::vec3& {
+    return vertices[data.vertices[meshlet.vertexOffset + local]].pos;
+  };
+  glm::vec3 posMin(std::numeric_limits<float>::max());
+  glm::vec3 posMax(std::numeric_limits<float>::lowest());
+  for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+    posMin = glm::min(posMin, position(i));
+    posMax = glm::max(posMax, position(i));
+  }
+  meshlet.center = (posMin + posMax) * 0.5f;
+  meshlet.radius = 0;
+  for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+    meshlet.radius =
+        std::max(meshlet.radius, glm::length(position(i) - meshlet.center));
+  }
+
+  std::vector<glm::vec3> normals;
+  glm::vec3 normalSum(0);
+  for (uint32_t i = 0; i < meshlet.triangleCount; i++) {
+    const uint8_t* local = &data.triangles[meshlet.triangleOffset + i * 3];
+    const glm::vec3& p0 = position(local[0]);
+    const glm::vec3 normal =
+        glm::cross(position(local[1]) - p0, position(local[2]) - p0);
+    if (const float length = glm::length(normal); length > 0) {
+      normals.push_back(normal / length);
+      normalSum += normals.back();
+    }
+  }
+  meshlet.coneAxis = glm::vec3(0, 0, 1);
+  meshlet.coneCutoff = 1;
+  if (normals.empty() || glm::length(normalSum) == 0) {
+    return;
+  }
+  meshlet.coneAxis = glm::normalize(normalSum);
+  float minDot = 1;
+  for (const glm::vec3& normal : normals) {
+    minDot = std::min(minDot, glm::dot(normal, meshlet.coneAxis));
+  }
+  // Spreads near or past a hemisphere cannot be culled as a whole
+  if (minDot > 0.1f) {
+    meshlet.coneCutoff = std::sqrt(1 - minDot * minDot);
+  }
+}
+
+// Sum of squared distances to planes, weighted by the area of the triangle
+// each plane came from. Error divides by the total area, so it is a mean
+// squared distance.
+struct Quadric {
+  double a2 = 0, b2 = 0, c2 = 0, d2 = 0;
+  double ab = 0, ac = 0, ad = 0, bc = 0, bd = 0, cd = 0;
+  double weight = 0;
+
+  void AddPlane(const glm::dvec3& normal, const double d, const double area) {
+    a2 += area * normal.x * normal.x;
+    b2 += area * normal.y * normal.y;
+    c2 += area * normal.z * normal.z;
+    d2 += area * d * d;
+    ab += area * normal.x * normal.y;
+    ac += area * normal.x * normal.z;
+    ad += area * normal.x * d;
+    bc += area * normal.y * normal.z;
+    bd += area * normal.y * d;
+    cd += area * normal.z * d;
+    weight += area;
+  }
+
+  Quadric& operator+=(const Quadric& other) {
+    a2 += other.a2, b2 += other.b2, c2 += other.c2, d2 += other.d2;
+    ab += other.ab, ac += other.ac, ad += other.ad;
+    bc += other.bc, bd += other.bd, cd += other.cd;
+    weight += other.weight;
+    return *this;
+  }
+
+  [[nodiscard]] double Error(const glm::vec3& pos) const {
+    const double x = pos.x, y = pos.y, z = pos.z;
+    const double error = a2 * x * x + b2 * y * y + c2 * z * z +
+                         2 * (ab * x * y + ac * x * z + bc * y * z) +
+                         2 * (ad * x + bd * y + cd * z) + d2;
+    return weight > 0 ? std::max(error, 0.0) / weight : 0;
+  }
+};
+
+uint64_t EdgeKey(const uint32_t a, const uint32_t b) {
+  return static_cast<uint64_t>(std::min(a, b)) << 32 | std::max(a, b);
+}
+
+struct Collapse {
+  uint32_t from;
+  uint32_t to;
+  double error;
+};
+}  // namespace
+
+MeshUtils::VertexCacheStats MeshUtils::AnalyzeVertexCache(
+    const std::vector<uint32_t>& indices, const size_t vertexCount) {
+  if (indices.empty()) {
+    return {};
+  }
+  const uint32_t misses =
+      SimulateVertexCache(indices, vertexCount, [](size_t, uint32_t) {});
+  std::vector<bool> used(vertexCount, false);
+  for (const uint32_t index : indices) {
+    used[index] = true;
+  }
+  const auto usedCount = std::ranges::count(used, true);
+  return {
+      .acmr = static_cast<float>(misses) / (indices.size() / 3),
+      .atvr = static_cast<float>(misses) / usedCount,
+  };
+}
+
+void MeshUtils::OptimizeVertexCache(std::vector<uint32_t>& indices,
+                                    const size_t vertexCount) {
+  const size_t triangleCount = indices.size() / 3;
+  if (triangleCount == 0) {
+    return;
+  }
+
+  // Triangles of every vertex, the first remaining[v] are not emitted yet
+  std::vector<uint32_t> offsets(vertexCount + 1, 0);
+  for (const uint32_t index : indices) {
+    offsets[index + 1]++;
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  std::vector<uint32_t> adjacency(indices.size());
+  std::vector<uint32_t> remaining(vertexCount, 0);
+  for (size_t i = 0; i < indices.size(); i++) {
+    const uint32_t vertex = indices[i];
+    adjacency[offsets[vertex] + remaining[vertex]++] =
+        static_cast<uint32_t>(i / 3);
+  }
+
+  std::vector<int> cachePosition(vertexCount, -1);
+  std::vector<float> vertexScores(vertexCount);
+  for (size_t v = 0; v < vertexCount; v++) {
+    vertexScores[v] = VertexScore(-1, remaining[v]);
+  }
+  std::vector<float> triangleScores(triangleCount, 0);
+  for (size_t i = 0; i < indices.size(); i++) {
+    triangleScores[i / 3] += vertexScores[indices[i]];
+  }
+  std::vector<bool> emitted(triangleCount, false);
+
+  std::vector<uint32_t> result;
+  result.reserve(indices.size());
+  std::vector<uint32_t> cache, nextCache;
+  size_t scanTriangle = 0;
+  int64_t best = std::distance(triangleScores.begin(),
+                               std::ranges::max_element(triangleScores));
+
+  while (result.size() < indices.size()) {
+    if (best < 0) {
+      // Nothing left around the cache, continue with the next triangle in
+      // input order
+      while (emitted[scanTriangle]) {
+        scanTriangle++;
+      }
+      best = static_cast<int64_t>(scanTriangle);
+    }
+    emitted[best] = true;
+    const uint32_t* triangle = &indices[best * 3];
+    for (size_t j = 0; j < 3; j++) {
+      const uint32_t vertex = triangle[j];
+      result.push_back(vertex);
+      const auto begin = adjacency.begin() + offsets[vertex];
+      const auto end = begin + remaining[vertex];
+      const auto iter = std::find(begin, end, static_cast<uint32_t>(best));
+      if (iter != end) {
+        std::iter_swap(iter, end - 1);
+        remaining[vertex]--;
+      }
+    }
+
+    nextCache.assign(triangle, triangle + 3);
+    for (const uint32_t vertex : cache) {
+      if (vertex != triangle[0] && vertex != triangle[1] &&
+          vertex != triangle[2]) {
+        nextCache.push_back(vertex);
+      }
+    }
+    for (size_t i = 0; i < nextCache.size(); i++) {
+      const uint32_t vertex = nextCache[i];
+      cachePosition[vertex] = i < ScoreCacheSize ? static_cast<int>(i) : -1;
+      const float score =
+          VertexScore(cachePosition[vertex], remaining[vertex]);
+      const float delta = score - vertexScores[vertex];
+      vertexScores[vertex] = score;
+      for (uint32_t k = 0; k < remaining[vertex]; k++) {
+        triangleScores[adjacency[offsets[vertex] + k]] += delta;
+      }
+    }
+    nextCache.resize(std::min<size_t>(nextCache.size(), ScoreCacheSize));
+    std::swap(cache, nextCache);
+
+    best = -1;
+    float bestScore = -1;
+    for (const uint32_t vertex : cache) {
+      for (uint32_t k = 0; k < remaining[vertex]; k++) {
+        const uint32_t candidate = adjacency[offsets[vertex] + k];
+        if (triangleScores[candidate] > bestScore) {
+          bestScore = triangleScores[candidate];
+          best = candidate;
+        }
+      }
+    }
+  }
+  indices = std::move(result);
+}
+
+void MeshUtils::OptimizeOverdraw(std::vector<uint32_t>& indices,
+                                 const std::vector<VertexData>& vertices,
+                                 const float threshold) {
+  const size_t triangleCount = indices.size() / 3;
+  if (triangleCount == 0) {
+    return;
+  }
+  struct Cluster {
+    size_t begin;
+    size_t end;
+    float sortKey;
+  };
+  std::vector<Cluster> clusters;
+  const uint32_t misses = SimulateVertexCache(
+      indices, vertices.size(),
+      [&clusters](const size_t triangle, const uint32_t triangleMisses) {
+        if (triangle == 0 || triangleMisses == 3) {
+          if (clusters.empty() == false) {
+            clusters.back().end = triangle;
+          }
+          clusters.push_back({triangle, 0, 0});
+        }
+      });
+  clusters.back().end = triangleCount;
+  if (clusters.size() < 2) {
+    return;
+  }
+
+  glm::vec3 meshCentroid(0);
+  float meshArea = 0;
+  for (size_t t = 0; t < triangleCount; t++) {
+    const float area = glm::length(TriangleCross(indices, vertices, t));
+    meshCentroid += TriangleCentroid(indices, vertices, t) * area;
+    meshArea += area;
+  }
+  meshCentroid /= std::max(meshArea, std::numeric_limits<float>::min());
+
+  for (Cluster& cluster : clusters) {
+    glm::vec3 centroid(0), normal(0);
+    float area = 0;
+    for (size_t t = cluster.begin; t < cluster.end; t++) {
+      const glm::vec3 cross = TriangleCross(indices, vertices, t);
+      const float triangleArea = glm::length(cross);
+      centroid += TriangleCentroid(indices, vertices, t) * triangleArea;
+      normal += cross;
+      area += triangleArea;
+    }
+    if (area == 0 || glm::length(normal) == 0) {
+      continue;
+    }
+    cluster.sortKey = glm::dot(centroid / area - meshCentroid,
+                               glm::normalize(normal));
+  }
+  std::ranges::stable_sort(clusters, std::ranges::greater(),
+                           &Cluster::sortKey);
+
+  std::vector<uint32_t> sorted;
+  sorted.reserve(indices.size());
+  for (const Cluster& cluster : clusters) {
+    sorted.insert(sorted.end(), indices.begin() + cluster.begin * 3,
+                  indices.begin() + cluster.end * 3);
+  }
+  const uint32_t sortedMisses =
+      SimulateVertexCache(sorted, vertices.size(), [](size_t, uint32_t) {});
+  if (sortedMisses <= misses * threshold) {
+    indices = std::move(sorted);
+  }
+}
+
+void MeshUtils::OptimizeVertexFetch(std::vector<uint32_t>& indices,
+                                    std::vector<VertexData>& vertices) {
+  std::vector<uint32_t> remap(vertices.size(), Unassigned);
+  std::vector<VertexData> reordered;
+  reordered.reserve(vertices.size());
+  for (uint32_t& index : indices) {
+    if (remap[index] == Unassigned) {
+      remap[index] = static_cast<uint32_t>(reordered.size());
+      reordered.push_back(vertices[index]);
+    }
+    index = remap[index];
+  }
+  vertices = std::move(reordered);
+}
+
+void MeshUtils::OptimizeGeometry(const uint32_t passes,
+                                 std::vector<uint32_t>& indices,
+                                 std::vector<VertexData>& vertices) {
+  if (passes & VertexCacheGeometryPass) {
+    OptimizeVertexCache(indices, vertices.size());
+  }
+  if (passes & OverdrawGeometryPass) {
+    OptimizeOverdraw(indices, vertices);
+  }
+  if (passes & VertexFetchGeometryPass) {
+    OptimizeVertexFetch(indices, vertices);
+  }
+}
+
+std::vector<MeshUtils::MeshChunk> MeshUtils::SplitMesh(
+    const std::vector<uint32_t>& indices,
+    const std::vector<VertexData>& vertices, const uint32_t maxVertices) {
+  std::vector<MeshChunk> chunks(1);
+  std::vector<uint32_t> localIndex(vertices.size(), Unassigned);
+  std::vector<uint32_t> chunkVertices;
+
+  for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+    const uint32_t a = indices[i], b = indices[i + 1], c = indices[i + 2];
+    const uint32_t newVertices =
+        (localIndex[a] == Unassigned) +
+        (localIndex[b] == Unassigned && b != a) +
+        (localIndex[c] == Unassigned && c != a && c != b);
+    if (chunkVertices.size() + newVertices > maxVertices) {
+      for (const uint32_t vertex : chunkVertices) {
+        localIndex[vertex] = Unassigned;
+      }
+      chunkVertices.clear();
+      chunks.emplace_back();
+    }
+    MeshChunk& chunk = chunks.back();
+    for (const uint32_t vertex : {a, b, c}) {
+      if (localIndex[vertex] == Unassigned) {
+        localIndex[vertex] = static_cast<uint32_t>(chunkVertices.size());
+        chunkVertices.push_back(vertex);
+        chunk.vertices.push_back(vertices[vertex]);
+      }
+      chunk.indices.push_back(localIndex[vertex]);
+    }
+  }
+  return chunks;
+}
+
+MeshletData MeshUtils::BuildMeshlets(const std::vector<uint32_t>& indices,
+                                     const std::vector<VertexData>& vertices) {
+  MeshletData data;
+  std::vector<uint32_t> localIndex(vertices.size(), Unassigned);
+  Meshlet meshlet;
+
+  const auto finish = [&data, &localIndex, &vertices, &meshlet] {
+    if (meshlet.triangleCount == 0) {
+      return;
+    }
+    ComputeMeshletBounds(meshlet, data, vertices);
+    for (uint32_t i = 0; i < meshlet.vertexCount; i++) {
+      localIndex[data.vertices[meshlet.vertexOffset + i]] = Unassigned;
+    }
+    data.meshlets.push_back(meshlet);
+    meshlet = {
+        .vertexOffset = static_cast<uint32_t>(data.vertices.size()),
+        .triangleOffset = static_cast<uint32_t>(data.triangles.size()),
+    };
+  };
+
+  for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+    const uint32_t a = indices[i], b = indices[i + 1], c = indices[i + 2];
+    const uint32_t newVertices =
+        (localIndex[a] == Unassigned) +
+        (localIndex[b] == Unassigned && b != a) +
+        (localIndex[c] == Unassigned && c != a && c != b);
+    if (meshlet.vertexCount + newVertices > MaxMeshletVertices ||
+        meshlet.triangleCount + 1 > MaxMeshletTriangles) {
+      finish();
+    }
+    for (const uint32_t vertex : {a, b, c}) {
+      if (localIndex[vertex] == Unassigned) {
+        localIndex[vertex] = meshlet.vertexCount++;
+        data.vertices.push_back(vertex);
+      }
+      data.triangles.push_back(static_cast<uint8_t>(localIndex[vertex]));
+    }
+    meshlet.triangleCount++;
+  }
+  finish();
+  return data;
+}
+
+float MeshUtils::SimplifyMesh(std::vector<uint32_t>& indices,
+                              const std::vector<VertexData>& vertices,
+                              const size_t targetIndexCount) {
+  // Edges not shared by exactly two triangles lie on a border, vertices split
+  // for their attributes leave one in the index topology as well
+  std::unordered_map<uint64_t, uint32_t> edgeUses;
+  for (size_t i = 0; i < indices.size(); i += 3) {
+    for (size_t j = 0; j < 3; j++) {
+      edgeUses[EdgeKey(indices[i + j], indices[i + (j + 1) % 3])]++;
+    }
+  }
+  std::vector<bool> locked(vertices.size(), false);
+  for (const auto& [edge, uses] : edgeUses) {
+    if (uses != 2) {
+      locked[edge >> 32] = locked[edge & Unassigned] = true;
+    }
+  }
+
+  std::vector<Quadric> quadrics(vertices.size());
+  for (size_t i = 0; i < indices.size(); i += 3) {
+    const glm::dvec3 p0 = vertices[indices[i]].pos;
+    const glm::dvec3 p1 = vertices[indices[i + 1]].pos;
+    const glm::dvec3 p2 = vertices[indices[i + 2]].pos;
+    glm::dvec3 normal = glm::cross(p1 - p0, p2 - p0);
+    const double length = glm::length(normal);
+    if (length == 0) {
+      continue;
+    }
+    normal /= length;
+    for (size_t j = 0; j < 3; j++) {
+      quadrics[indices[i + j]].AddPlane(normal, -glm::dot(normal, p0),
+                                        length * 0.5);
+    }
+  }
+
+  double maxError = 0;
+  std::vector<uint32_t> remap(vertices.size());
+  std::vector<uint32_t> firstTriangle, triangles;
+  std::vector<uint32_t> fromNeighbors, toNeighbors, shared;
+  while (indices.size() > targetIndexCount) {
+    // Triangles around each vertex, the ones of vertex v are
+    // triangles[firstTriangle[v]] up to triangles[firstTriangle[v + 1]]
+    firstTriangle.assign(vertices.size() + 1, 0);
+    for (const uint32_t index : indices) {
+      firstTriangle[index + 1]++;
+    }
+    std::partial_sum(firstTriangle.begin(), firstTriangle.end(),
+                     firstTriangle.begin());
+    triangles.resize(indices.size());
+    std::vector<uint32_t> fill(firstTriangle.begin(), firstTriangle.end() - 1);
+    for (size_t i = 0; i < indices.size(); i++) {
+      triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+    const auto around = [&](const uint32_t vertex) {
+      return std::span(triangles.data() + firstTriangle[vertex],
+                       triangles.data() + firstTriangle[vertex + 1]);
+    };
+    const auto neighbors = [&](const uint32_t vertex,
+                               std::vector<uint32_t>& result) {
+      result.clear();
+      for (const uint32_t triangle : around(vertex)) {
+        for (size_t j = 0; j < 3; j++) {
+          if (indices[triangle * 3 + j] != vertex) {
+            result.push_back(indices[triangle * 3 + j]);
+          }
+        }
+      }
+      std::ranges::sort(result);
+      result.erase(std::ranges::unique(result).begin(), result.end());
+    };
+
+    std::vector<Collapse> collapses;
+    for (size_t i = 0; i < indices.size(); i += 3) {
+      for (size_t j = 0; j < 3; j++) {
+        const uint32_t from = indices[i + j], to = indices[i + (j + 1) % 3];
+        if (locked[from] == false) {
+          Quadric merged = quadrics[from];
+          merged += quadrics[to];
+          collapses.push_back({from, to, merged.Error(vertices[to].pos)});
+        }
+      }
+    }
+    std::ranges::sort(collapses, {}, &Collapse::error);
+
+    // A vertex moves at most once per round so the adjacency stays valid
+    std::iota(remap.begin(), remap.end(), 0);
+    std::vector<bool> touched(vertices.size(), false);
+    size_t removedIndices = 0;
+    for (const auto& [from, to, error] : collapses) {
+      if (indices.size() - removedIndices <= targetIndexCount) {
+        break;
+      }
+      if (touched[from] || touched[to]) {
+        continue;
+      }
+      // More common neighbors than the two across the edge would pinch the
+      // surface into a non-manifold one
+      neighbors(from, fromNeighbors);
+      neighbors(to, toNeighbors);
+      shared.clear();
+      std::ranges::set_intersection(fromNeighbors, toNeighbors,
+                                    std::back_inserter(shared));
+      if (shared.size() != 2) {
+        continue;
+      }
+      const bool flips = std::ranges::any_of(around(from), [&](uint32_t t) {
+        const uint32_t* corner = &indices[t * 3];
+        if (corner[0] == to || corner[1] == to || corner[2] == to) {
+          return false;
+        }
+        glm::vec3 moved[3];
+        for (size_t j = 0; j < 3; j++) {
+          moved[j] = vertices[corner[j] == from ? to : corner[j]].pos;
+        }
+        const glm::vec3 normal =
+            glm::cross(moved[1] - moved[0], moved[2] - moved[0]);
+        return glm::dot(normal, TriangleCross(indices, vertices, t)) <= 0;
+      });
+      if (flips) {
+        continue;
+      }
+
+      remap[from] = to;
+      quadrics[to] += quadrics[from];
+      maxError = std::max(maxError, error);
+      for (const uint32_t triangle : around(from)) {
+        for (size_t j = 0; j < 3; j++) {
+          touched[indices[triangle * 3 + j]] = true;
+        }
+      }
+      removedIndices += 6;
+    }
+    if (removedIndices == 0) {
+      break;
+    }
+
+    size_t kept = 0;
+    for (size_t i = 0; i < indices.size(); i += 3) {
+      const uint32_t a = remap[indices[i]], b = remap[indices[i + 1]],
+                     c = remap[indices[i + 2]];
+      if (a != b && b != c && c != a) {
+        indices[kept++] = a;
+        indices[kept++] = b;
+        indices[kept++] = c;
+      }
+    }
+    indices.resize(kept);
+  }
+  return static_cast<float>(std::sqrt(maxError));
+}
+
+std::vector<MeshLod> MeshUtils::BuildLods(
+    std::vector<uint32_t>& indices, const std::vector<VertexData>& vertices,
+    const uint32_t lodCount) {
+  std::vector<MeshLod> lods{{
+      .indexOffset = 0,
+      .indexCount = static_cast<uint32_t>(indices.size()),
+  }};
+  std::vector<uint32_t> previous = indices;
+  float error = 0;
+  while (lods.size() < lodCount) {
+    std::vector<uint32_t> simplified = previous;
+    const size_t target =
+        static_cast<size_t>(previous.size() / 3 * LodReduction) * 3;
+    // Errors add up since each level only knows the one before
+    error += SimplifyMesh(simplified, vertices, target);
+    if (simplified.empty() ||
+        simplified.size() > previous.size() * LodMinReduction) {
+      break;
+    }
+    OptimizeVertexCache(simplified, vertices.size());
+    lods.push_back({
+        .indexOffset = static_cast<uint32_t>(indices.size()),
+        .indexCount = static_cast<uint32_t>(simplified.size()),
+        .error = error,
+    });
+    indices.insert(indices.end(), simplified.begin(), simplified.end());
+    previous = std::move(simplified);
+  }
+  return lods;
+}
+
+glm::vec4 MeshUtils::ComputeBounds(const std::vector<VertexData>& vertices) {
+  if (vertices.empty()) {
+    return glm::vec4(0);
+  }
+  glm::vec3 posMin(std::numeric_limits<float>::max());
+  glm::vec3 posMax(std::numeric_limits<float>::lowest());
+  for (const VertexData& vertex : vertices) {
+    posMin = glm::min(posMin, vertex.pos);
+    posMax = glm::max(posMax, vertex.pos);
+  }
+  const glm::vec3 center = (posMin + posMax) * 0.5f;
+  float radius = 0;
+  for (const VertexData& vertex : vertices) {
+    radius = std::max(radius, glm::length(vertex.pos - center));
+  }
+  return glm::vec4(center, radius);
+}
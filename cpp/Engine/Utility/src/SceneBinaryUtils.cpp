@@ -0,0 +1,454 @@
+#include "../include/SceneBinaryUtils.h"
+
+#include <Engine/Camera/include/BaseCamera.h>
+#include <Engine/Light/include/LightChannel.h>
+#include <Engine/Light/include/SpotLight.h>
+#include <Engine/Light/include/SunLight.h>
+#include <Engine/Model/include/BaseModel.h>
+#include <Engine/Scene/include/BaseScene.h>
+#include <Engine/Utility/include/FileUtils.h>
+#include <Engine/Utility/include/JsonUtils.h>
+
+#include <cstring>
+#include <filesystem>
+#include <ranges>
+#include <type_traits>
+
+using namespace rapidjson;
+
+namespace {
+constexpr char Magic[4] = {'E', 'Q', 'S', 'C'};
+constexpr uint32_t NoIndex = UINT32_MAX;
+constexpr uint32_t MaxParamSlots = 16;
+
+enum class SceneObjectType : uint32_t {
+  BaseModel,
+  BaseCamera,
+  SpotLight,
+  SunLight,
+  Count
+};
+
+enum TransformMask : uint32_t {
+  HasPosition = 1 << 0,
+  HasRotation = 1 << 1,
+  HasScale = 1 << 2,
+};
+
+struct SceneHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t stringCount;
+  uint32_t stringBytes;
+  uint32_t objectCount;
+  uint32_t channelCount;
+  uint32_t channelLightCount;
+};
+
+struct ObjectRecord {
+  SceneObjectType type;
+  uint32_t parent;
+  uint32_t name;
+  uint32_t path;
+  uint32_t camera;
+  uint32_t lightChannel;
+  uint32_t transformMask;
+  uint32_t paramMask;
+  float position[3];
+  float rotation[3];
+  float scale[3];
+  float params[MaxParamSlots];
+};
+
+struct ChannelRecord {
+  uint32_t name;
+  uint32_t firstLight;
+  uint32_t lightCount;
+};
+
+static_assert(std::is_trivially_copyable_v<SceneHeader>);
+static_assert(std::is_trivially_copyable_v<ObjectRecord>);
+static_assert(std::is_trivially_copyable_v<ChannelRecord>);
+
+enum class ParamKind { Float, Aspect, Vec4 };
+
+struct ParamInfo {
+  const char* key;
+  ParamKind kind;
+  void (*apply)(SceneObject& object, const float* values);
+};
+
+#define FLOAT_PARAM(type, key)                                       \
+  ParamInfo{#key, ParamKind::Float,                                  \
+            [](SceneObject& object, const float* values) {           \
+              static_cast<type&>(object).Set##key(values[0]);        \
+            }}
+#define ASPECT_PARAM(type)                                           \
+  ParamInfo{"Aspect", ParamKind::Aspect,                             \
+            [](SceneObject& object, const float* values) {           \
+              static_cast<type&>(object).SetAspect(values[0]);       \
+            }}
+#define COLOR_PARAM(type)                                            \
+  ParamInfo{"Color", ParamKind::Vec4,                                \
+            [](SceneObject& object, const float* values) {           \
+              static_cast<type&>(object).SetColor(                   \
+                  glm::vec4(values[0], values[1], values[2], values[3])); \
+            }}
+
+const std::vector<ParamInfo>& GetParamInfos(SceneObjectType type) {
+  static const std::vector<ParamInfo> paramInfos[] = {
+      {},
+      {FLOAT_PARAM(BaseCamera, FOVy), ASPECT_PARAM(BaseCamera),
+       FLOAT_PARAM(BaseCamera, Near), FLOAT_PARAM(BaseCamera, Far),
+       FLOAT_PARAM(BaseCamera, MaxFov), FLOAT_PARAM(BaseCamera, MinFov),
+       FLOAT_PARAM(BaseCamera, SensitivityX),
+       FLOAT_PARAM(BaseCamera, SensitivityY),
+       FLOAT_PARAM(BaseCamera, SensitivityZ),
+       FLOAT_PARAM(BaseCamera, MoveSpeed),
+       FLOAT_PARAM(BaseCamera, SpeedIncreasingRate),
+       FLOAT_PARAM(BaseCamera, MaxMoveSpeed),
+       FLOAT_PARAM(BaseCamera, MinMoveSpeed)},
+      {FLOAT_PARAM(BaseLight, Intensity), COLOR_PARAM(BaseLight),
+       FLOAT_PARAM(SpotLight, FOVy), ASPECT_PARAM(SpotLight),
+       FLOAT_PARAM(BaseLight, Near), FLOAT_PARAM(BaseLight, Far)},
+      {FLOAT_PARAM(BaseLight, Intensity), COLOR_PARAM(BaseLight),
+       FLOAT_PARAM(SunLight, Left), FLOAT_PARAM(SunLight, Right),
+       FLOAT_PARAM(SunLight, Bottom), FLOAT_PARAM(SunLight, Top),
+       FLOAT_PARAM(BaseLight, Near), FLOAT_PARAM(BaseLight, Far)},
+  };
+  return paramInfos[static_cast<uint32_t>(type)];
+}
+#undef FLOAT_PARAM
+#undef ASPECT_PARAM
+#undef COLOR_PARAM
+
+uint32_t GetParamSlots(ParamKind kind) {
+  return kind == ParamKind::Vec4 ? 4 : 1;
+}
+
+SceneObjectType ParseObjectType(const std::string& type) {
+  if (type == "BaseModel") return SceneObjectType::BaseModel;
+  if (type == "BaseCamera") return SceneObjectType::BaseCamera;
+  if (type == "SpotLight") return SceneObjectType::SpotLight;
+  if (type == "SunLight") return SceneObjectType::SunLight;
+  PRINT_AND_THROW_ERROR("unknown scene object type!");
+}
+
+class SceneWriter {
+  std::vector<char> strings;
+  std::vector<uint32_t> stringOffsets = {0};
+  std::unordered_map<std::string, uint32_t> stringIds;
+
+ public:
+  std::vector<ObjectRecord> objects;
+  std::vector<ChannelRecord> channels;
+  std::vector<uint32_t> channelLights;
+
+  uint32_t AddString(const std::string& str) {
+    if (auto iter = stringIds.find(str); iter != stringIds.end()) {
+      return iter->second;
+    }
+    const uint32_t id = static_cast<uint32_t>(stringIds.size());
+    strings.insert(strings.end(), str.begin(), str.end());
+    stringOffsets.emplace_back(static_cast<uint32_t>(strings.size()));
+    stringIds.emplace(str, id);
+    return id;
+  }
+  uint32_t AddOptionalString(const Value& val, const char* key) {
+    return val.HasMember(key) ? AddString(val[key].GetString()) : NoIndex;
+  }
+
+  void AddObject(const Value& val, uint32_t parent) {
+    if (!val.HasMember("Type") || !val.HasMember("Path")) {
+      PRINT_AND_THROW_ERROR("scene object is incomplete!");
+    }
+    ObjectRecord record = {};
+    record.type = ParseObjectType(val["Type"].GetString());
+    record.parent = parent;
+    record.name = AddString(val.HasMember("Name") ? val["Name"].GetString()
+                                                  : "Unset");
+    record.path = AddString(val["Path"].GetString());
+    record.camera = AddOptionalString(val, "Camera");
+    record.lightChannel = AddOptionalString(val, "LightChannel");
+
+    if (val.HasMember("Transform")) {
+      const auto& trans = val["Transform"];
+      auto readVec3 = [&](const char* key, float* dst, uint32_t mask,
+                          bool toRadians) {
+        if (trans.HasMember(key)) {
+          glm::vec3 vec = ParseGLMVec3(trans[key].GetString());
+          if (toRadians) {
+            vec = glm::radians(vec);
+          }
+          std::memcpy(dst, &vec, sizeof(float) * 3);
+          record.transformMask |= mask;
+        }
+      };
+      readVec3("Position", record.position, HasPosition, false);
+      readVec3("Rotation", record.rotation, HasRotation, true);
+      readVec3("Scale", record.scale, HasScale, false);
+    }
+
+    if (val.HasMember("Params")) {
+      const auto& params = val["Params"];
+      const auto& infos = GetParamInfos(record.type);
+      uint32_t slot = 0;
+      for (uint32_t i = 0; i < infos.size(); ++i) {
+        const ParamInfo& info = infos[i];
+        if (params.HasMember(info.key)) {
+          const auto& param = params[info.key];
+          if (info.kind == ParamKind::Float) {
+            record.params[slot] = param.GetFloat();
+          } else if (info.kind == ParamKind::Aspect) {
+            record.params[slot] = BaseCamera::ParseAspect(param.GetString());
+          } else {
+            glm::vec4 vec = ParseGLMVec4(param.GetString());
+            std::memcpy(record.params + slot, &vec, sizeof(float) * 4);
+          }
+          record.paramMask |= 1u << i;
+        }
+        slot += GetParamSlots(info.kind);
+      }
+    }
+
+    const uint32_t index = static_cast<uint32_t>(objects.size());
+    objects.emplace_back(record);
+    if (val.HasMember("Sons")) {
+      const auto& values = val["Sons"];
+      for (SizeType i = 0; i < values.Size(); ++i) {
+        AddObject(values[i], index);
+      }
+    }
+  }
+
+  void AddChannel(const std::string& name, const Value& lights) {
+    ChannelRecord record = {AddString(name),
+                            static_cast<uint32_t>(channelLights.size()),
+                            lights.Size()};
+    for (SizeType i = 0; i < lights.Size(); ++i) {
+      channelLights.emplace_back(AddString(lights[i].GetString()));
+    }
+    channels.emplace_back(record);
+  }
+
+  std::vector<char> Serialize() const {
+    std::vector<char> padded = strings;
+    padded.resize((padded.size() + 3) & ~size_t(3));
+
+    SceneHeader header = {};
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = SceneBinaryUtils::Version;
+    header.stringCount = static_cast<uint32_t>(stringOffsets.size() - 1);
+    header.stringBytes = static_cast<uint32_t>(padded.size());
+    header.objectCount = static_cast<uint32_t>(objects.size());
+    header.channelCount = static_cast<uint32_t>(channels.size());
+    header.channelLightCount = static_cast<uint32_t>(channelLights.size());
+
+    std::vector<char> bytes;
+    auto append = [&bytes](const void* data, size_t size) {
+      const char* begin = static_cast<const char*>(data);
+      bytes.insert(bytes.end(), begin, begin + size);
+    };
+    append(&header, sizeof(header));
+    append(stringOffsets.data(), stringOffsets.size() * sizeof(uint32_t));
+    append(padded.data(), padded.size());
+    append(objects.data(), objects.size() * sizeof(ObjectRecord));
+    append(channels.data(), channels.size() * sizeof(ChannelRecord));
+    append(channelLights.data(), channelLights.size() * sizeof(uint32_t));
+    return bytes;
+  }
+};
+
+class SceneReader {
+  const std::vector<char>& bytes;
+  size_t offset = 0;
+
+ public:
+  explicit SceneReader(const std::vector<char>& bytes) : bytes(bytes) {}
+
+  template <typename T>
+  const T* Read(size_t count) {
+    if (count > (bytes.size() - offset) / sizeof(T)) {
+      PRINT_AND_THROW_ERROR("binary scene is truncated!");
+    }
+    const T* ret = reinterpret_cast<const T*>(bytes.data() + offset);
+    offset += count * sizeof(T);
+    return ret;
+  }
+};
+
+std::string GetSceneBinaryPath(const std::string& root,
+                               const std::string& file) {
+  return root + file + SCENESUFFIX;
+}
+}  // namespace
+
+void SceneBinaryUtils::ConvertSceneToBinary(const std::string& root,
+                                            const std::string& file) {
+  std::shared_ptr<Document> doc = JsonUtils::GetJsonDocFromFile(root + file);
+  SceneWriter writer;
+  if (doc->HasMember("SceneObjects")) {
+    const auto& values = (*doc)["SceneObjects"];
+    for (SizeType i = 0; i < values.Size(); ++i) {
+      writer.AddObject(values[i], NoIndex);
+    }
+  }
+  if (doc->HasMember("LightChannels")) {
+    const auto& channels = (*doc)["LightChannels"];
+    for (auto iter = channels.MemberBegin(); iter != channels.MemberEnd();
+         ++iter) {
+      writer.AddChannel(iter->name.GetString(), iter->value);
+    }
+  }
+  FileUtils::WriteFileAsBytes(GetSceneBinaryPath(root, file),
+                              writer.Serialize());
+  std::cout << "Converted " << root + file << FILESUFFIX << " to "
+            << SCENESUFFIX << ": " << writer.objects.size() << " objects, "
+            << writer.channels.size() << " light channels\n";
+}
+
+bool SceneBinaryUtils::LoadBinaryScene(
+    std::weak_ptr<GraphicsInterface> graphics,
+    std::shared_ptr<SceneObject> parent, const std::string& root,
+    const std::string& file, std::weak_ptr<BaseScene> owner) {
+  namespace fs = std::filesystem;
+  const std::string binaryPath = GetSceneBinaryPath(root, file);
+  std::error_code error;
+  if (!fs::exists(binaryPath, error) ||
+      fs::last_write_time(binaryPath, error) <
+          fs::last_write_time(root + file + FILESUFFIX, error) ||
+      error) {
+    return false;
+  }
+
+  const std::vector<char> bytes = FileUtils::ReadFileAsBytes(binaryPath);
+  SceneReader reader(bytes);
+  const SceneHeader& header = *reader.Read<SceneHeader>(1);
+  if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0 ||
+      header.version != Version) {
+    return false;
+  }
+
+  const uint32_t* stringOffsets =
+      reader.Read<uint32_t>(size_t(header.stringCount) + 1);
+  const char* stringData = reader.Read<char>(header.stringBytes);
+  for (uint32_t i = 0; i < header.stringCount; ++i) {
+    if (stringOffsets[i] > stringOffsets[i + 1] ||
+        stringOffsets[i + 1] > header.stringBytes) {
+      PRINT_AND_THROW_ERROR("binary scene string table is corrupt!");
+    }
+  }
+  auto getString = [&](uint32_t id) -> std::string {
+    if (id >= header.stringCount) {
+      PRINT_AND_THROW_ERROR("binary scene string id out of range!");
+    }
+    return std::string(stringData + stringOffsets[id],
+                       stringOffsets[id + 1] - stringOffsets[id]);
+  };
+
+  const ObjectRecord* records = reader.Read<ObjectRecord>(header.objectCount);
+  const ChannelRecord* channels =
+      reader.Read<ChannelRecord>(header.channelCount);
+  const uint32_t* channelLights =
+      reader.Read<uint32_t>(header.channelLightCount);
+
+  std::vector<std::shared_ptr<SceneObject>> objects;
+  objects.reserve(header.objectCount);
+  for (uint32_t i = 0; i < header.objectCount; ++i) {
+    const ObjectRecord& record = records[i];
+    if (record.type >= SceneObjectType::Count ||
+        (record.parent != NoIndex && record.parent >= i)) {
+      PRINT_AND_THROW_ERROR("binary scene object table is corrupt!");
+    }
+    std::shared_ptr<SceneObject> objectParent =
+        record.parent == NoIndex ? parent : objects[record.parent];
+    const std::string name = getString(record.name);
+    const std::string path = getString(record.path);
+
+    std::shared_ptr<SceneObject> object;
+    switch (record.type) {
+      case SceneObjectType::BaseModel: {
+        auto model = BaseObject::CreateImmediately<BaseModel>(
+            graphics, objectParent, name, root, path, owner);
+        if (record.camera != NoIndex) {
+          model->SetCamera(getString(record.camera));
+        }
+        if (record.lightChannel != NoIndex) {
+          model->SetLightChannel(getString(record.lightChannel));
+        }
+        object = model;
+        break;
+      }
+      case SceneObjectType::BaseCamera: {
+        auto camera = BaseObject::CreateImmediately<BaseCamera>(
+            graphics, objectParent, name, root, path, owner);
+        if (record.transformMask & HasRotation) {
+          camera->InitRotation(glm::vec3(
+              record.rotation[0], record.rotation[1], record.rotation[2]));
+        }
+        object = camera;
+        break;
+      }
+      case SceneObjectType::SpotLight:
+        object = BaseObject::CreateImmediately<SpotLight>(
+            graphics, objectParent, name, root, path, owner);
+        break;
+      case SceneObjectType::SunLight:
+        object = BaseObject::CreateImmediately<SunLight>(objectParent, name,
+                                                         root, path, owner);
+        break;
+      default:
+        break;
+    }
+
+    const auto& infos = GetParamInfos(record.type);
+    uint32_t slot = 0;
+    for (uint32_t p = 0; p < infos.size(); ++p) {
+      if (record.paramMask & (1u << p)) {
+        infos[p].apply(*object, record.params + slot);
+      }
+      slot += GetParamSlots(infos[p].kind);
+    }
+
+    if (record.transformMask & HasScale) {
+      object->SetRelativeScale(
+          glm::vec3(record.scale[0], record.scale[1], record.scale[2]));
+    }
+    if (record.transformMask & HasRotation) {
+      object->SetRelativeRotation(glm::vec3(
+          record.rotation[0], record.rotation[1], record.rotation[2]));
+    }
+    if (record.transformMask & HasPosition) {
+      object->SetRelativePosition(glm::vec3(
+          record.position[0], record.position[1], record.position[2]));
+    }
+    objects.emplace_back(std::move(object));
+  }
+
+  if (auto ownerPtr = owner.lock()) {
+    for (uint32_t i = 0; i < header.channelCount; ++i) {
+      const ChannelRecord& record = channels[i];
+      if (record.firstLight > header.channelLightCount ||
+          record.lightCount > header.channelLightCount - record.firstLight) {
+        PRINT_AND_THROW_ERROR("binary scene light channel is corrupt!");
+      }
+      std::shared_ptr<LightChannel> channel =
+          BaseObject::CreateImmediately<LightChannel>(
+              getString(record.name), false, root, file, owner);
+      for (uint32_t l = 0; l < record.lightCount; ++l) {
+        channel->AddLightToChannel(ownerPtr->GetLightByName(
+            StringIdUtils::Intern(
+                getString(channelLights[record.firstLight + l]))));
+      }
+    }
+    if (!ownerPtr->GetLightChannelByName("All"_sid).lock()) {
+      std::shared_ptr<LightChannel> channel =
+          BaseObject::CreateImmediately<LightChannel>("All", false, root, file,
+                                                      owner);
+      for (auto light : ownerPtr->GetLights() | std::views::values) {
+        channel->AddLightToChannel(light);
+      }
+    }
+  }
+  return true;
+}
\ No newline at end of file
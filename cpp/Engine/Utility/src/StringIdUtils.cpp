@@ -0,0 +1,37 @@
+#include "../include/StringIdUtils.h"
+
+#include <Engine/Utility/include/TypeUtils.h>
+
+#include <format>
+#include <mutex>
+#include <unordered_map>
+
+#ifndef NDEBUG
+namespace {
+std::mutex namesMutex;
+std::unordered_map<StringId, std::string> names;
+}  // namespace
+#endif
+
+StringId StringIdUtils::Intern(const std::string_view str) {
+  const StringId id = Hash(str);
+#ifndef NDEBUG
+  std::lock_guard lock(namesMutex);
+  if (const auto [iter, inserted] = names.try_emplace(id, str);
+      inserted == false && iter->second != str) {
+    PRINT_AND_THROW_ERROR(std::format("string id collision: {} and {}",
+                                      iter->second, str));
+  }
+#endif
+  return id;
+}
+
+std::string StringIdUtils::GetName(const StringId id) {
+#ifndef NDEBUG
+  std::lock_guard lock(namesMutex);
+  if (const auto iter = names.find(id); iter != names.end()) {
+    return iter->second;
+  }
+#endif
+  return std::format("#{:016x}", id);
+}
@@ -4,14 +4,13 @@ layout(binding = 2) uniform TransformData {
     mat4 modelMatrix;
     mat4 viewMatrix;
     mat4 projMatrix;
+    mat4 dequantMatrix;
+    vec4 texCoordDequant;
 } transform;
 
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec4 inColor;
-layout(location = 2) in vec3 inNormal;
-layout(location = 3) in vec3 inTangent;
-layout(location = 4) in vec2 inTexCoord;
+#include <GLSLLibrary/Binding/Vertex/VertexInput.glsl>
 
 void main() {
+    DecodeVertexInput(transform.dequantMatrix, transform.texCoordDequant);
     gl_Position = transform.projMatrix * transform.viewMatrix * transform.modelMatrix * vec4(inPosition, 1.);
 }
\ No newline at end of file
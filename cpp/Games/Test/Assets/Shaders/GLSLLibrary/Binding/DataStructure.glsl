@@ -13,6 +13,8 @@ layout(binding = 2) uniform TransformData {
     mat4 modelMatrix;
     mat4 viewMatrix;
     mat4 projMatrix;
+    mat4 dequantMatrix;
+    vec4 texCoordDequant;
 } transform;
 
 struct LightData {
@@ -17,4 +17,6 @@ layout(binding = 3) uniform TransformData {
     mat4 modelMatrix;
     mat4 viewMatrix;
     mat4 projMatrix;
+    mat4 dequantMatrix;
+    vec4 texCoordDequant;
 } transform;
\ No newline at end of file
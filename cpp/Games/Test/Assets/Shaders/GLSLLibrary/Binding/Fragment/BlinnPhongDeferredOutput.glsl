@@ -1,3 +1,4 @@
+#include <GLSLLibrary/Utils/GBuffer.glsl>
 #include <GLSLLibrary/Binding/DataStructureDeferredOutput.glsl>
 
 layout(binding = 4) uniform sampler2D baseColorSampler;
@@ -7,9 +8,30 @@ layout(location = 1) in vec4 fragColor;
 layout(location = 2) in vec3 fragNormal;
 layout(location = 3) in vec2 fragTexCoord;
 
+#ifdef EnableCompactGBuffer
+layout(location = 0) out vec4 outAlbedo;
+layout(location = 1) out vec2 outPackedNormal;
+layout(location = 2) out vec4 outPackedMaterial;
+
+// Filled like the targets of the full layout, then packed by WriteGBuffer
+vec4 outColor;
+vec3 outNormal;
+vec4 outPosition;
+vec4 outMaterial;
+vec3 outCameraNormal;
+vec3 outCameraPosition;
+
+#define WriteGBuffer \
+outAlbedo = vec4(outColor.rgb, EncodePipelineId(pipeline.id)); \
+outPackedNormal = OctEncode(normalize(outNormal)); \
+outPackedMaterial = outMaterial
+#else
 layout(location = 0) out vec4 outColor;
 layout(location = 1) out vec3 outNormal;
 layout(location = 2) out vec4 outPosition;
 layout(location = 3) out vec4 outMaterial;
 layout(location = 4) out vec3 outCameraNormal;
-layout(location = 5) out vec3 outCameraPosition;
\ No newline at end of file
+layout(location = 5) out vec3 outCameraPosition;
+
+#define WriteGBuffer
+#endif
\ No newline at end of file
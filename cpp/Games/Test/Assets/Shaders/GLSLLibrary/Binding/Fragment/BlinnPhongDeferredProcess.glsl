@@ -1,5 +1,34 @@
+#include <GLSLLibrary/Utils/GBuffer.glsl>
 #include <GLSLLibrary/Binding/DataStructureDeferredProcess.glsl>
 
+#ifdef EnableCompactGBuffer
+layout(push_constant) uniform DeferredViewData {
+    mat4 screenToWorld;
+    vec4 cameraPosition;
+    vec4 cameraNormal;
+} view;
+
+#ifdef EnableMultiSample
+layout(input_attachment_index = 0, binding = 2) uniform subpassInputMS inAlbedo;
+layout(input_attachment_index = 1, binding = 3) uniform subpassInputMS inNormal;
+layout(input_attachment_index = 2, binding = 4) uniform subpassInputMS inMaterial;
+layout(input_attachment_index = 3, binding = 5) uniform subpassInputMS inDepth;
+#else
+layout(input_attachment_index = 0, binding = 2) uniform subpassInput inAlbedo;
+layout(input_attachment_index = 1, binding = 3) uniform subpassInput inNormal;
+layout(input_attachment_index = 2, binding = 4) uniform subpassInput inMaterial;
+layout(input_attachment_index = 3, binding = 5) uniform subpassInput inDepth;
+#endif
+
+#ifdef EnableShadowMap
+layout(binding = 6) uniform sampler2DShadow shadowMapSamplers[MaxLightNum];
+#endif
+
+vec3 ReconstructPosition(float depth) {
+    vec4 position = view.screenToWorld * vec4(gl_FragCoord.xy, depth, 1.);
+    return position.xyz / position.w;
+}
+#else
 #ifdef EnableMultiSample
 layout(input_attachment_index = 0, binding = 2) uniform subpassInputMS inColor;
 layout(input_attachment_index = 1, binding = 3) uniform subpassInputMS inNormal;
@@ -19,9 +48,41 @@ layout(input_attachment_index = 5, binding = 7) uniform subpassInput inCameraPos
 #ifdef EnableShadowMap
 layout(binding = 8) uniform sampler2DShadow shadowMapSamplers[MaxLightNum];
 #endif
+#endif
 
 layout(location = 0) out vec4 outColor;
 
+#ifdef EnableCompactGBuffer
+#ifdef EnableMultiSample
+#define ProcessSubpassInput \
+vec4 fragColor = vec4(0.); \
+vec3 fragNormal = vec3(0.); \
+vec4 fragPosition = vec4(0.); \
+vec4 fragMaterial = vec4(0.); \
+vec3 cameraNormal = view.cameraNormal.xyz; \
+vec3 cameraPosition = view.cameraPosition.xyz; \
+for (int i=0; i<EnableMultiSample; i++) { \
+    fragColor += vec4(subpassLoad(inAlbedo, i).rgb, 1.); \
+    fragNormal += OctDecode(subpassLoad(inNormal, i).xy); \
+    fragPosition.xyz += ReconstructPosition(subpassLoad(inDepth, i).r); \
+    fragMaterial += subpassLoad(inMaterial, i); \
+} \
+fragColor /= EnableMultiSample; \
+fragNormal /= EnableMultiSample; \
+fragPosition.xyz /= EnableMultiSample; \
+fragMaterial /= EnableMultiSample; \
+fragPosition.w = DecodePipelineId(subpassLoad(inAlbedo, 0).a)
+#else
+#define ProcessSubpassInput \
+vec4 fragColor = vec4(subpassLoad(inAlbedo).rgb, 1.); \
+vec3 fragNormal = OctDecode(subpassLoad(inNormal).xy); \
+vec4 fragPosition = vec4(ReconstructPosition(subpassLoad(inDepth).r), \
+                         DecodePipelineId(subpassLoad(inAlbedo).a)); \
+vec4 fragMaterial = subpassLoad(inMaterial); \
+vec3 cameraNormal = view.cameraNormal.xyz; \
+vec3 cameraPosition = view.cameraPosition.xyz
+#endif
+#else
 #ifdef EnableMultiSample
 #define ProcessSubpassInput \
 vec4 fragColor = vec4(0.); \
@@ -52,4 +113,5 @@ vec4 fragPosition = subpassLoad(inPosition); \
 vec4 fragMaterial = subpassLoad(inMaterial); \
 vec3 cameraNormal = subpassLoad(inCameraNormal).xyz; \
 vec3 cameraPosition = subpassLoad(inCameraPosition).xyz
+#endif
 #endif
\ No newline at end of file
@@ -0,0 +1,18 @@
+// Tile buffer of the deferred lighting pass, see LightingTiles::RecordClassify.
+// Declared by each stage with its own binding and access.
+
+struct DrawIndirectCommand {
+    uint vertexCount;
+    uint instanceCount;
+    uint firstVertex;
+    uint firstInstance;
+};
+
+// The draw of pipeline i shades instanceCount tiles from tiles[i * tileCount],
+// a tile is packed as y << 16 | x
+#define LightingTileMembers \
+DrawIndirectCommand draws[MaxPipelineNum]; \
+uvec2 extent; \
+uint tilesX; \
+uint tileCount; \
+uint tiles[]
\ No newline at end of file
@@ -1,10 +1,6 @@
 #include <GLSLLibrary/Binding/DataStructureDeferredOutput.glsl>
 
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec4 inColor;
-layout(location = 2) in vec3 inNormal;
-layout(location = 3) in vec3 inTangent;
-layout(location = 4) in vec2 inTexCoord;
+#include <GLSLLibrary/Binding/Vertex/VertexInput.glsl>
 
 layout(location = 0) out vec3 fragPosition;
 layout(location = 1) out vec4 fragColor;
@@ -0,0 +1,20 @@
+#include <GLSLLibrary/Binding/LightingTiles.glsl>
+
+layout(binding = 0) uniform PipelineData {
+    int id;
+} pipeline;
+
+// Bound after the G-buffer inputs and the shadow maps
+#if defined(EnableCompactGBuffer) && defined(EnableShadowMap)
+#define LightingTileBinding 7
+#elif defined(EnableCompactGBuffer)
+#define LightingTileBinding 6
+#elif defined(EnableShadowMap)
+#define LightingTileBinding 9
+#else
+#define LightingTileBinding 8
+#endif
+
+layout(std430, binding = LightingTileBinding) readonly buffer LightingTileData {
+    LightingTileMembers;
+} lightingTiles;
\ No newline at end of file
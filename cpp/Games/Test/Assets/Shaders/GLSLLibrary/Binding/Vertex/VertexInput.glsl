@@ -0,0 +1,56 @@
+// Inputs follow the mesh vertex format picked on the C++ side, see
+// VertexLayout. Call DecodeVertexInput first in main to fill the in* values.
+#ifdef VertexQuantizedPosition
+layout(location = 0) in vec4 inPackedPosition;
+#else
+layout(location = 0) in vec3 inPackedPosition;
+#endif
+#ifndef VertexNoColor
+layout(location = 1) in vec4 inPackedColor;
+#endif
+#ifdef VertexOctahedralNormal
+layout(location = 2) in vec2 inPackedNormal;
+layout(location = 3) in vec2 inPackedTangent;
+#else
+layout(location = 2) in vec3 inPackedNormal;
+layout(location = 3) in vec3 inPackedTangent;
+#endif
+layout(location = 4) in vec2 inPackedTexCoord;
+
+vec3 inPosition;
+vec4 inColor;
+vec3 inNormal;
+vec3 inTangent;
+vec2 inTexCoord;
+
+vec3 OctahedralDecode(vec2 e) {
+    vec3 n = vec3(e, 1. - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.);
+    n.xy += vec2(n.x >= 0. ? -t : t, n.y >= 0. ? -t : t);
+    return normalize(n);
+}
+
+void DecodeVertexInput(mat4 dequantMatrix, vec4 texCoordDequant) {
+#ifdef VertexQuantizedPosition
+    inPosition = (dequantMatrix * vec4(inPackedPosition.xyz, 1.)).xyz;
+#else
+    inPosition = inPackedPosition;
+#endif
+#ifdef VertexNoColor
+    inColor = vec4(1.);
+#else
+    inColor = inPackedColor;
+#endif
+#ifdef VertexOctahedralNormal
+    inNormal = OctahedralDecode(inPackedNormal);
+    inTangent = OctahedralDecode(inPackedTangent);
+#else
+    inNormal = inPackedNormal;
+    inTangent = inPackedTangent;
+#endif
+#ifdef VertexSnormTexCoord
+    inTexCoord = inPackedTexCoord * texCoordDequant.xy + texCoordDequant.zw;
+#else
+    inTexCoord = inPackedTexCoord;
+#endif
+}
\ No newline at end of file
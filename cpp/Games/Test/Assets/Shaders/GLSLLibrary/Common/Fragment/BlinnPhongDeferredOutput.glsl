@@ -9,8 +9,9 @@ void main() {
     outColor = fragColor * texture(baseColorSampler, fragTexCoord);
     outNormal = fragNormal;
     outPosition = vec4(fragPosition, pipeline.id);
-    outMaterial = vec4(ambientStrength, diffuseStrength, shininessStrength, specularStrength);
+    outMaterial = vec4(ambientStrength, diffuseStrength, shininessStrength / MaxShininess, specularStrength);
 
     outCameraNormal = camera.normal;
     outCameraPosition = camera.pos;
+    WriteGBuffer;
 }
\ No newline at end of file
@@ -9,7 +9,7 @@ void main() {
 
     float ambientStrength = fragMaterial.x;
     float diffuseStrength = fragMaterial.y;
-    float shininessStrength = fragMaterial.z;
+    float shininessStrength = fragMaterial.z * MaxShininess;
     float specularStrength = fragMaterial.w;
 
     vec4 ambient = vec4(0.);
@@ -11,4 +11,5 @@ void main() {
     float texMetallic = texture(metallicSampler, fragTexCoord)[0];
     float texAO = texture(AOSampler, fragTexCoord)[0];
     outMaterial = vec4(texRoughness, texMetallic, texAO, 1.);
+    WriteGBuffer;
 }
\ No newline at end of file
@@ -1,4 +1,17 @@
+#ifdef EnableTileClassification
+#include <GLSLLibrary/Binding/Vertex/BlinnPhongDeferredProcess.glsl>
+
+// A quad over one of the tiles classified as holding the pipeline's pixels
+void main() {
+    uint tile = lightingTiles.tiles[uint(pipeline.id) * lightingTiles.tileCount + uint(gl_InstanceIndex)];
+    vec2 corner = vec2(gl_VertexIndex & 1, gl_VertexIndex >> 1);
+    vec2 extent = vec2(lightingTiles.extent);
+    vec2 pixel = min((vec2(tile & 0xffffu, tile >> 16) + corner) * LightingTileSize, extent);
+    gl_Position = vec4(pixel / extent * 2. - 1., 0., 1.);
+}
+#else
 void main() {
     vec2 uv = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
     gl_Position = vec4(uv * 2.0f + -1.0f, 0.0f, 1.0f);
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include <GLSLLibrary/Binding/Vertex/PBR.glsl>
 
 void main() {
+    DecodeVertexInput(transform.dequantMatrix, transform.texCoordDequant);
     fragColor = inColor;
     fragTexCoord = inTexCoord;
 
@@ -0,0 +1,31 @@
+// Packing of the compact G-buffer, see SwapChain::GetGBufferFormats
+
+// Blinn-Phong shininess is stored divided by it to fit a unorm channel
+#define MaxShininess 256.
+
+vec2 OctWrap(vec2 v) {
+    return (1. - abs(v.yx)) * vec2(v.x >= 0. ? 1. : -1., v.y >= 0. ? 1. : -1.);
+}
+
+// Projects a unit vector onto the octahedron and unfolds it into [-1, 1]^2
+vec2 OctEncode(vec3 n) {
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    return n.z >= 0. ? n.xy : OctWrap(n.xy);
+}
+
+vec3 OctDecode(vec2 f) {
+    vec3 n = vec3(f, 1. - abs(f.x) - abs(f.y));
+    float t = max(-n.z, 0.);
+    n.x += n.x >= 0. ? -t : t;
+    n.y += n.y >= 0. ? -t : t;
+    return normalize(n);
+}
+
+// Pipeline ids are below MaxPipelineNum and fit 8 bits
+float EncodePipelineId(int id) {
+    return float(id) / 255.;
+}
+
+float DecodePipelineId(float value) {
+    return round(value * 255.);
+}
\ No newline at end of file
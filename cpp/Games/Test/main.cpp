@@ -1,10 +1,24 @@
 #include <Engine/System/include/Application.h>
+#include <Engine/Utility/include/BenchmarkUtils.h>
+#include <Engine/Utility/include/SceneBinaryUtils.h>
 
 #include <iostream>
 #include <ostream>
 
-int main() {
+int main(int argc, char* argv[]) {
   try {
+    if (argc > 1 && std::string(argv[1]) == "--benchmark") {
+      return BenchmarkUtils::RunBenchmarks("Games/Test/", "Configs/Benchmark",
+                                           argc > 2 ? argv[2] : "");
+    }
+    if (argc > 1 && std::string(argv[1]) == "--convert-scene") {
+      SceneBinaryUtils::ConvertSceneToBinary(
+          "Games/Test/",
+          argc > 2 ? argv[2]
+                   : JsonUtils::ReadStringFromFile("Games/Test/Index",
+                                                   "LauncherScene"));
+      return EXIT_SUCCESS;
+    }
     std::shared_ptr<Application> app =
         BaseObject::CreateImmediately<Application>("Games/Test/", "Index");
     app->RunApplication();